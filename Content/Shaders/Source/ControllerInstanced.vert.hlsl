@@ -0,0 +1,28 @@
+/* One instance per controller part; model matrices are written by the CPU
+ * right before submission so the newest pose prediction is used */
+StructuredBuffer<float4x4> Models : register(t0, space0);
+
+cbuffer UBO : register(b0, space1)
+{
+    float4x4 ViewProjection : packoffset(c0);
+};
+
+struct Input
+{
+    float3 Position : TEXCOORD0;
+    float4 Color : TEXCOORD1;
+};
+
+struct Output
+{
+    float4 Color : TEXCOORD0;
+    float4 Position : SV_Position;
+};
+
+Output main(Input input, uint InstanceIndex : SV_InstanceID)
+{
+    Output output;
+    output.Color = input.Color;
+    output.Position = mul(ViewProjection, mul(Models[InstanceIndex], float4(input.Position, 1.0f)));
+    return output;
+}
@@ -0,0 +1,39 @@
+/* The 36 vertices of the colored cube built from the vertex index, with no
+ * vertex or index buffer; one instance per object */
+StructuredBuffer<float4x4> Models : register(t0, space0);
+
+cbuffer UBO : register(b0, space1)
+{
+    float4x4 ViewProjection : packoffset(c0);
+};
+
+struct Output
+{
+    float4 Color : TEXCOORD0;
+    float4 Position : SV_Position;
+};
+
+/* Same faces, corner order and colors as the cube mesh */
+static const float3 Corners[24] = {
+    float3(-1,-1,-1), float3( 1,-1,-1), float3( 1, 1,-1), float3(-1, 1,-1),
+    float3( 1,-1, 1), float3(-1,-1, 1), float3(-1, 1, 1), float3( 1, 1, 1),
+    float3(-1,-1, 1), float3(-1,-1,-1), float3(-1, 1,-1), float3(-1, 1, 1),
+    float3( 1,-1,-1), float3( 1,-1, 1), float3( 1, 1, 1), float3( 1, 1,-1),
+    float3(-1, 1,-1), float3( 1, 1,-1), float3( 1, 1, 1), float3(-1, 1, 1),
+    float3(-1,-1, 1), float3( 1,-1, 1), float3( 1,-1,-1), float3(-1,-1,-1)
+};
+static const float3 FaceColors[6] = {
+    float3(1,0,0), float3(0,1,0), float3(0,0,1), float3(1,1,0), float3(1,0,1), float3(0,1,1)
+};
+static const uint QuadCorners[6] = { 0, 1, 2, 0, 2, 3 };
+
+Output main(uint VertexIndex : SV_VertexID, uint InstanceIndex : SV_InstanceID)
+{
+    uint face = VertexIndex / 6;
+    float3 position = Corners[face * 4 + QuadCorners[VertexIndex % 6]] * 0.25f;
+
+    Output output;
+    output.Color = float4(FaceColors[face], 1.0f);
+    output.Position = mul(ViewProjection, mul(Models[InstanceIndex], float4(position, 1.0f)));
+    return output;
+}
@@ -0,0 +1,16 @@
+/* Alpha tested: the atlas is opaque wherever the baked mesh covered it */
+Texture2D<float4> Atlas : register(t0, space2);
+SamplerState AtlasSampler : register(s0, space2);
+
+struct Input
+{
+    float2 TexCoord : TEXCOORD0;
+    float4 Tint : TEXCOORD1;
+};
+
+float4 main(Input input) : SV_Target0
+{
+    float4 color = Atlas.Sample(AtlasSampler, input.TexCoord);
+    clip(color.a - 0.5f);
+    return float4(color.rgb * input.Tint.rgb, 1.0f);
+}
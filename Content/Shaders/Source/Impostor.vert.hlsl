@@ -0,0 +1,82 @@
+/* One camera-facing quad per far object, built from the vertex index. The
+ * direction to this eye, in the object's own space, picks the nearest frame
+ * of the octahedral atlas and the quad is turned to match that frame, so
+ * each eye sees the view baked for its own side of the object. */
+struct Instance
+{
+    float4 CenterRadius;
+    float4 AxisX;           /* Object axes in world space, unit length */
+    float4 AxisY;
+    float4 AxisZ;
+    float4 Tint;
+};
+
+StructuredBuffer<Instance> Instances : register(t0, space0);
+
+cbuffer UBO : register(b0, space1)
+{
+    float4x4 ViewProjection : packoffset(c0);
+    float4 EyePosition : packoffset(c4);
+    float Frames : packoffset(c5.x);        /* Per atlas side */
+    uint FirstInstance : packoffset(c5.y);
+};
+
+struct Output
+{
+    float2 TexCoord : TEXCOORD0;
+    float4 Tint : TEXCOORD1;
+    float4 Position : SV_Position;
+};
+
+static const float2 Corners[6] = {
+    float2(-1,-1), float2( 1,-1), float2( 1, 1), float2(-1,-1), float2( 1, 1), float2(-1, 1)
+};
+
+float2 SignNotZero(float2 v)
+{
+    return float2(v.x >= 0.0f ? 1.0f : -1.0f, v.y >= 0.0f ? 1.0f : -1.0f);
+}
+
+/* Unit sphere onto [-1,1]^2 and back; the bake in impostors.c uses the same mapping */
+float2 OctahedronEncode(float3 n)
+{
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+    return n.z >= 0.0f ? n.xy : (1.0f - abs(n.yx)) * SignNotZero(n.xy);
+}
+
+float3 OctahedronDirection(float2 p)
+{
+    float3 n = float3(p, 1.0f - abs(p.x) - abs(p.y));
+    if (n.z < 0.0f) {
+        n.xy = (1.0f - abs(p.yx)) * SignNotZero(p);
+    }
+    return normalize(n);
+}
+
+Output main(uint VertexIndex : SV_VertexID, uint InstanceIndex : SV_InstanceID)
+{
+    Instance instance = Instances[FirstInstance + InstanceIndex];
+    float3 center = instance.CenterRadius.xyz;
+
+    float3 toEye = EyePosition.xyz - center;
+    float3 local = normalize(float3(dot(toEye, instance.AxisX.xyz), dot(toEye, instance.AxisY.xyz),
+                                    dot(toEye, instance.AxisZ.xyz)));
+    float2 frame = clamp(floor((OctahedronEncode(local) * 0.5f + 0.5f) * Frames), 0.0f, Frames - 1.0f);
+
+    /* The basis the frame was baked with, carried into world space */
+    float3 frameDir = OctahedronDirection((frame + 0.5f) / Frames * 2.0f - 1.0f);
+    float3 reference = abs(frameDir.y) < 0.999f ? float3(0.0f, 1.0f, 0.0f) : float3(0.0f, 0.0f, 1.0f);
+    float3 right = normalize(cross(reference, frameDir));
+    float3 up = cross(frameDir, right);
+    float3 worldRight = right.x * instance.AxisX.xyz + right.y * instance.AxisY.xyz + right.z * instance.AxisZ.xyz;
+    float3 worldUp = up.x * instance.AxisX.xyz + up.y * instance.AxisY.xyz + up.z * instance.AxisZ.xyz;
+
+    float2 corner = Corners[VertexIndex];
+    float3 world = center + (corner.x * worldRight + corner.y * worldUp) * instance.CenterRadius.w;
+
+    Output output;
+    output.TexCoord = (frame + float2(0.5f + 0.5f * corner.x, 0.5f - 0.5f * corner.y)) / Frames;
+    output.Tint = instance.Tint;
+    output.Position = mul(ViewProjection, float4(world, 1.0f));
+    return output;
+}
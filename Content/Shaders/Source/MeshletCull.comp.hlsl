@@ -0,0 +1,79 @@
+/* One group per meshlet of one object: the group's first thread tests the
+ * meshlet's bounding sphere against the frustum and, for single-sided
+ * objects, its normal cone against the eye. A visible meshlet reserves room
+ * in the object's indirect draw and every thread copies one triangle. */
+struct Meshlet
+{
+    float4 CenterRadius;
+    float4 ConeApexCutoff;      /* Cutoff above 1 never culls */
+    float4 ConeAxis;
+    uint4 Range;                /* First index, triangle count, vertex count */
+};
+
+struct Object
+{
+    float4x4 Model;
+    uint FirstMeshlet;
+    uint MeshletCount;
+    uint FirstOutputIndex;
+    uint CullBackfaces;
+};
+
+StructuredBuffer<Meshlet> Meshlets : register(t0, space0);
+StructuredBuffer<uint> MeshletIndices : register(t1, space0);
+StructuredBuffer<Object> Objects : register(t2, space0);
+
+/* Per object, an indexed indirect draw: index count, instance count, first index, vertex offset, first instance */
+RWStructuredBuffer<uint> Commands : register(u0, space1);
+RWStructuredBuffer<uint> OutputIndices : register(u1, space1);
+
+cbuffer UBO : register(b0, space2)
+{
+    float4 Planes[6];           /* Normalized, world space; inside is positive */
+    float4 EyePosition;
+};
+
+static const uint Culled = 0xffffffff;
+
+groupshared uint OutputBase;
+
+[numthreads(128, 1, 1)]
+void main(uint3 GroupID : SV_GroupID, uint3 ThreadID : SV_GroupThreadID)
+{
+    Object object = Objects[GroupID.y];
+    if (GroupID.x >= object.MeshletCount) return;
+    Meshlet meshlet = Meshlets[object.FirstMeshlet + GroupID.x];
+    uint triangleCount = meshlet.Range.y;
+
+    if (ThreadID.x == 0) {
+        float3 center = mul(object.Model, float4(meshlet.CenterRadius.xyz, 1.0f)).xyz;
+        float scale = max(length(mul(object.Model, float4(1.0f, 0.0f, 0.0f, 0.0f)).xyz),
+                          max(length(mul(object.Model, float4(0.0f, 1.0f, 0.0f, 0.0f)).xyz),
+                              length(mul(object.Model, float4(0.0f, 0.0f, 1.0f, 0.0f)).xyz)));
+        float radius = meshlet.CenterRadius.w * scale;
+
+        bool visible = true;
+        for (int i = 0; i < 6; i++) {
+            if (dot(Planes[i].xyz, center) + Planes[i].w < -radius) visible = false;
+        }
+        if (visible && object.CullBackfaces != 0 && meshlet.ConeApexCutoff.w <= 1.0f) {
+            float3 apex = mul(object.Model, float4(meshlet.ConeApexCutoff.xyz, 1.0f)).xyz;
+            float3 axis = normalize(mul(object.Model, float4(meshlet.ConeAxis.xyz, 0.0f)).xyz);
+            if (dot(normalize(apex - EyePosition.xyz), axis) >= meshlet.ConeApexCutoff.w) visible = false;
+        }
+
+        uint base = Culled;
+        if (visible) InterlockedAdd(Commands[GroupID.y * 5], triangleCount * 3, base);
+        OutputBase = base;
+    }
+    GroupMemoryBarrierWithGroupSync();
+
+    uint base = OutputBase;
+    if (base == Culled || ThreadID.x >= triangleCount) return;
+
+    uint src = meshlet.Range.x + ThreadID.x * 3;
+    uint dst = object.FirstOutputIndex + base + ThreadID.x * 3;
+    OutputIndices[dst + 0] = MeshletIndices[src + 0];
+    OutputIndices[dst + 1] = MeshletIndices[src + 1];
+    OutputIndices[dst + 2] = MeshletIndices[src + 2];
+}
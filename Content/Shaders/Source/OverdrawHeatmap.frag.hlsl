@@ -0,0 +1,27 @@
+Texture2D<float4> OverdrawTexture : register(t0, space2);
+SamplerState OverdrawSampler : register(s0, space2);
+
+cbuffer UBO : register(b0, space3)
+{
+    float MaxOverdraw : packoffset(c0);
+};
+
+/* Blue -> cyan -> green -> yellow -> red */
+float3 Heatmap(float t)
+{
+    float3 color;
+    color.r = saturate(t * 4.0f - 2.0f);
+    color.g = saturate(t < 0.75f ? t * 4.0f : 4.0f - t * 4.0f);
+    color.b = saturate(2.0f - t * 4.0f);
+    return color;
+}
+
+float4 main(float2 TexCoord : TEXCOORD0) : SV_Target0
+{
+    /* The overdraw target is R8_UNORM and every fragment adds 1/255 */
+    float layers = OverdrawTexture.Sample(OverdrawSampler, TexCoord).r * 255.0f;
+    if (layers < 0.5f) {
+        return float4(0.0f, 0.0f, 0.0f, 1.0f);
+    }
+    return float4(Heatmap(saturate(layers / MaxOverdraw)), 1.0f);
+}
@@ -0,0 +1,33 @@
+/* One draw per object; the model matrix comes from a storage buffer uploaded
+ * once per frame and the draw only pushes its index */
+StructuredBuffer<float4x4> Models : register(t0, space0);
+
+cbuffer UBO : register(b0, space1)
+{
+    float4x4 ViewProjection : packoffset(c0);
+};
+
+cbuffer ObjectUBO : register(b1, space1)
+{
+    uint ObjectIndex : packoffset(c0);
+};
+
+struct Input
+{
+    float3 Position : TEXCOORD0;
+    float4 Color : TEXCOORD1;
+};
+
+struct Output
+{
+    float4 Color : TEXCOORD0;
+    float4 Position : SV_Position;
+};
+
+Output main(Input input)
+{
+    Output output;
+    output.Color = input.Color;
+    output.Position = mul(ViewProjection, mul(Models[ObjectIndex], float4(input.Position, 1.0f)));
+    return output;
+}
@@ -0,0 +1,32 @@
+/* Model matrix rows as per-instance vertex attributes, so indirect draws
+ * pick their object with first_instance */
+cbuffer UBO : register(b0, space1)
+{
+    float4x4 ViewProjection : packoffset(c0);
+};
+
+struct Input
+{
+    float3 Position : TEXCOORD0;
+    float4 Color : TEXCOORD1;
+    float4 ModelRow0 : TEXCOORD2;
+    float4 ModelRow1 : TEXCOORD3;
+    float4 ModelRow2 : TEXCOORD4;
+    float4 ModelRow3 : TEXCOORD5;
+};
+
+struct Output
+{
+    float4 Color : TEXCOORD0;
+    float4 Position : SV_Position;
+};
+
+Output main(Input input)
+{
+    Output output;
+    output.Color = input.Color;
+    float4 world = input.Position.x * input.ModelRow0 + input.Position.y * input.ModelRow1 +
+                   input.Position.z * input.ModelRow2 + input.ModelRow3;
+    output.Position = mul(ViewProjection, world);
+    return output;
+}
@@ -0,0 +1,10 @@
+/* Per-material tint over the vertex color; alpha drives blended materials */
+cbuffer UBO : register(b0, space3)
+{
+    float4 Tint : packoffset(c0);
+};
+
+float4 main(float4 Color : TEXCOORD0) : SV_Target0
+{
+    return Color * Tint;
+}
@@ -0,0 +1,44 @@
+# Writes a C source holding compiled shaders as static data, so the examples
+# need no shader files at run time. Run in script mode:
+#
+#   cmake -DOUTPUT=embedded_shaders.c -DSHADER_FILES=a.vert.spv|b.frag.spv -P EmbedShaders.cmake
+#
+# Each shader is named after its file without the .spv extension, which is
+# the name Shaders_Load is given.
+
+string(REPLACE "|" ";" SHADER_FILES "${SHADER_FILES}")
+string(REPEAT "[0-9a-f]" 32 LINE_PATTERN)
+
+set(ARRAYS "")
+set(ENTRIES "")
+set(COUNT 0)
+foreach(SHADER_FILE ${SHADER_FILES})
+    get_filename_component(SHADER_NAME ${SHADER_FILE} NAME_WLE)
+    string(MAKE_C_IDENTIFIER "shader_${SHADER_NAME}" SYMBOL)
+
+    # 16 bytes per line
+    file(READ ${SHADER_FILE} HEX HEX)
+    string(REGEX REPLACE "(${LINE_PATTERN})" "\\1\n    " HEX "${HEX}")
+    string(REGEX REPLACE "([0-9a-f][0-9a-f])" "0x\\1," HEX "${HEX}")
+    string(STRIP "${HEX}" HEX)
+
+    # SPIR-V is consumed as 32-bit words
+    string(APPEND ARRAYS "static SDL_ALIGNED(4) const Uint8 ${SYMBOL}[] = {\n    ${HEX}\n};\n\n")
+    string(APPEND ENTRIES "    { \"${SHADER_NAME}\", ${SYMBOL}, sizeof(${SYMBOL}) },\n")
+    math(EXPR COUNT "${COUNT} + 1")
+endforeach()
+
+if(COUNT EQUAL 0)
+    set(ENTRIES "    { NULL, NULL, 0 }\n")
+endif()
+
+file(WRITE ${OUTPUT}.tmp
+    "/* Generated by cmake/EmbedShaders.cmake - do not edit */\n\n"
+    "#include \"shaders.h\"\n\n"
+    "${ARRAYS}"
+    "const ShaderBinary embeddedShaders[] = {\n${ENTRIES}};\n\n"
+    "const Uint32 embeddedShaderCount = ${COUNT};\n")
+
+# Only touch the output when it changed, so unchanged shaders don't rebuild the examples
+execute_process(COMMAND ${CMAKE_COMMAND} -E copy_if_different ${OUTPUT}.tmp ${OUTPUT})
+file(REMOVE ${OUTPUT}.tmp)
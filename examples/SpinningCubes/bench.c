@@ -0,0 +1,435 @@
+/*
+ * Frame benchmark recorder - see bench.h
+ */
+
+#include "bench.h"
+
+#include "gputimer.h"
+
+#define BENCH_MAX_INFO 32
+
+typedef struct {
+    const char *key;
+    char text[128];
+    double number;
+    bool isNumber;
+} BenchInfo;
+
+/* Summary of one timing distribution, in milliseconds */
+typedef struct {
+    Uint32 count;
+    double mean, stddev, min, p50, p90, p95, p99, max;
+} BenchDistribution;
+
+static bool benchEnabled = false;
+static bool benchFinished = false;
+static bool benchRegressed = false;
+static bool benchSkipped = false;
+static BenchConfig benchConfig;
+static GpuTimer *gpuTimer = NULL;
+
+static BenchInfo infos[BENCH_MAX_INFO];
+static int infoCount = 0;
+
+/* Per-frame samples of the measured frames, in nanoseconds */
+static Uint64 *cpuSamples = NULL;
+static Uint64 *gpuSamples = NULL;
+static Uint64 *intervalSamples = NULL;
+static Uint32 cpuCount = 0, gpuCount = 0, intervalCount = 0;
+static Uint32 gpuSamplesSeen = 0;   /* Including warmup frames */
+
+static Uint32 framesEnded = 0;
+static Uint64 frameBeginNs = 0;
+static Uint64 lastBeginNs = 0;
+static Uint64 measureStartNs = 0;
+static Uint64 measureEndNs = 0;
+
+static Uint64 drawCallTotal = 0;
+static Uint64 pipelineBindTotal = 0;
+static Uint64 culledObjectTotal = 0;
+static Uint64 triangleTotal = 0;
+
+/* ========================================================================
+ * Statistics
+ * ======================================================================== */
+
+static int SDLCALL CompareSamples(const void *a, const void *b)
+{
+    Uint64 x = *(const Uint64 *)a, y = *(const Uint64 *)b;
+    return (x > y) - (x < y);
+}
+
+/* Nearest-rank percentile of sorted samples */
+static double Percentile(const Uint64 *sorted, Uint32 count, double percent)
+{
+    Uint32 rank = (Uint32)SDL_ceil(percent / 100.0 * (double)count);
+    return (double)sorted[SDL_clamp(rank, 1u, count) - 1] / 1e6;
+}
+
+/* Sorts the samples in place */
+static BenchDistribution Summarize(Uint64 *samples, Uint32 count)
+{
+    BenchDistribution d = { count };
+    if (count == 0) return d;
+
+    SDL_qsort(samples, count, sizeof(Uint64), CompareSamples);
+
+    double sum = 0.0;
+    for (Uint32 i = 0; i < count; i++) sum += (double)samples[i];
+    double mean = sum / (double)count;
+    double variance = 0.0;
+    for (Uint32 i = 0; i < count; i++) {
+        double delta = (double)samples[i] - mean;
+        variance += delta * delta;
+    }
+    variance = count > 1 ? variance / (double)(count - 1) : 0.0;
+
+    d.mean = mean / 1e6;
+    d.stddev = SDL_sqrt(variance) / 1e6;
+    d.min = (double)samples[0] / 1e6;
+    d.p50 = Percentile(samples, count, 50.0);
+    d.p90 = Percentile(samples, count, 90.0);
+    d.p95 = Percentile(samples, count, 95.0);
+    d.p99 = Percentile(samples, count, 99.0);
+    d.max = (double)samples[count - 1] / 1e6;
+    return d;
+}
+
+static void WriteDistribution(SDL_IOStream *io, const char *name, const BenchDistribution *d)
+{
+    if (d->count == 0) {
+        SDL_IOprintf(io, "  \"%s\": null,\n", name);
+        return;
+    }
+    SDL_IOprintf(io, "  \"%s\": { \"count\": %u, \"mean\": %.4f, \"stddev\": %.4f, \"min\": %.4f, "
+                 "\"p50\": %.4f, \"p90\": %.4f, \"p95\": %.4f, \"p99\": %.4f, \"max\": %.4f },\n",
+                 name, d->count, d->mean, d->stddev, d->min, d->p50, d->p90, d->p95, d->p99, d->max);
+}
+
+static void WriteString(SDL_IOStream *io, const char *text)
+{
+    SDL_WriteU8(io, '"');
+    for (const char *c = text; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            SDL_IOprintf(io, "\\%c", *c);
+        } else if ((unsigned char)*c < 0x20) {
+            SDL_IOprintf(io, "\\u%04x", (unsigned char)*c);
+        } else {
+            SDL_WriteU8(io, (Uint8)*c);
+        }
+    }
+    SDL_WriteU8(io, '"');
+}
+
+static bool WriteReport(const char *path, const BenchDistribution *cpu, const BenchDistribution *gpu,
+                        const BenchDistribution *interval)
+{
+    SDL_IOStream *io = SDL_IOFromFile(path, "w");
+    if (!io) {
+        SDL_Log("Bench: failed to open %s: %s", path, SDL_GetError());
+        return false;
+    }
+
+    double wallMs = (double)(measureEndNs - measureStartNs) / 1e6;
+    double frames = (double)SDL_max(1u, cpuCount);
+
+    SDL_IOprintf(io, "{\n  \"format\": \"spinningcubes-bench\",\n  \"version\": 1,\n  \"run\": {");
+    for (int i = 0; i < infoCount; i++) {
+        SDL_IOprintf(io, "%s\n    ", i == 0 ? "" : ",");
+        WriteString(io, infos[i].key);
+        SDL_IOprintf(io, ": ");
+        if (infos[i].isNumber) {
+            SDL_IOprintf(io, "%.6g", infos[i].number);
+        } else {
+            WriteString(io, infos[i].text);
+        }
+    }
+    SDL_IOprintf(io, "\n  },\n");
+    SDL_IOprintf(io, "  \"frames\": { \"warmup\": %u, \"measured\": %u, \"wall_ms\": %.3f, \"fps\": %.2f },\n",
+                 benchConfig.warmupFrames, cpuCount, wallMs, wallMs > 0.0 ? frames * 1000.0 / wallMs : 0.0);
+    WriteDistribution(io, "cpu_ms", cpu);
+    WriteDistribution(io, "gpu_ms", gpu);
+    WriteDistribution(io, "interval_ms", interval);
+    SDL_IOprintf(io, "  \"render\": { \"draw_calls\": %.1f, \"pipeline_binds\": %.1f, "
+                 "\"culled_objects\": %.1f, \"triangles\": %.0f }\n}\n",
+                 (double)drawCallTotal / frames, (double)pipelineBindTotal / frames,
+                 (double)culledObjectTotal / frames, (double)triangleTotal / frames);
+
+    if (!SDL_CloseIO(io)) {
+        SDL_Log("Bench: failed to write %s: %s", path, SDL_GetError());
+        return false;
+    }
+    return true;
+}
+
+/* ========================================================================
+ * Baseline Comparison
+ * ======================================================================== */
+
+/* Finds "key": inside the object that follows "object": (or at top level) */
+static const char *FindValue(const char *json, const char *object, const char *key)
+{
+    char pattern[64];
+    const char *end = NULL;
+    if (object) {
+        SDL_snprintf(pattern, sizeof(pattern), "\"%s\":", object);
+        json = SDL_strstr(json, pattern);
+        if (!json || !(json = SDL_strchr(json, '{'))) return NULL;
+        end = SDL_strchr(json, '}');
+    }
+    SDL_snprintf(pattern, sizeof(pattern), "\"%s\":", key);
+    const char *value = SDL_strstr(json, pattern);
+    if (!value || (end && value > end)) return NULL;
+    value += SDL_strlen(pattern);
+    while (*value == ' ') value++;
+    return value;
+}
+
+static bool ReadBaselineDistribution(const char *json, const char *name, BenchDistribution *d)
+{
+    const char *count = FindValue(json, name, "count");
+    const char *mean = FindValue(json, name, "mean");
+    const char *stddev = FindValue(json, name, "stddev");
+    const char *p95 = FindValue(json, name, "p95");
+    if (!count || !mean || !stddev || !p95) return false;
+    d->count = (Uint32)SDL_strtoul(count, NULL, 10);
+    d->mean = SDL_strtod(mean, NULL);
+    d->stddev = SDL_strtod(stddev, NULL);
+    d->p95 = SDL_strtod(p95, NULL);
+    return d->count > 1;
+}
+
+/* Reports are only comparable when every run entry except the label matches */
+static bool SameRun(const char *json)
+{
+    for (int i = 0; i < infoCount; i++) {
+        const BenchInfo *info = &infos[i];
+        if (SDL_strcmp(info->key, "label") == 0) continue;
+
+        const char *value = FindValue(json, "run", info->key);
+        bool same;
+        if (!value) {
+            same = false;
+        } else if (info->isNumber) {
+            same = SDL_fabs(SDL_strtod(value, NULL) - info->number) <= 1e-5 * SDL_fabs(info->number);
+        } else {
+            size_t length = SDL_strlen(info->text);
+            same = value[0] == '"' && SDL_strncmp(value + 1, info->text, length) == 0 && value[length + 1] == '"';
+        }
+        if (!same && info->isNumber) {
+            SDL_Log("Bench: baseline was recorded with a different %s (this run: %g)", info->key, info->number);
+        } else if (!same) {
+            SDL_Log("Bench: baseline was recorded with a different %s (this run: %s)", info->key, info->text);
+        }
+        if (!same) return false;
+    }
+    return true;
+}
+
+/*
+ * A metric regresses when its mean is more than regressionPercent slower than
+ * the baseline and Welch's t statistic for the difference exceeds
+ * regressionSigma, so a slow outlier or two cannot fail the run on their own.
+ * The 95th percentile, which has no variance estimate, only gets the relative
+ * test with twice the margin.
+ */
+static bool CompareMetric(const char *name, const BenchDistribution *base, const BenchDistribution *current)
+{
+    if (current->count < 2) return true;
+
+    double limit = benchConfig.regressionPercent / 100.0;
+    double change = (current->mean - base->mean) / SDL_max(base->mean, 1e-6);
+    double error = SDL_sqrt(base->stddev * base->stddev / base->count +
+                            current->stddev * current->stddev / current->count);
+    double t = error > 0.0 ? (current->mean - base->mean) / error : 0.0;
+    double tailChange = (current->p95 - base->p95) / SDL_max(base->p95, 1e-6);
+
+    bool meanRegressed = change > limit && t > benchConfig.regressionSigma;
+    bool tailRegressed = tailChange > 2.0 * limit;
+    SDL_Log("Bench: %-11s mean %8.3f -> %8.3f ms (%+6.1f%%, t %+6.1f)  p95 %8.3f -> %8.3f ms (%+6.1f%%)%s",
+            name, base->mean, current->mean, change * 100.0, t, base->p95, current->p95, tailChange * 100.0,
+            meanRegressed || tailRegressed ? "  REGRESSION" : "");
+    return !meanRegressed && !tailRegressed;
+}
+
+static void CompareBaseline(const BenchDistribution *cpu, const BenchDistribution *gpu,
+                            const BenchDistribution *interval)
+{
+    const char *path = benchConfig.baselinePath;
+    if (benchConfig.recordBaseline) {
+        if (WriteReport(path, cpu, gpu, interval)) {
+            SDL_Log("Bench: recorded baseline %s", path);
+        } else {
+            benchRegressed = true;
+        }
+        return;
+    }
+
+    char *json = SDL_LoadFile(path, NULL);
+    if (!json) {
+        SDL_Log("Bench: baseline %s not found, comparison skipped (record one with --bench-record)", path);
+        benchSkipped = true;
+        return;
+    }
+
+    if (!SameRun(json)) {
+        benchRegressed = true;
+        SDL_free(json);
+        return;
+    }
+
+    const char *names[] = { "cpu_ms", "gpu_ms", "interval_ms" };
+    const BenchDistribution *current[] = { cpu, gpu, interval };
+    bool passed = true;
+    for (size_t i = 0; i < SDL_arraysize(names); i++) {
+        BenchDistribution base;
+        if (ReadBaselineDistribution(json, names[i], &base)) {
+            passed &= CompareMetric(names[i], &base, current[i]);
+        }
+    }
+    SDL_free(json);
+
+    SDL_Log("Bench: baseline compare %s against %s", passed ? "passed" : "FAILED", path);
+    if (!passed) benchRegressed = true;
+}
+
+/* Keeps the GPU times of measured frames; markers are submitted one per frame, in order */
+static void CollectGpuSamples(void)
+{
+    Uint64 samples[BENCH_FRAMES_IN_FLIGHT];
+    Uint32 count;
+    while ((count = GpuTimer_Read(gpuTimer, samples, BENCH_FRAMES_IN_FLIGHT)) > 0) {
+        for (Uint32 i = 0; i < count; i++, gpuSamplesSeen++) {
+            if (gpuSamplesSeen >= benchConfig.warmupFrames && gpuCount < benchConfig.measureFrames) {
+                gpuSamples[gpuCount++] = samples[i];
+            }
+        }
+    }
+}
+
+/* ========================================================================
+ * Public Interface
+ * ======================================================================== */
+
+bool Bench_Init(SDL_GPUDevice *device, const BenchConfig *config)
+{
+    benchConfig = *config;
+    benchConfig.measureFrames = SDL_max(1u, benchConfig.measureFrames);
+
+    cpuSamples = SDL_calloc(benchConfig.measureFrames, sizeof(Uint64));
+    gpuSamples = SDL_calloc(benchConfig.measureFrames, sizeof(Uint64));
+    intervalSamples = SDL_calloc(benchConfig.measureFrames, sizeof(Uint64));
+    if (!cpuSamples || !gpuSamples || !intervalSamples) {
+        Bench_Shutdown();
+        return false;
+    }
+
+    gpuTimer = GpuTimer_Create(device, BENCH_FRAMES_IN_FLIGHT);
+    if (!gpuTimer) {
+        Bench_Shutdown();
+        return false;
+    }
+
+    benchEnabled = true;
+    SDL_Log("Bench: %u warmup + %u measured frames -> %s",
+            benchConfig.warmupFrames, benchConfig.measureFrames, benchConfig.outputPath);
+    return true;
+}
+
+void Bench_Shutdown(void)
+{
+    GpuTimer_Destroy(gpuTimer);
+    gpuTimer = NULL;
+
+    SDL_free(cpuSamples);
+    SDL_free(gpuSamples);
+    SDL_free(intervalSamples);
+    cpuSamples = gpuSamples = intervalSamples = NULL;
+    benchEnabled = false;
+}
+
+bool Bench_IsEnabled(void)
+{
+    return benchEnabled;
+}
+
+void Bench_SetInfo(const char *key, const char *value)
+{
+    if (infoCount == BENCH_MAX_INFO) return;
+    BenchInfo *info = &infos[infoCount++];
+    info->key = key;
+    info->isNumber = false;
+    SDL_strlcpy(info->text, value ? value : "", sizeof(info->text));
+}
+
+void Bench_SetInfoNumber(const char *key, double value)
+{
+    if (infoCount == BENCH_MAX_INFO) return;
+    infos[infoCount++] = (BenchInfo){ key, "", value, true };
+}
+
+void Bench_BeginFrame(void)
+{
+    if (!benchEnabled || benchFinished) return;
+
+    Uint64 nowNs = SDL_GetTicksNS();
+    if (framesEnded == benchConfig.warmupFrames) {
+        measureStartNs = nowNs;
+    } else if (framesEnded > benchConfig.warmupFrames && intervalCount < benchConfig.measureFrames) {
+        intervalSamples[intervalCount++] = nowNs - lastBeginNs;
+    }
+    lastBeginNs = nowNs;
+    frameBeginNs = nowNs;
+}
+
+bool Bench_EndFrame(const BenchRenderStats *stats)
+{
+    if (!benchEnabled || benchFinished) return false;
+
+    Uint64 cpuNs = SDL_GetTicksNS() - frameBeginNs;
+    if (framesEnded >= benchConfig.warmupFrames) {
+        cpuSamples[cpuCount++] = cpuNs;
+        drawCallTotal += stats->drawCalls;
+        pipelineBindTotal += stats->pipelineBinds;
+        culledObjectTotal += stats->culledObjects;
+        triangleTotal += stats->triangles;
+    }
+
+    /* Throttle to the in-flight limit before marking, outside the CPU time above */
+    GpuTimer_Wait(gpuTimer, BENCH_FRAMES_IN_FLIGHT - 1);
+    GpuTimer_Mark(gpuTimer);
+    CollectGpuSamples();
+
+    if (++framesEnded < benchConfig.warmupFrames + benchConfig.measureFrames) {
+        return false;
+    }
+
+    measureEndNs = SDL_GetTicksNS();
+    GpuTimer_Wait(gpuTimer, 0);
+    CollectGpuSamples();
+    benchFinished = true;
+
+    BenchDistribution cpu = Summarize(cpuSamples, cpuCount);
+    BenchDistribution gpu = Summarize(gpuSamples, gpuCount);
+    BenchDistribution interval = Summarize(intervalSamples, intervalCount);
+    if (WriteReport(benchConfig.outputPath, &cpu, &gpu, &interval)) {
+        SDL_Log("Bench: %u frames, cpu p50 %.3f ms, gpu p50 %.3f ms -> %s", cpuCount,
+                cpu.p50, gpu.p50, benchConfig.outputPath);
+    } else {
+        benchRegressed = true;
+    }
+    if (benchConfig.baselinePath) {
+        CompareBaseline(&cpu, &gpu, &interval);
+    }
+    return true;
+}
+
+bool Bench_Failed(void)
+{
+    return benchRegressed;
+}
+
+bool Bench_Skipped(void)
+{
+    return benchSkipped;
+}
@@ -0,0 +1,67 @@
+/*
+ * Frame benchmark recorder
+ *
+ * Times a fixed number of frames after a warmup and writes the result as
+ * JSON: percentiles of CPU frame time, GPU frame time and frame interval,
+ * the renderer's per-frame statistics and free-form run metadata (scene,
+ * resolution, driver, build label), so runs can be compared across builds
+ * and devices.
+ *
+ * Given a baseline report, the run is compared against it once finished and
+ * Bench_Failed reports a significant slowdown of the CPU, GPU or interval
+ * times. A missing baseline is not a pass: the comparison is skipped and
+ * Bench_Skipped says so, unless the run records its baseline instead.
+ *
+ * At most BENCH_FRAMES_IN_FLIGHT frames are allowed on the GPU; beyond that
+ * Bench_EndFrame waits, as a compositor would, so an unpaced run measures
+ * throughput instead of queueing unbounded work.
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <SDL3/SDL.h>
+
+#define BENCH_FRAMES_IN_FLIGHT 2
+#define BENCH_EXIT_SKIPPED 77       /* Exit code of a run with no baseline to compare against */
+
+typedef struct BenchConfig {
+    Uint32 warmupFrames;        /* Rendered but not measured */
+    Uint32 measureFrames;
+    const char *outputPath;     /* JSON report */
+    const char *baselinePath;   /* Report to compare against; NULL skips the comparison */
+    bool recordBaseline;        /* Write the report to baselinePath instead of comparing */
+    float regressionPercent;    /* Slowdown of the mean that counts as a regression */
+    float regressionSigma;      /* ...when also this many standard errors from the baseline */
+} BenchConfig;
+
+/* What the renderer recorded for one frame, summed over its views */
+typedef struct BenchRenderStats {
+    Uint32 drawCalls;
+    Uint32 pipelineBinds;
+    Uint32 culledObjects;
+    Uint64 triangles;
+} BenchRenderStats;
+
+bool Bench_Init(SDL_GPUDevice *device, const BenchConfig *config);
+void Bench_Shutdown(void);
+bool Bench_IsEnabled(void);
+
+/* Run metadata written to the report's "run" object, in the order added */
+void Bench_SetInfo(const char *key, const char *value);
+void Bench_SetInfoNumber(const char *key, double value);
+
+/* Call once xrWaitFrame has returned */
+void Bench_BeginFrame(void);
+
+/* Call after the frame's command buffers are submitted. Returns true on the
+ * frame that completes the run, after the report has been written. */
+bool Bench_EndFrame(const BenchRenderStats *stats);
+
+/* True once the run could not write its report or regressed against the baseline */
+bool Bench_Failed(void);
+
+/* True when the run finished without a baseline to compare against */
+bool Bench_Skipped(void);
+
+#endif /* BENCH_H */
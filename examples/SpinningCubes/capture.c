@@ -0,0 +1,389 @@
+/*
+ * Frame capture - see capture.h
+ */
+
+#include "capture.h"
+
+#define CAPTURE_QUEUE_SIZE 16
+
+#define CAPTURE_TASK_SCREENSHOT (1u << 0)
+#define CAPTURE_TASK_VIDEO      (1u << 1)
+#define CAPTURE_TASK_GOLDEN     (1u << 2)
+
+typedef struct {
+    CaptureJobFunction fn;
+    void *userdata;
+    ReadbackImage image;
+} CaptureJob;
+
+static CaptureConfig captureConfig;
+static bool captureEnabled = false;
+
+/* Worker thread and its job queue */
+static SDL_Thread *captureThread = NULL;
+static SDL_Mutex *captureMutex = NULL;
+static SDL_Condition *captureCondition = NULL;
+static CaptureJob captureQueue[CAPTURE_QUEUE_SIZE];
+static Uint32 captureQueueHead = 0;
+static Uint32 captureQueueCount = 0;
+static bool captureQuit = false;
+static Uint64 captureDropped = 0;
+
+/* Worker-owned output state */
+static SDL_IOStream *videoFile = NULL;
+static Uint32 videoWidth = 0, videoHeight = 0;
+static Uint8 *videoFrame = NULL;
+static Uint64 videoFramesWritten = 0;
+static bool videoFailed = false;
+static SDL_AtomicInt videoFrameRate;
+static SDL_AtomicInt goldenFailed;
+
+/* ========================================================================
+ * Pixel Helpers
+ * ======================================================================== */
+
+/* Byte-order SDL format matching an 8-bit RGBA/BGRA GPU format */
+static SDL_PixelFormat SurfaceFormatFor(SDL_GPUTextureFormat format)
+{
+    switch (format) {
+        case SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM:
+        case SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM_SRGB:
+            return SDL_PIXELFORMAT_RGBA32;
+        case SDL_GPU_TEXTUREFORMAT_B8G8R8A8_UNORM:
+        case SDL_GPU_TEXTUREFORMAT_B8G8R8A8_UNORM_SRGB:
+            return SDL_PIXELFORMAT_BGRA32;
+        default:
+            return SDL_PIXELFORMAT_UNKNOWN;
+    }
+}
+
+static SDL_Surface *WrapImage(const ReadbackImage *image)
+{
+    SDL_PixelFormat format = SurfaceFormatFor(image->format);
+    if (format == SDL_PIXELFORMAT_UNKNOWN) {
+        SDL_Log("Capture: unsupported texture format %d", image->format);
+        return NULL;
+    }
+    return SDL_CreateSurfaceFrom((int)image->width, (int)image->height, format,
+                                 (void *)image->pixels, (int)image->pitch);
+}
+
+/* BT.601 limited-range RGB -> I420 with 2x2 box-filtered chroma */
+static void ConvertToI420(const ReadbackImage *image, Uint8 *dst)
+{
+    Uint32 w = image->width, h = image->height;
+    Uint32 cw = (w + 1) / 2, ch = (h + 1) / 2;
+    Uint8 *yPlane = dst;
+    Uint8 *uPlane = yPlane + w * h;
+    Uint8 *vPlane = uPlane + cw * ch;
+    int rOffset = (SurfaceFormatFor(image->format) == SDL_PIXELFORMAT_BGRA32) ? 2 : 0;
+    int bOffset = 2 - rOffset;
+
+    for (Uint32 y = 0; y < h; y++) {
+        const Uint8 *row = image->pixels + (size_t)y * image->pitch;
+        for (Uint32 x = 0; x < w; x++) {
+            int r = row[x * 4 + rOffset], g = row[x * 4 + 1], b = row[x * 4 + bOffset];
+            yPlane[(size_t)y * w + x] = (Uint8)(((66 * r + 129 * g + 25 * b + 128) >> 8) + 16);
+        }
+    }
+
+    for (Uint32 cy = 0; cy < ch; cy++) {
+        for (Uint32 cx = 0; cx < cw; cx++) {
+            int r = 0, g = 0, b = 0, n = 0;
+            for (Uint32 dy = 0; dy < 2; dy++) {
+                Uint32 y = cy * 2 + dy;
+                if (y >= h) break;
+                const Uint8 *row = image->pixels + (size_t)y * image->pitch;
+                for (Uint32 dx = 0; dx < 2; dx++) {
+                    Uint32 x = cx * 2 + dx;
+                    if (x >= w) break;
+                    r += row[x * 4 + rOffset];
+                    g += row[x * 4 + 1];
+                    b += row[x * 4 + bOffset];
+                    n++;
+                }
+            }
+            r /= n; g /= n; b /= n;
+            uPlane[(size_t)cy * cw + cx] = (Uint8)(((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128);
+            vPlane[(size_t)cy * cw + cx] = (Uint8)(((112 * r - 94 * g - 18 * b + 128) >> 8) + 128);
+        }
+    }
+}
+
+/* ========================================================================
+ * Capture Outputs (worker thread)
+ * ======================================================================== */
+
+static void WriteScreenshot(const ReadbackImage *image, SDL_Surface *surface)
+{
+    char path[512];
+    SDL_snprintf(path, sizeof(path), "%s_frame%llu_view%u.bmp", captureConfig.screenshotPrefix,
+                 (unsigned long long)image->frameIndex, image->tag);
+
+    if (SDL_SaveBMP(surface, path)) {
+        SDL_Log("Capture: wrote %s", path);
+    } else {
+        SDL_Log("Capture: failed to write %s: %s", path, SDL_GetError());
+    }
+}
+
+static void WriteVideoFrame(const ReadbackImage *image)
+{
+    if (videoFailed) return;
+
+    if (!videoFile) {
+        if (SurfaceFormatFor(image->format) == SDL_PIXELFORMAT_UNKNOWN) {
+            SDL_Log("Capture: unsupported texture format %d for video", image->format);
+            videoFailed = true;
+            return;
+        }
+
+        videoFile = SDL_IOFromFile(captureConfig.videoPath, "wb");
+        if (!videoFile) {
+            SDL_Log("Capture: failed to open %s: %s", captureConfig.videoPath, SDL_GetError());
+            videoFailed = true;
+            return;
+        }
+        videoWidth = image->width;
+        videoHeight = image->height;
+        videoFrame = SDL_malloc((size_t)videoWidth * videoHeight + 2 * (size_t)((videoWidth + 1) / 2) * ((videoHeight + 1) / 2));
+
+        int fps = SDL_GetAtomicInt(&videoFrameRate);
+        int interval = (int)SDL_max(captureConfig.videoInterval, 1);
+        SDL_IOprintf(videoFile, "YUV4MPEG2 W%u H%u F%d:%d Ip A1:1 C420jpeg XCOLORRANGE=LIMITED\n",
+                     videoWidth, videoHeight, fps > 0 ? fps : 90, interval);
+        SDL_Log("Capture: recording view %u to %s (%ux%u)", image->tag, captureConfig.videoPath, videoWidth, videoHeight);
+    }
+
+    if (!videoFrame || image->width != videoWidth || image->height != videoHeight) return;
+
+    ConvertToI420(image, videoFrame);
+    size_t frameSize = (size_t)videoWidth * videoHeight + 2 * (size_t)((videoWidth + 1) / 2) * ((videoHeight + 1) / 2);
+    SDL_WriteIO(videoFile, "FRAME\n", 6);
+    SDL_WriteIO(videoFile, videoFrame, frameSize);
+    videoFramesWritten++;
+}
+
+static void CompareGolden(SDL_Surface *captured)
+{
+    const char *path = captureConfig.goldenPath;
+    SDL_Surface *golden = SDL_LoadBMP(path);
+    if (!golden) {
+        SDL_Log("Capture: golden image %s not found, saving this frame as the new golden", path);
+        if (!SDL_SaveBMP(captured, path)) {
+            SDL_Log("Capture: failed to write %s: %s", path, SDL_GetError());
+        }
+        return;
+    }
+
+    SDL_Surface *a = SDL_ConvertSurface(captured, SDL_PIXELFORMAT_RGBA32);
+    SDL_Surface *b = SDL_ConvertSurface(golden, SDL_PIXELFORMAT_RGBA32);
+    SDL_DestroySurface(golden);
+
+    if (!a || !b || a->w != b->w || a->h != b->h) {
+        SDL_Log("Capture: golden compare FAILED (size mismatch or conversion error)");
+        SDL_SetAtomicInt(&goldenFailed, 1);
+        if (a) SDL_DestroySurface(a);
+        if (b) SDL_DestroySurface(b);
+        return;
+    }
+
+    /* Alpha is ignored: BMP round trips do not preserve it reliably */
+    Uint64 mismatches = 0;
+    double sumSquares = 0.0;
+    for (int y = 0; y < a->h; y++) {
+        const Uint8 *rowA = (const Uint8 *)a->pixels + (size_t)y * a->pitch;
+        const Uint8 *rowB = (const Uint8 *)b->pixels + (size_t)y * b->pitch;
+        for (int x = 0; x < a->w; x++) {
+            int worst = 0;
+            for (int c = 0; c < 3; c++) {
+                int diff = rowA[x * 4 + c] - rowB[x * 4 + c];
+                if (diff < 0) diff = -diff;
+                if (diff > worst) worst = diff;
+                sumSquares += (double)(diff * diff);
+            }
+            if (worst > (int)captureConfig.goldenTolerance) mismatches++;
+        }
+    }
+
+    double pixelCount = (double)a->w * (double)a->h;
+    double mse = sumSquares / (pixelCount * 3.0);
+    double psnr = mse > 0.0 ? 10.0 * SDL_log10((255.0 * 255.0) / mse) : 99.0;
+    bool passed = (double)mismatches <= (double)captureConfig.goldenMaxMismatch * pixelCount;
+
+    SDL_Log("Capture: golden compare %s against %s (%.4f%% pixels over tolerance %u, PSNR %.2f dB)",
+            passed ? "PASSED" : "FAILED", path, 100.0 * (double)mismatches / pixelCount,
+            captureConfig.goldenTolerance, psnr);
+    if (!passed) {
+        SDL_SetAtomicInt(&goldenFailed, 1);
+    }
+
+    SDL_DestroySurface(a);
+    SDL_DestroySurface(b);
+}
+
+static void RunCaptureTasks(void *userdata, const ReadbackImage *image)
+{
+    Uint32 tasks = (Uint32)(uintptr_t)userdata;
+
+    if (tasks & CAPTURE_TASK_VIDEO) {
+        WriteVideoFrame(image);
+    }
+
+    if (tasks & (CAPTURE_TASK_SCREENSHOT | CAPTURE_TASK_GOLDEN)) {
+        SDL_Surface *surface = WrapImage(image);
+        if (!surface) return;
+        if (tasks & CAPTURE_TASK_SCREENSHOT) WriteScreenshot(image, surface);
+        if (tasks & CAPTURE_TASK_GOLDEN) CompareGolden(surface);
+        SDL_DestroySurface(surface);
+    }
+}
+
+/* ========================================================================
+ * Worker Thread
+ * ======================================================================== */
+
+static int SDLCALL CaptureThreadMain(void *data)
+{
+    (void)data;
+
+    for (;;) {
+        SDL_LockMutex(captureMutex);
+        while (captureQueueCount == 0 && !captureQuit) {
+            SDL_WaitCondition(captureCondition, captureMutex);
+        }
+        if (captureQueueCount == 0) {
+            SDL_UnlockMutex(captureMutex);
+            break;
+        }
+        CaptureJob job = captureQueue[captureQueueHead];
+        captureQueueHead = (captureQueueHead + 1) % CAPTURE_QUEUE_SIZE;
+        captureQueueCount--;
+        SDL_UnlockMutex(captureMutex);
+
+        job.fn(job.userdata, &job.image);
+        Readback_Release(&job.image);
+    }
+    return 0;
+}
+
+bool Capture_Init(const CaptureConfig *config)
+{
+    captureConfig = *config;
+    captureEnabled = config->screenshotPrefix || config->videoPath || config->goldenPath;
+    SDL_SetAtomicInt(&goldenFailed, 0);
+
+    captureMutex = SDL_CreateMutex();
+    captureCondition = SDL_CreateCondition();
+    if (!captureMutex || !captureCondition) {
+        SDL_Log("Capture: failed to create worker sync objects: %s", SDL_GetError());
+        return false;
+    }
+
+    captureThread = SDL_CreateThread(CaptureThreadMain, "capture", NULL);
+    if (!captureThread) {
+        SDL_Log("Capture: failed to start worker: %s", SDL_GetError());
+        return false;
+    }
+    return true;
+}
+
+void Capture_Shutdown(void)
+{
+    if (captureThread) {
+        SDL_LockMutex(captureMutex);
+        captureQuit = true;
+        SDL_SignalCondition(captureCondition);
+        SDL_UnlockMutex(captureMutex);
+        SDL_WaitThread(captureThread, NULL);
+        captureThread = NULL;
+    }
+
+    if (videoFile) {
+        SDL_CloseIO(videoFile);
+        videoFile = NULL;
+        SDL_Log("Capture: wrote %llu video frames to %s", (unsigned long long)videoFramesWritten, captureConfig.videoPath);
+    }
+    SDL_free(videoFrame);
+    videoFrame = NULL;
+
+    if (captureDropped > 0) {
+        SDL_Log("Capture: dropped %llu jobs (worker busy)", (unsigned long long)captureDropped);
+    }
+
+    if (captureCondition) SDL_DestroyCondition(captureCondition);
+    if (captureMutex) SDL_DestroyMutex(captureMutex);
+    captureCondition = NULL;
+    captureMutex = NULL;
+}
+
+/* ========================================================================
+ * Frame Thread Interface
+ * ======================================================================== */
+
+static Uint32 CaptureTasksFor(Uint64 frameIndex, Uint32 view)
+{
+    Uint32 tasks = 0;
+    if (!captureEnabled) return 0;
+
+    if (frameIndex == captureConfig.captureFrame) {
+        if (captureConfig.screenshotPrefix) tasks |= CAPTURE_TASK_SCREENSHOT;
+        if (captureConfig.goldenPath && view == 0) tasks |= CAPTURE_TASK_GOLDEN;
+    }
+    if (captureConfig.videoPath && view == captureConfig.videoView &&
+        frameIndex % SDL_max(captureConfig.videoInterval, 1) == 0) {
+        tasks |= CAPTURE_TASK_VIDEO;
+    }
+    return tasks;
+}
+
+bool Capture_IsEnabled(void)
+{
+    return captureEnabled;
+}
+
+bool Capture_WantsView(Uint64 frameIndex, Uint32 view)
+{
+    return CaptureTasksFor(frameIndex, view) != 0;
+}
+
+void Capture_SetFrameRate(Uint32 framesPerSecond)
+{
+    SDL_SetAtomicInt(&videoFrameRate, (int)framesPerSecond);
+}
+
+bool Capture_OnReadback(void *userdata, const ReadbackImage *image)
+{
+    (void)userdata;
+
+    Uint32 tasks = CaptureTasksFor(image->frameIndex, image->tag);
+    if (tasks == 0) return false;
+
+    return Capture_Defer(image, RunCaptureTasks, (void *)(uintptr_t)tasks);
+}
+
+bool Capture_Defer(const ReadbackImage *image, CaptureJobFunction fn, void *userdata)
+{
+    if (!captureThread) return false;
+
+    bool queued = false;
+    SDL_LockMutex(captureMutex);
+    if (captureQueueCount < CAPTURE_QUEUE_SIZE) {
+        CaptureJob *job = &captureQueue[(captureQueueHead + captureQueueCount) % CAPTURE_QUEUE_SIZE];
+        job->fn = fn;
+        job->userdata = userdata;
+        job->image = *image;
+        captureQueueCount++;
+        queued = true;
+        SDL_SignalCondition(captureCondition);
+    } else {
+        captureDropped++;
+    }
+    SDL_UnlockMutex(captureMutex);
+    return queued;
+}
+
+bool Capture_GoldenFailed(void)
+{
+    return SDL_GetAtomicInt(&goldenFailed) != 0;
+}
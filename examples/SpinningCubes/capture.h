@@ -0,0 +1,52 @@
+/*
+ * Frame capture: screenshots, raw Y4M video and golden-image comparison
+ *
+ * Readbacks arrive from the ReadbackRing still mapped; all encoding, file
+ * I/O and comparison runs on a background worker which releases the image
+ * when it is done, so the frame thread only pays for queueing a job.
+ */
+
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#include <SDL3/SDL.h>
+
+#include "readback.h"
+
+typedef struct CaptureConfig {
+    const char *screenshotPrefix;   /* Writes <prefix>_frame<N>_view<V>.bmp; NULL disables */
+    const char *videoPath;          /* Raw 4:2:0 Y4M; NULL disables */
+    const char *goldenPath;         /* BMP compared against view 0; NULL disables */
+    Uint64 captureFrame;            /* Frame used for screenshots and the golden compare */
+    Uint32 videoView;
+    Uint32 videoInterval;           /* Record every Nth frame */
+    Uint32 goldenTolerance;         /* Max per-channel difference before a pixel mismatches */
+    float goldenMaxMismatch;        /* Fraction of mismatching pixels that still passes */
+} CaptureConfig;
+
+/* Runs on the capture worker; the image is released after it returns */
+typedef void (*CaptureJobFunction)(void *userdata, const ReadbackImage *image);
+
+bool Capture_Init(const CaptureConfig *config);
+void Capture_Shutdown(void);
+
+/* True when any capture output is configured */
+bool Capture_IsEnabled(void);
+
+/* True when this view of this frame should be read back for capture */
+bool Capture_WantsView(Uint64 frameIndex, Uint32 view);
+
+/* Frame rate written into the Y4M header; set before the first video frame */
+void Capture_SetFrameRate(Uint32 framesPerSecond);
+
+/* ReadbackCallback that queues the configured capture outputs for an image */
+bool Capture_OnReadback(void *userdata, const ReadbackImage *image);
+
+/* Runs fn on the capture worker, then releases the image. Returns false
+ * (and leaves the image to the caller) if the queue is full. */
+bool Capture_Defer(const ReadbackImage *image, CaptureJobFunction fn, void *userdata);
+
+/* True once a golden comparison has failed */
+bool Capture_GoldenFailed(void);
+
+#endif /* CAPTURE_H */
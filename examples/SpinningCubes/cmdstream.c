@@ -0,0 +1,934 @@
+/*
+ * Renderer command stream capture and replay - see cmdstream.h
+ */
+
+#include "cmdstream.h"
+
+#include "shaders.h"
+
+#define CMDSTREAM_MAGIC 0x53434353u     /* "SCCS" */
+#define CMDSTREAM_VERSION 1
+#define SHADER_NAME_LENGTH 64
+#define MAX_VERTEX_BUFFERS 4
+#define MAX_VERTEX_ATTRIBUTES 8
+#define MAX_BINDINGS 4
+#define MAX_UNIFORM_LENGTH 256
+#define MAX_TARGETS 8
+#define NO_OBJECT UINT32_MAX
+
+/*
+ * File layout: a header, the pipeline records, the buffer records each
+ * followed by their contents, then the commands. A command is a Uint32
+ * type and its payload struct; uniform and buffer update payloads are
+ * followed by their data. Objects are referred to by their index in
+ * registration order.
+ */
+
+typedef enum {
+    CMD_UPDATE_BUFFER,
+    CMD_BEGIN_PASS,
+    CMD_END_PASS,
+    CMD_VIEWPORT,
+    CMD_SCISSOR,
+    CMD_BIND_PIPELINE,
+    CMD_BIND_VERTEX_BUFFERS,
+    CMD_BIND_INDEX_BUFFER,
+    CMD_BIND_VERTEX_STORAGE,
+    CMD_PUSH_UNIFORM,
+    CMD_DRAW_INDEXED,
+    CMD_DRAW,
+    CMD_DRAW_INDEXED_INDIRECT
+} CmdType;
+
+typedef struct {
+    Uint32 magic;
+    Uint32 version;
+    Uint32 pipelineRecordSize;      /* Stands in for the layout of the SDL structs inside */
+    Uint32 pipelineCount;
+    Uint32 bufferCount;
+    Uint32 padding;
+    Uint64 commandBytes;
+    Uint64 frameIndex;
+} FileHeader;
+
+typedef struct {
+    char name[SHADER_NAME_LENGTH];
+    Uint32 samplers;
+    Uint32 uniformBuffers;
+    Uint32 storageBuffers;
+} ShaderRecord;
+
+typedef struct {
+    ShaderRecord vertexShader;
+    ShaderRecord fragmentShader;
+    SDL_GPUPrimitiveType primitiveType;
+    SDL_GPURasterizerState rasterizer;
+    SDL_GPUDepthStencilState depthStencil;
+    SDL_GPUColorTargetDescription colorTarget;
+    Uint32 vertexBufferCount;
+    Uint32 attributeCount;
+    SDL_GPUVertexBufferDescription vertexBuffers[MAX_VERTEX_BUFFERS];
+    SDL_GPUVertexAttribute attributes[MAX_VERTEX_ATTRIBUTES];
+} PipelineRecord;
+
+typedef struct {
+    Uint32 usage;
+    Uint32 size;
+    Uint32 hasContents;             /* Else zero-filled */
+} BufferRecord;
+
+typedef struct { Uint32 buffer, offset, size; } UpdateBufferCmd;
+typedef struct { Uint32 width, height, format, loadOp; SDL_FColor clearColor; } BeginPassCmd;
+typedef struct { Uint32 firstSlot, count, buffers[MAX_BINDINGS], offsets[MAX_BINDINGS]; } VertexBuffersCmd;
+typedef struct { Uint32 buffer, offset, indexSize; } IndexBufferCmd;
+typedef struct { Uint32 firstSlot, count, buffers[MAX_BINDINGS]; } StorageBuffersCmd;
+typedef struct { Uint32 stage, slot, length; } UniformCmd;
+typedef struct { Uint32 indexCount, instanceCount, firstIndex; Sint32 vertexOffset; Uint32 firstInstance; } DrawIndexedCmd;
+typedef struct { Uint32 vertexCount, instanceCount, firstVertex, firstInstance; } DrawCmd;
+typedef struct { Uint32 buffer, offset, drawCount; } IndirectCmd;
+
+/* ========================================================================
+ * Capture State
+ * ======================================================================== */
+
+typedef struct {
+    SDL_GPUGraphicsPipeline *pipeline;
+    PipelineRecord record;
+} RegisteredPipeline;
+
+typedef struct {
+    SDL_GPUBuffer *buffer;
+    Uint32 usage;
+    Uint32 size;
+    Uint8 *contents;                /* As of the start of the captured frame; NULL until filled */
+} RegisteredBuffer;
+
+bool cmdStreamRecording = false;
+
+static const char *capturePath = NULL;
+static Uint64 captureFrame = 0;
+static bool armed = false;
+static bool incomplete = false;
+
+static RegisteredPipeline *pipelines = NULL;
+static Uint32 pipelineCount = 0;
+static size_t pipelineCapacity = 0;
+static RegisteredBuffer *buffers = NULL;
+static Uint32 bufferCount = 0;
+static size_t bufferCapacity = 0;
+static Uint8 *commands = NULL;
+static size_t commandSize = 0, commandCapacity = 0;
+
+static bool Reserve(void **array, size_t *capacity, size_t needed, size_t elementSize)
+{
+    if (needed <= *capacity) return true;
+    size_t newCapacity = SDL_max(*capacity * 2, SDL_max(needed, (size_t)16));
+    void *grown = SDL_realloc(*array, newCapacity * elementSize);
+    if (!grown) return false;
+    *array = grown;
+    *capacity = newCapacity;
+    return true;
+}
+
+/* Anything the file could not describe makes the capture useless, so it is not written */
+static void MarkIncomplete(const char *reason)
+{
+    if (!incomplete) {
+        SDL_Log("CmdStream: capture incomplete: %s", reason);
+    }
+    incomplete = true;
+}
+
+static void Append(const void *data, size_t size)
+{
+    if (!Reserve((void **)&commands, &commandCapacity, commandSize + size, 1)) {
+        MarkIncomplete("out of memory");
+        return;
+    }
+    SDL_memcpy(commands + commandSize, data, size);
+    commandSize += size;
+}
+
+static void AppendCommand(CmdType type, const void *payload, size_t size)
+{
+    Uint32 type32 = (Uint32)type;
+    Append(&type32, sizeof(type32));
+    if (size > 0) Append(payload, size);
+}
+
+static Uint32 FindPipeline(SDL_GPUGraphicsPipeline *pipeline)
+{
+    for (Uint32 i = 0; i < pipelineCount; i++) {
+        if (pipelines[i].pipeline == pipeline) return i;
+    }
+    MarkIncomplete("a bound pipeline was not registered");
+    return NO_OBJECT;
+}
+
+static Uint32 FindBuffer(SDL_GPUBuffer *buffer)
+{
+    for (Uint32 i = 0; i < bufferCount; i++) {
+        if (buffers[i].buffer == buffer) return i;
+    }
+    MarkIncomplete("a bound buffer was not registered");
+    return NO_OBJECT;
+}
+
+static void FreeCaptureState(void)
+{
+    for (Uint32 i = 0; i < bufferCount; i++) {
+        SDL_free(buffers[i].contents);
+    }
+    SDL_free(pipelines);
+    SDL_free(buffers);
+    SDL_free(commands);
+    pipelines = NULL;
+    buffers = NULL;
+    commands = NULL;
+    pipelineCount = pipelineCapacity = 0;
+    bufferCount = bufferCapacity = 0;
+    commandSize = commandCapacity = 0;
+}
+
+/* ========================================================================
+ * Capture Interface
+ * ======================================================================== */
+
+bool CmdStream_Init(const char *path, Uint64 frame)
+{
+    capturePath = path;
+    captureFrame = frame;
+    armed = true;
+    incomplete = false;
+    SDL_Log("CmdStream: capturing frame %llu to %s", (unsigned long long)frame, path);
+    return true;
+}
+
+void CmdStream_Shutdown(void)
+{
+    if (armed) {
+        SDL_Log("CmdStream: frame %llu was never rendered, nothing captured", (unsigned long long)captureFrame);
+    }
+    armed = false;
+    cmdStreamRecording = false;
+    FreeCaptureState();
+}
+
+static void CopyShader(ShaderRecord *record, const CmdStreamShader *shader)
+{
+    SDL_strlcpy(record->name, shader->name, sizeof(record->name));
+    record->samplers = shader->samplers;
+    record->uniformBuffers = shader->uniformBuffers;
+    record->storageBuffers = shader->storageBuffers;
+}
+
+void CmdStream_RegisterPipeline(SDL_GPUGraphicsPipeline *pipeline, const SDL_GPUGraphicsPipelineCreateInfo *info,
+                                const CmdStreamShader *vertexShader, const CmdStreamShader *fragmentShader)
+{
+    if (!armed || !pipeline) return;
+
+    const SDL_GPUVertexInputState *input = &info->vertex_input_state;
+    if (info->target_info.num_color_targets != 1 || info->target_info.has_depth_stencil_target ||
+        input->num_vertex_buffers > MAX_VERTEX_BUFFERS || input->num_vertex_attributes > MAX_VERTEX_ATTRIBUTES) {
+        SDL_Log("CmdStream: pipeline using %s cannot be captured", vertexShader->name);
+        return;
+    }
+
+    if (!Reserve((void **)&pipelines, &pipelineCapacity, pipelineCount + 1, sizeof(RegisteredPipeline))) {
+        MarkIncomplete("out of memory");
+        return;
+    }
+
+    RegisteredPipeline *entry = &pipelines[pipelineCount++];
+    SDL_zerop(entry);
+    entry->pipeline = pipeline;
+    PipelineRecord *record = &entry->record;
+    CopyShader(&record->vertexShader, vertexShader);
+    CopyShader(&record->fragmentShader, fragmentShader);
+    record->primitiveType = info->primitive_type;
+    record->rasterizer = info->rasterizer_state;
+    record->depthStencil = info->depth_stencil_state;
+    record->colorTarget = info->target_info.color_target_descriptions[0];
+    record->vertexBufferCount = input->num_vertex_buffers;
+    record->attributeCount = input->num_vertex_attributes;
+    if (input->num_vertex_buffers > 0) {
+        SDL_memcpy(record->vertexBuffers, input->vertex_buffer_descriptions,
+                   input->num_vertex_buffers * sizeof(SDL_GPUVertexBufferDescription));
+    }
+    if (input->num_vertex_attributes > 0) {
+        SDL_memcpy(record->attributes, input->vertex_attributes,
+                   input->num_vertex_attributes * sizeof(SDL_GPUVertexAttribute));
+    }
+}
+
+void CmdStream_RegisterBuffer(SDL_GPUBuffer *buffer, SDL_GPUBufferUsageFlags usage, Uint32 size, const void *contents)
+{
+    if (!armed || !buffer) return;
+
+    if (!Reserve((void **)&buffers, &bufferCapacity, bufferCount + 1, sizeof(RegisteredBuffer))) {
+        MarkIncomplete("out of memory");
+        return;
+    }
+
+    RegisteredBuffer *entry = &buffers[bufferCount++];
+    entry->buffer = buffer;
+    entry->usage = usage;
+    entry->size = size;
+    entry->contents = NULL;
+    if (contents) {
+        entry->contents = SDL_malloc(size);
+        if (entry->contents) {
+            SDL_memcpy(entry->contents, contents, size);
+        } else {
+            MarkIncomplete("out of memory");
+        }
+    }
+}
+
+void CmdStream_UpdateBuffer(SDL_GPUBuffer *buffer, Uint32 offset, const void *data, Uint32 size)
+{
+    if (!armed) return;
+
+    Uint32 index = 0;
+    while (index < bufferCount && buffers[index].buffer != buffer) index++;
+    if (index == bufferCount) return;
+    RegisteredBuffer *entry = &buffers[index];
+    if (offset > entry->size || size > entry->size - offset) {
+        MarkIncomplete("a buffer update overran its buffer");
+        return;
+    }
+
+    /* Inside the frame the update is replayed; before it, it is the starting contents */
+    if (cmdStreamRecording) {
+        UpdateBufferCmd cmd = { index, offset, size };
+        AppendCommand(CMD_UPDATE_BUFFER, &cmd, sizeof(cmd));
+        Append(data, size);
+        return;
+    }
+    if (!entry->contents) {
+        entry->contents = SDL_calloc(1, entry->size);
+        if (!entry->contents) return;
+    }
+    SDL_memcpy(entry->contents + offset, data, size);
+}
+
+void CmdStream_BeginFrame(Uint64 frameIndex)
+{
+    if (!armed || frameIndex != captureFrame) return;
+    commandSize = 0;
+    cmdStreamRecording = true;
+}
+
+static bool WriteCapture(void)
+{
+    SDL_IOStream *io = SDL_IOFromFile(capturePath, "wb");
+    if (!io) {
+        SDL_Log("CmdStream: failed to open %s: %s", capturePath, SDL_GetError());
+        return false;
+    }
+
+    FileHeader header = {
+        .magic = CMDSTREAM_MAGIC,
+        .version = CMDSTREAM_VERSION,
+        .pipelineRecordSize = (Uint32)sizeof(PipelineRecord),
+        .pipelineCount = pipelineCount,
+        .bufferCount = bufferCount,
+        .commandBytes = commandSize,
+        .frameIndex = captureFrame
+    };
+    bool ok = SDL_WriteIO(io, &header, sizeof(header)) == sizeof(header);
+    for (Uint32 i = 0; i < pipelineCount && ok; i++) {
+        ok = SDL_WriteIO(io, &pipelines[i].record, sizeof(PipelineRecord)) == sizeof(PipelineRecord);
+    }
+    Uint64 bufferBytes = 0;
+    for (Uint32 i = 0; i < bufferCount && ok; i++) {
+        const RegisteredBuffer *entry = &buffers[i];
+        BufferRecord record = { entry->usage, entry->size, entry->contents != NULL };
+        ok = SDL_WriteIO(io, &record, sizeof(record)) == sizeof(record);
+        if (ok && entry->contents) {
+            ok = SDL_WriteIO(io, entry->contents, entry->size) == entry->size;
+            bufferBytes += entry->size;
+        }
+    }
+    if (ok) {
+        ok = SDL_WriteIO(io, commands, commandSize) == commandSize;
+    }
+    if (!SDL_CloseIO(io) || !ok) {
+        SDL_Log("CmdStream: failed to write %s: %s", capturePath, SDL_GetError());
+        return false;
+    }
+
+    SDL_Log("CmdStream: wrote frame %llu to %s (%u pipelines, %u buffers with %llu bytes, %zu command bytes)",
+            (unsigned long long)captureFrame, capturePath, pipelineCount, bufferCount,
+            (unsigned long long)bufferBytes, commandSize);
+    return true;
+}
+
+void CmdStream_EndFrame(void)
+{
+    if (!cmdStreamRecording) return;
+    cmdStreamRecording = false;
+    armed = false;
+
+    if (!incomplete) {
+        WriteCapture();
+    }
+    FreeCaptureState();
+}
+
+/* ========================================================================
+ * Recording
+ * ======================================================================== */
+
+void CmdStream_RecordBeginPass(const SDL_GPUColorTargetInfo *colorTarget, Uint32 width, Uint32 height,
+                               SDL_GPUTextureFormat format)
+{
+    BeginPassCmd cmd = { width, height, (Uint32)format, (Uint32)colorTarget->load_op, colorTarget->clear_color };
+    AppendCommand(CMD_BEGIN_PASS, &cmd, sizeof(cmd));
+}
+
+void CmdStream_RecordEndPass(void)
+{
+    AppendCommand(CMD_END_PASS, NULL, 0);
+}
+
+void CmdStream_RecordViewport(const SDL_GPUViewport *viewport)
+{
+    AppendCommand(CMD_VIEWPORT, viewport, sizeof(*viewport));
+}
+
+void CmdStream_RecordScissor(const SDL_Rect *scissor)
+{
+    AppendCommand(CMD_SCISSOR, scissor, sizeof(*scissor));
+}
+
+void CmdStream_RecordBindPipeline(SDL_GPUGraphicsPipeline *pipeline)
+{
+    Uint32 index = FindPipeline(pipeline);
+    AppendCommand(CMD_BIND_PIPELINE, &index, sizeof(index));
+}
+
+void CmdStream_RecordBindVertexBuffers(Uint32 firstSlot, const SDL_GPUBufferBinding *bindings, Uint32 count)
+{
+    if (count > MAX_BINDINGS) {
+        MarkIncomplete("too many vertex buffers bound");
+        return;
+    }
+    VertexBuffersCmd cmd = { firstSlot, count };
+    for (Uint32 i = 0; i < count; i++) {
+        cmd.buffers[i] = FindBuffer(bindings[i].buffer);
+        cmd.offsets[i] = bindings[i].offset;
+    }
+    AppendCommand(CMD_BIND_VERTEX_BUFFERS, &cmd, sizeof(cmd));
+}
+
+void CmdStream_RecordBindIndexBuffer(const SDL_GPUBufferBinding *binding, SDL_GPUIndexElementSize indexSize)
+{
+    IndexBufferCmd cmd = { FindBuffer(binding->buffer), binding->offset, (Uint32)indexSize };
+    AppendCommand(CMD_BIND_INDEX_BUFFER, &cmd, sizeof(cmd));
+}
+
+void CmdStream_RecordBindVertexStorageBuffers(Uint32 firstSlot, SDL_GPUBuffer *const *storageBuffers, Uint32 count)
+{
+    if (count > MAX_BINDINGS) {
+        MarkIncomplete("too many storage buffers bound");
+        return;
+    }
+    StorageBuffersCmd cmd = { firstSlot, count };
+    for (Uint32 i = 0; i < count; i++) {
+        cmd.buffers[i] = FindBuffer(storageBuffers[i]);
+    }
+    AppendCommand(CMD_BIND_VERTEX_STORAGE, &cmd, sizeof(cmd));
+}
+
+void CmdStream_RecordPushUniformData(SDL_GPUShaderStage stage, Uint32 slot, const void *data, Uint32 length)
+{
+    if (length > MAX_UNIFORM_LENGTH) {
+        MarkIncomplete("uniform data too large");
+        return;
+    }
+    UniformCmd cmd = { (Uint32)stage, slot, length };
+    AppendCommand(CMD_PUSH_UNIFORM, &cmd, sizeof(cmd));
+    Append(data, length);
+}
+
+void CmdStream_RecordDrawIndexed(Uint32 indexCount, Uint32 instanceCount, Uint32 firstIndex,
+                                 Sint32 vertexOffset, Uint32 firstInstance)
+{
+    DrawIndexedCmd cmd = { indexCount, instanceCount, firstIndex, vertexOffset, firstInstance };
+    AppendCommand(CMD_DRAW_INDEXED, &cmd, sizeof(cmd));
+}
+
+void CmdStream_RecordDraw(Uint32 vertexCount, Uint32 instanceCount, Uint32 firstVertex, Uint32 firstInstance)
+{
+    DrawCmd cmd = { vertexCount, instanceCount, firstVertex, firstInstance };
+    AppendCommand(CMD_DRAW, &cmd, sizeof(cmd));
+}
+
+void CmdStream_RecordDrawIndexedIndirect(SDL_GPUBuffer *buffer, Uint32 offset, Uint32 drawCount)
+{
+    IndirectCmd cmd = { FindBuffer(buffer), offset, drawCount };
+    AppendCommand(CMD_DRAW_INDEXED_INDIRECT, &cmd, sizeof(cmd));
+}
+
+/* ========================================================================
+ * Replay
+ * ======================================================================== */
+
+typedef struct {
+    Uint32 width, height;
+    SDL_GPUTextureFormat format;
+    SDL_GPUTexture *texture;
+} ReplayTarget;
+
+struct CmdStreamReplay {
+    SDL_GPUDevice *device;
+    Uint8 *file;
+    const Uint8 *commands;
+    size_t commandBytes;
+    SDL_GPUGraphicsPipeline **pipelines;
+    Uint32 pipelineCount;
+    SDL_GPUBuffer **buffers;
+    Uint32 bufferCount;
+    Uint64 bufferBytes;
+    SDL_GPUTransferBuffer *updates;     /* Data of every buffer update, in command order */
+    Uint32 updateBytes;
+    ReplayTarget targets[MAX_TARGETS];
+    Uint32 targetCount;
+    Uint32 passCount;
+};
+
+typedef struct {
+    const Uint8 *cursor;
+    const Uint8 *end;
+} Reader;
+
+static bool Read(Reader *reader, void *data, size_t size)
+{
+    if ((size_t)(reader->end - reader->cursor) < size) return false;
+    if (size > 0) SDL_memcpy(data, reader->cursor, size);
+    reader->cursor += size;
+    return true;
+}
+
+/* Returns a pointer to the next size bytes and skips them */
+static const Uint8 *Skip(Reader *reader, size_t size)
+{
+    if ((size_t)(reader->end - reader->cursor) < size) return NULL;
+    const Uint8 *data = reader->cursor;
+    reader->cursor += size;
+    return data;
+}
+
+static SDL_GPUGraphicsPipeline *CreateReplayPipeline(SDL_GPUDevice *device, const PipelineRecord *record)
+{
+    const ShaderRecord *vs = &record->vertexShader, *fs = &record->fragmentShader;
+    if (record->vertexBufferCount > MAX_VERTEX_BUFFERS || record->attributeCount > MAX_VERTEX_ATTRIBUTES ||
+        vs->name[SHADER_NAME_LENGTH - 1] != '\0' || fs->name[SHADER_NAME_LENGTH - 1] != '\0') {
+        return NULL;
+    }
+
+    SDL_GPUShader *vertShader = Shaders_Load(device, vs->name, SDL_GPU_SHADERSTAGE_VERTEX,
+                                             vs->samplers, vs->uniformBuffers, vs->storageBuffers);
+    SDL_GPUShader *fragShader = Shaders_Load(device, fs->name, SDL_GPU_SHADERSTAGE_FRAGMENT,
+                                             fs->samplers, fs->uniformBuffers, fs->storageBuffers);
+    SDL_GPUGraphicsPipeline *pipeline = NULL;
+    if (vertShader && fragShader) {
+        SDL_GPUGraphicsPipelineCreateInfo info = {
+            .vertex_shader = vertShader,
+            .fragment_shader = fragShader,
+            .vertex_input_state = {
+                .vertex_buffer_descriptions = record->vertexBuffers,
+                .num_vertex_buffers = record->vertexBufferCount,
+                .vertex_attributes = record->attributes,
+                .num_vertex_attributes = record->attributeCount
+            },
+            .primitive_type = record->primitiveType,
+            .rasterizer_state = record->rasterizer,
+            .depth_stencil_state = record->depthStencil,
+            .target_info = {
+                .color_target_descriptions = &record->colorTarget,
+                .num_color_targets = 1
+            }
+        };
+        pipeline = SDL_CreateGPUGraphicsPipeline(device, &info);
+        if (!pipeline) {
+            SDL_Log("CmdStream: failed to create pipeline for %s: %s", vs->name, SDL_GetError());
+        }
+    }
+    if (vertShader) SDL_ReleaseGPUShader(device, vertShader);
+    if (fragShader) SDL_ReleaseGPUShader(device, fragShader);
+    return pipeline;
+}
+
+static bool UploadBuffers(CmdStreamReplay *replay, Reader *reader)
+{
+    for (Uint32 i = 0; i < replay->bufferCount; i++) {
+        BufferRecord record;
+        if (!Read(reader, &record, sizeof(record))) return false;
+        const Uint8 *contents = record.hasContents ? Skip(reader, record.size) : NULL;
+        if (record.hasContents && !contents) return false;
+
+        SDL_GPUBufferCreateInfo bufferInfo = { .usage = record.usage, .size = record.size };
+        replay->buffers[i] = SDL_CreateGPUBuffer(replay->device, &bufferInfo);
+        if (!replay->buffers[i]) {
+            SDL_Log("CmdStream: failed to create buffer %u (%u bytes): %s", i, record.size, SDL_GetError());
+            return false;
+        }
+        replay->bufferBytes += record.size;
+
+        /* Zero-filled buffers get zeros uploaded, so no driver garbage differs between runs */
+        SDL_GPUTransferBufferCreateInfo transferInfo = { .usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD, .size = record.size };
+        SDL_GPUTransferBuffer *transfer = SDL_CreateGPUTransferBuffer(replay->device, &transferInfo);
+        if (!transfer) return false;
+        Uint8 *data = SDL_MapGPUTransferBuffer(replay->device, transfer, false);
+        if (data) {
+            if (contents) {
+                SDL_memcpy(data, contents, record.size);
+            } else {
+                SDL_memset(data, 0, record.size);
+            }
+            SDL_UnmapGPUTransferBuffer(replay->device, transfer);
+
+            SDL_GPUCommandBuffer *cmdBuf = SDL_AcquireGPUCommandBuffer(replay->device);
+            SDL_GPUCopyPass *copyPass = SDL_BeginGPUCopyPass(cmdBuf);
+            SDL_GPUTransferBufferLocation src = { .transfer_buffer = transfer };
+            SDL_GPUBufferRegion dst = { .buffer = replay->buffers[i], .size = record.size };
+            SDL_UploadToGPUBuffer(copyPass, &src, &dst, false);
+            SDL_EndGPUCopyPass(copyPass);
+            SDL_SubmitGPUCommandBuffer(cmdBuf);
+        }
+        SDL_ReleaseGPUTransferBuffer(replay->device, transfer);
+        if (!data) return false;
+    }
+    return true;
+}
+
+static ReplayTarget *FindTarget(CmdStreamReplay *replay, Uint32 width, Uint32 height, SDL_GPUTextureFormat format)
+{
+    for (Uint32 i = 0; i < replay->targetCount; i++) {
+        ReplayTarget *target = &replay->targets[i];
+        if (target->width == width && target->height == height && target->format == format) return target;
+    }
+    return NULL;
+}
+
+typedef enum {
+    WALK_VALIDATE,          /* Check every command and collect the targets and update size */
+    WALK_FILL_UPDATES,      /* Copy the update data into the mapped transfer buffer */
+    WALK_RECORD             /* Record the frame into a command buffer */
+} WalkMode;
+
+/*
+ * One pass over the commands. cmdBuf is only used by WALK_RECORD and
+ * updateData by WALK_FILL_UPDATES. Returns false on a malformed stream,
+ * which WALK_VALIDATE catches before anything is recorded.
+ */
+static bool Walk(CmdStreamReplay *replay, WalkMode mode, SDL_GPUCommandBuffer *cmdBuf, Uint8 *updateData,
+                 Uint32 *draws)
+{
+    Reader reader = { replay->commands, replay->commands + replay->commandBytes };
+    SDL_GPURenderPass *renderPass = NULL;
+    bool inPass = false;
+    Uint32 updateOffset = 0;
+    Uint32 drawCount = 0;
+
+#define CHECK_OBJECT(index, count) if ((index) >= (count)) return false
+
+    while (reader.cursor < reader.end) {
+        Uint32 type;
+        if (!Read(&reader, &type, sizeof(type))) return false;
+
+        switch (type) {
+        case CMD_UPDATE_BUFFER: {
+            UpdateBufferCmd cmd;
+            const Uint8 *data;
+            if (inPass || !Read(&reader, &cmd, sizeof(cmd)) || !(data = Skip(&reader, cmd.size))) return false;
+            CHECK_OBJECT(cmd.buffer, replay->bufferCount);
+            if (mode == WALK_RECORD) {
+                SDL_GPUCopyPass *copyPass = SDL_BeginGPUCopyPass(cmdBuf);
+                SDL_GPUTransferBufferLocation src = { replay->updates, updateOffset };
+                SDL_GPUBufferRegion dst = { replay->buffers[cmd.buffer], cmd.offset, cmd.size };
+                SDL_UploadToGPUBuffer(copyPass, &src, &dst, true);
+                SDL_EndGPUCopyPass(copyPass);
+            } else if (mode == WALK_FILL_UPDATES) {
+                SDL_memcpy(updateData + updateOffset, data, cmd.size);
+            }
+            updateOffset += cmd.size;
+            break;
+        }
+        case CMD_BEGIN_PASS: {
+            BeginPassCmd cmd;
+            if (inPass || !Read(&reader, &cmd, sizeof(cmd)) || cmd.width == 0 || cmd.height == 0) return false;
+            ReplayTarget *target = FindTarget(replay, cmd.width, cmd.height, (SDL_GPUTextureFormat)cmd.format);
+            if (mode == WALK_VALIDATE) {
+                if (!target) {
+                    if (replay->targetCount == MAX_TARGETS) return false;
+                    target = &replay->targets[replay->targetCount++];
+                    *target = (ReplayTarget){ cmd.width, cmd.height, (SDL_GPUTextureFormat)cmd.format, NULL };
+                }
+                replay->passCount++;
+            }
+            if (mode == WALK_RECORD) {
+                SDL_GPUColorTargetInfo colorTarget = {
+                    .texture = target->texture,
+                    .clear_color = cmd.clearColor,
+                    .load_op = (SDL_GPULoadOp)cmd.loadOp,
+                    .store_op = SDL_GPU_STOREOP_STORE
+                };
+                renderPass = SDL_BeginGPURenderPass(cmdBuf, &colorTarget, 1, NULL);
+            }
+            inPass = true;
+            break;
+        }
+        case CMD_END_PASS:
+            if (!inPass) return false;
+            if (mode == WALK_RECORD) SDL_EndGPURenderPass(renderPass);
+            inPass = false;
+            break;
+        case CMD_VIEWPORT: {
+            SDL_GPUViewport viewport;
+            if (!inPass || !Read(&reader, &viewport, sizeof(viewport))) return false;
+            if (mode == WALK_RECORD) SDL_SetGPUViewport(renderPass, &viewport);
+            break;
+        }
+        case CMD_SCISSOR: {
+            SDL_Rect scissor;
+            if (!inPass || !Read(&reader, &scissor, sizeof(scissor))) return false;
+            if (mode == WALK_RECORD) SDL_SetGPUScissor(renderPass, &scissor);
+            break;
+        }
+        case CMD_BIND_PIPELINE: {
+            Uint32 index;
+            if (!inPass || !Read(&reader, &index, sizeof(index))) return false;
+            CHECK_OBJECT(index, replay->pipelineCount);
+            if (mode == WALK_RECORD) SDL_BindGPUGraphicsPipeline(renderPass, replay->pipelines[index]);
+            break;
+        }
+        case CMD_BIND_VERTEX_BUFFERS: {
+            VertexBuffersCmd cmd;
+            if (!inPass || !Read(&reader, &cmd, sizeof(cmd)) || cmd.count > MAX_BINDINGS) return false;
+            SDL_GPUBufferBinding bindings[MAX_BINDINGS];
+            for (Uint32 i = 0; i < cmd.count; i++) {
+                CHECK_OBJECT(cmd.buffers[i], replay->bufferCount);
+                bindings[i] = (SDL_GPUBufferBinding){ replay->buffers[cmd.buffers[i]], cmd.offsets[i] };
+            }
+            if (mode == WALK_RECORD) SDL_BindGPUVertexBuffers(renderPass, cmd.firstSlot, bindings, cmd.count);
+            break;
+        }
+        case CMD_BIND_INDEX_BUFFER: {
+            IndexBufferCmd cmd;
+            if (!inPass || !Read(&reader, &cmd, sizeof(cmd))) return false;
+            CHECK_OBJECT(cmd.buffer, replay->bufferCount);
+            SDL_GPUBufferBinding binding = { replay->buffers[cmd.buffer], cmd.offset };
+            if (mode == WALK_RECORD) SDL_BindGPUIndexBuffer(renderPass, &binding, (SDL_GPUIndexElementSize)cmd.indexSize);
+            break;
+        }
+        case CMD_BIND_VERTEX_STORAGE: {
+            StorageBuffersCmd cmd;
+            if (!inPass || !Read(&reader, &cmd, sizeof(cmd)) || cmd.count > MAX_BINDINGS) return false;
+            SDL_GPUBuffer *storage[MAX_BINDINGS];
+            for (Uint32 i = 0; i < cmd.count; i++) {
+                CHECK_OBJECT(cmd.buffers[i], replay->bufferCount);
+                storage[i] = replay->buffers[cmd.buffers[i]];
+            }
+            if (mode == WALK_RECORD) SDL_BindGPUVertexStorageBuffers(renderPass, cmd.firstSlot, storage, cmd.count);
+            break;
+        }
+        case CMD_PUSH_UNIFORM: {
+            UniformCmd cmd;
+            const Uint8 *data;
+            if (!Read(&reader, &cmd, sizeof(cmd)) || cmd.length > MAX_UNIFORM_LENGTH ||
+                !(data = Skip(&reader, cmd.length))) return false;
+            if (mode == WALK_RECORD && cmd.stage == SDL_GPU_SHADERSTAGE_VERTEX) {
+                SDL_PushGPUVertexUniformData(cmdBuf, cmd.slot, data, cmd.length);
+            } else if (mode == WALK_RECORD) {
+                SDL_PushGPUFragmentUniformData(cmdBuf, cmd.slot, data, cmd.length);
+            }
+            break;
+        }
+        case CMD_DRAW_INDEXED: {
+            DrawIndexedCmd cmd;
+            if (!inPass || !Read(&reader, &cmd, sizeof(cmd))) return false;
+            if (mode == WALK_RECORD) {
+                SDL_DrawGPUIndexedPrimitives(renderPass, cmd.indexCount, cmd.instanceCount, cmd.firstIndex,
+                                             cmd.vertexOffset, cmd.firstInstance);
+            }
+            drawCount++;
+            break;
+        }
+        case CMD_DRAW: {
+            DrawCmd cmd;
+            if (!inPass || !Read(&reader, &cmd, sizeof(cmd))) return false;
+            if (mode == WALK_RECORD) SDL_DrawGPUPrimitives(renderPass, cmd.vertexCount, cmd.instanceCount, cmd.firstVertex, cmd.firstInstance);
+            drawCount++;
+            break;
+        }
+        case CMD_DRAW_INDEXED_INDIRECT: {
+            IndirectCmd cmd;
+            if (!inPass || !Read(&reader, &cmd, sizeof(cmd))) return false;
+            CHECK_OBJECT(cmd.buffer, replay->bufferCount);
+            if (mode == WALK_RECORD) SDL_DrawGPUIndexedPrimitivesIndirect(renderPass, replay->buffers[cmd.buffer], cmd.offset, cmd.drawCount);
+            drawCount += cmd.drawCount;
+            break;
+        }
+        default:
+            return false;
+        }
+    }
+
+#undef CHECK_OBJECT
+
+    if (inPass) return false;
+    if (mode == WALK_VALIDATE) replay->updateBytes = updateOffset;
+    if (draws) *draws = drawCount;
+    return true;
+}
+
+static bool CreateTargets(CmdStreamReplay *replay)
+{
+    for (Uint32 i = 0; i < replay->targetCount; i++) {
+        ReplayTarget *target = &replay->targets[i];
+        SDL_GPUTextureCreateInfo textureInfo = {
+            .type = SDL_GPU_TEXTURETYPE_2D,
+            .format = target->format,
+            .usage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET,
+            .width = target->width,
+            .height = target->height,
+            .layer_count_or_depth = 1,
+            .num_levels = 1
+        };
+        target->texture = SDL_CreateGPUTexture(replay->device, &textureInfo);
+        if (!target->texture) {
+            SDL_Log("CmdStream: failed to create %ux%u target: %s", target->width, target->height, SDL_GetError());
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool CreateUpdateData(CmdStreamReplay *replay)
+{
+    if (replay->updateBytes == 0) return true;
+
+    SDL_GPUTransferBufferCreateInfo transferInfo = {
+        .usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
+        .size = replay->updateBytes
+    };
+    replay->updates = SDL_CreateGPUTransferBuffer(replay->device, &transferInfo);
+    if (!replay->updates) return false;
+    Uint8 *data = SDL_MapGPUTransferBuffer(replay->device, replay->updates, false);
+    if (!data) return false;
+    Walk(replay, WALK_FILL_UPDATES, NULL, data, NULL);
+    SDL_UnmapGPUTransferBuffer(replay->device, replay->updates);
+    return true;
+}
+
+CmdStreamReplay *CmdStream_Load(SDL_GPUDevice *device, const char *path)
+{
+    size_t fileSize = 0;
+    Uint8 *file = SDL_LoadFile(path, &fileSize);
+    if (!file) {
+        SDL_Log("CmdStream: failed to read %s: %s", path, SDL_GetError());
+        return NULL;
+    }
+
+    CmdStreamReplay *replay = SDL_calloc(1, sizeof(CmdStreamReplay));
+    if (!replay) {
+        SDL_free(file);
+        return NULL;
+    }
+    replay->device = device;
+    replay->file = file;
+
+    Reader reader = { file, file + fileSize };
+    FileHeader header;
+    if (!Read(&reader, &header, sizeof(header)) || header.magic != CMDSTREAM_MAGIC) {
+        SDL_Log("CmdStream: %s is not a command stream capture", path);
+        CmdStream_Free(replay);
+        return NULL;
+    }
+    if (header.version != CMDSTREAM_VERSION || header.pipelineRecordSize != sizeof(PipelineRecord)) {
+        SDL_Log("CmdStream: %s was captured by an incompatible build (version %u)", path, header.version);
+        CmdStream_Free(replay);
+        return NULL;
+    }
+
+    replay->pipelineCount = header.pipelineCount;
+    replay->bufferCount = header.bufferCount;
+    replay->pipelines = SDL_calloc(SDL_max(1u, header.pipelineCount), sizeof(SDL_GPUGraphicsPipeline *));
+    replay->buffers = SDL_calloc(SDL_max(1u, header.bufferCount), sizeof(SDL_GPUBuffer *));
+    bool ok = replay->pipelines && replay->buffers;
+
+    for (Uint32 i = 0; i < replay->pipelineCount && ok; i++) {
+        PipelineRecord record;
+        ok = Read(&reader, &record, sizeof(record));
+        if (ok) {
+            replay->pipelines[i] = CreateReplayPipeline(device, &record);
+            ok = replay->pipelines[i] != NULL;
+        }
+    }
+    ok = ok && UploadBuffers(replay, &reader);
+
+    replay->commands = reader.cursor;
+    replay->commandBytes = (size_t)(reader.end - reader.cursor);
+    ok = ok && header.commandBytes == replay->commandBytes;
+    if (ok && !Walk(replay, WALK_VALIDATE, NULL, NULL, NULL)) {
+        SDL_Log("CmdStream: %s has malformed commands", path);
+        ok = false;
+    }
+    ok = ok && CreateTargets(replay) && CreateUpdateData(replay);
+
+    if (!ok) {
+        SDL_Log("CmdStream: failed to load %s", path);
+        CmdStream_Free(replay);
+        return NULL;
+    }
+
+    SDL_Log("CmdStream: loaded frame %llu from %s (%u pipelines, %u buffers, %u targets)",
+            (unsigned long long)header.frameIndex, path, replay->pipelineCount, replay->bufferCount, replay->targetCount);
+    return replay;
+}
+
+void CmdStream_Free(CmdStreamReplay *replay)
+{
+    if (!replay) return;
+
+    SDL_GPUDevice *device = replay->device;
+    for (Uint32 i = 0; replay->pipelines && i < replay->pipelineCount; i++) {
+        if (replay->pipelines[i]) SDL_ReleaseGPUGraphicsPipeline(device, replay->pipelines[i]);
+    }
+    for (Uint32 i = 0; replay->buffers && i < replay->bufferCount; i++) {
+        if (replay->buffers[i]) SDL_ReleaseGPUBuffer(device, replay->buffers[i]);
+    }
+    for (Uint32 i = 0; i < replay->targetCount; i++) {
+        if (replay->targets[i].texture) SDL_ReleaseGPUTexture(device, replay->targets[i].texture);
+    }
+    if (replay->updates) SDL_ReleaseGPUTransferBuffer(device, replay->updates);
+    SDL_free(replay->pipelines);
+    SDL_free(replay->buffers);
+    SDL_free(replay->file);
+    SDL_free(replay);
+}
+
+Uint32 CmdStream_Execute(CmdStreamReplay *replay, SDL_GPUCommandBuffer *cmdBuf)
+{
+    Uint32 draws = 0;
+    Walk(replay, WALK_RECORD, cmdBuf, NULL, &draws);
+    return draws;
+}
+
+Uint32 CmdStream_PassCount(const CmdStreamReplay *replay)
+{
+    return replay->passCount;
+}
+
+Uint32 CmdStream_PipelineCount(const CmdStreamReplay *replay)
+{
+    return replay->pipelineCount;
+}
+
+Uint64 CmdStream_BufferBytes(const CmdStreamReplay *replay)
+{
+    return replay->bufferBytes;
+}
@@ -0,0 +1,190 @@
+/*
+ * Renderer command stream capture and replay
+ *
+ * Records what the renderer submits for one frame into a file that does
+ * not depend on OpenXR: pipelines as the descriptions they were built
+ * from, buffers with their contents, render passes, binds, uniform data
+ * and draws. SpinningCubesReplay rebuilds the pipelines and buffers
+ * against offscreen targets and re-executes the frame as often as asked,
+ * so GPU-side changes can be measured on a desktop, with a real or a
+ * software driver, on the exact frame that was slow on the device.
+ *
+ * The renderer calls the CmdStream_ wrappers below in place of the SDL
+ * GPU functions they are named after; outside the captured frame they only
+ * forward the call. Pipelines and buffers must be registered when they are
+ * created so a capture can describe them, and buffers filled by copy passes
+ * report the data they were given with CmdStream_UpdateBuffer. Only the
+ * renderer's own passes are captured, not readbacks, mirror copies or
+ * samplers (so not the overdraw view).
+ *
+ * The file stores the SDL GPU description structs as they are laid out in
+ * memory, with their sizes in the header; it only replays on a build with
+ * the same layout (same SDL version, little-endian, 64-bit).
+ */
+
+#ifndef CMDSTREAM_H
+#define CMDSTREAM_H
+
+#include <SDL3/SDL.h>
+
+typedef struct CmdStreamShader {
+    const char *name;           /* As given to Shaders_Load */
+    Uint32 samplers;
+    Uint32 uniformBuffers;
+    Uint32 storageBuffers;
+} CmdStreamShader;
+
+/* ========================================================================
+ * Capture
+ * ======================================================================== */
+
+/* Arms a capture of frame captureFrame into path. Registration does nothing
+ * until this is called, so call it before creating any GPU objects. */
+bool CmdStream_Init(const char *path, Uint64 captureFrame);
+void CmdStream_Shutdown(void);
+
+/* Pipelines with one color target and no depth target can be registered */
+void CmdStream_RegisterPipeline(SDL_GPUGraphicsPipeline *pipeline, const SDL_GPUGraphicsPipelineCreateInfo *info,
+                                const CmdStreamShader *vertexShader, const CmdStreamShader *fragmentShader);
+
+/* contents, when not NULL, is size bytes the buffer was filled with */
+void CmdStream_RegisterBuffer(SDL_GPUBuffer *buffer, SDL_GPUBufferUsageFlags usage, Uint32 size, const void *contents);
+
+/* Call wherever a copy pass uploads data into a registered buffer */
+void CmdStream_UpdateBuffer(SDL_GPUBuffer *buffer, Uint32 offset, const void *data, Uint32 size);
+
+/* Bracket everything recorded for one frame; EndFrame writes the file after the captured frame */
+void CmdStream_BeginFrame(Uint64 frameIndex);
+void CmdStream_EndFrame(void);
+
+/* Recording entry points behind the wrappers */
+extern bool cmdStreamRecording;
+
+void CmdStream_RecordBeginPass(const SDL_GPUColorTargetInfo *colorTarget, Uint32 width, Uint32 height,
+                               SDL_GPUTextureFormat format);
+void CmdStream_RecordEndPass(void);
+void CmdStream_RecordViewport(const SDL_GPUViewport *viewport);
+void CmdStream_RecordScissor(const SDL_Rect *scissor);
+void CmdStream_RecordBindPipeline(SDL_GPUGraphicsPipeline *pipeline);
+void CmdStream_RecordBindVertexBuffers(Uint32 firstSlot, const SDL_GPUBufferBinding *bindings, Uint32 count);
+void CmdStream_RecordBindIndexBuffer(const SDL_GPUBufferBinding *binding, SDL_GPUIndexElementSize indexSize);
+void CmdStream_RecordBindVertexStorageBuffers(Uint32 firstSlot, SDL_GPUBuffer *const *buffers, Uint32 count);
+void CmdStream_RecordPushUniformData(SDL_GPUShaderStage stage, Uint32 slot, const void *data, Uint32 length);
+void CmdStream_RecordDrawIndexed(Uint32 indexCount, Uint32 instanceCount, Uint32 firstIndex,
+                                 Sint32 vertexOffset, Uint32 firstInstance);
+void CmdStream_RecordDraw(Uint32 vertexCount, Uint32 instanceCount, Uint32 firstVertex, Uint32 firstInstance);
+void CmdStream_RecordDrawIndexedIndirect(SDL_GPUBuffer *buffer, Uint32 offset, Uint32 drawCount);
+
+/* ========================================================================
+ * Recording Wrappers
+ * ======================================================================== */
+
+/* width, height and format describe colorTarget's texture */
+static inline SDL_GPURenderPass *CmdStream_BeginRenderPass(SDL_GPUCommandBuffer *cmdBuf,
+                                                           const SDL_GPUColorTargetInfo *colorTarget,
+                                                           Uint32 width, Uint32 height, SDL_GPUTextureFormat format)
+{
+    if (cmdStreamRecording) CmdStream_RecordBeginPass(colorTarget, width, height, format);
+    return SDL_BeginGPURenderPass(cmdBuf, colorTarget, 1, NULL);
+}
+
+static inline void CmdStream_EndRenderPass(SDL_GPURenderPass *renderPass)
+{
+    if (cmdStreamRecording) CmdStream_RecordEndPass();
+    SDL_EndGPURenderPass(renderPass);
+}
+
+static inline void CmdStream_SetViewport(SDL_GPURenderPass *renderPass, const SDL_GPUViewport *viewport)
+{
+    if (cmdStreamRecording) CmdStream_RecordViewport(viewport);
+    SDL_SetGPUViewport(renderPass, viewport);
+}
+
+static inline void CmdStream_SetScissor(SDL_GPURenderPass *renderPass, const SDL_Rect *scissor)
+{
+    if (cmdStreamRecording) CmdStream_RecordScissor(scissor);
+    SDL_SetGPUScissor(renderPass, scissor);
+}
+
+static inline void CmdStream_BindGraphicsPipeline(SDL_GPURenderPass *renderPass, SDL_GPUGraphicsPipeline *pipeline)
+{
+    if (cmdStreamRecording) CmdStream_RecordBindPipeline(pipeline);
+    SDL_BindGPUGraphicsPipeline(renderPass, pipeline);
+}
+
+static inline void CmdStream_BindVertexBuffers(SDL_GPURenderPass *renderPass, Uint32 firstSlot,
+                                               const SDL_GPUBufferBinding *bindings, Uint32 count)
+{
+    if (cmdStreamRecording) CmdStream_RecordBindVertexBuffers(firstSlot, bindings, count);
+    SDL_BindGPUVertexBuffers(renderPass, firstSlot, bindings, count);
+}
+
+static inline void CmdStream_BindIndexBuffer(SDL_GPURenderPass *renderPass, const SDL_GPUBufferBinding *binding,
+                                             SDL_GPUIndexElementSize indexSize)
+{
+    if (cmdStreamRecording) CmdStream_RecordBindIndexBuffer(binding, indexSize);
+    SDL_BindGPUIndexBuffer(renderPass, binding, indexSize);
+}
+
+static inline void CmdStream_BindVertexStorageBuffers(SDL_GPURenderPass *renderPass, Uint32 firstSlot,
+                                                      SDL_GPUBuffer *const *buffers, Uint32 count)
+{
+    if (cmdStreamRecording) CmdStream_RecordBindVertexStorageBuffers(firstSlot, buffers, count);
+    SDL_BindGPUVertexStorageBuffers(renderPass, firstSlot, buffers, count);
+}
+
+static inline void CmdStream_PushVertexUniformData(SDL_GPUCommandBuffer *cmdBuf, Uint32 slot,
+                                                   const void *data, Uint32 length)
+{
+    if (cmdStreamRecording) CmdStream_RecordPushUniformData(SDL_GPU_SHADERSTAGE_VERTEX, slot, data, length);
+    SDL_PushGPUVertexUniformData(cmdBuf, slot, data, length);
+}
+
+static inline void CmdStream_PushFragmentUniformData(SDL_GPUCommandBuffer *cmdBuf, Uint32 slot,
+                                                     const void *data, Uint32 length)
+{
+    if (cmdStreamRecording) CmdStream_RecordPushUniformData(SDL_GPU_SHADERSTAGE_FRAGMENT, slot, data, length);
+    SDL_PushGPUFragmentUniformData(cmdBuf, slot, data, length);
+}
+
+static inline void CmdStream_DrawIndexedPrimitives(SDL_GPURenderPass *renderPass, Uint32 indexCount,
+                                                   Uint32 instanceCount, Uint32 firstIndex,
+                                                   Sint32 vertexOffset, Uint32 firstInstance)
+{
+    if (cmdStreamRecording) CmdStream_RecordDrawIndexed(indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
+    SDL_DrawGPUIndexedPrimitives(renderPass, indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
+}
+
+static inline void CmdStream_DrawPrimitives(SDL_GPURenderPass *renderPass, Uint32 vertexCount,
+                                            Uint32 instanceCount, Uint32 firstVertex, Uint32 firstInstance)
+{
+    if (cmdStreamRecording) CmdStream_RecordDraw(vertexCount, instanceCount, firstVertex, firstInstance);
+    SDL_DrawGPUPrimitives(renderPass, vertexCount, instanceCount, firstVertex, firstInstance);
+}
+
+static inline void CmdStream_DrawIndexedPrimitivesIndirect(SDL_GPURenderPass *renderPass, SDL_GPUBuffer *buffer,
+                                                           Uint32 offset, Uint32 drawCount)
+{
+    if (cmdStreamRecording) CmdStream_RecordDrawIndexedIndirect(buffer, offset, drawCount);
+    SDL_DrawGPUIndexedPrimitivesIndirect(renderPass, buffer, offset, drawCount);
+}
+
+/* ========================================================================
+ * Replay
+ * ======================================================================== */
+
+typedef struct CmdStreamReplay CmdStreamReplay;
+
+/* Rebuilds the captured pipelines, buffers and offscreen targets on device */
+CmdStreamReplay *CmdStream_Load(SDL_GPUDevice *device, const char *path);
+void CmdStream_Free(CmdStreamReplay *replay);
+
+/* Records the captured frame into cmdBuf; returns the number of draws */
+Uint32 CmdStream_Execute(CmdStreamReplay *replay, SDL_GPUCommandBuffer *cmdBuf);
+
+/* Counts for the report */
+Uint32 CmdStream_PassCount(const CmdStreamReplay *replay);
+Uint32 CmdStream_PipelineCount(const CmdStreamReplay *replay);
+Uint64 CmdStream_BufferBytes(const CmdStreamReplay *replay);
+
+#endif /* CMDSTREAM_H */
@@ -0,0 +1,488 @@
+/*
+ * Draw submission benchmark
+ *
+ * Measures what each draw path (drawpaths.h) costs per object on one device,
+ * at object counts from a handful to a million: every path draws the
+ * many-small-objects scene's cubes into an offscreen target for a few
+ * frames per count, recording the CPU time from acquiring the command
+ * buffer to submitting it, and the GPU time of the frame. The counts at
+ * which one path becomes cheaper on the CPU than another are reported as
+ * crossover points, interpolated between the measured counts.
+ *
+ * No window or XR runtime is involved.
+ */
+
+#include <SDL3/SDL.h>
+
+#include "drawpaths.h"
+#include "gputimer.h"
+#include "scenes.h"
+#include "vecmath.h"
+
+#define MAX_COUNTS 16
+#define MAX_FRAMES 1024
+#define FRAMES_IN_FLIGHT 2
+
+typedef struct {
+    bool measured;
+    Uint32 frames;
+    double cpuMs;               /* Median per frame */
+    double gpuMs;               /* Median per frame; 0 if no GPU times arrived */
+    double cpuNsPerObject;
+} DrawBenchResult;
+
+/* Options */
+static Uint32 counts[MAX_COUNTS] = { 10, 100, 1000, 10000, 100000, 1000000 };
+static Uint32 countCount = 6;
+static bool pathEnabled[DRAWPATH_COUNT] = { true, true, true, true, true };
+static Uint32 warmupFrames = 5;
+static Uint32 measureFrames = 20;
+static double maxSecondsPerPoint = 5.0;
+static int targetWidth = 512, targetHeight = 512;
+static const char *outputPath = NULL;
+static const char *label = NULL;
+
+static SDL_GPUDevice *device = NULL;
+static SDL_GPUTexture *target = NULL;
+static DrawPaths *drawPaths = NULL;
+static GpuTimer *gpuTimer = NULL;
+static Scene *scene = NULL;
+static Mat4 *models = NULL;
+static DrawPathMesh mesh;
+static Mat4 viewProj;
+
+static DrawBenchResult results[DRAWPATH_COUNT][MAX_COUNTS];
+
+/* ========================================================================
+ * Setup
+ * ======================================================================== */
+
+static bool CreateMeshBuffers(const SceneMesh *sceneMesh)
+{
+    Uint32 vertexSize = sceneMesh->vertexCount * (Uint32)sizeof(PositionColorVertex);
+    Uint32 indexSize = sceneMesh->indexCount * (Uint32)sizeof(Uint32);
+    SDL_GPUBufferCreateInfo vertexInfo = { .usage = SDL_GPU_BUFFERUSAGE_VERTEX, .size = vertexSize };
+    SDL_GPUBufferCreateInfo indexInfo = { .usage = SDL_GPU_BUFFERUSAGE_INDEX, .size = indexSize };
+    mesh.vertices = SDL_CreateGPUBuffer(device, &vertexInfo);
+    mesh.indices = SDL_CreateGPUBuffer(device, &indexInfo);
+    mesh.indexSize = SDL_GPU_INDEXELEMENTSIZE_32BIT;
+    mesh.indexCount = sceneMesh->indexCount;
+
+    SDL_GPUTransferBufferCreateInfo transferInfo = {
+        .usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
+        .size = vertexSize + indexSize
+    };
+    SDL_GPUTransferBuffer *transfer = SDL_CreateGPUTransferBuffer(device, &transferInfo);
+    if (!mesh.vertices || !mesh.indices || !transfer) {
+        SDL_Log("DrawBench: failed to create mesh buffers: %s", SDL_GetError());
+        if (transfer) SDL_ReleaseGPUTransferBuffer(device, transfer);
+        return false;
+    }
+
+    Uint8 *data = SDL_MapGPUTransferBuffer(device, transfer, false);
+    SDL_memcpy(data, sceneMesh->vertices, vertexSize);
+    SDL_memcpy(data + vertexSize, sceneMesh->indices, indexSize);
+    SDL_UnmapGPUTransferBuffer(device, transfer);
+
+    SDL_GPUCommandBuffer *cmd = SDL_AcquireGPUCommandBuffer(device);
+    SDL_GPUCopyPass *copyPass = SDL_BeginGPUCopyPass(cmd);
+    SDL_GPUTransferBufferLocation srcVertex = { .transfer_buffer = transfer, .offset = 0 };
+    SDL_GPUBufferRegion dstVertex = { .buffer = mesh.vertices, .offset = 0, .size = vertexSize };
+    SDL_UploadToGPUBuffer(copyPass, &srcVertex, &dstVertex, false);
+    SDL_GPUTransferBufferLocation srcIndex = { .transfer_buffer = transfer, .offset = vertexSize };
+    SDL_GPUBufferRegion dstIndex = { .buffer = mesh.indices, .offset = 0, .size = indexSize };
+    SDL_UploadToGPUBuffer(copyPass, &srcIndex, &dstIndex, false);
+    SDL_EndGPUCopyPass(copyPass);
+    SDL_SubmitGPUCommandBuffer(cmd);
+    SDL_ReleaseGPUTransferBuffer(device, transfer);
+    return true;
+}
+
+static bool Setup(Uint32 maxCount)
+{
+    if (!SDL_Init(SDL_INIT_VIDEO)) {
+        SDL_Log("DrawBench: SDL_Init failed: %s", SDL_GetError());
+        return false;
+    }
+
+    device = SDL_CreateGPUDevice(SDL_GPU_SHADERFORMAT_SPIRV, false, NULL);
+    if (!device) {
+        SDL_Log("DrawBench: failed to create GPU device: %s", SDL_GetError());
+        return false;
+    }
+
+    SDL_GPUTextureCreateInfo targetInfo = {
+        .type = SDL_GPU_TEXTURETYPE_2D,
+        .format = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM,
+        .usage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET,
+        .width = (Uint32)targetWidth,
+        .height = (Uint32)targetHeight,
+        .layer_count_or_depth = 1,
+        .num_levels = 1
+    };
+    target = SDL_CreateGPUTexture(device, &targetInfo);
+    if (!target) {
+        SDL_Log("DrawBench: failed to create render target: %s", SDL_GetError());
+        return false;
+    }
+
+    SceneConfig sceneConfig = { SCENE_MANY_SMALL_OBJECTS, maxCount };
+    scene = Scene_Create(&sceneConfig);
+    models = SDL_malloc(maxCount * sizeof(Mat4));
+    if (!scene || !models) {
+        SDL_Log("DrawBench: out of memory for %u objects", maxCount);
+        return false;
+    }
+    Scene_Update(scene, 0.0f);
+    for (Uint32 i = 0; i < maxCount; i++) {
+        models[i] = scene->objects[i].model;
+    }
+
+    drawPaths = DrawPaths_Create(device, targetInfo.format, maxCount);
+    gpuTimer = GpuTimer_Create(device, FRAMES_IN_FLIGHT);
+    if (!drawPaths || !gpuTimer || !CreateMeshBuffers(&scene->meshes[0])) {
+        return false;
+    }
+
+    /* The scene's default viewer: at the origin, looking down -Z */
+    XrPosef head = { { 0.0f, 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, 0.0f } };
+    XrFovf fov = { -0.8f, 0.8f, 0.8f, -0.8f };
+    viewProj = Mat4_Multiply(Mat4_FromXrPose(head), Mat4_Projection(fov, 0.05f, 100.0f));
+    return true;
+}
+
+static void Shutdown(void)
+{
+    if (gpuTimer) GpuTimer_Destroy(gpuTimer);
+    DrawPaths_Destroy(drawPaths);
+    if (device) {
+        if (mesh.vertices) SDL_ReleaseGPUBuffer(device, mesh.vertices);
+        if (mesh.indices) SDL_ReleaseGPUBuffer(device, mesh.indices);
+        if (target) SDL_ReleaseGPUTexture(device, target);
+        SDL_DestroyGPUDevice(device);
+    }
+    Scene_Destroy(scene);
+    SDL_free(models);
+    SDL_Quit();
+}
+
+/* ========================================================================
+ * Measurement
+ * ======================================================================== */
+
+static int SDLCALL CompareSamples(const void *a, const void *b)
+{
+    Uint64 x = *(const Uint64 *)a, y = *(const Uint64 *)b;
+    return (x > y) - (x < y);
+}
+
+static double MedianMs(Uint64 *samples, Uint32 count)
+{
+    if (count == 0) return 0.0;
+    SDL_qsort(samples, count, sizeof(Uint64), CompareSamples);
+    return (double)samples[count / 2] / 1e6;
+}
+
+/* One frame, timed from acquiring the command buffer to submitting it */
+static Uint64 RenderFrame(DrawPathKind kind, Uint32 count)
+{
+    Uint64 start = SDL_GetTicksNS();
+
+    SDL_GPUCommandBuffer *cmdBuf = SDL_AcquireGPUCommandBuffer(device);
+    DrawPaths_Upload(drawPaths, cmdBuf, kind, &mesh, models, count);
+
+    SDL_GPUColorTargetInfo colorTarget = {
+        .texture = target,
+        .clear_color = { 0.1f, 0.1f, 0.2f, 1.0f },
+        .load_op = SDL_GPU_LOADOP_CLEAR,
+        .store_op = SDL_GPU_STOREOP_STORE,
+        .cycle = true
+    };
+    SDL_GPURenderPass *renderPass = SDL_BeginGPURenderPass(cmdBuf, &colorTarget, 1, NULL);
+    DrawPaths_Draw(drawPaths, cmdBuf, renderPass, kind, &mesh, models, count, &viewProj, NULL);
+    SDL_EndGPURenderPass(renderPass);
+    SDL_SubmitGPUCommandBuffer(cmdBuf);
+
+    return SDL_GetTicksNS() - start;
+}
+
+static DrawBenchResult MeasurePoint(DrawPathKind kind, Uint32 count)
+{
+    static Uint64 cpuSamples[MAX_FRAMES];
+    static Uint64 gpuSamples[MAX_FRAMES + FRAMES_IN_FLIGHT];
+    Uint32 cpuCount = 0, gpuCount = 0, gpuSeen = 0;
+    Uint32 frames = SDL_min(measureFrames, (Uint32)MAX_FRAMES);
+    Uint64 deadline = SDL_GetTicksNS() + (Uint64)(maxSecondsPerPoint * 1e9);
+
+    for (Uint32 frame = 0; frame < warmupFrames + frames; frame++) {
+        /* At least one measured frame, however slow */
+        if (frame > warmupFrames && SDL_GetTicksNS() > deadline) break;
+
+        Uint64 cpuNs = RenderFrame(kind, count);
+        if (frame >= warmupFrames) cpuSamples[cpuCount++] = cpuNs;
+
+        GpuTimer_Wait(gpuTimer, FRAMES_IN_FLIGHT - 1);
+        GpuTimer_Mark(gpuTimer);
+
+        Uint64 samples[FRAMES_IN_FLIGHT];
+        Uint32 read;
+        while ((read = GpuTimer_Read(gpuTimer, samples, FRAMES_IN_FLIGHT)) > 0) {
+            for (Uint32 i = 0; i < read; i++, gpuSeen++) {
+                if (gpuSeen >= warmupFrames) gpuSamples[gpuCount++] = samples[i];
+            }
+        }
+    }
+
+    /* Drain so the next point starts on an idle GPU */
+    GpuTimer_Wait(gpuTimer, 0);
+    Uint64 samples[FRAMES_IN_FLIGHT];
+    Uint32 read;
+    while ((read = GpuTimer_Read(gpuTimer, samples, FRAMES_IN_FLIGHT)) > 0) {
+        for (Uint32 i = 0; i < read; i++, gpuSeen++) {
+            if (gpuSeen >= warmupFrames && gpuCount < SDL_arraysize(gpuSamples)) gpuSamples[gpuCount++] = samples[i];
+        }
+    }
+
+    DrawBenchResult result = { true, cpuCount };
+    result.cpuMs = MedianMs(cpuSamples, cpuCount);
+    result.gpuMs = MedianMs(gpuSamples, gpuCount);
+    result.cpuNsPerObject = result.cpuMs * 1e6 / (double)count;
+    return result;
+}
+
+/* ========================================================================
+ * Crossovers and Report
+ * ======================================================================== */
+
+/*
+ * Counts at which path a stops being cheaper on the CPU than path b, found
+ * where the sign of their frame time difference changes between two
+ * measured counts and interpolated on a log scale. Returns how many were
+ * found.
+ */
+static Uint32 FindCrossovers(DrawPathKind a, DrawPathKind b, double *crossovers, Uint32 capacity)
+{
+    Uint32 found = 0;
+    for (Uint32 i = 1; i < countCount && found < capacity; i++) {
+        const DrawBenchResult *a0 = &results[a][i - 1], *a1 = &results[a][i];
+        const DrawBenchResult *b0 = &results[b][i - 1], *b1 = &results[b][i];
+        if (!a0->measured || !a1->measured || !b0->measured || !b1->measured) continue;
+
+        double d0 = a0->cpuMs - b0->cpuMs, d1 = a1->cpuMs - b1->cpuMs;
+        if ((d0 < 0.0) == (d1 < 0.0) || d0 == d1) continue;
+
+        double x0 = SDL_log10((double)counts[i - 1]), x1 = SDL_log10((double)counts[i]);
+        crossovers[found++] = SDL_pow(10.0, x0 + (x1 - x0) * d0 / (d0 - d1));
+    }
+    return found;
+}
+
+static void LogResults(void)
+{
+    char line[256];
+    int length = SDL_snprintf(line, sizeof(line), "%10s", "objects");
+    for (int kind = 0; kind < DRAWPATH_COUNT; kind++) {
+        if (pathEnabled[kind]) {
+            length += SDL_snprintf(line + length, sizeof(line) - length, " %16s", DrawPaths_Name((DrawPathKind)kind));
+        }
+    }
+    SDL_Log("DrawBench: CPU ns per object");
+    SDL_Log("%s", line);
+
+    for (Uint32 i = 0; i < countCount; i++) {
+        length = SDL_snprintf(line, sizeof(line), "%10u", counts[i]);
+        for (int kind = 0; kind < DRAWPATH_COUNT; kind++) {
+            if (!pathEnabled[kind]) continue;
+            const DrawBenchResult *r = &results[kind][i];
+            if (r->measured) {
+                length += SDL_snprintf(line + length, sizeof(line) - length, " %16.1f", r->cpuNsPerObject);
+            } else {
+                length += SDL_snprintf(line + length, sizeof(line) - length, " %16s", "-");
+            }
+        }
+        SDL_Log("%s", line);
+    }
+
+    for (int a = 0; a < DRAWPATH_COUNT; a++) {
+        for (int b = a + 1; b < DRAWPATH_COUNT; b++) {
+            double crossovers[MAX_COUNTS];
+            Uint32 found = FindCrossovers((DrawPathKind)a, (DrawPathKind)b, crossovers, MAX_COUNTS);
+            for (Uint32 i = 0; i < found; i++) {
+                /* Which one wins past the crossover */
+                Uint32 after = 0;
+                while (after < countCount && counts[after] < crossovers[i]) after++;
+                bool aWins = after < countCount && results[a][after].cpuMs < results[b][after].cpuMs;
+                SDL_Log("DrawBench: %s becomes cheaper than %s at ~%.0f objects",
+                        DrawPaths_Name((DrawPathKind)(aWins ? a : b)), DrawPaths_Name((DrawPathKind)(aWins ? b : a)),
+                        crossovers[i]);
+            }
+        }
+    }
+}
+
+static bool WriteReport(void)
+{
+    SDL_IOStream *io = SDL_IOFromFile(outputPath, "w");
+    if (!io) {
+        SDL_Log("DrawBench: failed to open %s: %s", outputPath, SDL_GetError());
+        return false;
+    }
+
+    SDL_IOprintf(io, "{\n  \"format\": \"spinningcubes-drawbench\",\n  \"version\": 1,\n");
+    SDL_IOprintf(io, "  \"run\": {\n    \"label\": \"%s\",\n    \"platform\": \"%s\",\n    \"driver\": \"%s\",\n"
+                 "    \"width\": %d,\n    \"height\": %d\n  },\n", label ? label : "", SDL_GetPlatform(),
+                 SDL_GetGPUDeviceDriver(device), targetWidth, targetHeight);
+
+    SDL_IOprintf(io, "  \"results\": [");
+    bool first = true;
+    for (int kind = 0; kind < DRAWPATH_COUNT; kind++) {
+        for (Uint32 i = 0; i < countCount; i++) {
+            const DrawBenchResult *r = &results[kind][i];
+            if (!r->measured) continue;
+            SDL_IOprintf(io, "%s\n    { \"path\": \"%s\", \"objects\": %u, \"frames\": %u, \"cpu_ms\": %.4f, "
+                         "\"gpu_ms\": %.4f, \"cpu_ns_per_object\": %.2f }", first ? "" : ",",
+                         DrawPaths_Name((DrawPathKind)kind), counts[i], r->frames, r->cpuMs, r->gpuMs,
+                         r->cpuNsPerObject);
+            first = false;
+        }
+    }
+
+    SDL_IOprintf(io, "\n  ],\n  \"crossovers\": [");
+    first = true;
+    for (int a = 0; a < DRAWPATH_COUNT; a++) {
+        for (int b = a + 1; b < DRAWPATH_COUNT; b++) {
+            double crossovers[MAX_COUNTS];
+            Uint32 found = FindCrossovers((DrawPathKind)a, (DrawPathKind)b, crossovers, MAX_COUNTS);
+            for (Uint32 i = 0; i < found; i++) {
+                SDL_IOprintf(io, "%s\n    { \"a\": \"%s\", \"b\": \"%s\", \"objects\": %.0f }", first ? "" : ",",
+                             DrawPaths_Name((DrawPathKind)a), DrawPaths_Name((DrawPathKind)b), crossovers[i]);
+                first = false;
+            }
+        }
+    }
+    SDL_IOprintf(io, "\n  ]\n}\n");
+
+    if (!SDL_CloseIO(io)) {
+        SDL_Log("DrawBench: failed to write %s: %s", outputPath, SDL_GetError());
+        return false;
+    }
+    SDL_Log("DrawBench: report written to %s", outputPath);
+    return true;
+}
+
+/* ========================================================================
+ * Main
+ * ======================================================================== */
+
+static int ParseInt(const char *text, int min)
+{
+    int value = SDL_atoi(text);
+    return SDL_max(min, value);
+}
+
+static int SDLCALL CompareCounts(const void *a, const void *b)
+{
+    Uint32 x = *(const Uint32 *)a, y = *(const Uint32 *)b;
+    return (x > y) - (x < y);
+}
+
+static bool ParseCounts(const char *text)
+{
+    Uint32 parsed = 0;
+    const char *c = text;
+    while (*c && parsed < MAX_COUNTS) {
+        char *end;
+        unsigned long value = SDL_strtoul(c, &end, 10);
+        if (end == c || value == 0) break;
+        counts[parsed++] = (Uint32)value;
+        c = (*end == ',') ? end + 1 : end;
+    }
+    if (parsed == 0 || *c) {
+        SDL_Log("Invalid object counts '%s' (expected N,N,..., at most %d)", text, MAX_COUNTS);
+        return false;
+    }
+    countCount = parsed;
+    SDL_qsort(counts, countCount, sizeof(Uint32), CompareCounts);
+    return true;
+}
+
+static void ParsePaths(const char *text)
+{
+    char names[256];
+    SDL_strlcpy(names, text, sizeof(names));
+    SDL_memset(pathEnabled, 0, sizeof(pathEnabled));
+
+    char *state = NULL;
+    for (char *name = SDL_strtok_r(names, ",", &state); name; name = SDL_strtok_r(NULL, ",", &state)) {
+        DrawPathKind kind;
+        if (DrawPaths_ParseKind(name, &kind)) {
+            pathEnabled[kind] = true;
+        } else {
+            SDL_Log("Unknown draw path '%s'", name);
+        }
+    }
+}
+
+static void ParseArgs(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; i++) {
+        if (SDL_strcmp(argv[i], "--counts") == 0 && i + 1 < argc) {
+            ParseCounts(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--paths") == 0 && i + 1 < argc) {
+            ParsePaths(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            measureFrames = (Uint32)ParseInt(argv[++i], 1);
+        } else if (SDL_strcmp(argv[i], "--warmup") == 0 && i + 1 < argc) {
+            warmupFrames = (Uint32)ParseInt(argv[++i], 0);
+        } else if (SDL_strcmp(argv[i], "--max-seconds") == 0 && i + 1 < argc) {
+            maxSecondsPerPoint = SDL_atof(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--size") == 0 && i + 1 < argc) {
+            if (SDL_sscanf(argv[++i], "%dx%d", &targetWidth, &targetHeight) != 2 || targetWidth < 1 || targetHeight < 1) {
+                SDL_Log("Invalid size '%s' (expected WxH)", argv[i]);
+                targetWidth = targetHeight = 512;
+            }
+        } else if (SDL_strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            outputPath = argv[++i];
+        } else if (SDL_strcmp(argv[i], "--label") == 0 && i + 1 < argc) {
+            label = argv[++i];
+        } else {
+            SDL_Log("Ignoring unknown option: %s", argv[i]);
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    ParseArgs(argc, argv);
+
+    Uint32 maxCount = 1;
+    for (Uint32 i = 0; i < countCount; i++) maxCount = SDL_max(maxCount, counts[i]);
+
+    if (!Setup(maxCount)) {
+        Shutdown();
+        return 1;
+    }
+    SDL_Log("DrawBench: %s, %dx%d target, %u warmup + up to %u frames per point",
+            SDL_GetGPUDeviceDriver(device), targetWidth, targetHeight, warmupFrames, measureFrames);
+
+    for (int kind = 0; kind < DRAWPATH_COUNT; kind++) {
+        if (!pathEnabled[kind]) continue;
+        if (!DrawPaths_IsAvailable(drawPaths, (DrawPathKind)kind)) {
+            SDL_Log("DrawBench: %s unavailable, skipped", DrawPaths_Name((DrawPathKind)kind));
+            pathEnabled[kind] = false;
+            continue;
+        }
+        for (Uint32 i = 0; i < countCount; i++) {
+            results[kind][i] = MeasurePoint((DrawPathKind)kind, counts[i]);
+            SDL_Log("DrawBench: %-14s %8u objects  cpu %9.3f ms (%8.1f ns/object)  gpu %9.3f ms",
+                    DrawPaths_Name((DrawPathKind)kind), counts[i], results[kind][i].cpuMs,
+                    results[kind][i].cpuNsPerObject, results[kind][i].gpuMs);
+        }
+    }
+
+    LogResults();
+    bool written = !outputPath || WriteReport();
+
+    Shutdown();
+    return written ? 0 : 1;
+}
@@ -0,0 +1,310 @@
+/*
+ * Draw submission paths - see drawpaths.h
+ */
+
+#include "drawpaths.h"
+
+#include "cmdstream.h"
+#include "shaders.h"
+
+/* Vertices of the cube CubePulled.vert generates */
+#define PULLED_CUBE_VERTICES 36
+
+struct DrawPaths {
+    SDL_GPUDevice *device;
+    Uint32 maxObjects;
+    SDL_GPUGraphicsPipeline *pipelines[DRAWPATH_COUNT];
+    SDL_GPUBuffer *modelBuffer;             /* Storage buffer and per-instance vertex data */
+    SDL_GPUBuffer *indirectBuffer;
+    SDL_GPUTransferBuffer *modelTransfer;
+    SDL_GPUTransferBuffer *indirectTransfer;
+};
+
+static const char *const pathNames[DRAWPATH_COUNT] = {
+    "uniform",
+    "uniform-ring",
+    "instanced",
+    "indirect",
+    "vertex-pulling"
+};
+
+/* ========================================================================
+ * Pipelines
+ * ======================================================================== */
+
+typedef struct {
+    const char *shader;
+    Uint32 uniformBuffers;
+    Uint32 storageBuffers;
+} PathShader;
+
+static const PathShader pathShaders[DRAWPATH_COUNT] = {
+    { "PositionColorTransform.vert", 1, 0 },
+    { "PositionColorIndexed.vert", 2, 1 },
+    { "ControllerInstanced.vert", 1, 1 },
+    { "PositionColorInstanceRows.vert", 1, 0 },
+    { "CubePulled.vert", 1, 1 }
+};
+
+static SDL_GPUGraphicsPipeline *CreatePathPipeline(SDL_GPUDevice *device, DrawPathKind kind,
+                                                   SDL_GPUShader *fragShader, SDL_GPUTextureFormat colorFormat)
+{
+    const PathShader *info = &pathShaders[kind];
+    SDL_GPUShader *vertShader = Shaders_Load(device, info->shader, SDL_GPU_SHADERSTAGE_VERTEX, 0,
+                                             info->uniformBuffers, info->storageBuffers);
+    if (!vertShader) return NULL;
+
+    SDL_GPUVertexBufferDescription vertexBuffers[2] = {{
+        .slot = 0,
+        .pitch = sizeof(PositionColorVertex),
+        .input_rate = SDL_GPU_VERTEXINPUTRATE_VERTEX
+    }, {
+        .slot = 1,
+        .pitch = sizeof(Mat4),
+        .input_rate = SDL_GPU_VERTEXINPUTRATE_INSTANCE
+    }};
+    SDL_GPUVertexAttribute attributes[6] = {{
+        .location = 0,
+        .buffer_slot = 0,
+        .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,
+        .offset = 0
+    }, {
+        .location = 1,
+        .buffer_slot = 0,
+        .format = SDL_GPU_VERTEXELEMENTFORMAT_UBYTE4_NORM,
+        .offset = sizeof(float) * 3
+    }};
+    for (Uint32 row = 0; row < 4; row++) {
+        attributes[2 + row] = (SDL_GPUVertexAttribute){
+            .location = 2 + row,
+            .buffer_slot = 1,
+            .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4,
+            .offset = row * sizeof(float) * 4
+        };
+    }
+
+    SDL_GPUGraphicsPipelineCreateInfo pipelineInfo = {
+        .vertex_shader = vertShader,
+        .fragment_shader = fragShader,
+        .target_info = {
+            .num_color_targets = 1,
+            .color_target_descriptions = (SDL_GPUColorTargetDescription[]){{
+                .format = colorFormat
+            }}
+        },
+        .rasterizer_state = {
+            .cull_mode = SDL_GPU_CULLMODE_BACK,
+            .front_face = SDL_GPU_FRONTFACE_COUNTER_CLOCKWISE,
+            .fill_mode = SDL_GPU_FILLMODE_FILL
+        },
+        .vertex_input_state = {
+            .num_vertex_buffers = kind == DRAWPATH_INDIRECT ? 2 : 1,
+            .vertex_buffer_descriptions = vertexBuffers,
+            .num_vertex_attributes = kind == DRAWPATH_INDIRECT ? 6 : 2,
+            .vertex_attributes = attributes
+        },
+        .primitive_type = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST
+    };
+    if (kind == DRAWPATH_VERTEX_PULLING) {
+        pipelineInfo.vertex_input_state = (SDL_GPUVertexInputState){ 0 };
+    }
+
+    SDL_GPUGraphicsPipeline *pipeline = SDL_CreateGPUGraphicsPipeline(device, &pipelineInfo);
+    if (!pipeline) {
+        SDL_Log("Draw path %s: failed to create pipeline: %s", pathNames[kind], SDL_GetError());
+    }
+    CmdStream_RegisterPipeline(pipeline, &pipelineInfo,
+                               &(CmdStreamShader){ info->shader, 0, info->uniformBuffers, info->storageBuffers },
+                               &(CmdStreamShader){ "SolidColor.frag", 0, 0, 0 });
+    SDL_ReleaseGPUShader(device, vertShader);
+    return pipeline;
+}
+
+/* ========================================================================
+ * Public Interface
+ * ======================================================================== */
+
+DrawPaths *DrawPaths_Create(SDL_GPUDevice *device, SDL_GPUTextureFormat colorFormat, Uint32 maxObjects)
+{
+    DrawPaths *paths = SDL_calloc(1, sizeof(DrawPaths));
+    if (!paths) return NULL;
+    paths->device = device;
+    paths->maxObjects = SDL_max(1u, maxObjects);
+
+    Uint32 modelSize = paths->maxObjects * (Uint32)sizeof(Mat4);
+    Uint32 indirectSize = paths->maxObjects * (Uint32)sizeof(SDL_GPUIndexedIndirectDrawCommand);
+    SDL_GPUBufferCreateInfo modelInfo = {
+        .usage = SDL_GPU_BUFFERUSAGE_GRAPHICS_STORAGE_READ | SDL_GPU_BUFFERUSAGE_VERTEX,
+        .size = modelSize
+    };
+    SDL_GPUBufferCreateInfo indirectInfo = { .usage = SDL_GPU_BUFFERUSAGE_INDIRECT, .size = indirectSize };
+    SDL_GPUTransferBufferCreateInfo modelTransferInfo = {
+        .usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
+        .size = modelSize
+    };
+    SDL_GPUTransferBufferCreateInfo indirectTransferInfo = {
+        .usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
+        .size = indirectSize
+    };
+    paths->modelBuffer = SDL_CreateGPUBuffer(device, &modelInfo);
+    paths->indirectBuffer = SDL_CreateGPUBuffer(device, &indirectInfo);
+    paths->modelTransfer = SDL_CreateGPUTransferBuffer(device, &modelTransferInfo);
+    paths->indirectTransfer = SDL_CreateGPUTransferBuffer(device, &indirectTransferInfo);
+    if (!paths->modelBuffer || !paths->indirectBuffer || !paths->modelTransfer || !paths->indirectTransfer) {
+        SDL_Log("Draw paths: failed to create buffers for %u objects: %s", paths->maxObjects, SDL_GetError());
+        DrawPaths_Destroy(paths);
+        return NULL;
+    }
+    CmdStream_RegisterBuffer(paths->modelBuffer, modelInfo.usage, modelSize, NULL);
+    CmdStream_RegisterBuffer(paths->indirectBuffer, indirectInfo.usage, indirectSize, NULL);
+
+    SDL_GPUShader *fragShader = Shaders_Load(device, "SolidColor.frag", SDL_GPU_SHADERSTAGE_FRAGMENT, 0, 0, 0);
+    if (!fragShader) {
+        DrawPaths_Destroy(paths);
+        return NULL;
+    }
+    for (int kind = 0; kind < DRAWPATH_COUNT; kind++) {
+        paths->pipelines[kind] = CreatePathPipeline(device, (DrawPathKind)kind, fragShader, colorFormat);
+    }
+    SDL_ReleaseGPUShader(device, fragShader);
+
+    return paths;
+}
+
+void DrawPaths_Destroy(DrawPaths *paths)
+{
+    if (!paths) return;
+
+    for (int kind = 0; kind < DRAWPATH_COUNT; kind++) {
+        if (paths->pipelines[kind]) SDL_ReleaseGPUGraphicsPipeline(paths->device, paths->pipelines[kind]);
+    }
+    if (paths->modelBuffer) SDL_ReleaseGPUBuffer(paths->device, paths->modelBuffer);
+    if (paths->indirectBuffer) SDL_ReleaseGPUBuffer(paths->device, paths->indirectBuffer);
+    if (paths->modelTransfer) SDL_ReleaseGPUTransferBuffer(paths->device, paths->modelTransfer);
+    if (paths->indirectTransfer) SDL_ReleaseGPUTransferBuffer(paths->device, paths->indirectTransfer);
+    SDL_free(paths);
+}
+
+bool DrawPaths_IsAvailable(const DrawPaths *paths, DrawPathKind kind)
+{
+    return paths && kind < DRAWPATH_COUNT && paths->pipelines[kind] != NULL;
+}
+
+const char *DrawPaths_Name(DrawPathKind kind)
+{
+    return kind < DRAWPATH_COUNT ? pathNames[kind] : "unknown";
+}
+
+bool DrawPaths_ParseKind(const char *name, DrawPathKind *kind)
+{
+    for (int i = 0; i < DRAWPATH_COUNT; i++) {
+        if (SDL_strcmp(name, pathNames[i]) == 0) {
+            *kind = (DrawPathKind)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+void DrawPaths_Upload(DrawPaths *paths, SDL_GPUCommandBuffer *cmdBuf, DrawPathKind kind,
+                      const DrawPathMesh *mesh, const Mat4 *models, Uint32 count)
+{
+    count = SDL_min(count, paths->maxObjects);
+    if (kind == DRAWPATH_UNIFORM || count == 0) return;
+
+    /* Cycled so the previous frame's draws can still read their copy */
+    Mat4 *data = SDL_MapGPUTransferBuffer(paths->device, paths->modelTransfer, true);
+    if (!data) return;
+    SDL_memcpy(data, models, count * sizeof(Mat4));
+    SDL_UnmapGPUTransferBuffer(paths->device, paths->modelTransfer);
+    CmdStream_UpdateBuffer(paths->modelBuffer, 0, models, count * (Uint32)sizeof(Mat4));
+
+    if (kind == DRAWPATH_INDIRECT) {
+        SDL_GPUIndexedIndirectDrawCommand *commands =
+            SDL_MapGPUTransferBuffer(paths->device, paths->indirectTransfer, true);
+        if (!commands) return;
+        for (Uint32 i = 0; i < count; i++) {
+            commands[i] = (SDL_GPUIndexedIndirectDrawCommand){
+                .num_indices = mesh->indexCount,
+                .num_instances = 1,
+                .first_instance = i
+            };
+        }
+        CmdStream_UpdateBuffer(paths->indirectBuffer, 0, commands,
+                               count * (Uint32)sizeof(SDL_GPUIndexedIndirectDrawCommand));
+        SDL_UnmapGPUTransferBuffer(paths->device, paths->indirectTransfer);
+    }
+
+    SDL_GPUCopyPass *copyPass = SDL_BeginGPUCopyPass(cmdBuf);
+    SDL_GPUTransferBufferLocation src = { .transfer_buffer = paths->modelTransfer };
+    SDL_GPUBufferRegion dst = { .buffer = paths->modelBuffer, .size = count * (Uint32)sizeof(Mat4) };
+    SDL_UploadToGPUBuffer(copyPass, &src, &dst, true);
+    if (kind == DRAWPATH_INDIRECT) {
+        SDL_GPUTransferBufferLocation commandSrc = { .transfer_buffer = paths->indirectTransfer };
+        SDL_GPUBufferRegion commandDst = {
+            .buffer = paths->indirectBuffer,
+            .size = count * (Uint32)sizeof(SDL_GPUIndexedIndirectDrawCommand)
+        };
+        SDL_UploadToGPUBuffer(copyPass, &commandSrc, &commandDst, true);
+    }
+    SDL_EndGPUCopyPass(copyPass);
+}
+
+void DrawPaths_Draw(DrawPaths *paths, SDL_GPUCommandBuffer *cmdBuf, SDL_GPURenderPass *renderPass,
+                    DrawPathKind kind, const DrawPathMesh *mesh, const Mat4 *models, Uint32 count,
+                    const Mat4 *viewProj, BenchRenderStats *stats)
+{
+    count = SDL_min(count, paths->maxObjects);
+    if (!DrawPaths_IsAvailable(paths, kind) || count == 0) return;
+
+    CmdStream_BindGraphicsPipeline(renderPass, paths->pipelines[kind]);
+    if (kind != DRAWPATH_VERTEX_PULLING) {
+        SDL_GPUBufferBinding vertexBindings[2] = { { mesh->vertices, 0 }, { paths->modelBuffer, 0 } };
+        CmdStream_BindVertexBuffers(renderPass, 0, vertexBindings, kind == DRAWPATH_INDIRECT ? 2 : 1);
+        SDL_GPUBufferBinding indexBinding = { mesh->indices, 0 };
+        CmdStream_BindIndexBuffer(renderPass, &indexBinding, mesh->indexSize);
+    }
+    if (kind == DRAWPATH_UNIFORM_RING || kind == DRAWPATH_INSTANCED || kind == DRAWPATH_VERTEX_PULLING) {
+        CmdStream_BindVertexStorageBuffers(renderPass, 0, &paths->modelBuffer, 1);
+    }
+    if (kind != DRAWPATH_UNIFORM) {
+        CmdStream_PushVertexUniformData(cmdBuf, 0, viewProj, sizeof(Mat4));
+    }
+
+    Uint32 drawCalls = 1;
+    Uint32 indexCount = kind == DRAWPATH_VERTEX_PULLING ? PULLED_CUBE_VERTICES : mesh->indexCount;
+    switch (kind) {
+    case DRAWPATH_UNIFORM:
+        for (Uint32 i = 0; i < count; i++) {
+            Mat4 mvp = Mat4_Multiply(models[i], *viewProj);
+            CmdStream_PushVertexUniformData(cmdBuf, 0, &mvp, sizeof(mvp));
+            CmdStream_DrawIndexedPrimitives(renderPass, indexCount, 1, 0, 0, 0);
+        }
+        drawCalls = count;
+        break;
+    case DRAWPATH_UNIFORM_RING:
+        for (Uint32 i = 0; i < count; i++) {
+            CmdStream_PushVertexUniformData(cmdBuf, 1, &i, sizeof(i));
+            CmdStream_DrawIndexedPrimitives(renderPass, indexCount, 1, 0, 0, 0);
+        }
+        drawCalls = count;
+        break;
+    case DRAWPATH_INSTANCED:
+        CmdStream_DrawIndexedPrimitives(renderPass, indexCount, count, 0, 0, 0);
+        break;
+    case DRAWPATH_INDIRECT:
+        CmdStream_DrawIndexedPrimitivesIndirect(renderPass, paths->indirectBuffer, 0, count);
+        break;
+    case DRAWPATH_VERTEX_PULLING:
+        CmdStream_DrawPrimitives(renderPass, PULLED_CUBE_VERTICES, count, 0, 0);
+        break;
+    default:
+        break;
+    }
+
+    if (stats) {
+        stats->drawCalls += drawCalls;
+        stats->pipelineBinds++;
+        stats->triangles += (Uint64)count * (indexCount / 3);
+    }
+}
@@ -0,0 +1,65 @@
+/*
+ * Draw submission paths
+ *
+ * Interchangeable ways of submitting the same set of objects - one mesh, one
+ * material, a model matrix each - so their CPU and GPU cost can be compared
+ * on one device:
+ *
+ *   uniform          push the object's MVP and draw, per object (the default renderer loop)
+ *   uniform-ring     model matrices uploaded once per frame; per object push a 4-byte index and draw
+ *   instanced        one instanced draw reading model matrices from a storage buffer
+ *   indirect         one multi-draw indirect call, one command per object; model matrices
+ *                    are per-instance vertex attributes selected by first_instance
+ *   vertex-pulling   one instanced draw without vertex or index buffers; the shader builds
+ *                    the cube from the vertex index (so it only draws the cube mesh)
+ *
+ * Paths other than uniform read per-object data from GPU buffers that
+ * DrawPaths_Upload fills in a copy pass, once per frame, before any view
+ * is drawn. A path whose shader is missing is reported unavailable.
+ */
+
+#ifndef DRAWPATHS_H
+#define DRAWPATHS_H
+
+#include <SDL3/SDL.h>
+
+#include "bench.h"
+#include "vecmath.h"
+
+typedef enum DrawPathKind {
+    DRAWPATH_UNIFORM,
+    DRAWPATH_UNIFORM_RING,
+    DRAWPATH_INSTANCED,
+    DRAWPATH_INDIRECT,
+    DRAWPATH_VERTEX_PULLING,
+    DRAWPATH_COUNT
+} DrawPathKind;
+
+typedef struct DrawPathMesh {
+    SDL_GPUBuffer *vertices;            /* PositionColorVertex */
+    SDL_GPUBuffer *indices;
+    SDL_GPUIndexElementSize indexSize;
+    Uint32 indexCount;
+} DrawPathMesh;
+
+typedef struct DrawPaths DrawPaths;
+
+/* Pipelines render into colorFormat with the renderer's cube raster state; buffers hold maxObjects */
+DrawPaths *DrawPaths_Create(SDL_GPUDevice *device, SDL_GPUTextureFormat colorFormat, Uint32 maxObjects);
+void DrawPaths_Destroy(DrawPaths *paths);
+
+bool DrawPaths_IsAvailable(const DrawPaths *paths, DrawPathKind kind);
+const char *DrawPaths_Name(DrawPathKind kind);
+bool DrawPaths_ParseKind(const char *name, DrawPathKind *kind);
+
+/* Copy pass for this frame's models; call outside any pass. Nothing to do for DRAWPATH_UNIFORM. */
+void DrawPaths_Upload(DrawPaths *paths, SDL_GPUCommandBuffer *cmdBuf, DrawPathKind kind,
+                      const DrawPathMesh *mesh, const Mat4 *models, Uint32 count);
+
+/* Records the objects uploaded this frame (or, for DRAWPATH_UNIFORM, the models given here)
+ * into an open render pass. stats, when not NULL, accumulates what was recorded. */
+void DrawPaths_Draw(DrawPaths *paths, SDL_GPUCommandBuffer *cmdBuf, SDL_GPURenderPass *renderPass,
+                    DrawPathKind kind, const DrawPathMesh *mesh, const Mat4 *models, Uint32 count,
+                    const Mat4 *viewProj, BenchRenderStats *stats);
+
+#endif /* DRAWPATHS_H */
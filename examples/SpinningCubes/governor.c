@@ -0,0 +1,339 @@
+/*
+ * Frame budget governor - see governor.h
+ */
+
+#include "governor.h"
+
+#include "gputimer.h"
+#include "log.h"
+
+#define GOVERNOR_MAX_PENDING 4  /* Outstanding GPU timing fences */
+#define GOVERNOR_MAX_HISTORY 64
+
+typedef struct {
+    const char *name;
+    int levelCount;
+    int level;
+    GovernorApplyFunction apply;
+    void *userdata;
+    float ratesHz[GOVERNOR_MAX_RATES];  /* Refresh rate knobs only */
+    bool isRefreshRate;
+} GovernorKnob;
+
+static GovernorConfig governorConfig;
+static bool governorEnabled = false;
+
+/* Knobs in priority order once the first frame begins */
+static GovernorKnob knobs[GOVERNOR_MAX_KNOBS];
+static int knobCount = 0;
+static bool orderResolved = false;
+
+/* Knob indices in the order they were degraded, so restores undo the latest first */
+static int history[GOVERNOR_MAX_HISTORY];
+static int historyCount = 0;
+
+static Uint64 frameBeginNs = 0;
+static Uint32 slowFrames = 0;
+static Uint32 fastFrames = 0;
+static Uint64 fastStreakMaxNs = 0;     /* Slowest frame of the current fast streak */
+
+static GpuTimer *gpuTimer = NULL;
+static Uint64 lastGpuNs = 0;   /* Most recent completed GPU frame time */
+static Uint64 lastCpuNs = 0;
+static Sint64 lastPeriodNs = 0;
+
+static int qualityPressure[GOVERNOR_DOMAIN_COUNT];  /* Set by Governor_SetQualityPressure */
+
+typedef struct {
+    int level;
+    int maxLevel;           /* Lowered by Governor_CapPerformanceLevel */
+    Uint32 slowFrames;
+    Uint32 fastFrames;
+} GovernorDomainState;
+
+static const char *const domainNames[GOVERNOR_DOMAIN_COUNT] = { "cpu", "gpu" };
+static GovernorDomainState domains[GOVERNOR_DOMAIN_COUNT];
+static int performanceLevelCount = 0;  /* 0 when performance levels are not managed */
+static GovernorLevelFunction levelApply = NULL;
+static void *levelUserdata = NULL;
+
+/* ========================================================================
+ * Knobs
+ * ======================================================================== */
+
+/* Moves the knobs named in config.order to the front, in that order */
+static void ResolveOrder(void)
+{
+    orderResolved = true;
+    if (!governorConfig.order) return;
+
+    int placed = 0;
+    const char *cursor = governorConfig.order;
+    while (*cursor) {
+        const char *comma = SDL_strchr(cursor, ',');
+        size_t length = comma ? (size_t)(comma - cursor) : SDL_strlen(cursor);
+        bool found = false;
+        for (int i = placed; i < knobCount; i++) {
+            if (SDL_strlen(knobs[i].name) == length && SDL_strncmp(knobs[i].name, cursor, length) == 0) {
+                GovernorKnob knob = knobs[i];
+                SDL_memmove(&knobs[placed + 1], &knobs[placed], (size_t)(i - placed) * sizeof(GovernorKnob));
+                knobs[placed++] = knob;
+                found = true;
+                break;
+            }
+        }
+        if (!found && length > 0) {
+            SDL_Log("Governor: ignoring unknown knob '%.*s'", (int)length, cursor);
+        }
+        cursor += length;
+        if (*cursor == ',') cursor++;
+    }
+}
+
+static void SetLevel(GovernorKnob *knob, int level, Uint64 cpuNs, Uint64 gpuNs, Sint64 periodNs)
+{
+    knob->level = level;
+    knob->apply(knob->userdata, level);
+    Log_Write(LOG_INFO, "Governor: %s -> level %d/%d (cpu %.2f ms, gpu %.2f ms, budget %.2f ms)",
+            knob->name, level, knob->levelCount - 1,
+            (double)cpuNs / 1e6, (double)gpuNs / 1e6, (double)periodNs / 1e6);
+}
+
+static bool Degrade(Uint64 cpuNs, Uint64 gpuNs, Sint64 periodNs)
+{
+    if (historyCount == GOVERNOR_MAX_HISTORY) return false;
+
+    for (int i = 0; i < knobCount; i++) {
+        if (knobs[i].level + 1 < knobs[i].levelCount) {
+            history[historyCount++] = i;
+            SetLevel(&knobs[i], knobs[i].level + 1, cpuNs, gpuNs, periodNs);
+            return true;
+        }
+    }
+    return false;
+}
+
+/* A lower refresh rate can only come back if the frame also fits the higher rate's period */
+static bool CanRestore(const GovernorKnob *knob)
+{
+    if (!knob->isRefreshRate) return true;
+    double restoredPeriodNs = 1e9 / (double)knob->ratesHz[knob->level - 1];
+    return (double)fastStreakMaxNs < restoredPeriodNs * governorConfig.restoreThreshold;
+}
+
+static bool Restore(Uint64 cpuNs, Uint64 gpuNs, Sint64 periodNs)
+{
+    for (int i = 0; i < GOVERNOR_DOMAIN_COUNT; i++) {
+        if (qualityPressure[i] > 0) return false;
+    }
+
+    for (int i = historyCount - 1; i >= 0; i--) {
+        GovernorKnob *knob = &knobs[history[i]];
+        if (!CanRestore(knob)) continue;
+
+        SDL_memmove(&history[i], &history[i + 1], (size_t)(historyCount - 1 - i) * sizeof(history[0]));
+        historyCount--;
+        SetLevel(knob, knob->level - 1, cpuNs, gpuNs, periodNs);
+        return true;
+    }
+    return false;
+}
+
+/* ========================================================================
+ * Performance Levels
+ * ======================================================================== */
+
+static void SetDomainLevel(GovernorDomain domain, int level, Uint64 domainNs, Sint64 periodNs)
+{
+    domains[domain].level = level;
+    levelApply(levelUserdata, domain, level);
+    Log_Write(LOG_INFO, "Governor: %s performance -> level %d/%d (%s %.2f ms, budget %.2f ms)",
+            domainNames[domain], level, performanceLevelCount - 1, domainNames[domain],
+            (double)domainNs / 1e6, (double)periodNs / 1e6);
+}
+
+static bool CanRaise(GovernorDomain domain)
+{
+    return performanceLevelCount > 0 && domains[domain].level < domains[domain].maxLevel;
+}
+
+/* Same thresholds and frame counts as the quality knobs, judged on the domain's own time */
+static void UpdateDomain(GovernorDomain domain, Uint64 domainNs, bool backlogged, bool isBottleneck, Sint64 periodNs)
+{
+    GovernorDomainState *state = &domains[domain];
+
+    if (backlogged || domainNs > (Uint64)((double)periodNs * governorConfig.degradeThreshold)) {
+        state->fastFrames = 0;
+        if (++state->slowFrames >= governorConfig.degradeFrames) {
+            state->slowFrames = 0;
+            if (CanRaise(domain)) SetDomainLevel(domain, state->level + 1, domainNs, periodNs);
+        }
+    } else if (domainNs < (Uint64)((double)periodNs * governorConfig.restoreThreshold)) {
+        state->slowFrames = 0;
+        if (++state->fastFrames >= governorConfig.restoreFrames) {
+            state->fastFrames = 0;
+            /* Headroom on the bottleneck goes back to quality first */
+            if (state->level > 0 && (historyCount == 0 || !isBottleneck)) {
+                SetDomainLevel(domain, state->level - 1, domainNs, periodNs);
+            }
+        }
+    } else {
+        state->slowFrames = 0;
+        state->fastFrames = 0;
+    }
+}
+
+/* ========================================================================
+ * Public Interface
+ * ======================================================================== */
+
+bool Governor_Init(SDL_GPUDevice *device, const GovernorConfig *config)
+{
+    governorConfig = *config;
+
+    gpuTimer = GpuTimer_Create(device, GOVERNOR_MAX_PENDING);
+    if (!gpuTimer) return false;
+
+    governorEnabled = true;
+    SDL_Log("Governor: degrade above %.0f%%, restore below %.0f%% of the display period",
+            config->degradeThreshold * 100.0f, config->restoreThreshold * 100.0f);
+    return true;
+}
+
+void Governor_Shutdown(void)
+{
+    GpuTimer_Destroy(gpuTimer);
+    gpuTimer = NULL;
+
+    governorEnabled = false;
+    knobCount = 0;
+    historyCount = 0;
+    SDL_zeroa(qualityPressure);
+    performanceLevelCount = 0;
+    levelApply = NULL;
+    levelUserdata = NULL;
+}
+
+bool Governor_AddKnob(const char *name, int levelCount, GovernorApplyFunction apply, void *userdata)
+{
+    if (knobCount == GOVERNOR_MAX_KNOBS || levelCount < 2) return false;
+
+    knobs[knobCount++] = (GovernorKnob){ name, levelCount, 0, apply, userdata, { 0 }, false };
+    return true;
+}
+
+bool Governor_AddRefreshRateKnob(const char *name, const float *ratesHz, int rateCount,
+                                 GovernorApplyFunction apply, void *userdata)
+{
+    if (rateCount > GOVERNOR_MAX_RATES || !Governor_AddKnob(name, rateCount, apply, userdata)) return false;
+
+    GovernorKnob *knob = &knobs[knobCount - 1];
+    SDL_memcpy(knob->ratesHz, ratesHz, (size_t)rateCount * sizeof(float));
+    knob->isRefreshRate = true;
+    return true;
+}
+
+bool Governor_SetPerformanceLevels(int levelCount, int initialLevel, GovernorLevelFunction apply, void *userdata)
+{
+    if (!governorEnabled || levelCount < 2 || initialLevel < 0 || initialLevel >= levelCount) return false;
+
+    performanceLevelCount = levelCount;
+    levelApply = apply;
+    levelUserdata = userdata;
+    for (int i = 0; i < GOVERNOR_DOMAIN_COUNT; i++) {
+        domains[i] = (GovernorDomainState){ initialLevel, levelCount - 1, 0, 0 };
+        apply(userdata, (GovernorDomain)i, initialLevel);
+    }
+    SDL_Log("Governor: managing %d CPU/GPU performance levels, starting at %d", levelCount, initialLevel);
+    return true;
+}
+
+void Governor_CapPerformanceLevel(GovernorDomain domain, int maxLevel)
+{
+    if (performanceLevelCount == 0) return;
+
+    GovernorDomainState *state = &domains[domain];
+    state->maxLevel = SDL_clamp(maxLevel, 0, performanceLevelCount - 1);
+    Log_Write(LOG_INFO, "Governor: %s performance capped at level %d", domainNames[domain], state->maxLevel);
+    if (state->level > state->maxLevel) {
+        state->level = state->maxLevel;
+        levelApply(levelUserdata, domain, state->level);
+    }
+}
+
+void Governor_SetQualityPressure(GovernorDomain domain, int pressure)
+{
+    if (!governorEnabled) return;
+    /* Degrading indexes the knobs, so their order has to be final first */
+    if (!orderResolved) ResolveOrder();
+
+    pressure = SDL_max(pressure, 0);
+    Log_Write(LOG_INFO, "Governor: %s quality pressure %d -> %d", domainNames[domain],
+            qualityPressure[domain], pressure);
+    for (int i = qualityPressure[domain]; i < pressure; i++) {
+        if (!Degrade(lastCpuNs, lastGpuNs, lastPeriodNs)) break;
+    }
+    qualityPressure[domain] = pressure;
+    slowFrames = 0;
+    fastFrames = 0;
+    fastStreakMaxNs = 0;
+}
+
+void Governor_BeginFrame(void)
+{
+    if (!governorEnabled) return;
+    if (!orderResolved) ResolveOrder();
+
+    frameBeginNs = SDL_GetTicksNS();
+}
+
+void Governor_EndFrame(Sint64 displayPeriodNs)
+{
+    if (!governorEnabled || displayPeriodNs <= 0) return;
+
+    Uint64 cpuNs = SDL_GetTicksNS() - frameBeginNs;
+
+    /* A full marker queue means the GPU is several frames behind */
+    bool gpuBacklogged = !GpuTimer_Mark(gpuTimer);
+
+    Uint64 samples[GOVERNOR_MAX_PENDING];
+    Uint32 sampleCount;
+    while ((sampleCount = GpuTimer_Read(gpuTimer, samples, GOVERNOR_MAX_PENDING)) > 0) {
+        lastGpuNs = samples[sampleCount - 1];
+    }
+    Uint64 gpuNs = lastGpuNs;
+
+    Uint64 frameNs = SDL_max(cpuNs, gpuNs);
+    lastCpuNs = cpuNs;
+    lastPeriodNs = displayPeriodNs;
+    GovernorDomain bottleneck = gpuBacklogged || gpuNs >= cpuNs ? GOVERNOR_DOMAIN_GPU : GOVERNOR_DOMAIN_CPU;
+
+    /* Quality is only given up once clocks cannot be raised any further; decided
+     * before the domains update so a level raise and a degrade never coincide */
+    bool canRaise = CanRaise(bottleneck);
+    if (performanceLevelCount > 0) {
+        UpdateDomain(GOVERNOR_DOMAIN_CPU, cpuNs, false, bottleneck == GOVERNOR_DOMAIN_CPU, displayPeriodNs);
+        UpdateDomain(GOVERNOR_DOMAIN_GPU, gpuNs, gpuBacklogged, bottleneck == GOVERNOR_DOMAIN_GPU, displayPeriodNs);
+    }
+
+    if (gpuBacklogged || frameNs > (Uint64)((double)displayPeriodNs * governorConfig.degradeThreshold)) {
+        fastFrames = 0;
+        fastStreakMaxNs = 0;
+        if (++slowFrames >= governorConfig.degradeFrames) {
+            slowFrames = 0;
+            if (!canRaise) Degrade(cpuNs, gpuNs, displayPeriodNs);
+        }
+    } else if (frameNs < (Uint64)((double)displayPeriodNs * governorConfig.restoreThreshold)) {
+        slowFrames = 0;
+        fastStreakMaxNs = SDL_max(fastStreakMaxNs, frameNs);
+        if (++fastFrames >= governorConfig.restoreFrames) {
+            Restore(cpuNs, gpuNs, displayPeriodNs);
+            fastFrames = 0;
+            fastStreakMaxNs = 0;
+        }
+    } else {
+        slowFrames = 0;
+        fastFrames = 0;
+        fastStreakMaxNs = 0;
+    }
+}
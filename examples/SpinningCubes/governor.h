@@ -0,0 +1,94 @@
+/*
+ * Frame budget governor
+ *
+ * Measures CPU and GPU time per XR frame and trades quality for frame rate
+ * through a list of knobs. Each knob has discrete levels, 0 being full
+ * quality. When the slower of CPU and GPU stays above the degrade threshold
+ * (a fraction of the display period from XrFrameState) for degradeFrames
+ * frames, the highest-priority knob that can still drop does so by one level;
+ * when it stays below the restore threshold for restoreFrames frames, the most
+ * recently degraded knob comes back by one level. The gap between the two
+ * thresholds and frame counts is the hysteresis that keeps it from
+ * oscillating.
+ *
+ * A refresh rate knob lowers the display rate itself. Since that lengthens
+ * the period the thresholds are measured against, it is only restored when
+ * the slowest frame of the fast streak also fits the shorter period it
+ * restores to; until then more recently degraded knobs may restore past it.
+ *
+ * Optionally the governor also picks a CPU and a GPU performance (clock)
+ * level. Each domain is judged on its own time with the same thresholds:
+ * a domain near the budget is raised, one with headroom is lowered, so the
+ * device runs no faster than the frame needs. Quality knobs only degrade
+ * once the slower domain is at its highest allowed level, and a domain that
+ * is the bottleneck is not lowered while any quality is still given up.
+ * The highest allowed level can be capped, e.g. while the device is hot.
+ *
+ * The runtime may also report that a domain misses its deadlines. Each step
+ * up in that pressure degrades a knob at once, whatever the measured times,
+ * and no knob is restored while any domain is still under pressure.
+ *
+ * GPU time comes from a GpuTimer, whose fences are waited on by a timing
+ * thread, so nothing on the frame thread ever blocks.
+ */
+
+#ifndef GOVERNOR_H
+#define GOVERNOR_H
+
+#include <SDL3/SDL.h>
+
+#define GOVERNOR_MAX_KNOBS 8
+#define GOVERNOR_MAX_RATES 8
+
+typedef struct GovernorConfig {
+    float degradeThreshold;     /* Fraction of the display period, e.g. 0.9 */
+    float restoreThreshold;     /* e.g. 0.7; must be below degradeThreshold */
+    Uint32 degradeFrames;       /* Consecutive slow frames before degrading */
+    Uint32 restoreFrames;       /* Consecutive fast frames before restoring */
+    const char *order;          /* Comma-separated knob names, highest priority first; NULL keeps registration order */
+} GovernorConfig;
+
+/* Called on the frame thread whenever a knob changes level */
+typedef void (*GovernorApplyFunction)(void *userdata, int level);
+
+typedef enum GovernorDomain {
+    GOVERNOR_DOMAIN_CPU,
+    GOVERNOR_DOMAIN_GPU,
+    GOVERNOR_DOMAIN_COUNT
+} GovernorDomain;
+
+/* Called on the frame thread whenever a domain changes performance level */
+typedef void (*GovernorLevelFunction)(void *userdata, GovernorDomain domain, int level);
+
+bool Governor_Init(SDL_GPUDevice *device, const GovernorConfig *config);
+void Governor_Shutdown(void);
+
+/* Knobs registered first are degraded first, unless config->order says otherwise.
+ * Call before the first frame. */
+bool Governor_AddKnob(const char *name, int levelCount, GovernorApplyFunction apply, void *userdata);
+
+/* Lets the governor choose each domain's performance level among levelCount
+ * levels, 0 drawing the least power. apply is called at once with
+ * initialLevel for both domains. Call before the first frame. */
+bool Governor_SetPerformanceLevels(int levelCount, int initialLevel, GovernorLevelFunction apply, void *userdata);
+
+/* Highest level a domain may use from now on; a domain above it drops to it at once */
+void Governor_CapPerformanceLevel(GovernorDomain domain, int maxLevel);
+
+/* Pressure on a domain from outside the governor, 0 meaning none; every
+ * level it rises degrades one knob at once, and restores wait for 0 */
+void Governor_SetQualityPressure(GovernorDomain domain, int pressure);
+
+/* A knob whose level picks ratesHz[level]; rates must be in descending order,
+ * so level 0 is the fastest */
+bool Governor_AddRefreshRateKnob(const char *name, const float *ratesHz, int rateCount,
+                                 GovernorApplyFunction apply, void *userdata);
+
+/* Call once xrWaitFrame has returned, before any rendering work */
+void Governor_BeginFrame(void);
+
+/* Call after the frame's command buffers are submitted; displayPeriodNs is
+ * XrFrameState::predictedDisplayPeriod */
+void Governor_EndFrame(Sint64 displayPeriodNs);
+
+#endif /* GOVERNOR_H */
@@ -0,0 +1,155 @@
+/*
+ * GPU frame timer - see gputimer.h
+ */
+
+#include "gputimer.h"
+
+#define GPUTIMER_HISTORY 256   /* Completed samples kept until read */
+
+typedef struct {
+    SDL_GPUFence *fence;
+    Uint64 submitNs;
+} GpuTimerMarker;
+
+struct GpuTimer {
+    SDL_GPUDevice *device;
+    SDL_Thread *thread;
+    SDL_Mutex *mutex;
+    SDL_Condition *condition;   /* Signalled on new markers, completions and quit */
+    bool quit;
+
+    GpuTimerMarker *pending;
+    Uint32 maxPending;
+    Uint32 pendingHead;
+    Uint32 pendingCount;
+
+    Uint64 samples[GPUTIMER_HISTORY];
+    Uint32 sampleHead;
+    Uint32 sampleCount;
+};
+
+static int SDLCALL TimingThreadMain(void *data)
+{
+    GpuTimer *timer = data;
+    Uint64 lastCompletionNs = 0;
+
+    for (;;) {
+        SDL_LockMutex(timer->mutex);
+        while (timer->pendingCount == 0 && !timer->quit) {
+            SDL_WaitCondition(timer->condition, timer->mutex);
+        }
+        if (timer->pendingCount == 0) {
+            SDL_UnlockMutex(timer->mutex);
+            break;
+        }
+        GpuTimerMarker marker = timer->pending[timer->pendingHead];
+        SDL_UnlockMutex(timer->mutex);
+
+        SDL_WaitForGPUFences(timer->device, true, &marker.fence, 1);
+        Uint64 completionNs = SDL_GetTicksNS();
+        SDL_ReleaseGPUFence(timer->device, marker.fence);
+
+        Uint64 startNs = SDL_max(marker.submitNs, lastCompletionNs);
+        lastCompletionNs = completionNs;
+
+        SDL_LockMutex(timer->mutex);
+        if (timer->sampleCount == GPUTIMER_HISTORY) {
+            timer->sampleHead = (timer->sampleHead + 1) % GPUTIMER_HISTORY;
+            timer->sampleCount--;
+        }
+        timer->samples[(timer->sampleHead + timer->sampleCount) % GPUTIMER_HISTORY] = completionNs - startNs;
+        timer->sampleCount++;
+        timer->pendingHead = (timer->pendingHead + 1) % timer->maxPending;
+        timer->pendingCount--;
+        SDL_BroadcastCondition(timer->condition);
+        SDL_UnlockMutex(timer->mutex);
+    }
+    return 0;
+}
+
+GpuTimer *GpuTimer_Create(SDL_GPUDevice *device, Uint32 maxPending)
+{
+    GpuTimer *timer = SDL_calloc(1, sizeof(GpuTimer));
+    if (!timer) return NULL;
+
+    timer->device = device;
+    timer->maxPending = SDL_max(1, maxPending);
+    timer->pending = SDL_calloc(timer->maxPending, sizeof(GpuTimerMarker));
+    timer->mutex = SDL_CreateMutex();
+    timer->condition = SDL_CreateCondition();
+    if (!timer->pending || !timer->mutex || !timer->condition) {
+        SDL_Log("GPU timer: failed to create sync objects: %s", SDL_GetError());
+        GpuTimer_Destroy(timer);
+        return NULL;
+    }
+
+    timer->thread = SDL_CreateThread(TimingThreadMain, "gputimer", timer);
+    if (!timer->thread) {
+        SDL_Log("GPU timer: failed to start timing thread: %s", SDL_GetError());
+        GpuTimer_Destroy(timer);
+        return NULL;
+    }
+    return timer;
+}
+
+void GpuTimer_Destroy(GpuTimer *timer)
+{
+    if (!timer) return;
+
+    /* The timing thread drains every outstanding fence before it exits */
+    if (timer->thread) {
+        SDL_LockMutex(timer->mutex);
+        timer->quit = true;
+        SDL_BroadcastCondition(timer->condition);
+        SDL_UnlockMutex(timer->mutex);
+        SDL_WaitThread(timer->thread, NULL);
+    }
+
+    if (timer->condition) SDL_DestroyCondition(timer->condition);
+    if (timer->mutex) SDL_DestroyMutex(timer->mutex);
+    SDL_free(timer->pending);
+    SDL_free(timer);
+}
+
+bool GpuTimer_Mark(GpuTimer *timer)
+{
+    SDL_LockMutex(timer->mutex);
+    bool full = timer->pendingCount == timer->maxPending;
+    SDL_UnlockMutex(timer->mutex);
+    if (full) return false;
+
+    SDL_GPUCommandBuffer *cmdBuf = SDL_AcquireGPUCommandBuffer(timer->device);
+    if (!cmdBuf) return false;
+    SDL_GPUFence *fence = SDL_SubmitGPUCommandBufferAndAcquireFence(cmdBuf);
+    if (!fence) return false;
+
+    SDL_LockMutex(timer->mutex);
+    timer->pending[(timer->pendingHead + timer->pendingCount) % timer->maxPending] =
+        (GpuTimerMarker){ fence, SDL_GetTicksNS() };
+    timer->pendingCount++;
+    SDL_BroadcastCondition(timer->condition);
+    SDL_UnlockMutex(timer->mutex);
+    return true;
+}
+
+void GpuTimer_Wait(GpuTimer *timer, Uint32 maxOutstanding)
+{
+    SDL_LockMutex(timer->mutex);
+    while (timer->pendingCount > maxOutstanding) {
+        SDL_WaitCondition(timer->condition, timer->mutex);
+    }
+    SDL_UnlockMutex(timer->mutex);
+}
+
+Uint32 GpuTimer_Read(GpuTimer *timer, Uint64 *samples, Uint32 capacity)
+{
+    SDL_LockMutex(timer->mutex);
+    Uint32 count = SDL_min(capacity, timer->sampleCount);
+    for (Uint32 i = 0; i < count; i++) {
+        samples[i] = timer->samples[(timer->sampleHead + i) % GPUTIMER_HISTORY];
+    }
+    timer->sampleHead = (timer->sampleHead + count) % GPUTIMER_HISTORY;
+    timer->sampleCount -= count;
+    SDL_UnlockMutex(timer->mutex);
+    return count;
+}
@@ -0,0 +1,36 @@
+/*
+ * GPU frame timer
+ *
+ * Approximates GPU time per frame without timestamp queries: an empty
+ * command buffer is submitted right behind the frame's work and a timing
+ * thread waits on its fence. A frame's GPU time is the span from the later
+ * of its submission and the previous frame's completion to its own
+ * completion, i.e. how long the queue was busy with it.
+ */
+
+#ifndef GPUTIMER_H
+#define GPUTIMER_H
+
+#include <SDL3/SDL.h>
+
+typedef struct GpuTimer GpuTimer;
+
+/* maxPending bounds the outstanding markers, and so how far the GPU may fall behind */
+GpuTimer *GpuTimer_Create(SDL_GPUDevice *device, Uint32 maxPending);
+
+/* Waits for every outstanding marker before returning */
+void GpuTimer_Destroy(GpuTimer *timer);
+
+/* Call after the frame's command buffers are submitted. Returns false, without
+ * marking, when maxPending markers are already outstanding. */
+bool GpuTimer_Mark(GpuTimer *timer);
+
+/* Blocks until at most maxOutstanding markers are left */
+void GpuTimer_Wait(GpuTimer *timer, Uint32 maxOutstanding);
+
+/* Moves completed frame times, in nanoseconds and submission order, into
+ * samples; returns how many were written. Unread samples beyond the timer's
+ * history are dropped, oldest first. */
+Uint32 GpuTimer_Read(GpuTimer *timer, Uint64 *samples, Uint32 capacity);
+
+#endif /* GPUTIMER_H */
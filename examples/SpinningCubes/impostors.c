@@ -0,0 +1,461 @@
+/*
+ * Octahedral impostors - see impostors.h
+ */
+
+#include "impostors.h"
+
+#include "shaders.h"
+
+#define ATLAS_SIZE (IMPOSTOR_FRAMES * IMPOSTOR_FRAME_SIZE)
+#define ATLAS_FORMAT SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM
+#define ATLAS_MIP_LEVELS 3          /* Down to 16-pixel frames, before neighbours bleed in */
+#define FRAME_MARGIN 1.0625f        /* Frames and quads cover a little more than the bounding sphere */
+
+/* Per-object data of the draw; the layout Impostor.vert.hlsl reads */
+typedef struct {
+    float centerRadius[4];
+    float axes[3][4];               /* Object X, Y and Z axes in world space, unit length */
+    float tint[4];
+} ImpostorInstance;
+
+/* Impostor.vert.hlsl uniforms */
+typedef struct {
+    Mat4 viewProj;
+    float eye[4];
+    float frames;
+    Uint32 firstInstance;
+    Uint32 padding[2];
+} DrawUniforms;
+
+struct Impostors {
+    SDL_GPUDevice *device;
+    Uint32 meshCount;
+    Uint32 maxInstances;
+    SDL_GPUGraphicsPipeline *bakePipeline;
+    SDL_GPUGraphicsPipeline *drawPipeline;
+    SDL_GPUSampler *sampler;
+    SDL_GPUTexture **atlases;       /* Per mesh */
+    SDL_GPUBuffer *instanceBuffer;
+    SDL_GPUTransferBuffer *instanceTransfer;
+
+    /* This frame's objects in the order added, then grouped by mesh for the upload */
+    ImpostorInstance *instances;
+    Uint32 *instanceMeshes;
+    Uint32 instanceCount;
+    Uint32 *meshFirst;
+    Uint32 *meshInstances;
+};
+
+/* ========================================================================
+ * Frame Directions
+ * ======================================================================== */
+
+static Vec3 Normalize(Vec3 v)
+{
+    float len = SDL_sqrtf(v.x * v.x + v.y * v.y + v.z * v.z);
+    return (Vec3){ v.x / len, v.y / len, v.z / len };
+}
+
+static Vec3 Cross(Vec3 a, Vec3 b)
+{
+    return (Vec3){ a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+}
+
+/* Octahedral mapping of [-1,1]^2 onto the unit sphere; Impostor.vert.hlsl has the same */
+static Vec3 OctahedronDirection(float u, float v)
+{
+    Vec3 n = { u, v, 1.0f - SDL_fabsf(u) - SDL_fabsf(v) };
+    if (n.z < 0.0f) {
+        n.x = (1.0f - SDL_fabsf(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+        n.y = (1.0f - SDL_fabsf(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+    }
+    return Normalize(n);
+}
+
+/* Right and up of the frame seen from dir. No frame center comes within the
+ * switch of the poles, so the shader always picks the same reference. */
+static void FrameBasis(Vec3 dir, Vec3 *right, Vec3 *up)
+{
+    Vec3 reference = SDL_fabsf(dir.y) < 0.999f ? (Vec3){ 0.0f, 1.0f, 0.0f } : (Vec3){ 0.0f, 0.0f, 1.0f };
+    *right = Normalize(Cross(reference, dir));
+    *up = Cross(dir, *right);
+}
+
+/* Orthographic view-projection looking at the origin from dir, covering radius */
+static Mat4 FrameViewProj(Vec3 dir, float radius)
+{
+    Vec3 right, up;
+    FrameBasis(dir, &right, &up);
+    float s = 1.0f / radius;
+    float d = -0.5f / radius;
+    return (Mat4){{
+        right.x * s, up.x * s, dir.x * d, 0,
+        right.y * s, up.y * s, dir.y * d, 0,
+        right.z * s, up.z * s, dir.z * d, 0,
+        0, 0, 0.5f, 1
+    }};
+}
+
+/* ========================================================================
+ * Pipelines
+ * ======================================================================== */
+
+/* The mesh's vertex colors into the atlas, depth tested so concave meshes bake correctly */
+static SDL_GPUGraphicsPipeline *CreateBakePipeline(SDL_GPUDevice *device)
+{
+    SDL_GPUShader *vertShader = Shaders_Load(device, "PositionColorTransform.vert", SDL_GPU_SHADERSTAGE_VERTEX, 0, 1, 0);
+    SDL_GPUShader *fragShader = Shaders_Load(device, "SolidColor.frag", SDL_GPU_SHADERSTAGE_FRAGMENT, 0, 0, 0);
+    SDL_GPUGraphicsPipeline *pipeline = NULL;
+
+    if (vertShader && fragShader) {
+        SDL_GPUGraphicsPipelineCreateInfo pipelineInfo = {
+            .vertex_shader = vertShader,
+            .fragment_shader = fragShader,
+            .target_info = {
+                .num_color_targets = 1,
+                .color_target_descriptions = (SDL_GPUColorTargetDescription[]){{
+                    .format = ATLAS_FORMAT
+                }},
+                .has_depth_stencil_target = true,
+                .depth_stencil_format = SDL_GPU_TEXTUREFORMAT_D16_UNORM
+            },
+            .depth_stencil_state = {
+                .compare_op = SDL_GPU_COMPAREOP_LESS,
+                .enable_depth_test = true,
+                .enable_depth_write = true
+            },
+            .rasterizer_state = {
+                .cull_mode = SDL_GPU_CULLMODE_BACK,
+                .front_face = SDL_GPU_FRONTFACE_COUNTER_CLOCKWISE,
+                .fill_mode = SDL_GPU_FILLMODE_FILL
+            },
+            .vertex_input_state = {
+                .num_vertex_buffers = 1,
+                .vertex_buffer_descriptions = (SDL_GPUVertexBufferDescription[]){{
+                    .slot = 0,
+                    .pitch = sizeof(PositionColorVertex),
+                    .input_rate = SDL_GPU_VERTEXINPUTRATE_VERTEX
+                }},
+                .num_vertex_attributes = 2,
+                .vertex_attributes = (SDL_GPUVertexAttribute[]){{
+                    .location = 0,
+                    .buffer_slot = 0,
+                    .format = SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,
+                    .offset = 0
+                }, {
+                    .location = 1,
+                    .buffer_slot = 0,
+                    .format = SDL_GPU_VERTEXELEMENTFORMAT_UBYTE4_NORM,
+                    .offset = sizeof(float) * 3
+                }}
+            },
+            .primitive_type = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST
+        };
+        pipeline = SDL_CreateGPUGraphicsPipeline(device, &pipelineInfo);
+        if (!pipeline) {
+            SDL_Log("Impostors: failed to create bake pipeline: %s", SDL_GetError());
+        }
+    }
+
+    if (vertShader) SDL_ReleaseGPUShader(device, vertShader);
+    if (fragShader) SDL_ReleaseGPUShader(device, fragShader);
+    return pipeline;
+}
+
+/* Quads built from the vertex index, alpha tested against the atlas; no culling since
+ * the quad faces whichever way its frame does */
+static SDL_GPUGraphicsPipeline *CreateDrawPipeline(SDL_GPUDevice *device, SDL_GPUTextureFormat colorFormat)
+{
+    SDL_GPUShader *vertShader = Shaders_Load(device, "Impostor.vert", SDL_GPU_SHADERSTAGE_VERTEX, 0, 1, 1);
+    SDL_GPUShader *fragShader = Shaders_Load(device, "Impostor.frag", SDL_GPU_SHADERSTAGE_FRAGMENT, 1, 0, 0);
+    SDL_GPUGraphicsPipeline *pipeline = NULL;
+
+    if (vertShader && fragShader) {
+        SDL_GPUGraphicsPipelineCreateInfo pipelineInfo = {
+            .vertex_shader = vertShader,
+            .fragment_shader = fragShader,
+            .target_info = {
+                .num_color_targets = 1,
+                .color_target_descriptions = (SDL_GPUColorTargetDescription[]){{
+                    .format = colorFormat
+                }}
+            },
+            .rasterizer_state = {
+                .cull_mode = SDL_GPU_CULLMODE_NONE,
+                .fill_mode = SDL_GPU_FILLMODE_FILL
+            },
+            .primitive_type = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST
+        };
+        pipeline = SDL_CreateGPUGraphicsPipeline(device, &pipelineInfo);
+        if (!pipeline) {
+            SDL_Log("Impostors: failed to create draw pipeline: %s", SDL_GetError());
+        }
+    }
+
+    if (vertShader) SDL_ReleaseGPUShader(device, vertShader);
+    if (fragShader) SDL_ReleaseGPUShader(device, fragShader);
+    return pipeline;
+}
+
+/* ========================================================================
+ * Public Interface
+ * ======================================================================== */
+
+Impostors *Impostors_Create(SDL_GPUDevice *device, SDL_GPUTextureFormat colorFormat, Uint32 meshCount,
+                            Uint32 maxInstances)
+{
+    Impostors *impostors = SDL_calloc(1, sizeof(Impostors));
+    if (!impostors) return NULL;
+    impostors->device = device;
+    impostors->meshCount = meshCount;
+    impostors->maxInstances = SDL_max(1u, maxInstances);
+
+    impostors->drawPipeline = CreateDrawPipeline(device, colorFormat);
+    impostors->bakePipeline = impostors->drawPipeline ? CreateBakePipeline(device) : NULL;
+    if (!impostors->bakePipeline) {
+        Impostors_Destroy(impostors);
+        return NULL;
+    }
+
+    Uint32 instanceSize = impostors->maxInstances * (Uint32)sizeof(ImpostorInstance);
+    SDL_GPUBufferCreateInfo bufferInfo = { .usage = SDL_GPU_BUFFERUSAGE_GRAPHICS_STORAGE_READ, .size = instanceSize };
+    SDL_GPUTransferBufferCreateInfo transferInfo = { .usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD, .size = instanceSize };
+    SDL_GPUSamplerCreateInfo samplerInfo = {
+        .min_filter = SDL_GPU_FILTER_LINEAR,
+        .mag_filter = SDL_GPU_FILTER_LINEAR,
+        .mipmap_mode = SDL_GPU_SAMPLERMIPMAPMODE_LINEAR,
+        .address_mode_u = SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE,
+        .address_mode_v = SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE,
+        .address_mode_w = SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE
+    };
+    impostors->instanceBuffer = SDL_CreateGPUBuffer(device, &bufferInfo);
+    impostors->instanceTransfer = SDL_CreateGPUTransferBuffer(device, &transferInfo);
+    impostors->sampler = SDL_CreateGPUSampler(device, &samplerInfo);
+    impostors->atlases = SDL_calloc(SDL_max(1u, meshCount), sizeof(SDL_GPUTexture *));
+    impostors->instances = SDL_malloc(impostors->maxInstances * sizeof(ImpostorInstance));
+    impostors->instanceMeshes = SDL_malloc(impostors->maxInstances * sizeof(Uint32));
+    impostors->meshFirst = SDL_calloc(SDL_max(1u, meshCount), sizeof(Uint32));
+    impostors->meshInstances = SDL_calloc(SDL_max(1u, meshCount), sizeof(Uint32));
+    if (!impostors->instanceBuffer || !impostors->instanceTransfer || !impostors->sampler || !impostors->atlases ||
+        !impostors->instances || !impostors->instanceMeshes || !impostors->meshFirst || !impostors->meshInstances) {
+        SDL_Log("Impostors: failed to create resources for %u objects: %s", impostors->maxInstances, SDL_GetError());
+        Impostors_Destroy(impostors);
+        return NULL;
+    }
+    return impostors;
+}
+
+void Impostors_Destroy(Impostors *impostors)
+{
+    if (!impostors) return;
+
+    SDL_GPUDevice *device = impostors->device;
+    if (impostors->bakePipeline) SDL_ReleaseGPUGraphicsPipeline(device, impostors->bakePipeline);
+    if (impostors->drawPipeline) SDL_ReleaseGPUGraphicsPipeline(device, impostors->drawPipeline);
+    if (impostors->sampler) SDL_ReleaseGPUSampler(device, impostors->sampler);
+    for (Uint32 i = 0; i < impostors->meshCount && impostors->atlases; i++) {
+        if (impostors->atlases[i]) SDL_ReleaseGPUTexture(device, impostors->atlases[i]);
+    }
+    if (impostors->instanceBuffer) SDL_ReleaseGPUBuffer(device, impostors->instanceBuffer);
+    if (impostors->instanceTransfer) SDL_ReleaseGPUTransferBuffer(device, impostors->instanceTransfer);
+    SDL_free(impostors->atlases);
+    SDL_free(impostors->instances);
+    SDL_free(impostors->instanceMeshes);
+    SDL_free(impostors->meshFirst);
+    SDL_free(impostors->meshInstances);
+    SDL_free(impostors);
+}
+
+bool Impostors_Bake(Impostors *impostors, Uint32 mesh, SDL_GPUBuffer *vertices, SDL_GPUBuffer *indices,
+                    Uint32 indexCount, float boundRadius)
+{
+    if (mesh >= impostors->meshCount) return false;
+
+    SDL_GPUDevice *device = impostors->device;
+    SDL_GPUTextureCreateInfo atlasInfo = {
+        .type = SDL_GPU_TEXTURETYPE_2D,
+        .format = ATLAS_FORMAT,
+        .usage = SDL_GPU_TEXTUREUSAGE_SAMPLER | SDL_GPU_TEXTUREUSAGE_COLOR_TARGET,
+        .width = ATLAS_SIZE,
+        .height = ATLAS_SIZE,
+        .layer_count_or_depth = 1,
+        .num_levels = ATLAS_MIP_LEVELS
+    };
+    SDL_GPUTextureCreateInfo depthInfo = {
+        .type = SDL_GPU_TEXTURETYPE_2D,
+        .format = SDL_GPU_TEXTUREFORMAT_D16_UNORM,
+        .usage = SDL_GPU_TEXTUREUSAGE_DEPTH_STENCIL_TARGET,
+        .width = ATLAS_SIZE,
+        .height = ATLAS_SIZE,
+        .layer_count_or_depth = 1,
+        .num_levels = 1
+    };
+    SDL_GPUTexture *atlas = SDL_CreateGPUTexture(device, &atlasInfo);
+    SDL_GPUTexture *depth = SDL_CreateGPUTexture(device, &depthInfo);
+    SDL_GPUCommandBuffer *cmdBuf = atlas && depth ? SDL_AcquireGPUCommandBuffer(device) : NULL;
+    if (!cmdBuf) {
+        SDL_Log("Impostors: failed to create atlas for mesh %u: %s", mesh, SDL_GetError());
+        if (atlas) SDL_ReleaseGPUTexture(device, atlas);
+        if (depth) SDL_ReleaseGPUTexture(device, depth);
+        return false;
+    }
+
+    /* Transparent where the mesh is not, so the draw can alpha test */
+    SDL_GPUColorTargetInfo colorTarget = {
+        .texture = atlas,
+        .load_op = SDL_GPU_LOADOP_CLEAR,
+        .store_op = SDL_GPU_STOREOP_STORE
+    };
+    SDL_GPUDepthStencilTargetInfo depthTarget = {
+        .texture = depth,
+        .clear_depth = 1.0f,
+        .load_op = SDL_GPU_LOADOP_CLEAR,
+        .store_op = SDL_GPU_STOREOP_DONT_CARE,
+        .stencil_load_op = SDL_GPU_LOADOP_DONT_CARE,
+        .stencil_store_op = SDL_GPU_STOREOP_DONT_CARE
+    };
+    SDL_GPURenderPass *renderPass = SDL_BeginGPURenderPass(cmdBuf, &colorTarget, 1, &depthTarget);
+    SDL_BindGPUGraphicsPipeline(renderPass, impostors->bakePipeline);
+    SDL_GPUBufferBinding vertexBinding = { vertices, 0 };
+    SDL_BindGPUVertexBuffers(renderPass, 0, &vertexBinding, 1);
+    SDL_GPUBufferBinding indexBinding = { indices, 0 };
+    SDL_BindGPUIndexBuffer(renderPass, &indexBinding, SDL_GPU_INDEXELEMENTSIZE_32BIT);
+
+    /* Frame (x, y) looks from the direction at its center in the octahedral square */
+    for (Uint32 y = 0; y < IMPOSTOR_FRAMES; y++) {
+        for (Uint32 x = 0; x < IMPOSTOR_FRAMES; x++) {
+            float u = ((float)x + 0.5f) / IMPOSTOR_FRAMES * 2.0f - 1.0f;
+            float v = ((float)y + 0.5f) / IMPOSTOR_FRAMES * 2.0f - 1.0f;
+            Mat4 viewProj = FrameViewProj(OctahedronDirection(u, v), boundRadius * FRAME_MARGIN);
+
+            SDL_GPUViewport viewport = {
+                (float)(x * IMPOSTOR_FRAME_SIZE), (float)(y * IMPOSTOR_FRAME_SIZE),
+                IMPOSTOR_FRAME_SIZE, IMPOSTOR_FRAME_SIZE, 0, 1
+            };
+            SDL_Rect scissor = {
+                (int)(x * IMPOSTOR_FRAME_SIZE), (int)(y * IMPOSTOR_FRAME_SIZE), IMPOSTOR_FRAME_SIZE, IMPOSTOR_FRAME_SIZE
+            };
+            SDL_SetGPUViewport(renderPass, &viewport);
+            SDL_SetGPUScissor(renderPass, &scissor);
+            SDL_PushGPUVertexUniformData(cmdBuf, 0, &viewProj, sizeof(viewProj));
+            SDL_DrawGPUIndexedPrimitives(renderPass, indexCount, 1, 0, 0, 0);
+        }
+    }
+    SDL_EndGPURenderPass(renderPass);
+    SDL_GenerateMipmapsForGPUTexture(cmdBuf, atlas);
+
+    /* Released now; the device keeps the depth target alive until the bake has run */
+    SDL_ReleaseGPUTexture(device, depth);
+    if (!SDL_SubmitGPUCommandBuffer(cmdBuf)) {
+        SDL_Log("Impostors: failed to submit bake of mesh %u: %s", mesh, SDL_GetError());
+        SDL_ReleaseGPUTexture(device, atlas);
+        return false;
+    }
+
+    if (impostors->atlases[mesh]) SDL_ReleaseGPUTexture(device, impostors->atlases[mesh]);
+    impostors->atlases[mesh] = atlas;
+    SDL_Log("Impostors: baked mesh %u into %d frames (%dx%d atlas)", mesh, IMPOSTOR_FRAMES * IMPOSTOR_FRAMES,
+            ATLAS_SIZE, ATLAS_SIZE);
+    return true;
+}
+
+void Impostors_Clear(Impostors *impostors)
+{
+    impostors->instanceCount = 0;
+}
+
+void Impostors_Add(Impostors *impostors, Uint32 mesh, const Mat4 *model, Vec3 center, float radius,
+                   const float tint[4])
+{
+    if (impostors->instanceCount >= impostors->maxInstances || mesh >= impostors->meshCount) return;
+
+    ImpostorInstance *instance = &impostors->instances[impostors->instanceCount];
+    instance->centerRadius[0] = center.x;
+    instance->centerRadius[1] = center.y;
+    instance->centerRadius[2] = center.z;
+    instance->centerRadius[3] = radius * FRAME_MARGIN;
+
+    /* Row-vector models: rows 0-2 are the object's axes, scaled */
+    for (int axis = 0; axis < 3; axis++) {
+        const float *row = &model->m[axis * 4];
+        Vec3 direction = Normalize((Vec3){ row[0], row[1], row[2] });
+        instance->axes[axis][0] = direction.x;
+        instance->axes[axis][1] = direction.y;
+        instance->axes[axis][2] = direction.z;
+        instance->axes[axis][3] = 0.0f;
+    }
+    SDL_memcpy(instance->tint, tint, sizeof(instance->tint));
+    impostors->instanceMeshes[impostors->instanceCount++] = mesh;
+}
+
+void Impostors_Upload(Impostors *impostors, SDL_GPUCommandBuffer *cmdBuf)
+{
+    SDL_memset(impostors->meshInstances, 0, impostors->meshCount * sizeof(Uint32));
+    if (impostors->instanceCount == 0) return;
+
+    /* Counting sort by mesh, so each mesh's impostors are one contiguous range */
+    for (Uint32 i = 0; i < impostors->instanceCount; i++) {
+        impostors->meshInstances[impostors->instanceMeshes[i]]++;
+    }
+    Uint32 first = 0;
+    for (Uint32 i = 0; i < impostors->meshCount; i++) {
+        impostors->meshFirst[i] = first;
+        first += impostors->meshInstances[i];
+    }
+
+    /* Cycled so the previous frame's draws can still read their copy */
+    ImpostorInstance *data = SDL_MapGPUTransferBuffer(impostors->device, impostors->instanceTransfer, true);
+    SDL_memset(impostors->meshInstances, 0, impostors->meshCount * sizeof(Uint32));
+    if (!data) return;
+
+    /* meshInstances counts back up as each range fills */
+    for (Uint32 i = 0; i < impostors->instanceCount; i++) {
+        Uint32 mesh = impostors->instanceMeshes[i];
+        data[impostors->meshFirst[mesh] + impostors->meshInstances[mesh]++] = impostors->instances[i];
+    }
+    SDL_UnmapGPUTransferBuffer(impostors->device, impostors->instanceTransfer);
+
+    SDL_GPUCopyPass *copyPass = SDL_BeginGPUCopyPass(cmdBuf);
+    SDL_GPUTransferBufferLocation src = { .transfer_buffer = impostors->instanceTransfer };
+    SDL_GPUBufferRegion dst = {
+        .buffer = impostors->instanceBuffer,
+        .size = impostors->instanceCount * (Uint32)sizeof(ImpostorInstance)
+    };
+    SDL_UploadToGPUBuffer(copyPass, &src, &dst, true);
+    SDL_EndGPUCopyPass(copyPass);
+}
+
+Uint32 Impostors_Count(const Impostors *impostors)
+{
+    return impostors->instanceCount;
+}
+
+void Impostors_Draw(Impostors *impostors, SDL_GPUCommandBuffer *cmdBuf, SDL_GPURenderPass *renderPass,
+                    const Mat4 *viewProj, Vec3 eye, BenchRenderStats *stats)
+{
+    bool bound = false;
+    for (Uint32 mesh = 0; mesh < impostors->meshCount; mesh++) {
+        Uint32 count = impostors->meshInstances[mesh];
+        if (count == 0 || !impostors->atlases[mesh]) continue;
+
+        if (!bound) {
+            SDL_BindGPUGraphicsPipeline(renderPass, impostors->drawPipeline);
+            SDL_BindGPUVertexStorageBuffers(renderPass, 0, &impostors->instanceBuffer, 1);
+            bound = true;
+            if (stats) stats->pipelineBinds++;
+        }
+        SDL_GPUTextureSamplerBinding atlasBinding = { impostors->atlases[mesh], impostors->sampler };
+        SDL_BindGPUFragmentSamplers(renderPass, 0, &atlasBinding, 1);
+
+        /* SV_InstanceID does not include the first instance on every backend, so it is passed here */
+        DrawUniforms uniforms = {
+            *viewProj, { eye.x, eye.y, eye.z, 1.0f }, (float)IMPOSTOR_FRAMES, impostors->meshFirst[mesh], { 0, 0 }
+        };
+        SDL_PushGPUVertexUniformData(cmdBuf, 0, &uniforms, sizeof(uniforms));
+        SDL_DrawGPUPrimitives(renderPass, 6, count, 0, 0);
+        if (stats) {
+            stats->drawCalls++;
+            stats->triangles += (Uint64)count * 2;
+        }
+    }
+}
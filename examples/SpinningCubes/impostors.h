@@ -0,0 +1,55 @@
+/*
+ * Octahedral impostors
+ *
+ * Each mesh is rendered once, at load time, from IMPOSTOR_FRAMES x
+ * IMPOSTOR_FRAMES directions spread over the whole sphere by an octahedral
+ * mapping, one frame of an atlas texture per direction. A far object is then
+ * drawn as a single quad: the vertex shader turns the direction from the eye
+ * to the object into the object's own space, picks the baked frame nearest
+ * to it and orients the quad to match that frame. Each eye picks its frame
+ * from its own position, so the two eyes get the slightly different views
+ * the mesh itself would give them.
+ *
+ * All impostors of one mesh are one instanced draw reading per-object data
+ * from a storage buffer that Impostors_Upload fills once per frame. The
+ * nearest frame is used without blending, so a turning object steps between
+ * views. The draws sample a texture, so like the overdraw view they are not
+ * part of command stream captures.
+ */
+
+#ifndef IMPOSTORS_H
+#define IMPOSTORS_H
+
+#include <SDL3/SDL.h>
+
+#include "bench.h"
+#include "vecmath.h"
+
+#define IMPOSTOR_FRAMES 16          /* Per atlas side */
+#define IMPOSTOR_FRAME_SIZE 64      /* Pixels per frame side */
+
+typedef struct Impostors Impostors;
+
+/* Impostors render into colorFormat; up to maxInstances per frame across meshCount meshes */
+Impostors *Impostors_Create(SDL_GPUDevice *device, SDL_GPUTextureFormat colorFormat, Uint32 meshCount,
+                            Uint32 maxInstances);
+void Impostors_Destroy(Impostors *impostors);
+
+/* Renders the atlas of one mesh (PositionColorVertex, 32-bit indices) in its own submission */
+bool Impostors_Bake(Impostors *impostors, Uint32 mesh, SDL_GPUBuffer *vertices, SDL_GPUBuffer *indices,
+                    Uint32 indexCount, float boundRadius);
+
+/* Per frame: clear, add every object to draw as an impostor, then upload outside any pass.
+ * radius is the object's bounding radius and tint multiplies the atlas color. */
+void Impostors_Clear(Impostors *impostors);
+void Impostors_Add(Impostors *impostors, Uint32 mesh, const Mat4 *model, Vec3 center, float radius,
+                   const float tint[4]);
+void Impostors_Upload(Impostors *impostors, SDL_GPUCommandBuffer *cmdBuf);
+Uint32 Impostors_Count(const Impostors *impostors);
+
+/* Records this frame's impostors, as seen from eye, into an open render pass.
+ * stats, when not NULL, accumulates what was recorded. */
+void Impostors_Draw(Impostors *impostors, SDL_GPUCommandBuffer *cmdBuf, SDL_GPURenderPass *renderPass,
+                    const Mat4 *viewProj, Vec3 eye, BenchRenderStats *stats);
+
+#endif /* IMPOSTORS_H */
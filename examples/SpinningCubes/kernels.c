@@ -0,0 +1,497 @@
+/*
+ * CPU-side renderer kernels - see kernels.h
+ *
+ * Each instruction set has its own section whose functions are compiled
+ * for it with SDL_TARGETING, so the binary itself only assumes the
+ * platform baseline; the dispatch section at the end only hands out a
+ * table after SDL's CPU feature check for it has passed.
+ */
+
+#include "kernels.h"
+
+/* ========================================================================
+ * Scalar Reference
+ * ======================================================================== */
+
+static void MultiplyMat4Scalar(const Mat4 *a, const Mat4 *b, Mat4 *out)
+{
+    *out = Mat4_Multiply(*a, *b);
+}
+
+void Kernels_TransformBatchScalar(const Mat4 *models, const Mat4 *viewProj, Mat4 *out, Uint32 count)
+{
+    for (Uint32 i = 0; i < count; i++) {
+        out[i] = Mat4_Multiply(models[i], *viewProj);
+    }
+}
+
+Uint32 Kernels_CullSpheresScalar(const Frustum *frustum, const Sphere *spheres, Uint8 *visible, Uint32 count)
+{
+    Uint32 visibleCount = 0;
+    for (Uint32 i = 0; i < count; i++) {
+        const Sphere *s = &spheres[i];
+        bool inside = true;
+        for (int plane = 0; plane < 6 && inside; plane++) {
+            const float *p = frustum->planes[plane];
+            inside = p[0] * s->x + p[1] * s->y + p[2] * s->z + p[3] >= -s->radius;
+        }
+        visible[i] = inside;
+        visibleCount += inside;
+    }
+    return visibleCount;
+}
+
+void Kernels_EncodeInstancesScalar(const Mat4 *models, InstanceData *out, Uint32 count)
+{
+    for (Uint32 i = 0; i < count; i++) {
+        const float *m = models[i].m;
+        for (int row = 0; row < 3; row++) {
+            out[i].rows[row][0] = m[row];
+            out[i].rows[row][1] = m[4 + row];
+            out[i].rows[row][2] = m[8 + row];
+            out[i].rows[row][3] = m[12 + row];
+        }
+    }
+}
+
+/* ========================================================================
+ * Draw Key Sort
+ * ======================================================================== */
+
+void Kernels_SortKeys(Uint64 *keys, Uint64 *scratch, Uint32 count)
+{
+    /* All eight histograms in one read; passes whose byte is the same for every key are skipped */
+    Uint32 histograms[8][256] = {{0}};
+    for (Uint32 i = 0; i < count; i++) {
+        Uint64 key = keys[i];
+        for (int pass = 0; pass < 8; pass++) {
+            histograms[pass][(key >> (pass * 8)) & 0xff]++;
+        }
+    }
+
+    Uint64 *src = keys, *dst = scratch;
+    for (int pass = 0; pass < 8; pass++) {
+        Uint32 *histogram = histograms[pass];
+        if (count == 0 || histogram[(src[0] >> (pass * 8)) & 0xff] == count) continue;
+
+        Uint32 offset = 0;
+        for (int bucket = 0; bucket < 256; bucket++) {
+            Uint32 n = histogram[bucket];
+            histogram[bucket] = offset;
+            offset += n;
+        }
+        for (Uint32 i = 0; i < count; i++) {
+            dst[histogram[(src[i] >> (pass * 8)) & 0xff]++] = src[i];
+        }
+
+        Uint64 *swap = src;
+        src = dst;
+        dst = swap;
+    }
+    if (src != keys) {
+        SDL_memcpy(keys, src, count * sizeof(Uint64));
+    }
+}
+
+/* ========================================================================
+ * SSE2
+ * ======================================================================== */
+
+#if defined(SDL_SSE2_INTRINSICS)
+
+static inline __m128 SDL_TARGETING("sse2") MultiplyRowSSE2(const float *row, __m128 b0, __m128 b1, __m128 b2, __m128 b3)
+{
+    __m128 r = _mm_mul_ps(_mm_set1_ps(row[0]), b0);
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(row[1]), b1));
+    r = _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(row[2]), b2));
+    return _mm_add_ps(r, _mm_mul_ps(_mm_set1_ps(row[3]), b3));
+}
+
+static void SDL_TARGETING("sse2") MultiplyMat4SSE2(const Mat4 *a, const Mat4 *b, Mat4 *out)
+{
+    __m128 b0 = _mm_loadu_ps(&b->m[0]), b1 = _mm_loadu_ps(&b->m[4]);
+    __m128 b2 = _mm_loadu_ps(&b->m[8]), b3 = _mm_loadu_ps(&b->m[12]);
+    for (int i = 0; i < 4; i++) {
+        _mm_storeu_ps(&out->m[i * 4], MultiplyRowSSE2(&a->m[i * 4], b0, b1, b2, b3));
+    }
+}
+
+static void SDL_TARGETING("sse2") TransformBatchSSE2(const Mat4 *models, const Mat4 *viewProj, Mat4 *out, Uint32 count)
+{
+    __m128 b0 = _mm_loadu_ps(&viewProj->m[0]), b1 = _mm_loadu_ps(&viewProj->m[4]);
+    __m128 b2 = _mm_loadu_ps(&viewProj->m[8]), b3 = _mm_loadu_ps(&viewProj->m[12]);
+    for (Uint32 i = 0; i < count; i++) {
+        for (int row = 0; row < 4; row++) {
+            _mm_storeu_ps(&out[i].m[row * 4], MultiplyRowSSE2(&models[i].m[row * 4], b0, b1, b2, b3));
+        }
+    }
+}
+
+/* Four spheres per iteration, transposed so each lane holds one sphere */
+static Uint32 SDL_TARGETING("sse2") CullSpheresSSE2(const Frustum *frustum, const Sphere *spheres, Uint8 *visible, Uint32 count)
+{
+    Uint32 i = 0, visibleCount = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 x = _mm_loadu_ps(&spheres[i].x), y = _mm_loadu_ps(&spheres[i + 1].x);
+        __m128 z = _mm_loadu_ps(&spheres[i + 2].x), r = _mm_loadu_ps(&spheres[i + 3].x);
+        _MM_TRANSPOSE4_PS(x, y, z, r);
+        __m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), r);
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (int plane = 0; plane < 6; plane++) {
+            const float *p = frustum->planes[plane];
+            __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(p[0]), x), _mm_mul_ps(_mm_set1_ps(p[1]), y)),
+                                  _mm_add_ps(_mm_mul_ps(_mm_set1_ps(p[2]), z), _mm_set1_ps(p[3])));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(d, negRadius));
+        }
+        int mask = _mm_movemask_ps(inside);
+        for (int lane = 0; lane < 4; lane++) {
+            visible[i + lane] = (mask >> lane) & 1;
+            visibleCount += (mask >> lane) & 1;
+        }
+    }
+    return visibleCount + Kernels_CullSpheresScalar(frustum, spheres + i, visible + i, count - i);
+}
+
+static void SDL_TARGETING("sse2") EncodeInstancesSSE2(const Mat4 *models, InstanceData *out, Uint32 count)
+{
+    for (Uint32 i = 0; i < count; i++) {
+        const float *m = models[i].m;
+        __m128 r0 = _mm_loadu_ps(&m[0]), r1 = _mm_loadu_ps(&m[4]);
+        __m128 r2 = _mm_loadu_ps(&m[8]), r3 = _mm_loadu_ps(&m[12]);
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+        _mm_storeu_ps(out[i].rows[0], r0);
+        _mm_storeu_ps(out[i].rows[1], r1);
+        _mm_storeu_ps(out[i].rows[2], r2);
+    }
+}
+
+static const KernelTable sse2Kernels = {
+    "sse2", MultiplyMat4SSE2, TransformBatchSSE2, CullSpheresSSE2, EncodeInstancesSSE2
+};
+
+#endif /* SDL_SSE2_INTRINSICS */
+
+/* ========================================================================
+ * AVX2
+ * ======================================================================== */
+
+#if defined(SDL_AVX2_INTRINSICS)
+
+/* Two rows at once, one per 128-bit lane; the same operations in the same order as SSE2 */
+static inline __m256 SDL_TARGETING("avx2") MultiplyRowsAVX2(__m256 rows, __m256 b0, __m256 b1, __m256 b2, __m256 b3)
+{
+    __m256 r = _mm256_mul_ps(_mm256_permute_ps(rows, 0x00), b0);
+    r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_permute_ps(rows, 0x55), b1));
+    r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_permute_ps(rows, 0xaa), b2));
+    return _mm256_add_ps(r, _mm256_mul_ps(_mm256_permute_ps(rows, 0xff), b3));
+}
+
+static void SDL_TARGETING("avx2") MultiplyMat4AVX2(const Mat4 *a, const Mat4 *b, Mat4 *out)
+{
+    __m256 b0 = _mm256_broadcast_ps((const __m128 *)&b->m[0]), b1 = _mm256_broadcast_ps((const __m128 *)&b->m[4]);
+    __m256 b2 = _mm256_broadcast_ps((const __m128 *)&b->m[8]), b3 = _mm256_broadcast_ps((const __m128 *)&b->m[12]);
+    _mm256_storeu_ps(&out->m[0], MultiplyRowsAVX2(_mm256_loadu_ps(&a->m[0]), b0, b1, b2, b3));
+    _mm256_storeu_ps(&out->m[8], MultiplyRowsAVX2(_mm256_loadu_ps(&a->m[8]), b0, b1, b2, b3));
+}
+
+static void SDL_TARGETING("avx2") TransformBatchAVX2(const Mat4 *models, const Mat4 *viewProj, Mat4 *out, Uint32 count)
+{
+    __m256 b0 = _mm256_broadcast_ps((const __m128 *)&viewProj->m[0]);
+    __m256 b1 = _mm256_broadcast_ps((const __m128 *)&viewProj->m[4]);
+    __m256 b2 = _mm256_broadcast_ps((const __m128 *)&viewProj->m[8]);
+    __m256 b3 = _mm256_broadcast_ps((const __m128 *)&viewProj->m[12]);
+    for (Uint32 i = 0; i < count; i++) {
+        _mm256_storeu_ps(&out[i].m[0], MultiplyRowsAVX2(_mm256_loadu_ps(&models[i].m[0]), b0, b1, b2, b3));
+        _mm256_storeu_ps(&out[i].m[8], MultiplyRowsAVX2(_mm256_loadu_ps(&models[i].m[8]), b0, b1, b2, b3));
+    }
+}
+
+/* Eight spheres per iteration: sphere j in the low lane and j + 4 in the high lane, then transposed within each lane */
+static Uint32 SDL_TARGETING("avx2") CullSpheresAVX2(const Frustum *frustum, const Sphere *spheres, Uint8 *visible, Uint32 count)
+{
+    Uint32 i = 0, visibleCount = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 s[4];
+        for (int j = 0; j < 4; j++) {
+            s[j] = _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(&spheres[i + j].x)),
+                                        _mm_loadu_ps(&spheres[i + j + 4].x), 1);
+        }
+        __m256 t0 = _mm256_unpacklo_ps(s[0], s[1]), t1 = _mm256_unpackhi_ps(s[0], s[1]);
+        __m256 t2 = _mm256_unpacklo_ps(s[2], s[3]), t3 = _mm256_unpackhi_ps(s[2], s[3]);
+        __m256 x = _mm256_shuffle_ps(t0, t2, 0x44), y = _mm256_shuffle_ps(t0, t2, 0xee);
+        __m256 z = _mm256_shuffle_ps(t1, t3, 0x44), r = _mm256_shuffle_ps(t1, t3, 0xee);
+
+        __m256 negRadius = _mm256_sub_ps(_mm256_setzero_ps(), r);
+        __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+        for (int plane = 0; plane < 6; plane++) {
+            const float *p = frustum->planes[plane];
+            __m256 d = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(p[0]), x), _mm256_mul_ps(_mm256_set1_ps(p[1]), y)),
+                                     _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(p[2]), z), _mm256_set1_ps(p[3])));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(d, negRadius, _CMP_GE_OQ));
+        }
+        int mask = _mm256_movemask_ps(inside);
+        for (int lane = 0; lane < 8; lane++) {
+            visible[i + lane] = (mask >> lane) & 1;
+            visibleCount += (mask >> lane) & 1;
+        }
+    }
+    return visibleCount + Kernels_CullSpheresScalar(frustum, spheres + i, visible + i, count - i);
+}
+
+/* Interleaving rows 0-1 with rows 2-3 leaves each output row's elements one permute away */
+static void SDL_TARGETING("avx2") EncodeInstancesAVX2(const Mat4 *models, InstanceData *out, Uint32 count)
+{
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    for (Uint32 i = 0; i < count; i++) {
+        __m256 rows01 = _mm256_loadu_ps(&models[i].m[0]), rows23 = _mm256_loadu_ps(&models[i].m[8]);
+        __m256 lo = _mm256_permutevar8x32_ps(_mm256_unpacklo_ps(rows01, rows23), order);
+        __m256 hi = _mm256_permutevar8x32_ps(_mm256_unpackhi_ps(rows01, rows23), order);
+        _mm256_storeu_ps(out[i].rows[0], lo);
+        _mm_storeu_ps(out[i].rows[2], _mm256_castps256_ps128(hi));
+    }
+}
+
+static const KernelTable avx2Kernels = {
+    "avx2", MultiplyMat4AVX2, TransformBatchAVX2, CullSpheresAVX2, EncodeInstancesAVX2
+};
+
+#endif /* SDL_AVX2_INTRINSICS */
+
+/* ========================================================================
+ * AVX-512
+ * ======================================================================== */
+
+#if defined(SDL_AVX512F_INTRINSICS)
+
+/* The whole matrix at once, one row per 128-bit lane */
+static inline __m512 SDL_TARGETING("avx512f") MultiplyRowsAVX512(__m512 rows, __m512 b0, __m512 b1, __m512 b2, __m512 b3)
+{
+    __m512 r = _mm512_mul_ps(_mm512_permute_ps(rows, 0x00), b0);
+    r = _mm512_add_ps(r, _mm512_mul_ps(_mm512_permute_ps(rows, 0x55), b1));
+    r = _mm512_add_ps(r, _mm512_mul_ps(_mm512_permute_ps(rows, 0xaa), b2));
+    return _mm512_add_ps(r, _mm512_mul_ps(_mm512_permute_ps(rows, 0xff), b3));
+}
+
+static void SDL_TARGETING("avx512f") MultiplyMat4AVX512(const Mat4 *a, const Mat4 *b, Mat4 *out)
+{
+    __m512 b0 = _mm512_broadcast_f32x4(_mm_loadu_ps(&b->m[0])), b1 = _mm512_broadcast_f32x4(_mm_loadu_ps(&b->m[4]));
+    __m512 b2 = _mm512_broadcast_f32x4(_mm_loadu_ps(&b->m[8])), b3 = _mm512_broadcast_f32x4(_mm_loadu_ps(&b->m[12]));
+    _mm512_storeu_ps(out->m, MultiplyRowsAVX512(_mm512_loadu_ps(a->m), b0, b1, b2, b3));
+}
+
+static void SDL_TARGETING("avx512f") TransformBatchAVX512(const Mat4 *models, const Mat4 *viewProj, Mat4 *out, Uint32 count)
+{
+    __m512 b0 = _mm512_broadcast_f32x4(_mm_loadu_ps(&viewProj->m[0]));
+    __m512 b1 = _mm512_broadcast_f32x4(_mm_loadu_ps(&viewProj->m[4]));
+    __m512 b2 = _mm512_broadcast_f32x4(_mm_loadu_ps(&viewProj->m[8]));
+    __m512 b3 = _mm512_broadcast_f32x4(_mm_loadu_ps(&viewProj->m[12]));
+    for (Uint32 i = 0; i < count; i++) {
+        _mm512_storeu_ps(out[i].m, MultiplyRowsAVX512(_mm512_loadu_ps(models[i].m), b0, b1, b2, b3));
+    }
+}
+
+/*
+ * Sixteen spheres per iteration, loaded four to a register and transposed
+ * within each lane, so element 4 * lane + j holds sphere 4 * j + lane.
+ */
+static Uint32 SDL_TARGETING("avx512f") CullSpheresAVX512(const Frustum *frustum, const Sphere *spheres, Uint8 *visible, Uint32 count)
+{
+    Uint32 i = 0, visibleCount = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m512 s0 = _mm512_loadu_ps(&spheres[i].x), s1 = _mm512_loadu_ps(&spheres[i + 4].x);
+        __m512 s2 = _mm512_loadu_ps(&spheres[i + 8].x), s3 = _mm512_loadu_ps(&spheres[i + 12].x);
+        __m512 t0 = _mm512_unpacklo_ps(s0, s1), t1 = _mm512_unpackhi_ps(s0, s1);
+        __m512 t2 = _mm512_unpacklo_ps(s2, s3), t3 = _mm512_unpackhi_ps(s2, s3);
+        __m512 x = _mm512_shuffle_ps(t0, t2, 0x44), y = _mm512_shuffle_ps(t0, t2, 0xee);
+        __m512 z = _mm512_shuffle_ps(t1, t3, 0x44), r = _mm512_shuffle_ps(t1, t3, 0xee);
+
+        __m512 negRadius = _mm512_sub_ps(_mm512_setzero_ps(), r);
+        __mmask16 inside = 0xffff;
+        for (int plane = 0; plane < 6; plane++) {
+            const float *p = frustum->planes[plane];
+            __m512 d = _mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(_mm512_set1_ps(p[0]), x), _mm512_mul_ps(_mm512_set1_ps(p[1]), y)),
+                                     _mm512_add_ps(_mm512_mul_ps(_mm512_set1_ps(p[2]), z), _mm512_set1_ps(p[3])));
+            inside = _mm512_mask_cmp_ps_mask(inside, d, negRadius, _CMP_GE_OQ);
+        }
+        for (int element = 0; element < 16; element++) {
+            Uint8 bit = (inside >> element) & 1;
+            visible[i + ((element & 3) << 2 | element >> 2)] = bit;
+            visibleCount += bit;
+        }
+    }
+    return visibleCount + Kernels_CullSpheresScalar(frustum, spheres + i, visible + i, count - i);
+}
+
+/* A matrix fits one register, so encoding is one permute and a masked store of the first three rows */
+static void SDL_TARGETING("avx512f") EncodeInstancesAVX512(const Mat4 *models, InstanceData *out, Uint32 count)
+{
+    const __m512i transpose = _mm512_setr_epi32(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+    for (Uint32 i = 0; i < count; i++) {
+        __m512 rows = _mm512_permutexvar_ps(transpose, _mm512_loadu_ps(models[i].m));
+        _mm512_mask_storeu_ps(out[i].rows[0], 0x0fff, rows);
+    }
+}
+
+static const KernelTable avx512Kernels = {
+    "avx512", MultiplyMat4AVX512, TransformBatchAVX512, CullSpheresAVX512, EncodeInstancesAVX512
+};
+
+#endif /* SDL_AVX512F_INTRINSICS */
+
+/* ========================================================================
+ * NEON
+ * ======================================================================== */
+
+#if defined(SDL_NEON_INTRINSICS)
+
+static inline float32x4_t MultiplyRowNEON(const float *row, float32x4_t b0, float32x4_t b1, float32x4_t b2, float32x4_t b3)
+{
+    float32x4_t r = vmulq_n_f32(b0, row[0]);
+    r = vmlaq_n_f32(r, b1, row[1]);
+    r = vmlaq_n_f32(r, b2, row[2]);
+    return vmlaq_n_f32(r, b3, row[3]);
+}
+
+static void MultiplyMat4NEON(const Mat4 *a, const Mat4 *b, Mat4 *out)
+{
+    float32x4_t b0 = vld1q_f32(&b->m[0]), b1 = vld1q_f32(&b->m[4]);
+    float32x4_t b2 = vld1q_f32(&b->m[8]), b3 = vld1q_f32(&b->m[12]);
+    for (int i = 0; i < 4; i++) {
+        vst1q_f32(&out->m[i * 4], MultiplyRowNEON(&a->m[i * 4], b0, b1, b2, b3));
+    }
+}
+
+static void TransformBatchNEON(const Mat4 *models, const Mat4 *viewProj, Mat4 *out, Uint32 count)
+{
+    float32x4_t b0 = vld1q_f32(&viewProj->m[0]), b1 = vld1q_f32(&viewProj->m[4]);
+    float32x4_t b2 = vld1q_f32(&viewProj->m[8]), b3 = vld1q_f32(&viewProj->m[12]);
+    for (Uint32 i = 0; i < count; i++) {
+        for (int row = 0; row < 4; row++) {
+            vst1q_f32(&out[i].m[row * 4], MultiplyRowNEON(&models[i].m[row * 4], b0, b1, b2, b3));
+        }
+    }
+}
+
+/* Four spheres per iteration; vld4q de-interleaves them so each lane holds one sphere */
+static Uint32 CullSpheresNEON(const Frustum *frustum, const Sphere *spheres, Uint8 *visible, Uint32 count)
+{
+    Uint32 i = 0, visibleCount = 0;
+    for (; i + 4 <= count; i += 4) {
+        float32x4x4_t s = vld4q_f32(&spheres[i].x);
+        float32x4_t negRadius = vnegq_f32(s.val[3]);
+        uint32x4_t inside = vdupq_n_u32(~0u);
+        for (int plane = 0; plane < 6; plane++) {
+            const float *p = frustum->planes[plane];
+            float32x4_t d = vmlaq_n_f32(vdupq_n_f32(p[3]), s.val[0], p[0]);
+            d = vmlaq_n_f32(d, s.val[1], p[1]);
+            d = vmlaq_n_f32(d, s.val[2], p[2]);
+            inside = vandq_u32(inside, vcgeq_f32(d, negRadius));
+        }
+        Uint32 lanes[4];
+        vst1q_u32(lanes, vshrq_n_u32(inside, 31));
+        for (int lane = 0; lane < 4; lane++) {
+            visible[i + lane] = (Uint8)lanes[lane];
+            visibleCount += lanes[lane];
+        }
+    }
+    return visibleCount + Kernels_CullSpheresScalar(frustum, spheres + i, visible + i, count - i);
+}
+
+static void EncodeInstancesNEON(const Mat4 *models, InstanceData *out, Uint32 count)
+{
+    for (Uint32 i = 0; i < count; i++) {
+        float32x4x4_t columns = vld4q_f32(models[i].m);
+        vst1q_f32(out[i].rows[0], columns.val[0]);
+        vst1q_f32(out[i].rows[1], columns.val[1]);
+        vst1q_f32(out[i].rows[2], columns.val[2]);
+    }
+}
+
+static const KernelTable neonKernels = {
+    "neon", MultiplyMat4NEON, TransformBatchNEON, CullSpheresNEON, EncodeInstancesNEON
+};
+
+#endif /* SDL_NEON_INTRINSICS */
+
+/* ========================================================================
+ * Dispatch
+ * ======================================================================== */
+
+static const KernelTable scalarKernels = {
+    "scalar", MultiplyMat4Scalar, Kernels_TransformBatchScalar, Kernels_CullSpheresScalar, Kernels_EncodeInstancesScalar
+};
+
+static bool SDLCALL AlwaysSupported(void)
+{
+    return true;
+}
+
+/* Slowest first; each table is only used when SDL reports its instruction set (and the OS state it needs) */
+static const struct {
+    const KernelTable *table;
+    bool (SDLCALL *supported)(void);
+} candidates[] = {
+    { &scalarKernels, AlwaysSupported },
+#if defined(SDL_SSE2_INTRINSICS)
+    { &sse2Kernels, SDL_HasSSE2 },
+#endif
+#if defined(SDL_AVX2_INTRINSICS)
+    { &avx2Kernels, SDL_HasAVX2 },
+#endif
+#if defined(SDL_AVX512F_INTRINSICS)
+    { &avx512Kernels, SDL_HasAVX512F },
+#endif
+#if defined(SDL_NEON_INTRINSICS)
+    { &neonKernels, SDL_HasNEON },
+#endif
+};
+
+static void *activeKernels = NULL;
+
+Uint32 Kernels_SupportedTables(const KernelTable **tables, Uint32 maxTables)
+{
+    Uint32 count = 0;
+    for (size_t i = 0; i < SDL_arraysize(candidates) && count < maxTables; i++) {
+        if (candidates[i].supported()) {
+            tables[count++] = candidates[i].table;
+        }
+    }
+    return count;
+}
+
+const KernelTable *Kernels_Active(void)
+{
+    /* Threads racing through the first call all pick the same table */
+    const KernelTable *active = SDL_GetAtomicPointer(&activeKernels);
+    if (!active) {
+        const KernelTable *tables[SDL_arraysize(candidates)];
+        active = tables[Kernels_SupportedTables(tables, SDL_arraysize(tables)) - 1];
+        SDL_SetAtomicPointer(&activeKernels, (void *)active);
+    }
+    return active;
+}
+
+const char *Kernels_SIMDName(void)
+{
+    return Kernels_Active()->name;
+}
+
+void Kernels_MultiplyMat4(const Mat4 *a, const Mat4 *b, Mat4 *out)
+{
+    Kernels_Active()->multiplyMat4(a, b, out);
+}
+
+void Kernels_TransformBatch(const Mat4 *models, const Mat4 *viewProj, Mat4 *out, Uint32 count)
+{
+    Kernels_Active()->transformBatch(models, viewProj, out, count);
+}
+
+Uint32 Kernels_CullSpheres(const Frustum *frustum, const Sphere *spheres, Uint8 *visible, Uint32 count)
+{
+    return Kernels_Active()->cullSpheres(frustum, spheres, visible, count);
+}
+
+void Kernels_EncodeInstances(const Mat4 *models, InstanceData *out, Uint32 count)
+{
+    Kernels_Active()->encodeInstances(models, out, count);
+}
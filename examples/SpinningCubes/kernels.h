@@ -0,0 +1,62 @@
+/*
+ * CPU-side renderer kernels
+ *
+ * The per-object work of a frame in batch form: transforming model matrices
+ * by a view-projection, culling bounding spheres, sorting draw keys and
+ * packing instance data for a storage buffer. Each kernel that vectorizes
+ * has a scalar reference and SIMD variants that must produce the same
+ * results: SSE2, AVX2 and AVX-512 on x86, NEON on ARM. Every variant the
+ * compiler can target is built into the one binary, grouped by instruction
+ * set into KernelTables, and the first dispatched call picks the fastest
+ * table the CPU supports. Kernels_SIMDName reports which one that is.
+ */
+
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include <SDL3/SDL.h>
+
+#include "vecmath.h"
+
+/* World-space bounding sphere */
+typedef struct { float x, y, z, radius; } Sphere;
+
+/* Affine model matrix as three float4 rows (its first three columns), so a
+ * shader gets world = float3(dot(p, row0), dot(p, row1), dot(p, row2)) with p = float4(pos, 1) */
+typedef struct { float rows[3][4]; } InstanceData;
+
+/* One implementation of every kernel that has SIMD variants */
+typedef struct KernelTable {
+    const char *name;           /* "scalar", "sse2", "avx2", "avx512" or "neon" */
+    void (*multiplyMat4)(const Mat4 *a, const Mat4 *b, Mat4 *out);
+    void (*transformBatch)(const Mat4 *models, const Mat4 *viewProj, Mat4 *out, Uint32 count);
+    Uint32 (*cullSpheres)(const Frustum *frustum, const Sphere *spheres, Uint8 *visible, Uint32 count);
+    void (*encodeInstances)(const Mat4 *models, InstanceData *out, Uint32 count);
+} KernelTable;
+
+/* Detects the CPU's features once and returns the table the entry points below dispatch to */
+const KernelTable *Kernels_Active(void);
+
+/* Fills tables with the compiled-in tables this CPU can run, scalar first and fastest last; returns the count */
+Uint32 Kernels_SupportedTables(const KernelTable **tables, Uint32 maxTables);
+
+const char *Kernels_SIMDName(void);
+
+/* out = a * b; out must not alias a or b */
+void Kernels_MultiplyMat4(const Mat4 *a, const Mat4 *b, Mat4 *out);
+
+/* out[i] = models[i] * viewProj */
+void Kernels_TransformBatchScalar(const Mat4 *models, const Mat4 *viewProj, Mat4 *out, Uint32 count);
+void Kernels_TransformBatch(const Mat4 *models, const Mat4 *viewProj, Mat4 *out, Uint32 count);
+
+/* Writes 1 to visible[i] for spheres inside or crossing the frustum, 0 otherwise; returns the visible count */
+Uint32 Kernels_CullSpheresScalar(const Frustum *frustum, const Sphere *spheres, Uint8 *visible, Uint32 count);
+Uint32 Kernels_CullSpheres(const Frustum *frustum, const Sphere *spheres, Uint8 *visible, Uint32 count);
+
+/* Stable LSD radix sort of 64-bit draw keys, 8 bits per pass; scratch holds count keys */
+void Kernels_SortKeys(Uint64 *keys, Uint64 *scratch, Uint32 count);
+
+void Kernels_EncodeInstancesScalar(const Mat4 *models, InstanceData *out, Uint32 count);
+void Kernels_EncodeInstances(const Mat4 *models, InstanceData *out, Uint32 count);
+
+#endif /* KERNELS_H */
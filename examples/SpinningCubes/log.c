@@ -0,0 +1,491 @@
+/*
+ * Asynchronous frame-thread logging - see log.h
+ */
+
+#include "log.h"
+
+#define LOG_RING_SIZE 256           /* Records; a power of two */
+#define LOG_MAX_ARGS 12
+#define LOG_TEXT_BYTES 192          /* Copies of %s arguments, per record */
+#define LOG_SITES 256               /* Rate limit entries, one per format string */
+#define LOG_SITE_PROBES 8
+#define LOG_WINDOW_MS 1000
+#define LOG_FLUSH_INTERVAL_MS 10
+
+typedef enum {
+    LOG_ARG_INT,
+    LOG_ARG_UINT,
+    LOG_ARG_DOUBLE,
+    LOG_ARG_POINTER,
+    LOG_ARG_STRING
+} LogArgKind;
+
+typedef struct {
+    LogArgKind kind;
+    union {
+        Sint64 i;
+        Uint64 u;
+        double d;
+        const void *p;
+        Uint32 text;                /* Offset into the record's text */
+    } value;
+} LogArg;
+
+typedef struct {
+    const char *format;
+    LogLevel level;
+    Uint32 suppressed;              /* Messages from this format held back since the last one */
+    int argCount;
+    LogArg args[LOG_MAX_ARGS];
+    char text[LOG_TEXT_BYTES];
+} LogRecord;
+
+/* Bounded multi-producer queue: a slot is free to write when its sequence
+ * equals the write position, and ready to read when it is one past it */
+typedef struct {
+    SDL_AtomicInt sequence;
+    LogRecord record;
+} LogSlot;
+
+typedef struct {
+    void *format;                   /* Claimed once, never released */
+    SDL_AtomicInt windowStartMs;
+    SDL_AtomicInt count;            /* Messages in the current window */
+    SDL_AtomicInt suppressed;
+} LogSite;
+
+static LogSlot ring[LOG_RING_SIZE];
+static SDL_AtomicInt writePosition;
+static Uint32 readPosition = 0;     /* Log thread only */
+static LogSite sites[LOG_SITES];
+
+static SDL_AtomicInt running;
+static SDL_AtomicInt quit;
+static SDL_AtomicInt dropped;
+static LogLevel minLevel = LOG_INFO; /* Set at startup, before other threads log */
+static SDL_Thread *thread = NULL;
+static SDL_Semaphore *wake = NULL;
+
+static SDL_LogPriority Priority(LogLevel level)
+{
+    switch (level) {
+        case LOG_DEBUG: return SDL_LOG_PRIORITY_DEBUG;
+        case LOG_WARN: return SDL_LOG_PRIORITY_WARN;
+        case LOG_ERROR: return SDL_LOG_PRIORITY_ERROR;
+        default: return SDL_LOG_PRIORITY_INFO;
+    }
+}
+
+/* ========================================================================
+ * Format Specifications
+ * ======================================================================== */
+
+typedef struct {
+    int length;                     /* From '%' through the conversion */
+    char conversion;
+    char size;                      /* 0, 'H' (hh), 'h', 'l', 'L' (ll), 'z', 'j', 't' or 'D' (long double) */
+    bool widthStar;
+    bool precisionStar;
+} LogSpec;
+
+/* p points at a '%' that doesn't start "%%" */
+static bool ParseSpec(const char *p, LogSpec *spec)
+{
+    const char *start = p++;
+    *spec = (LogSpec){ 0 };
+
+    while (*p && SDL_strchr("-+ #0", *p)) p++;
+    if (*p == '*') {
+        spec->widthStar = true;
+        p++;
+    } else {
+        while (SDL_isdigit(*p)) p++;
+    }
+    if (*p == '.') {
+        p++;
+        if (*p == '*') {
+            spec->precisionStar = true;
+            p++;
+        } else {
+            while (SDL_isdigit(*p)) p++;
+        }
+    }
+
+    switch (*p) {
+        case 'h':
+            spec->size = p[1] == 'h' ? 'H' : 'h';
+            p += p[1] == 'h' ? 2 : 1;
+            break;
+        case 'l':
+            spec->size = p[1] == 'l' ? 'L' : 'l';
+            p += p[1] == 'l' ? 2 : 1;
+            break;
+        case 'z':
+        case 'j':
+        case 't':
+            spec->size = *p++;
+            break;
+        case 'L':
+            spec->size = 'D';
+            p++;
+            break;
+        default:
+            break;
+    }
+
+    if (!*p || !SDL_strchr("diuxXocspfFeEgGaA", *p)) return false;
+    spec->conversion = *p++;
+    spec->length = (int)(p - start);
+    return true;
+}
+
+/* ========================================================================
+ * Producer Side
+ * ======================================================================== */
+
+static Sint64 SignedArg(char size, va_list *ap)
+{
+    switch (size) {
+        case 'l': return va_arg(*ap, long);
+        case 'L': return va_arg(*ap, long long);
+        case 'z': return (Sint64)va_arg(*ap, size_t);
+        case 'j': return va_arg(*ap, intmax_t);
+        case 't': return va_arg(*ap, ptrdiff_t);
+        default: return va_arg(*ap, int);
+    }
+}
+
+static Uint64 UnsignedArg(char size, va_list *ap)
+{
+    switch (size) {
+        case 'l': return va_arg(*ap, unsigned long);
+        case 'L': return va_arg(*ap, unsigned long long);
+        case 'z': return va_arg(*ap, size_t);
+        case 'j': return va_arg(*ap, uintmax_t);
+        case 't': return (Uint64)va_arg(*ap, ptrdiff_t);
+        default: return va_arg(*ap, unsigned int);
+    }
+}
+
+/* Copies the raw arguments the format consumes; stops early when they don't fit */
+static void CaptureArgs(LogRecord *record, const char *format, va_list *ap)
+{
+    Uint32 textUsed = 0;
+    record->argCount = 0;
+
+    for (const char *p = format; *p; p++) {
+        if (*p != '%') continue;
+        if (p[1] == '%') {
+            p++;
+            continue;
+        }
+
+        LogSpec spec;
+        int needed = 1;
+        if (!ParseSpec(p, &spec)) return;
+        needed += spec.widthStar + spec.precisionStar;
+        if (record->argCount + needed > LOG_MAX_ARGS) return;
+        p += spec.length - 1;
+
+        if (spec.widthStar) {
+            record->args[record->argCount++] = (LogArg){ LOG_ARG_INT, { .i = va_arg(*ap, int) } };
+        }
+        if (spec.precisionStar) {
+            record->args[record->argCount++] = (LogArg){ LOG_ARG_INT, { .i = va_arg(*ap, int) } };
+        }
+
+        LogArg *arg = &record->args[record->argCount++];
+        switch (spec.conversion) {
+            case 'd':
+            case 'i':
+                *arg = (LogArg){ LOG_ARG_INT, { .i = SignedArg(spec.size, ap) } };
+                break;
+            case 'c':
+                *arg = (LogArg){ LOG_ARG_INT, { .i = va_arg(*ap, int) } };
+                break;
+            case 'u':
+            case 'x':
+            case 'X':
+            case 'o':
+                *arg = (LogArg){ LOG_ARG_UINT, { .u = UnsignedArg(spec.size, ap) } };
+                break;
+            case 'p':
+                *arg = (LogArg){ LOG_ARG_POINTER, { .p = va_arg(*ap, void *) } };
+                break;
+            case 's': {
+                const char *text = va_arg(*ap, const char *);
+                if (!text) text = "(null)";
+                size_t length = SDL_min(SDL_strlen(text), (size_t)(LOG_TEXT_BYTES - 1 - textUsed));
+                SDL_memcpy(record->text + textUsed, text, length);
+                record->text[textUsed + length] = '\0';
+                *arg = (LogArg){ LOG_ARG_STRING, { .text = textUsed } };
+                textUsed = SDL_min(textUsed + (Uint32)length + 1, (Uint32)(LOG_TEXT_BYTES - 1));
+                break;
+            }
+            default:
+                if (spec.size == 'D') {
+                    *arg = (LogArg){ LOG_ARG_DOUBLE, { .d = (double)va_arg(*ap, long double) } };
+                } else {
+                    *arg = (LogArg){ LOG_ARG_DOUBLE, { .d = va_arg(*ap, double) } };
+                }
+                break;
+        }
+    }
+}
+
+static LogSite *FindSite(const char *format)
+{
+    Uint32 hash = (Uint32)(((uintptr_t)format >> 3) * 2654435761u);
+    for (Uint32 probe = 0; probe < LOG_SITE_PROBES; probe++) {
+        LogSite *site = &sites[(hash + probe) & (LOG_SITES - 1)];
+        void *claimed = SDL_GetAtomicPointer(&site->format);
+        if (!claimed && SDL_CompareAndSwapAtomicPointer(&site->format, NULL, (void *)format)) {
+            return site;
+        }
+        if (SDL_GetAtomicPointer(&site->format) == format) {
+            return site;
+        }
+    }
+    return NULL;
+}
+
+/* False when the message is over its format's burst for this window. Otherwise
+ * returns, through suppressed, how many were held back since the last one. */
+static bool PassRateLimit(const char *format, Uint32 *suppressed)
+{
+    *suppressed = 0;
+    LogSite *site = FindSite(format);
+    if (!site) return true;
+
+    Uint32 nowMs = (Uint32)SDL_GetTicks();
+    int windowStart = SDL_GetAtomicInt(&site->windowStartMs);
+    if (nowMs - (Uint32)windowStart >= LOG_WINDOW_MS &&
+        SDL_CompareAndSwapAtomicInt(&site->windowStartMs, windowStart, (int)nowMs)) {
+        SDL_SetAtomicInt(&site->count, 0);
+    }
+    if (SDL_AddAtomicInt(&site->count, 1) >= LOG_BURST) {
+        SDL_AddAtomicInt(&site->suppressed, 1);
+        return false;
+    }
+    *suppressed = (Uint32)SDL_SetAtomicInt(&site->suppressed, 0);
+    return true;
+}
+
+void Log_Write(LogLevel level, const char *format, ...)
+{
+    if (level < minLevel) return;
+
+    va_list ap;
+    va_start(ap, format);
+    if (!SDL_GetAtomicInt(&running)) {
+        SDL_LogMessageV(SDL_LOG_CATEGORY_APPLICATION, Priority(level), format, ap);
+        va_end(ap);
+        return;
+    }
+
+    Uint32 suppressed;
+    if (!PassRateLimit(format, &suppressed)) {
+        va_end(ap);
+        return;
+    }
+
+    Uint32 position = (Uint32)SDL_GetAtomicInt(&writePosition);
+    for (;;) {
+        LogSlot *slot = &ring[position & (LOG_RING_SIZE - 1)];
+        int lag = (int)((Uint32)SDL_GetAtomicInt(&slot->sequence) - position);
+        if (lag == 0) {
+            if (SDL_CompareAndSwapAtomicInt(&writePosition, (int)position, (int)(position + 1))) {
+                LogRecord *record = &slot->record;
+                record->format = format;
+                record->level = level;
+                record->suppressed = suppressed;
+                CaptureArgs(record, format, &ap);
+                SDL_SetAtomicInt(&slot->sequence, (int)(position + 1));
+                break;
+            }
+        } else if (lag < 0) {
+            /* Full: the log thread is a whole ring behind */
+            SDL_AddAtomicInt(&dropped, 1);
+            break;
+        }
+        position = (Uint32)SDL_GetAtomicInt(&writePosition);
+    }
+    va_end(ap);
+}
+
+/* ========================================================================
+ * Log Thread
+ * ======================================================================== */
+
+/* Rebuilds each conversion with its '*' filled in and the length modifier of the stored value */
+static void FormatRecord(const LogRecord *record, char *out, size_t outSize)
+{
+    size_t used = 0;
+    int argIndex = 0;
+    const char *p = record->format;
+
+    while (*p && used < outSize - 1) {
+        if (*p != '%') {
+            out[used++] = *p++;
+            continue;
+        }
+        if (p[1] == '%') {
+            out[used++] = '%';
+            p += 2;
+            continue;
+        }
+
+        LogSpec spec;
+        if (!ParseSpec(p, &spec) || argIndex + 1 + spec.widthStar + spec.precisionStar > record->argCount) {
+            break;
+        }
+
+        char conversion[48];
+        size_t length = 0;
+        for (int i = 0; i < spec.length - 1 && length < sizeof(conversion) - 16; i++) {
+            char c = p[i];
+            if (c == '*') {
+                length += (size_t)SDL_snprintf(conversion + length, sizeof(conversion) - length, "%d",
+                                               (int)record->args[argIndex++].value.i);
+            } else if (!SDL_strchr("hlLzjt", c)) {
+                conversion[length++] = c;
+            }
+        }
+
+        const LogArg *arg = &record->args[argIndex++];
+        int written;
+        switch (arg->kind) {
+            case LOG_ARG_INT:
+                if (spec.conversion == 'c') {
+                    SDL_snprintf(conversion + length, sizeof(conversion) - length, "c");
+                    written = SDL_snprintf(out + used, outSize - used, conversion, (int)arg->value.i);
+                } else {
+                    SDL_snprintf(conversion + length, sizeof(conversion) - length, "ll%c", spec.conversion);
+                    written = SDL_snprintf(out + used, outSize - used, conversion, (long long)arg->value.i);
+                }
+                break;
+            case LOG_ARG_UINT:
+                SDL_snprintf(conversion + length, sizeof(conversion) - length, "ll%c", spec.conversion);
+                written = SDL_snprintf(out + used, outSize - used, conversion, (unsigned long long)arg->value.u);
+                break;
+            case LOG_ARG_POINTER:
+                SDL_snprintf(conversion + length, sizeof(conversion) - length, "p");
+                written = SDL_snprintf(out + used, outSize - used, conversion, arg->value.p);
+                break;
+            case LOG_ARG_STRING:
+                SDL_snprintf(conversion + length, sizeof(conversion) - length, "s");
+                written = SDL_snprintf(out + used, outSize - used, conversion, record->text + arg->value.text);
+                break;
+            default:
+                SDL_snprintf(conversion + length, sizeof(conversion) - length, "%c", spec.conversion);
+                written = SDL_snprintf(out + used, outSize - used, conversion, arg->value.d);
+                break;
+        }
+        used = SDL_min(used + (size_t)SDL_max(written, 0), outSize - 1);
+        p += spec.length;
+    }
+    out[used] = '\0';
+}
+
+static void Emit(LogLevel level, const char *message, Uint32 suppressed)
+{
+    if (suppressed > 0) {
+        SDL_LogMessage(SDL_LOG_CATEGORY_APPLICATION, Priority(level), "%s (%u similar messages suppressed)",
+                       message, suppressed);
+    } else {
+        SDL_LogMessage(SDL_LOG_CATEGORY_APPLICATION, Priority(level), "%s", message);
+    }
+}
+
+static void DrainRing(void)
+{
+    for (;;) {
+        LogSlot *slot = &ring[readPosition & (LOG_RING_SIZE - 1)];
+        if ((Uint32)SDL_GetAtomicInt(&slot->sequence) != readPosition + 1) break;
+
+        char message[512];
+        FormatRecord(&slot->record, message, sizeof(message));
+        LogLevel level = slot->record.level;
+        Uint32 suppressed = slot->record.suppressed;
+        SDL_SetAtomicInt(&slot->sequence, (int)(readPosition + LOG_RING_SIZE));
+        readPosition++;
+
+        Emit(level, message, suppressed);
+    }
+
+    int lost = SDL_SetAtomicInt(&dropped, 0);
+    if (lost > 0) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_APPLICATION, "Log: dropped %d messages (ring full)", lost);
+    }
+}
+
+static int SDLCALL LogThreadMain(void *data)
+{
+    (void)data;
+    while (!SDL_GetAtomicInt(&quit)) {
+        DrainRing();
+        SDL_WaitSemaphoreTimeout(wake, LOG_FLUSH_INTERVAL_MS);
+    }
+    DrainRing();
+    return 0;
+}
+
+/* ========================================================================
+ * Public Interface
+ * ======================================================================== */
+
+bool Log_Init(void)
+{
+    if (SDL_GetAtomicInt(&running)) return true;
+
+    for (Uint32 i = 0; i < LOG_RING_SIZE; i++) {
+        SDL_SetAtomicInt(&ring[i].sequence, (int)i);
+    }
+    SDL_SetAtomicInt(&writePosition, 0);
+    readPosition = 0;
+    SDL_SetAtomicInt(&quit, 0);
+
+    wake = SDL_CreateSemaphore(0);
+    thread = wake ? SDL_CreateThread(LogThreadMain, "log", NULL) : NULL;
+    if (!thread) {
+        SDL_Log("Log: failed to start log thread, logging synchronously: %s", SDL_GetError());
+        if (wake) SDL_DestroySemaphore(wake);
+        wake = NULL;
+        return false;
+    }
+
+    SDL_SetAtomicInt(&running, 1);
+    return true;
+}
+
+void Log_Shutdown(void)
+{
+    if (!SDL_GetAtomicInt(&running)) return;
+
+    SDL_SetAtomicInt(&running, 0);
+    SDL_SetAtomicInt(&quit, 1);
+    SDL_SignalSemaphore(wake);
+    SDL_WaitThread(thread, NULL);
+    SDL_DestroySemaphore(wake);
+    thread = NULL;
+    wake = NULL;
+
+    /* Writers that saw the ring running just before it stopped */
+    DrainRing();
+
+    for (Uint32 i = 0; i < LOG_SITES; i++) {
+        const char *format = SDL_GetAtomicPointer(&sites[i].format);
+        int suppressed = SDL_SetAtomicInt(&sites[i].suppressed, 0);
+        if (format && suppressed > 0) {
+            SDL_Log("Log: %d more messages suppressed like: %s", suppressed, format);
+        }
+    }
+}
+
+void Log_SetLevel(LogLevel level)
+{
+    minLevel = level;
+    if (level == LOG_DEBUG) {
+        SDL_SetLogPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_DEBUG);
+    }
+}
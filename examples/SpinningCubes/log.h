@@ -0,0 +1,41 @@
+/*
+ * Asynchronous frame-thread logging
+ *
+ * Log_Write never formats, allocates, locks or does I/O on the calling
+ * thread: it copies the format pointer and the raw arguments (strings by
+ * value, truncated) into a lock-free ring, and a background thread formats
+ * and hands them to SDL_Log. When the ring is full the record is dropped
+ * and counted instead of waiting.
+ *
+ * Each format string is also rate limited: after LOG_BURST messages within
+ * a second the rest are only counted, and the next one let through says how
+ * many were suppressed. Formats are told apart by address, so they must be
+ * string literals. Before Log_Init and after Log_Shutdown messages go
+ * straight to SDL_Log.
+ */
+
+#ifndef LOG_H
+#define LOG_H
+
+#include <SDL3/SDL.h>
+
+typedef enum LogLevel {
+    LOG_DEBUG,
+    LOG_INFO,
+    LOG_WARN,
+    LOG_ERROR
+} LogLevel;
+
+#define LOG_BURST 5
+
+bool Log_Init(void);
+
+/* Writes out everything queued, then any suppression counts left over */
+void Log_Shutdown(void);
+
+/* Messages below this level are discarded on the calling thread (default LOG_INFO) */
+void Log_SetLevel(LogLevel level);
+
+void Log_Write(LogLevel level, SDL_PRINTF_FORMAT_STRING const char *format, ...) SDL_PRINTF_VARARG_FUNC(2);
+
+#endif /* LOG_H */
@@ -15,6 +15,24 @@
 
 #include <math.h>
 
+#include "bench.h"
+#include "capture.h"
+#include "cmdstream.h"
+#include "drawpaths.h"
+#include "governor.h"
+#include "impostors.h"
+#include "log.h"
+#include "meshlets.h"
+#include "mirror.h"
+#include "profile.h"
+#include "readback.h"
+#include "scenes.h"
+#include "shaders.h"
+#include "spaces.h"
+#include "startup.h"
+#include "vecmath.h"
+#include "xrmock.h"
+
 #define XR_ERR_LOG(result, msg) \
     do { \
         if (XR_FAILED(result)) { \
@@ -23,90 +41,12 @@
         } \
     } while(0)
 
-/* ========================================================================
- * Math Types and Functions for 3D rendering
- * ======================================================================== */
-
-typedef struct { float x, y, z; } Vec3;
-typedef struct { float m[16]; } Mat4;
-
-typedef struct {
-    float x, y, z;
-    Uint8 r, g, b, a;
-} PositionColorVertex;
-
-static Mat4 Mat4_Identity(void) {
-    return (Mat4){{ 1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1 }};
-}
-
-static Mat4 Mat4_Multiply(Mat4 a, Mat4 b) {
-    Mat4 result = {{0}};
-    for (int i = 0; i < 4; i++) {
-        for (int j = 0; j < 4; j++) {
-            for (int k = 0; k < 4; k++) {
-                result.m[i * 4 + j] += a.m[i * 4 + k] * b.m[k * 4 + j];
-            }
-        }
-    }
-    return result;
-}
-
-static Mat4 Mat4_Translation(float x, float y, float z) {
-    return (Mat4){{ 1,0,0,0, 0,1,0,0, 0,0,1,0, x,y,z,1 }};
-}
-
-static Mat4 Mat4_Scale(float s) {
-    return (Mat4){{ s,0,0,0, 0,s,0,0, 0,0,s,0, 0,0,0,1 }};
-}
-
-static Mat4 Mat4_RotationY(float rad) {
-    float c = SDL_cosf(rad), s = SDL_sinf(rad);
-    return (Mat4){{ c,0,-s,0, 0,1,0,0, s,0,c,0, 0,0,0,1 }};
-}
-
-static Mat4 Mat4_RotationX(float rad) {
-    float c = SDL_cosf(rad), s = SDL_sinf(rad);
-    return (Mat4){{ 1,0,0,0, 0,c,s,0, 0,-s,c,0, 0,0,0,1 }};
-}
-
-/* Convert XrPosef to view matrix (inverted transform) */
-static Mat4 Mat4_FromXrPose(XrPosef pose) {
-    float x = pose.orientation.x, y = pose.orientation.y;
-    float z = pose.orientation.z, w = pose.orientation.w;
-    
-    /* Quaternion to rotation matrix columns */
-    Vec3 right = { 1-2*(y*y+z*z), 2*(x*y+w*z), 2*(x*z-w*y) };
-    Vec3 up = { 2*(x*y-w*z), 1-2*(x*x+z*z), 2*(y*z+w*x) };
-    Vec3 fwd = { 2*(x*z+w*y), 2*(y*z-w*x), 1-2*(x*x+y*y) };
-    Vec3 pos = { pose.position.x, pose.position.y, pose.position.z };
-    
-    /* Inverted transform for view matrix */
-    float dr = -(right.x*pos.x + right.y*pos.y + right.z*pos.z);
-    float du = -(up.x*pos.x + up.y*pos.y + up.z*pos.z);
-    float df = -(fwd.x*pos.x + fwd.y*pos.y + fwd.z*pos.z);
-    
-    return (Mat4){{ right.x,up.x,fwd.x,0, right.y,up.y,fwd.y,0, right.z,up.z,fwd.z,0, dr,du,df,1 }};
-}
-
-/* Create asymmetric projection matrix from XR FOV */
-static Mat4 Mat4_Projection(XrFovf fov, float nearZ, float farZ) {
-    float tL = SDL_tanf(fov.angleLeft), tR = SDL_tanf(fov.angleRight);
-    float tU = SDL_tanf(fov.angleUp), tD = SDL_tanf(fov.angleDown);
-    float w = tR - tL, h = tU - tD;
-    
-    return (Mat4){{
-        2/w, 0, 0, 0,
-        0, 2/h, 0, 0,
-        (tR+tL)/w, (tU+tD)/h, -farZ/(farZ-nearZ), -1,
-        0, 0, -(farZ*nearZ)/(farZ-nearZ), 0
-    }};
-}
-
 /* ========================================================================
  * OpenXR Function Pointers (loaded dynamically)
  * ======================================================================== */
 
 static PFN_xrGetInstanceProcAddr pfn_xrGetInstanceProcAddr = NULL;
+static PFN_xrEnumerateViewConfigurations pfn_xrEnumerateViewConfigurations = NULL;
 static PFN_xrEnumerateViewConfigurationViews pfn_xrEnumerateViewConfigurationViews = NULL;
 static PFN_xrEnumerateSwapchainImages pfn_xrEnumerateSwapchainImages = NULL;
 static PFN_xrCreateReferenceSpace pfn_xrCreateReferenceSpace = NULL;
@@ -115,6 +55,7 @@ static PFN_xrDestroySession pfn_xrDestroySession = NULL;
 static PFN_xrPollEvent pfn_xrPollEvent = NULL;
 static PFN_xrBeginSession pfn_xrBeginSession = NULL;
 static PFN_xrEndSession pfn_xrEndSession = NULL;
+static PFN_xrRequestExitSession pfn_xrRequestExitSession = NULL;
 static PFN_xrWaitFrame pfn_xrWaitFrame = NULL;
 static PFN_xrBeginFrame pfn_xrBeginFrame = NULL;
 static PFN_xrEndFrame pfn_xrEndFrame = NULL;
@@ -122,6 +63,28 @@ static PFN_xrLocateViews pfn_xrLocateViews = NULL;
 static PFN_xrAcquireSwapchainImage pfn_xrAcquireSwapchainImage = NULL;
 static PFN_xrWaitSwapchainImage pfn_xrWaitSwapchainImage = NULL;
 static PFN_xrReleaseSwapchainImage pfn_xrReleaseSwapchainImage = NULL;
+static PFN_xrStringToPath pfn_xrStringToPath = NULL;
+static PFN_xrCreateActionSet pfn_xrCreateActionSet = NULL;
+static PFN_xrDestroyActionSet pfn_xrDestroyActionSet = NULL;
+static PFN_xrCreateAction pfn_xrCreateAction = NULL;
+static PFN_xrSuggestInteractionProfileBindings pfn_xrSuggestInteractionProfileBindings = NULL;
+static PFN_xrAttachSessionActionSets pfn_xrAttachSessionActionSets = NULL;
+static PFN_xrSyncActions pfn_xrSyncActions = NULL;
+static PFN_xrCreateActionSpace pfn_xrCreateActionSpace = NULL;
+static PFN_xrGetActionStatePose pfn_xrGetActionStatePose = NULL;
+static PFN_xrGetActionStateBoolean pfn_xrGetActionStateBoolean = NULL;
+static PFN_xrLocateSpace pfn_xrLocateSpace = NULL;
+static PFN_xrLocateSpacesKHR pfn_xrLocateSpacesKHR = NULL;     /* XR_KHR_locate_spaces, may be NULL */
+static PFN_xrPerfSettingsSetPerformanceLevelEXT pfn_xrPerfSettingsSetPerformanceLevelEXT = NULL; /* XR_EXT_performance_settings, may be NULL */
+static PFN_xrEnumerateDisplayRefreshRatesFB pfn_xrEnumerateDisplayRefreshRatesFB = NULL; /* XR_FB_display_refresh_rate, may be NULL */
+static PFN_xrGetDisplayRefreshRateFB pfn_xrGetDisplayRefreshRateFB = NULL;
+static PFN_xrRequestDisplayRefreshRateFB pfn_xrRequestDisplayRefreshRateFB = NULL;
+
+/* SDL's session and swapchain helpers, or the mock runtime's equivalents */
+static XrResult (SDLCALL *createXRSession)(SDL_GPUDevice *, const XrSessionCreateInfo *, XrSession *) = NULL;
+static XrResult (SDLCALL *createXRSwapchain)(SDL_GPUDevice *, XrSession, const XrSwapchainCreateInfo *,
+                                             SDL_GPUTextureFormat *, XrSwapchain *, SDL_GPUTexture ***) = NULL;
+static XrResult (SDLCALL *destroyXRSwapchain)(SDL_GPUDevice *, XrSwapchain, SDL_GPUTexture **) = NULL;
 
 /* ========================================================================
  * Global State
@@ -134,6 +97,9 @@ static XrSession xrSession = XR_NULL_HANDLE;
 static XrSpace xrLocalSpace = XR_NULL_HANDLE;
 static bool xrSessionRunning = false;
 static bool xrShouldQuit = false;
+static XrViewConfigurationType xrViewConfigType = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO;
+static XrExtensionProperties *runtimeExtensions = NULL; /* Queried before instance creation; empty on the mock runtime */
+static uint32_t runtimeExtensionCount = 0;
 
 /* Swapchain state */
 typedef struct {
@@ -142,10 +108,12 @@ typedef struct {
     XrExtent2Di size;
     SDL_GPUTextureFormat format;
     uint32_t imageCount;
+    SDL_GPUTexture *overdrawTexture; /* R8 layer counter, overdraw mode only */
 } VRSwapchain;
 
 static VRSwapchain *vrSwapchains = NULL;
 static XrView *xrViews = NULL;
+static XrCompositionLayerProjectionView *projViews = NULL;
 static uint32_t viewCount = 0;
 
 /* SDL GPU state */
@@ -154,6 +122,61 @@ static SDL_GPUGraphicsPipeline *pipeline = NULL;
 static SDL_GPUBuffer *vertexBuffer = NULL;
 static SDL_GPUBuffer *indexBuffer = NULL;
 
+/* Overdraw visualization state */
+static SDL_GPUGraphicsPipeline *overdrawPipeline = NULL;
+static SDL_GPUGraphicsPipeline *overdrawPipelineDoubleSided = NULL;  /* Scenes only */
+static SDL_GPUGraphicsPipeline *heatmapPipeline = NULL;
+static SDL_GPUSampler *overdrawSampler = NULL;
+static SDL_GPUBuffer *overdrawVertexBuffer = NULL;
+
+/* Spectator camera state */
+static SDL_Window *spectatorWindow = NULL;
+static SDL_GPUTexture *spectatorTexture = NULL; /* Reduced-resolution render target in the eye format */
+static Uint32 spectatorTextureWidth = 0, spectatorTextureHeight = 0;
+static Sint64 lastSpectatorTimeNs = 0;
+
+/* Controller state: a grip model and an aim ray per hand, drawn as instances */
+#define HAND_COUNT 2
+#define CONTROLLER_INSTANCES (HAND_COUNT * 2)
+static XrActionSet xrActionSet = XR_NULL_HANDLE;
+static XrAction gripPoseAction = XR_NULL_HANDLE;
+static XrAction aimPoseAction = XR_NULL_HANDLE;
+static XrAction cyclePathAction = XR_NULL_HANDLE;     /* Steps to the next render path */
+static XrPath handPaths[HAND_COUNT];
+static XrSpace gripSpaces[HAND_COUNT];
+static XrSpace aimSpaces[HAND_COUNT];
+static int controllerSpaceIndices[CONTROLLER_INSTANCES];   /* Pose table index of each part */
+static bool controllersReady = false;
+static SDL_GPUGraphicsPipeline *controllerPipeline = NULL;
+static SDL_GPUBuffer *controllerBuffer = NULL;             /* CONTROLLER_INSTANCES model matrices */
+static SDL_GPUTransferBuffer *controllerTransfer = NULL;
+
+/* Quality knobs driven by the frame budget governor */
+static const float renderScales[] = { 1.0f, 0.85f, 0.7f, 0.6f, 0.5f };
+static float renderScale = 1.0f;           /* Eye viewport relative to the swapchain */
+#define SPECTATOR_RATE_LEVELS 4            /* Full, half, quarter rate, paused */
+static int spectatorRateLevel = 0;
+
+/* CPU and GPU performance levels the governor may request, lowest power first.
+ * Boost is left out: it is meant for short bursts such as loading, not for
+ * holding a frame rate. */
+static const XrPerfSettingsLevelEXT perfLevels[] = {
+    XR_PERF_SETTINGS_LEVEL_POWER_SAVINGS_EXT,
+    XR_PERF_SETTINGS_LEVEL_SUSTAINED_LOW_EXT,
+    XR_PERF_SETTINGS_LEVEL_SUSTAINED_HIGH_EXT
+};
+
+/* Display refresh rates offered by the runtime up to maxRefreshRate, fastest
+ * first; the governor steps down them when a frame cannot keep up */
+static float maxRefreshRate = 0.0f;        /* 0: 90 Hz, or the mock runtime's configured rate */
+static float refreshRates[GOVERNOR_MAX_RATES];
+static int refreshRateCount = 0;
+
+/* Frame capture state */
+#define READBACK_SLOTS 8
+static ReadbackRing *readbackRing = NULL;
+static Uint64 frameIndex = 0;
+
 /* Animation time */
 static float animTime = 0.0f;
 
@@ -169,48 +192,485 @@ static Vec3 cubePositions[NUM_CUBES] = {
 static float cubeScales[NUM_CUBES] = { 1.0f, 0.6f, 0.6f, 0.5f, 0.5f };
 static float cubeSpeeds[NUM_CUBES] = { 1.0f, 1.5f, -1.2f, 2.0f, -0.8f };
 
+/* Cube transforms, computed once per frame and shared by every view */
+static Mat4 cubeModels[NUM_CUBES];
+
+/* Benchmark scene, drawn instead of the cubes when one is selected */
+static Scene *activeScene = NULL;
+static SDL_GPUBuffer **sceneVertexBuffers = NULL;   /* Per scene mesh */
+static SDL_GPUBuffer **sceneIndexBuffers = NULL;
+static SDL_GPUBuffer **sceneOverdrawBuffers = NULL; /* Per scene mesh, overdraw mode only */
+static SDL_GPUGraphicsPipeline **scenePipelines = NULL; /* Per scene material */
+static Impostors *impostors = NULL;
+static bool *sceneImpostors = NULL;     /* Per object: drawn as an impostor this frame */
+static MeshletMesh *sceneMeshlets = NULL;   /* Per scene mesh; no meshlets when drawn whole */
+static MeshletCuller *meshletCuller = NULL;
+static MeshletObject *meshletObjects = NULL;
+static Uint32 *sceneClusterSlots = NULL;    /* Per object: its culled draw this frame, or UINT32_MAX */
+
+/* Render paths: the draw paths of drawpaths.h, plus single-pass stereo, which
+ * culls against every view and uploads once, then replays the same instanced
+ * draw in each view. Uniform is the per-object loop of DrawCubes/DrawScene. */
+#define RENDER_PATH_STEREO DRAWPATH_COUNT
+#define RENDER_PATH_COUNT (DRAWPATH_COUNT + 1)
+static DrawPaths *drawPaths = NULL;
+static Mat4 *visibleModels = NULL;      /* Objects that passed culling, per upload */
+static Mat4 *pathViewProjs = NULL;      /* Per view, for single-pass stereo culling */
+static int activeRenderPath = DRAWPATH_UNIFORM;
+
+/* Stats line, shown in the desktop window titles and optionally logged */
+#define STATS_INTERVAL_NS 1000000000
+static Uint64 statsStartNs = 0;
+static Uint64 statsCpuNs = 0;
+static Uint32 statsFrames = 0;
+
+/* ========================================================================
+ * Command Line Options
+ * ======================================================================== */
+
+/* Each overdraw fragment adds 1/255 to an R8_UNORM target, so the stored
+ * byte is exactly the number of layers that touched the pixel. */
+#define OVERDRAW_INCREMENT 1
+#define OVERDRAW_STATS_INTERVAL 90 /* Frames between readbacks, ~1s at 90Hz */
+
+static bool overdrawMode = false;
+static bool overdrawStats = false;
+static float overdrawMax = 8.0f; /* Layer count mapped to the hot end of the heatmap */
+
+static CaptureConfig captureConfig = {
+    .captureFrame = 90,
+    .videoInterval = 1,
+    .goldenTolerance = 8,
+    .goldenMaxMismatch = 0.001f
+};
+
+static const char *streamCapturePath = NULL;
+
+static MirrorMode mirrorMode = MIRROR_OFF;
+static float mirrorRate = 30.0f;
+static int mirrorWidth = 1280, mirrorHeight = 720;
+
+static bool spectatorEnabled = false;
+static float spectatorRate = 30.0f;
+static float spectatorScale = 0.5f; /* Render resolution relative to the window */
+static int spectatorWidth = 1280, spectatorHeight = 720;
+static Vec3 spectatorEye = { 2.0f, 1.2f, 0.5f };
+static Vec3 spectatorTarget = { 0.0f, 0.0f, -2.2f };
+
+static bool controllersEnabled = true;
+static bool lateLatch = false;
+
+static ProfileKind profileKind = PROFILE_DEBUG;
+static bool profileChosen = false;
+static const RuntimeProfile *runtimeProfile = NULL;
+
+static int requestedRenderPath = DRAWPATH_UNIFORM;
+static bool statsLog = false;
+static const char *startupTracePath = NULL;
+
+static XrViewConfigurationType requestedViewConfig = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO;
+
+static bool mockRuntime = false;
+static MockXRConfig mockConfig = {
+    .width = 1440,
+    .height = 1584,
+    .refreshRate = 90.0f
+};
+
+static bool sceneEnabled = false;
+static SceneConfig sceneConfig = { .kind = SCENE_MANY_SMALL_OBJECTS };
+static const char *sceneSnapshotPath = NULL;
+static float impostorDistance = 0.0f;   /* 0: every object is drawn as a mesh */
+static bool meshletsEnabled = false;
+
+static bool benchEnabled = false;
+static const char *benchLabel = NULL;
+static BenchConfig benchConfig = {
+    .warmupFrames = 120,
+    .measureFrames = 600,
+    .outputPath = "bench.json",
+    .regressionPercent = 10.0f,
+    .regressionSigma = 3.0f
+};
+
+static bool governorEnabled = false;
+static GovernorConfig governorConfig = {
+    .degradeThreshold = 0.9f,
+    .restoreThreshold = 0.7f,
+    .degradeFrames = 5,
+    .restoreFrames = 90
+};
+
+static bool ParseSize(const char *text, int *width, int *height)
+{
+    int w, h;
+    if (SDL_sscanf(text, "%dx%d", &w, &h) != 2 || w <= 0 || h <= 0) {
+        SDL_Log("Invalid size '%s' (expected WxH)", text);
+        return false;
+    }
+    *width = w;
+    *height = h;
+    return true;
+}
+
+/* Numeric option values, raised to min. Not SDL_max(min, SDL_atoi(argv[++i])):
+ * the macro evaluates its arguments twice and would skip the next option. */
+static int ParseInt(const char *text, int min)
+{
+    int value = SDL_atoi(text);
+    return SDL_max(min, value);
+}
+
+static float ParseFloat(const char *text, float min)
+{
+    float value = (float)SDL_atof(text);
+    return SDL_max(min, value);
+}
+
+static bool ParseVec3(const char *text, Vec3 *v)
+{
+    Vec3 parsed;
+    if (SDL_sscanf(text, "%f,%f,%f", &parsed.x, &parsed.y, &parsed.z) != 3) {
+        SDL_Log("Invalid position '%s' (expected X,Y,Z)", text);
+        return false;
+    }
+    *v = parsed;
+    return true;
+}
+
+static void ParseArgs(int argc, char *argv[])
+{
+    profileKind = Profile_Default();
+    
+#ifdef SPINNING_CUBES_BENCH
+    /* The benchmark build runs a scene headless and unpaced on the mock runtime
+     * unless told otherwise */
+    sceneEnabled = true;
+    benchEnabled = true;
+    mockRuntime = true;
+    mockConfig.unpaced = true;
+    controllersEnabled = false;
+#endif
+    
+    for (int i = 1; i < argc; i++) {
+        if (SDL_strcmp(argv[i], "--overdraw") == 0) {
+            overdrawMode = true;
+        } else if (SDL_strcmp(argv[i], "--overdraw-stats") == 0) {
+            overdrawMode = true;
+            overdrawStats = true;
+        } else if (SDL_strcmp(argv[i], "--overdraw-max") == 0 && i + 1 < argc) {
+            overdrawMax = ParseFloat(argv[++i], 1.0f);
+        } else if (SDL_strcmp(argv[i], "--screenshot") == 0 && i + 1 < argc) {
+            captureConfig.screenshotPrefix = argv[++i];
+        } else if (SDL_strcmp(argv[i], "--capture-frame") == 0 && i + 1 < argc) {
+            captureConfig.captureFrame = SDL_strtoull(argv[++i], NULL, 10);
+        } else if (SDL_strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            captureConfig.videoPath = argv[++i];
+        } else if (SDL_strcmp(argv[i], "--record-view") == 0 && i + 1 < argc) {
+            captureConfig.videoView = (Uint32)SDL_atoi(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--record-every") == 0 && i + 1 < argc) {
+            captureConfig.videoInterval = (Uint32)ParseInt(argv[++i], 1);
+        } else if (SDL_strcmp(argv[i], "--stream-capture") == 0 && i + 1 < argc) {
+            streamCapturePath = argv[++i];
+        } else if (SDL_strcmp(argv[i], "--golden") == 0 && i + 1 < argc) {
+            captureConfig.goldenPath = argv[++i];
+        } else if (SDL_strcmp(argv[i], "--golden-tolerance") == 0 && i + 1 < argc) {
+            captureConfig.goldenTolerance = (Uint32)SDL_atoi(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--golden-max-mismatch") == 0 && i + 1 < argc) {
+            captureConfig.goldenMaxMismatch = (float)SDL_atof(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--mirror") == 0 && i + 1 < argc) {
+            mirrorMode = Mirror_ParseMode(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--mirror-hz") == 0 && i + 1 < argc) {
+            mirrorRate = ParseFloat(argv[++i], 1.0f);
+        } else if (SDL_strcmp(argv[i], "--mirror-size") == 0 && i + 1 < argc) {
+            ParseSize(argv[++i], &mirrorWidth, &mirrorHeight);
+        } else if (SDL_strcmp(argv[i], "--spectator") == 0) {
+            spectatorEnabled = true;
+        } else if (SDL_strcmp(argv[i], "--spectator-hz") == 0 && i + 1 < argc) {
+            spectatorRate = ParseFloat(argv[++i], 1.0f);
+        } else if (SDL_strcmp(argv[i], "--spectator-size") == 0 && i + 1 < argc) {
+            ParseSize(argv[++i], &spectatorWidth, &spectatorHeight);
+        } else if (SDL_strcmp(argv[i], "--spectator-scale") == 0 && i + 1 < argc) {
+            float scale = ParseFloat(argv[++i], 0.1f);
+            spectatorScale = SDL_min(scale, 1.0f);
+        } else if (SDL_strcmp(argv[i], "--spectator-eye") == 0 && i + 1 < argc) {
+            ParseVec3(argv[++i], &spectatorEye);
+        } else if (SDL_strcmp(argv[i], "--spectator-target") == 0 && i + 1 < argc) {
+            ParseVec3(argv[++i], &spectatorTarget);
+        } else if (SDL_strcmp(argv[i], "--no-controllers") == 0) {
+            controllersEnabled = false;
+        } else if (SDL_strcmp(argv[i], "--late-latch") == 0) {
+            lateLatch = true;
+        } else if (SDL_strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+            const char *name = argv[++i];
+            if (Profile_ParseKind(name, &profileKind)) {
+                profileChosen = true;
+            } else {
+                SDL_Log("Unknown profile '%s' (expected debug, profile or release)", name);
+            }
+        } else if (SDL_strcmp(argv[i], "--render-path") == 0 && i + 1 < argc) {
+            const char *name = argv[++i];
+            DrawPathKind kind;
+            if (SDL_strcmp(name, "single-pass-stereo") == 0) {
+                requestedRenderPath = RENDER_PATH_STEREO;
+            } else if (DrawPaths_ParseKind(name, &kind)) {
+                requestedRenderPath = (int)kind;
+            } else {
+                SDL_Log("Unknown render path '%s'", name);
+            }
+        } else if (SDL_strcmp(argv[i], "--stats") == 0) {
+            statsLog = true;
+        } else if (SDL_strcmp(argv[i], "--startup-trace") == 0 && i + 1 < argc) {
+            startupTracePath = argv[++i];
+        } else if (SDL_strcmp(argv[i], "--view-config") == 0 && i + 1 < argc) {
+            const char *name = argv[++i];
+            if (SDL_strcmp(name, "mono") == 0) {
+                requestedViewConfig = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_MONO;
+            } else if (SDL_strcmp(name, "stereo") == 0) {
+                requestedViewConfig = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO;
+            } else if (SDL_strcmp(name, "quad") == 0) {
+                requestedViewConfig = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO_WITH_FOVEATED_INSET;
+            } else {
+                SDL_Log("Unknown view configuration '%s' (expected mono, stereo or quad)", name);
+            }
+        } else if (SDL_strcmp(argv[i], "--mock-xr") == 0) {
+            mockRuntime = true;
+        } else if (SDL_strcmp(argv[i], "--mock-size") == 0 && i + 1 < argc) {
+            int w = (int)mockConfig.width, h = (int)mockConfig.height;
+            ParseSize(argv[++i], &w, &h);
+            mockConfig.width = (Uint32)w;
+            mockConfig.height = (Uint32)h;
+        } else if (SDL_strcmp(argv[i], "--mock-hz") == 0 && i + 1 < argc) {
+            mockConfig.refreshRate = ParseFloat(argv[++i], 1.0f);
+        } else if (SDL_strcmp(argv[i], "--mock-frames") == 0 && i + 1 < argc) {
+            mockConfig.frameLimit = SDL_strtoull(argv[++i], NULL, 10);
+        } else if (SDL_strcmp(argv[i], "--mock-unpaced") == 0) {
+            mockConfig.unpaced = true;
+        } else if (SDL_strcmp(argv[i], "--mock-thermal") == 0 && i + 1 < argc) {
+            mockConfig.thermalSeconds = ParseFloat(argv[++i], 0.0f);
+        } else if (SDL_strcmp(argv[i], "--no-mock-xr") == 0) {
+            mockRuntime = false;
+        } else if (SDL_strcmp(argv[i], "--scene") == 0 && i + 1 < argc) {
+            const char *name = argv[++i];
+            if (Scene_ParseKind(name, &sceneConfig.kind)) {
+                sceneEnabled = true;
+            } else {
+                SDL_Log("Unknown scene '%s'", name);
+            }
+        } else if (SDL_strcmp(argv[i], "--scene-objects") == 0 && i + 1 < argc) {
+            sceneConfig.objectCount = (Uint32)ParseInt(argv[++i], 1);
+        } else if (SDL_strcmp(argv[i], "--scene-materials") == 0 && i + 1 < argc) {
+            sceneConfig.materialCount = (Uint32)ParseInt(argv[++i], 1);
+        } else if (SDL_strcmp(argv[i], "--scene-detail") == 0 && i + 1 < argc) {
+            sceneConfig.detail = (Uint32)ParseInt(argv[++i], 1);
+        } else if (SDL_strcmp(argv[i], "--scene-snapshot") == 0 && i + 1 < argc) {
+            sceneSnapshotPath = argv[++i];
+        } else if (SDL_strcmp(argv[i], "--impostor-distance") == 0 && i + 1 < argc) {
+            impostorDistance = ParseFloat(argv[++i], 0.0f);
+        } else if (SDL_strcmp(argv[i], "--meshlets") == 0) {
+            meshletsEnabled = true;
+        } else if (SDL_strcmp(argv[i], "--bench") == 0) {
+            benchEnabled = true;
+        } else if (SDL_strcmp(argv[i], "--bench-frames") == 0 && i + 1 < argc) {
+            benchConfig.measureFrames = (Uint32)ParseInt(argv[++i], 1);
+        } else if (SDL_strcmp(argv[i], "--bench-warmup") == 0 && i + 1 < argc) {
+            benchConfig.warmupFrames = (Uint32)ParseInt(argv[++i], 0);
+        } else if (SDL_strcmp(argv[i], "--bench-out") == 0 && i + 1 < argc) {
+            benchConfig.outputPath = argv[++i];
+        } else if (SDL_strcmp(argv[i], "--bench-label") == 0 && i + 1 < argc) {
+            benchLabel = argv[++i];
+        } else if (SDL_strcmp(argv[i], "--bench-baseline") == 0 && i + 1 < argc) {
+            benchConfig.baselinePath = argv[++i];
+        } else if (SDL_strcmp(argv[i], "--bench-record") == 0) {
+            benchConfig.recordBaseline = true;
+        } else if (SDL_strcmp(argv[i], "--bench-threshold") == 0 && i + 1 < argc) {
+            benchConfig.regressionPercent = ParseFloat(argv[++i], 0.0f);
+        } else if (SDL_strcmp(argv[i], "--bench-sigma") == 0 && i + 1 < argc) {
+            benchConfig.regressionSigma = ParseFloat(argv[++i], 0.0f);
+        } else if (SDL_strcmp(argv[i], "--governor") == 0) {
+            governorEnabled = true;
+        } else if (SDL_strcmp(argv[i], "--refresh-rate") == 0 && i + 1 < argc) {
+            maxRefreshRate = ParseFloat(argv[++i], 1.0f);
+        } else if (SDL_strcmp(argv[i], "--governor-order") == 0 && i + 1 < argc) {
+            governorConfig.order = argv[++i];
+        } else if (SDL_strcmp(argv[i], "--governor-degrade") == 0 && i + 1 < argc) {
+            governorConfig.degradeThreshold = (float)SDL_atof(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--governor-restore") == 0 && i + 1 < argc) {
+            governorConfig.restoreThreshold = (float)SDL_atof(argv[++i]);
+        } else if (SDL_strcmp(argv[i], "--governor-degrade-frames") == 0 && i + 1 < argc) {
+            governorConfig.degradeFrames = (Uint32)ParseInt(argv[++i], 1);
+        } else if (SDL_strcmp(argv[i], "--governor-restore-frames") == 0 && i + 1 < argc) {
+            governorConfig.restoreFrames = (Uint32)ParseInt(argv[++i], 1);
+        } else {
+            SDL_Log("Ignoring unknown option: %s", argv[i]);
+        }
+    }
+}
+
+/* ========================================================================
+ * Runtime Profile
+ * ======================================================================== */
+
+/* A benchmark only runs with validation when the debug profile was asked for
+ * by name; a debug build's default falls back to the profile profile */
+static void ApplyProfile(void)
+{
+    if (benchEnabled && !profileChosen && Profile_Get(profileKind)->gpuValidation) {
+        profileKind = PROFILE_PROFILE;
+    }
+    runtimeProfile = Profile_Get(profileKind);
+    
+    Log_SetLevel(runtimeProfile->logLevel);
+    if (runtimeProfile->instrumentation == INSTRUMENT_FULL) {
+        statsLog = true;
+    }
+    
+    SDL_Log("Profile: %s (GPU validation %s, debug labels %s)", runtimeProfile->name,
+            runtimeProfile->gpuValidation ? "on" : "off", runtimeProfile->debugLabels ? "on" : "off");
+    if (benchEnabled && runtimeProfile->gpuValidation) {
+        SDL_Log("Profile: benchmarking with GPU validation on; timings are not representative");
+    }
+}
+
+/* Names show up in GPU debuggers and validation messages */
+static void NameBuffer(SDL_GPUBuffer *buffer, const char *name)
+{
+    if (buffer && runtimeProfile->debugLabels) SDL_SetGPUBufferName(gpuDevice, buffer, name);
+}
+
+static void NameTexture(SDL_GPUTexture *texture, const char *name)
+{
+    if (texture && runtimeProfile->debugLabels) SDL_SetGPUTextureName(gpuDevice, texture, name);
+}
+
+/* Debug groups give a GPU capture its structure (view > pass > batch). The
+ * name is only formatted when the profile keeps labels. A group opened inside
+ * a pass must be closed before the pass ends. */
+static void PushDebugGroup(SDL_GPUCommandBuffer *cmdBuf, const char *format, ...)
+{
+    if (!runtimeProfile->debugLabels) return;
+    
+    char name[96];
+    va_list args;
+    va_start(args, format);
+    SDL_vsnprintf(name, sizeof(name), format, args);
+    va_end(args);
+    SDL_PushGPUDebugGroup(cmdBuf, name);
+}
+
+static void PopDebugGroup(SDL_GPUCommandBuffer *cmdBuf)
+{
+    if (runtimeProfile->debugLabels) SDL_PopGPUDebugGroup(cmdBuf);
+}
+
 /* ========================================================================
  * Shader and Pipeline Creation
  * ======================================================================== */
 
-static SDL_GPUShader* LoadShader(const char* shaderName, SDL_GPUShaderStage stage, Uint32 samplerCount, Uint32 uniformBufferCount)
+/* Fullscreen pass that turns the R8 overdraw counter into a color ramp */
+static int CreateHeatmapPipeline(SDL_GPUTextureFormat colorFormat)
 {
-    char path[256];
-    SDL_snprintf(path, sizeof(path), "Shaders/Compiled/SPIRV/%s.spv", shaderName);
+    SDL_GPUShader *vertShader = Shaders_Load(gpuDevice, "Fullscreen.vert", SDL_GPU_SHADERSTAGE_VERTEX, 0, 0, 0);
+    SDL_GPUShader *fragShader = Shaders_Load(gpuDevice, "OverdrawHeatmap.frag", SDL_GPU_SHADERSTAGE_FRAGMENT, 1, 1, 0);
     
-    size_t codeSize;
-    void* code = SDL_LoadFile(path, &codeSize);
-    if (!code) {
-        SDL_Log("Failed to load shader %s: %s", path, SDL_GetError());
-        return NULL;
+    if (!vertShader || !fragShader) {
+        if (vertShader) SDL_ReleaseGPUShader(gpuDevice, vertShader);
+        if (fragShader) SDL_ReleaseGPUShader(gpuDevice, fragShader);
+        return 1;
     }
     
-    SDL_GPUShaderCreateInfo shaderInfo = {
-        .code = (const Uint8*)code,
-        .code_size = codeSize,
-        .entrypoint = "main",
-        .format = SDL_GPU_SHADERFORMAT_SPIRV,
-        .stage = stage,
-        .num_samplers = samplerCount,
-        .num_uniform_buffers = uniformBufferCount
+    SDL_GPUGraphicsPipelineCreateInfo pipelineInfo = {
+        .vertex_shader = vertShader,
+        .fragment_shader = fragShader,
+        .target_info = {
+            .num_color_targets = 1,
+            .color_target_descriptions = (SDL_GPUColorTargetDescription[]){{
+                .format = colorFormat
+            }}
+        },
+        .rasterizer_state = {
+            .cull_mode = SDL_GPU_CULLMODE_NONE,
+            .fill_mode = SDL_GPU_FILLMODE_FILL
+        },
+        .primitive_type = SDL_GPU_PRIMITIVETYPE_TRIANGLELIST
     };
     
-    SDL_GPUShader* shader = SDL_CreateGPUShader(gpuDevice, &shaderInfo);
-    SDL_free(code);
+    heatmapPipeline = SDL_CreateGPUGraphicsPipeline(gpuDevice, &pipelineInfo);
     
-    if (!shader) {
-        SDL_Log("Failed to create shader %s: %s", shaderName, SDL_GetError());
-    } else {
-        SDL_Log("Loaded shader: %s", shaderName);
+    SDL_ReleaseGPUShader(gpuDevice, vertShader);
+    SDL_ReleaseGPUShader(gpuDevice, fragShader);
+    
+    SDL_GPUSamplerCreateInfo samplerInfo = {
+        .min_filter = SDL_GPU_FILTER_NEAREST,
+        .mag_filter = SDL_GPU_FILTER_NEAREST,
+        .mipmap_mode = SDL_GPU_SAMPLERMIPMAPMODE_NEAREST,
+        .address_mode_u = SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE,
+        .address_mode_v = SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE,
+        .address_mode_w = SDL_GPU_SAMPLERADDRESSMODE_CLAMP_TO_EDGE
+    };
+    overdrawSampler = SDL_CreateGPUSampler(gpuDevice, &samplerInfo);
+    
+    if (!heatmapPipeline || !overdrawPipeline || !overdrawSampler || (activeScene && !overdrawPipelineDoubleSided)) {
+        SDL_Log("Failed to create overdraw pipelines: %s", SDL_GetError());
+        return 1;
+    }
+    
+    SDL_Log("Created overdraw heatmap pipeline (max %.0f layers)", overdrawMax);
+    return 0;
+}
+
+/* How the pipelines sharing the base vertex shader describe it to a command stream capture */
+static const CmdStreamShader baseVertexShader = { "PositionColorTransform.vert", 0, 1, 0 };
+
+/* One pipeline per scene material: the base pipeline's layout with the tinted
+ * fragment shader and the material's blending and culling */
+static int CreateScenePipelines(const SDL_GPUGraphicsPipelineCreateInfo *baseInfo)
+{
+    SDL_GPUShader *fragShader = Shaders_Load(gpuDevice, "TintedColor.frag", SDL_GPU_SHADERSTAGE_FRAGMENT, 0, 1, 0);
+    if (!fragShader) return 1;
+    
+    scenePipelines = SDL_calloc(activeScene->materialCount, sizeof(SDL_GPUGraphicsPipeline *));
+    int failed = scenePipelines ? 0 : 1;
+    
+    for (Uint32 i = 0; i < activeScene->materialCount && !failed; i++) {
+        const SceneMaterial *material = &activeScene->materials[i];
+        SDL_GPUColorTargetDescription colorTarget = baseInfo->target_info.color_target_descriptions[0];
+        if (material->blend) {
+            colorTarget.blend_state = (SDL_GPUColorTargetBlendState){
+                .enable_blend = true,
+                .src_color_blendfactor = SDL_GPU_BLENDFACTOR_SRC_ALPHA,
+                .dst_color_blendfactor = SDL_GPU_BLENDFACTOR_ONE_MINUS_SRC_ALPHA,
+                .color_blend_op = SDL_GPU_BLENDOP_ADD,
+                .src_alpha_blendfactor = SDL_GPU_BLENDFACTOR_ONE,
+                .dst_alpha_blendfactor = SDL_GPU_BLENDFACTOR_ONE_MINUS_SRC_ALPHA,
+                .alpha_blend_op = SDL_GPU_BLENDOP_ADD
+            };
+        }
+        
+        SDL_GPUGraphicsPipelineCreateInfo pipelineInfo = *baseInfo;
+        pipelineInfo.fragment_shader = fragShader;
+        pipelineInfo.target_info.color_target_descriptions = &colorTarget;
+        if (material->doubleSided) {
+            pipelineInfo.rasterizer_state.cull_mode = SDL_GPU_CULLMODE_NONE;
+        }
+        
+        scenePipelines[i] = SDL_CreateGPUGraphicsPipeline(gpuDevice, &pipelineInfo);
+        if (!scenePipelines[i]) {
+            SDL_Log("Failed to create scene material %u pipeline: %s", i, SDL_GetError());
+            failed = 1;
+        }
+        CmdStream_RegisterPipeline(scenePipelines[i], &pipelineInfo, &baseVertexShader,
+                                   &(CmdStreamShader){ "TintedColor.frag", 0, 1, 0 });
     }
     
-    return shader;
+    SDL_ReleaseGPUShader(gpuDevice, fragShader);
+    return failed;
 }
 
 static int CreatePipeline(SDL_GPUTextureFormat colorFormat)
 {
-    SDL_GPUShader *vertShader = LoadShader("PositionColorTransform.vert", SDL_GPU_SHADERSTAGE_VERTEX, 0, 1);
-    SDL_GPUShader *fragShader = LoadShader("SolidColor.frag", SDL_GPU_SHADERSTAGE_FRAGMENT, 0, 0);
+    SDL_GPUShader *vertShader = Shaders_Load(gpuDevice, "PositionColorTransform.vert", SDL_GPU_SHADERSTAGE_VERTEX, 0, 1, 0);
+    SDL_GPUShader *fragShader = Shaders_Load(gpuDevice, "SolidColor.frag", SDL_GPU_SHADERSTAGE_FRAGMENT, 0, 0, 0);
     
     if (!vertShader || !fragShader) {
         if (vertShader) SDL_ReleaseGPUShader(gpuDevice, vertShader);
@@ -260,6 +720,53 @@ static int CreatePipeline(SDL_GPUTextureFormat colorFormat)
     };
     
     pipeline = SDL_CreateGPUGraphicsPipeline(gpuDevice, &pipelineInfo);
+    CmdStream_RegisterPipeline(pipeline, &pipelineInfo, &baseVertexShader, &(CmdStreamShader){ "SolidColor.frag", 0, 0, 0 });
+    
+    /* Controller variant: same vertex layout, model matrices from a storage buffer per instance */
+    if (pipeline && controllersEnabled) {
+        SDL_GPUShader *controllerShader = Shaders_Load(gpuDevice, "ControllerInstanced.vert", SDL_GPU_SHADERSTAGE_VERTEX, 0, 1, 1);
+        if (controllerShader) {
+            pipelineInfo.vertex_shader = controllerShader;
+            controllerPipeline = SDL_CreateGPUGraphicsPipeline(gpuDevice, &pipelineInfo);
+            CmdStream_RegisterPipeline(controllerPipeline, &pipelineInfo,
+                                       &(CmdStreamShader){ "ControllerInstanced.vert", 0, 1, 1 },
+                                       &(CmdStreamShader){ "SolidColor.frag", 0, 0, 0 });
+            pipelineInfo.vertex_shader = vertShader;
+            SDL_ReleaseGPUShader(gpuDevice, controllerShader);
+        }
+        if (!controllerPipeline) {
+            SDL_Log("Controller rendering unavailable");
+        }
+    }
+    
+    /* A benchmark scene is useless without its materials */
+    if (pipeline && activeScene && CreateScenePipelines(&pipelineInfo) != 0) {
+        SDL_Log("Scene %s unavailable", Scene_KindName(activeScene->config.kind));
+        SDL_ReleaseGPUShader(gpuDevice, vertShader);
+        SDL_ReleaseGPUShader(gpuDevice, fragShader);
+        return 1;
+    }
+    
+    /* Overdraw variant: same shaders, additive blend into an R8 layer counter */
+    if (pipeline && overdrawMode) {
+        pipelineInfo.target_info.color_target_descriptions = (SDL_GPUColorTargetDescription[]){{
+            .format = SDL_GPU_TEXTUREFORMAT_R8_UNORM,
+            .blend_state = {
+                .enable_blend = true,
+                .src_color_blendfactor = SDL_GPU_BLENDFACTOR_ONE,
+                .dst_color_blendfactor = SDL_GPU_BLENDFACTOR_ONE,
+                .color_blend_op = SDL_GPU_BLENDOP_ADD,
+                .src_alpha_blendfactor = SDL_GPU_BLENDFACTOR_ONE,
+                .dst_alpha_blendfactor = SDL_GPU_BLENDFACTOR_ONE,
+                .alpha_blend_op = SDL_GPU_BLENDOP_ADD
+            }
+        }};
+        overdrawPipeline = SDL_CreateGPUGraphicsPipeline(gpuDevice, &pipelineInfo);
+        if (activeScene) {
+            pipelineInfo.rasterizer_state.cull_mode = SDL_GPU_CULLMODE_NONE;
+            overdrawPipelineDoubleSided = SDL_CreateGPUGraphicsPipeline(gpuDevice, &pipelineInfo);
+        }
+    }
     
     SDL_ReleaseGPUShader(gpuDevice, vertShader);
     SDL_ReleaseGPUShader(gpuDevice, fragShader);
@@ -270,6 +777,12 @@ static int CreatePipeline(SDL_GPUTextureFormat colorFormat)
     }
     
     SDL_Log("Created graphics pipeline for format %d", colorFormat);
+    
+    if (overdrawMode && CreateHeatmapPipeline(colorFormat) != 0) {
+        SDL_Log("Overdraw visualization unavailable, rendering normally");
+        overdrawMode = false;
+    }
+    
     return 0;
 }
 
@@ -317,17 +830,40 @@ static int CreateCubeBuffers(void)
         SDL_Log("Failed to create buffers: %s", SDL_GetError());
         return 1;
     }
+    NameBuffer(vertexBuffer, "cube vertices");
+    NameBuffer(indexBuffer, "cube indices");
+    CmdStream_RegisterBuffer(vertexBuffer, vertexBufInfo.usage, sizeof(vertices), vertices);
+    CmdStream_RegisterBuffer(indexBuffer, indexBufInfo.usage, sizeof(indices), indices);
+    
+    /* Overdraw copy of the cube: same positions, constant per-layer increment */
+    PositionColorVertex overdrawVertices[24];
+    if (overdrawMode) {
+        for (int i = 0; i < 24; i++) {
+            overdrawVertices[i] = vertices[i];
+            overdrawVertices[i].r = overdrawVertices[i].g = overdrawVertices[i].b = OVERDRAW_INCREMENT;
+            overdrawVertices[i].a = OVERDRAW_INCREMENT;
+        }
+        overdrawVertexBuffer = SDL_CreateGPUBuffer(gpuDevice, &vertexBufInfo);
+        if (!overdrawVertexBuffer) {
+            SDL_Log("Failed to create overdraw vertex buffer: %s", SDL_GetError());
+            return 1;
+        }
+        NameBuffer(overdrawVertexBuffer, "overdraw cube vertices");
+    }
     
     /* Create transfer buffer and upload data */
     SDL_GPUTransferBufferCreateInfo transferInfo = {
         .usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
-        .size = sizeof(vertices) + sizeof(indices)
+        .size = sizeof(vertices) + sizeof(indices) + (overdrawMode ? sizeof(overdrawVertices) : 0)
     };
     SDL_GPUTransferBuffer *transfer = SDL_CreateGPUTransferBuffer(gpuDevice, &transferInfo);
     
     void *data = SDL_MapGPUTransferBuffer(gpuDevice, transfer, false);
     SDL_memcpy(data, vertices, sizeof(vertices));
     SDL_memcpy((Uint8*)data + sizeof(vertices), indices, sizeof(indices));
+    if (overdrawMode) {
+        SDL_memcpy((Uint8*)data + sizeof(vertices) + sizeof(indices), overdrawVertices, sizeof(overdrawVertices));
+    }
     SDL_UnmapGPUTransferBuffer(gpuDevice, transfer);
     
     SDL_GPUCommandBuffer *cmd = SDL_AcquireGPUCommandBuffer(gpuDevice);
@@ -341,6 +877,12 @@ static int CreateCubeBuffers(void)
     SDL_GPUBufferRegion dstIndex = { .buffer = indexBuffer, .offset = 0, .size = sizeof(indices) };
     SDL_UploadToGPUBuffer(copyPass, &srcIndex, &dstIndex, false);
     
+    if (overdrawMode) {
+        SDL_GPUTransferBufferLocation srcOverdraw = { .transfer_buffer = transfer, .offset = sizeof(vertices) + sizeof(indices) };
+        SDL_GPUBufferRegion dstOverdraw = { .buffer = overdrawVertexBuffer, .offset = 0, .size = sizeof(overdrawVertices) };
+        SDL_UploadToGPUBuffer(copyPass, &srcOverdraw, &dstOverdraw, false);
+    }
+    
     SDL_EndGPUCopyPass(copyPass);
     SDL_SubmitGPUCommandBuffer(cmd);
     SDL_ReleaseGPUTransferBuffer(gpuDevice, transfer);
@@ -349,79 +891,522 @@ static int CreateCubeBuffers(void)
     return 0;
 }
 
-/* ========================================================================
- * OpenXR Function Loading
- * ======================================================================== */
-
-/* Load OpenXR function pointers after instance is created */
-static int LoadXRFunctions(void)
+/* Uploads every scene mesh through one transfer buffer */
+static int CreateSceneBuffers(void)
 {
-    pfn_xrGetInstanceProcAddr = SDL_OpenXR_GetXrGetInstanceProcAddr();
-    if (!pfn_xrGetInstanceProcAddr) {
-        SDL_Log("Failed to get xrGetInstanceProcAddr");
-        return 1;
+    Uint32 meshCount = activeScene->meshCount;
+    sceneVertexBuffers = SDL_calloc(meshCount, sizeof(SDL_GPUBuffer *));
+    sceneIndexBuffers = SDL_calloc(meshCount, sizeof(SDL_GPUBuffer *));
+    if (!sceneVertexBuffers || !sceneIndexBuffers) return 1;
+    if (overdrawMode) {
+        sceneOverdrawBuffers = SDL_calloc(meshCount, sizeof(SDL_GPUBuffer *));
+        if (!sceneOverdrawBuffers) return 1;
     }
-
-#define XR_LOAD(fn) \
-    if (XR_FAILED(pfn_xrGetInstanceProcAddr(xrInstance, #fn, (PFN_xrVoidFunction*)&pfn_##fn))) { \
-        SDL_Log("Failed to load " #fn); \
-        return 1; \
+    
+    Uint32 transferSize = 0;
+    for (Uint32 i = 0; i < meshCount; i++) {
+        const SceneMesh *mesh = &activeScene->meshes[i];
+        Uint32 vertexSize = mesh->vertexCount * (Uint32)sizeof(PositionColorVertex);
+        Uint32 indexSize = mesh->indexCount * (Uint32)sizeof(Uint32);
+        
+        SDL_GPUBufferCreateInfo vertexBufInfo = { .usage = SDL_GPU_BUFFERUSAGE_VERTEX, .size = vertexSize };
+        SDL_GPUBufferCreateInfo indexBufInfo = { .usage = SDL_GPU_BUFFERUSAGE_INDEX, .size = indexSize };
+        sceneVertexBuffers[i] = SDL_CreateGPUBuffer(gpuDevice, &vertexBufInfo);
+        sceneIndexBuffers[i] = SDL_CreateGPUBuffer(gpuDevice, &indexBufInfo);
+        if (!sceneVertexBuffers[i] || !sceneIndexBuffers[i]) {
+            SDL_Log("Failed to create scene buffers: %s", SDL_GetError());
+            return 1;
+        }
+        if (runtimeProfile->debugLabels) {
+            char name[64];
+            SDL_snprintf(name, sizeof(name), "scene mesh %u vertices", i);
+            NameBuffer(sceneVertexBuffers[i], name);
+            SDL_snprintf(name, sizeof(name), "scene mesh %u indices", i);
+            NameBuffer(sceneIndexBuffers[i], name);
+        }
+        CmdStream_RegisterBuffer(sceneVertexBuffers[i], vertexBufInfo.usage, vertexSize, mesh->vertices);
+        CmdStream_RegisterBuffer(sceneIndexBuffers[i], indexBufInfo.usage, indexSize, mesh->indices);
+        transferSize += vertexSize + indexSize;
+        
+        /* Overdraw copy: same positions, constant per-layer increment */
+        if (overdrawMode) {
+            sceneOverdrawBuffers[i] = SDL_CreateGPUBuffer(gpuDevice, &vertexBufInfo);
+            if (!sceneOverdrawBuffers[i]) {
+                SDL_Log("Failed to create scene overdraw buffer: %s", SDL_GetError());
+                return 1;
+            }
+            transferSize += vertexSize;
+        }
     }
     
-    XR_LOAD(xrEnumerateViewConfigurationViews);
-    XR_LOAD(xrEnumerateSwapchainImages);
-    XR_LOAD(xrCreateReferenceSpace);
-    XR_LOAD(xrDestroySpace);
-    XR_LOAD(xrDestroySession);
-    XR_LOAD(xrPollEvent);
-    XR_LOAD(xrBeginSession);
-    XR_LOAD(xrEndSession);
-    XR_LOAD(xrWaitFrame);
-    XR_LOAD(xrBeginFrame);
-    XR_LOAD(xrEndFrame);
-    XR_LOAD(xrLocateViews);
-    XR_LOAD(xrAcquireSwapchainImage);
-    XR_LOAD(xrWaitSwapchainImage);
-    XR_LOAD(xrReleaseSwapchainImage);
+    SDL_GPUTransferBufferCreateInfo transferInfo = {
+        .usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
+        .size = transferSize
+    };
+    SDL_GPUTransferBuffer *transfer = SDL_CreateGPUTransferBuffer(gpuDevice, &transferInfo);
+    if (!transfer) {
+        SDL_Log("Failed to create scene transfer buffer: %s", SDL_GetError());
+        return 1;
+    }
     
-#undef XR_LOAD
+    Uint8 *data = SDL_MapGPUTransferBuffer(gpuDevice, transfer, false);
+    SDL_GPUCommandBuffer *cmd = SDL_AcquireGPUCommandBuffer(gpuDevice);
+    SDL_GPUCopyPass *copyPass = SDL_BeginGPUCopyPass(cmd);
     
-    SDL_Log("Loaded all XR functions successfully");
+    Uint32 offset = 0;
+    for (Uint32 i = 0; i < meshCount; i++) {
+        const SceneMesh *mesh = &activeScene->meshes[i];
+        Uint32 vertexSize = mesh->vertexCount * (Uint32)sizeof(PositionColorVertex);
+        Uint32 indexSize = mesh->indexCount * (Uint32)sizeof(Uint32);
+        SDL_memcpy(data + offset, mesh->vertices, vertexSize);
+        SDL_memcpy(data + offset + vertexSize, mesh->indices, indexSize);
+        
+        SDL_GPUTransferBufferLocation srcVertex = { .transfer_buffer = transfer, .offset = offset };
+        SDL_GPUBufferRegion dstVertex = { .buffer = sceneVertexBuffers[i], .offset = 0, .size = vertexSize };
+        SDL_UploadToGPUBuffer(copyPass, &srcVertex, &dstVertex, false);
+        
+        SDL_GPUTransferBufferLocation srcIndex = { .transfer_buffer = transfer, .offset = offset + vertexSize };
+        SDL_GPUBufferRegion dstIndex = { .buffer = sceneIndexBuffers[i], .offset = 0, .size = indexSize };
+        SDL_UploadToGPUBuffer(copyPass, &srcIndex, &dstIndex, false);
+        
+        offset += vertexSize + indexSize;
+        
+        if (overdrawMode) {
+            PositionColorVertex *overdrawVertices = (PositionColorVertex *)(data + offset);
+            for (Uint32 v = 0; v < mesh->vertexCount; v++) {
+                overdrawVertices[v] = mesh->vertices[v];
+                overdrawVertices[v].r = overdrawVertices[v].g = overdrawVertices[v].b = OVERDRAW_INCREMENT;
+                overdrawVertices[v].a = OVERDRAW_INCREMENT;
+            }
+            SDL_GPUTransferBufferLocation srcOverdraw = { .transfer_buffer = transfer, .offset = offset };
+            SDL_GPUBufferRegion dstOverdraw = { .buffer = sceneOverdrawBuffers[i], .offset = 0, .size = vertexSize };
+            SDL_UploadToGPUBuffer(copyPass, &srcOverdraw, &dstOverdraw, false);
+            offset += vertexSize;
+        }
+    }
+    
+    SDL_UnmapGPUTransferBuffer(gpuDevice, transfer);
+    SDL_EndGPUCopyPass(copyPass);
+    SDL_SubmitGPUCommandBuffer(cmd);
+    SDL_ReleaseGPUTransferBuffer(gpuDevice, transfer);
+    
+    SDL_Log("Created scene buffers (%u bytes)", transferSize);
     return 0;
 }
 
-static int InitXRSession(void)
+/* ========================================================================
+ * Render Paths
+ * ======================================================================== */
+
+static const char *RenderPathName(int path)
 {
-    XrResult result;
-    
-    /* Create session */
-    XrSessionCreateInfo sessionCreateInfo = { XR_TYPE_SESSION_CREATE_INFO };
-    result = SDL_CreateGPUXRSession(gpuDevice, &sessionCreateInfo, &xrSession);
-    XR_ERR_LOG(result, "Failed to create XR session");
-    
-    SDL_Log("Created OpenXR session: %p", (void*)xrSession);
-    
-    /* Create reference space */
-    XrReferenceSpaceCreateInfo spaceCreateInfo = { XR_TYPE_REFERENCE_SPACE_CREATE_INFO };
-    spaceCreateInfo.referenceSpaceType = XR_REFERENCE_SPACE_TYPE_LOCAL;
-    spaceCreateInfo.poseInReferenceSpace.orientation.w = 1.0f; /* Identity quaternion */
-    
-    result = pfn_xrCreateReferenceSpace(xrSession, &spaceCreateInfo, &xrLocalSpace);
-    XR_ERR_LOG(result, "Failed to create reference space");
-    
-    return 0;
+    return path == RENDER_PATH_STEREO ? "single-pass-stereo" : DrawPaths_Name((DrawPathKind)path);
 }
 
-static int CreateSwapchains(void)
+/* The draw path a render path records with */
+static DrawPathKind RenderPathKind(int path)
 {
-    XrResult result;
-    
-    /* Get view configuration */
-    result = pfn_xrEnumerateViewConfigurationViews(
-        xrInstance, xrSystemId,
-        XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO,
-        0, &viewCount, NULL);
-    XR_ERR_LOG(result, "Failed to enumerate view config views (count)");
+    return path == RENDER_PATH_STEREO ? DRAWPATH_INSTANCED : (DrawPathKind)path;
+}
+
+/* NULL if the path can draw the current content. Paths other than uniform
+ * draw one mesh with one opaque material through their own pipelines. */
+static const char *RenderPathUnsupportedReason(int path)
+{
+    if (path == DRAWPATH_UNIFORM) return NULL;
+    if (overdrawMode) return "the overdraw view always draws per object";
+    if (!DrawPaths_IsAvailable(drawPaths, RenderPathKind(path))) return "its pipeline could not be created";
+    if (activeScene) {
+        const SceneMaterial *material = &activeScene->materials[0];
+        if (activeScene->materialCount > 1 || material->blend || material->doubleSided) {
+            return "the scene needs per-material pipelines";
+        }
+        if (path == DRAWPATH_VERTEX_PULLING && activeScene->config.kind == SCENE_VERTEX_HEAVY) {
+            return "vertex pulling only builds cubes";
+        }
+    }
+    return NULL;
+}
+
+static bool SetRenderPath(int path)
+{
+    const char *reason = RenderPathUnsupportedReason(path);
+    if (reason) {
+        SDL_Log("Render path %s unavailable: %s", RenderPathName(path), reason);
+        return false;
+    }
+    activeRenderPath = path;
+    statsStartNs = 0;
+    SDL_Log("Render path: %s", RenderPathName(path));
+    return true;
+}
+
+/* Hotkey and controller switches; a benchmark run keeps the path it started with */
+static void SwitchRenderPath(int path)
+{
+    if (Bench_IsEnabled()) {
+        SDL_Log("Render path stays %s for the benchmark run", RenderPathName(activeRenderPath));
+        return;
+    }
+    SetRenderPath(path);
+}
+
+static void CycleRenderPath(void)
+{
+    for (int step = 1; step < RENDER_PATH_COUNT; step++) {
+        int path = (activeRenderPath + step) % RENDER_PATH_COUNT;
+        if (!RenderPathUnsupportedReason(path)) {
+            SwitchRenderPath(path);
+            return;
+        }
+    }
+}
+
+/* Created with the cube and scene buffers. Without draw paths only the uniform path is left. */
+static int InitRenderPaths(void)
+{
+    Uint32 objectCount = activeScene ? activeScene->objectCount : NUM_CUBES;
+    visibleModels = SDL_malloc(objectCount * sizeof(Mat4));
+    pathViewProjs = SDL_malloc(viewCount * sizeof(Mat4));
+    if (!visibleModels || !pathViewProjs) {
+        SDL_Log("Failed to allocate render path state");
+        return 1;
+    }
+    
+    if (!overdrawMode) {
+        drawPaths = DrawPaths_Create(gpuDevice, vrSwapchains[0].format, objectCount);
+        if (!drawPaths) {
+            SDL_Log("Draw paths unavailable; rendering with per-object uniforms only");
+        }
+    }
+    if (!SetRenderPath(requestedRenderPath)) {
+        SetRenderPath(DRAWPATH_UNIFORM);
+    }
+    if (Bench_IsEnabled()) {
+        Bench_SetInfo("render_path", RenderPathName(activeRenderPath));
+    }
+    return 0;
+}
+
+/* Bakes an impostor atlas for every scene mesh; without them every object is drawn as a mesh */
+static void InitImpostors(void)
+{
+    sceneImpostors = SDL_calloc(activeScene->objectCount, sizeof(bool));
+    if (sceneImpostors) {
+        impostors = Impostors_Create(gpuDevice, vrSwapchains[0].format, activeScene->meshCount,
+                                     activeScene->objectCount);
+    }
+    for (Uint32 i = 0; i < activeScene->meshCount && impostors; i++) {
+        const SceneMesh *mesh = &activeScene->meshes[i];
+        if (!Impostors_Bake(impostors, i, sceneVertexBuffers[i], sceneIndexBuffers[i], mesh->indexCount,
+                            mesh->boundRadius)) {
+            Impostors_Destroy(impostors);
+            impostors = NULL;
+        }
+    }
+    if (!impostors) {
+        SDL_Log("Impostors unavailable; drawing every object as a mesh");
+        return;
+    }
+    SDL_Log("Drawing opaque objects beyond %.1f m as impostors", impostorDistance);
+    if (Bench_IsEnabled()) {
+        Bench_SetInfoNumber("impostor_distance", impostorDistance);
+    }
+}
+
+/* Splits the large scene meshes into meshlets; without a culler every object is drawn whole */
+static void InitMeshlets(void)
+{
+    sceneMeshlets = SDL_calloc(activeScene->meshCount, sizeof(MeshletMesh));
+    meshletObjects = SDL_calloc(activeScene->objectCount, sizeof(MeshletObject));
+    sceneClusterSlots = SDL_malloc(activeScene->objectCount * sizeof(Uint32));
+    bool built = sceneMeshlets && meshletObjects && sceneClusterSlots;
+    for (Uint32 i = 0; i < activeScene->meshCount && built; i++) {
+        const SceneMesh *mesh = &activeScene->meshes[i];
+        built = Meshlets_Build(mesh->vertices, mesh->vertexCount, mesh->indices, mesh->indexCount,
+                               &sceneMeshlets[i]);
+    }
+    
+    /* Room for every clustered object at once, each with all of its triangles */
+    Uint32 maxObjects = 0, maxIndices = 0;
+    for (Uint32 i = 0; i < activeScene->objectCount && built; i++) {
+        const SceneObject *object = &activeScene->objects[i];
+        if (sceneMeshlets[object->mesh].meshletCount > 0 && !activeScene->materials[object->material].blend) {
+            maxObjects++;
+            maxIndices += activeScene->meshes[object->mesh].indexCount;
+        }
+    }
+    if (built && maxObjects > 0) {
+        meshletCuller = Meshlets_CreateCuller(gpuDevice, sceneMeshlets, activeScene->meshCount, viewCount,
+                                              maxObjects, maxIndices);
+    }
+    if (!meshletCuller) {
+        SDL_Log("Meshlet culling unavailable; drawing every object whole");
+        return;
+    }
+    SDL_Log("Culling %u large objects per meshlet", maxObjects);
+    if (Bench_IsEnabled()) {
+        Bench_SetInfo("meshlets", "on");
+    }
+}
+
+/* ========================================================================
+ * OpenXR Function Loading
+ * ======================================================================== */
+
+/* Asks the loader which extensions the runtime offers, before SDL creates the
+ * instance, so optional ones can be added to its extension list */
+static void QueryRuntimeExtensions(void)
+{
+    if (!SDL_OpenXR_LoadLibrary()) {
+        SDL_Log("Failed to load the OpenXR loader: %s", SDL_GetError());
+        return;
+    }
+    
+    PFN_xrGetInstanceProcAddr getInstanceProcAddr = SDL_OpenXR_GetXrGetInstanceProcAddr();
+    PFN_xrEnumerateInstanceExtensionProperties enumerateExtensions = NULL;
+    if (getInstanceProcAddr &&
+        XR_SUCCEEDED(getInstanceProcAddr(XR_NULL_HANDLE, "xrEnumerateInstanceExtensionProperties",
+                                         (PFN_xrVoidFunction *)&enumerateExtensions))) {
+        uint32_t count = 0;
+        if (XR_SUCCEEDED(enumerateExtensions(NULL, 0, &count, NULL)) && count > 0) {
+            runtimeExtensions = SDL_calloc(count, sizeof(XrExtensionProperties));
+            for (uint32_t i = 0; runtimeExtensions && i < count; i++) {
+                runtimeExtensions[i].type = XR_TYPE_EXTENSION_PROPERTIES;
+            }
+            if (runtimeExtensions && XR_SUCCEEDED(enumerateExtensions(NULL, count, &count, runtimeExtensions))) {
+                runtimeExtensionCount = count;
+            }
+        }
+    }
+    
+    SDL_OpenXR_UnloadLibrary();
+    SDL_Log("Runtime offers %u instance extensions", runtimeExtensionCount);
+}
+
+static bool RuntimeHasExtension(const char *name)
+{
+    for (uint32_t i = 0; i < runtimeExtensionCount; i++) {
+        if (SDL_strcmp(runtimeExtensions[i].extensionName, name) == 0) return true;
+    }
+    return false;
+}
+
+/* Load OpenXR function pointers after instance is created */
+static int LoadXRFunctions(void)
+{
+    pfn_xrGetInstanceProcAddr = mockRuntime ? MockXR_GetInstanceProcAddr : SDL_OpenXR_GetXrGetInstanceProcAddr();
+    if (!pfn_xrGetInstanceProcAddr) {
+        SDL_Log("Failed to get xrGetInstanceProcAddr");
+        return 1;
+    }
+
+#define XR_LOAD(fn) \
+    if (XR_FAILED(pfn_xrGetInstanceProcAddr(xrInstance, #fn, (PFN_xrVoidFunction*)&pfn_##fn))) { \
+        SDL_Log("Failed to load " #fn); \
+        return 1; \
+    }
+    
+    XR_LOAD(xrEnumerateViewConfigurations);
+    XR_LOAD(xrEnumerateViewConfigurationViews);
+    XR_LOAD(xrEnumerateSwapchainImages);
+    XR_LOAD(xrCreateReferenceSpace);
+    XR_LOAD(xrDestroySpace);
+    XR_LOAD(xrDestroySession);
+    XR_LOAD(xrPollEvent);
+    XR_LOAD(xrBeginSession);
+    XR_LOAD(xrEndSession);
+    XR_LOAD(xrRequestExitSession);
+    XR_LOAD(xrWaitFrame);
+    XR_LOAD(xrBeginFrame);
+    XR_LOAD(xrEndFrame);
+    XR_LOAD(xrLocateViews);
+    XR_LOAD(xrAcquireSwapchainImage);
+    XR_LOAD(xrWaitSwapchainImage);
+    XR_LOAD(xrReleaseSwapchainImage);
+    XR_LOAD(xrStringToPath);
+    XR_LOAD(xrCreateActionSet);
+    XR_LOAD(xrDestroyActionSet);
+    XR_LOAD(xrCreateAction);
+    XR_LOAD(xrSuggestInteractionProfileBindings);
+    XR_LOAD(xrAttachSessionActionSets);
+    XR_LOAD(xrSyncActions);
+    XR_LOAD(xrCreateActionSpace);
+    XR_LOAD(xrGetActionStatePose);
+    XR_LOAD(xrGetActionStateBoolean);
+    XR_LOAD(xrLocateSpace);
+    
+#undef XR_LOAD
+    
+    /* Optional: without it, Spaces_ falls back to one xrLocateSpace per space */
+    if (XR_FAILED(pfn_xrGetInstanceProcAddr(xrInstance, "xrLocateSpacesKHR",
+                                            (PFN_xrVoidFunction *)&pfn_xrLocateSpacesKHR))) {
+        pfn_xrLocateSpacesKHR = NULL;
+    }
+    /* Optional: without it, the governor only trades quality */
+    if (XR_FAILED(pfn_xrGetInstanceProcAddr(xrInstance, "xrPerfSettingsSetPerformanceLevelEXT",
+                                            (PFN_xrVoidFunction *)&pfn_xrPerfSettingsSetPerformanceLevelEXT))) {
+        pfn_xrPerfSettingsSetPerformanceLevelEXT = NULL;
+    }
+    /* Optional: without it, the display runs at whatever rate the runtime picked */
+    if (XR_FAILED(pfn_xrGetInstanceProcAddr(xrInstance, "xrEnumerateDisplayRefreshRatesFB",
+                                            (PFN_xrVoidFunction *)&pfn_xrEnumerateDisplayRefreshRatesFB)) ||
+        XR_FAILED(pfn_xrGetInstanceProcAddr(xrInstance, "xrGetDisplayRefreshRateFB",
+                                            (PFN_xrVoidFunction *)&pfn_xrGetDisplayRefreshRateFB)) ||
+        XR_FAILED(pfn_xrGetInstanceProcAddr(xrInstance, "xrRequestDisplayRefreshRateFB",
+                                            (PFN_xrVoidFunction *)&pfn_xrRequestDisplayRefreshRateFB))) {
+        pfn_xrEnumerateDisplayRefreshRatesFB = NULL;
+        pfn_xrGetDisplayRefreshRateFB = NULL;
+        pfn_xrRequestDisplayRefreshRateFB = NULL;
+    }
+    
+    SDL_Log("Loaded all XR functions successfully");
+    return 0;
+}
+
+/* Picks the requested view configuration if the runtime offers it, else stereo */
+static int SelectViewConfiguration(void)
+{
+    uint32_t count = 0;
+    XrResult result = pfn_xrEnumerateViewConfigurations(xrInstance, xrSystemId, 0, &count, NULL);
+    XR_ERR_LOG(result, "Failed to enumerate view configurations (count)");
+    
+    XrViewConfigurationType *types = SDL_calloc(count, sizeof(XrViewConfigurationType));
+    if (!types) return 1;
+    result = pfn_xrEnumerateViewConfigurations(xrInstance, xrSystemId, count, &count, types);
+    if (XR_FAILED(result)) {
+        SDL_free(types);
+        XR_ERR_LOG(result, "Failed to enumerate view configurations");
+    }
+    
+    bool haveRequested = false, haveStereo = false;
+    for (uint32_t i = 0; i < count; i++) {
+        haveRequested |= types[i] == requestedViewConfig;
+        haveStereo |= types[i] == XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO;
+    }
+    
+    if (haveRequested) {
+        xrViewConfigType = requestedViewConfig;
+    } else if (haveStereo) {
+        SDL_Log("View configuration %d not offered, using stereo", (int)requestedViewConfig);
+        xrViewConfigType = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO;
+    } else if (count > 0) {
+        SDL_Log("View configuration %d not offered, using %d", (int)requestedViewConfig, (int)types[0]);
+        xrViewConfigType = types[0];
+    }
+    SDL_free(types);
+    
+    if (count == 0) {
+        SDL_Log("Runtime offers no view configurations");
+        return 1;
+    }
+    
+    SDL_Log("Using view configuration %d", (int)xrViewConfigType);
+    return 0;
+}
+
+static int InitXRSession(void)
+{
+    XrResult result;
+    
+    /* Create session */
+    XrSessionCreateInfo sessionCreateInfo = { XR_TYPE_SESSION_CREATE_INFO };
+    result = createXRSession(gpuDevice, &sessionCreateInfo, &xrSession);
+    XR_ERR_LOG(result, "Failed to create XR session");
+    
+    SDL_Log("Created OpenXR session: %p", (void*)xrSession);
+    
+    /* Create reference space */
+    XrReferenceSpaceCreateInfo spaceCreateInfo = { XR_TYPE_REFERENCE_SPACE_CREATE_INFO };
+    spaceCreateInfo.referenceSpaceType = XR_REFERENCE_SPACE_TYPE_LOCAL;
+    spaceCreateInfo.poseInReferenceSpace.orientation.w = 1.0f; /* Identity quaternion */
+    
+    result = pfn_xrCreateReferenceSpace(xrSession, &spaceCreateInfo, &xrLocalSpace);
+    XR_ERR_LOG(result, "Failed to create reference space");
+    
+    if (!Spaces_Init(xrSession, pfn_xrLocateSpace, pfn_xrLocateSpacesKHR)) return 1;
+    
+    return 0;
+}
+
+static int SDLCALL CompareRatesDescending(const void *a, const void *b)
+{
+    float x = *(const float *)a, y = *(const float *)b;
+    return (x < y) - (x > y);
+}
+
+/* Collects the offered rates up to maxRefreshRate, fastest first, and starts
+ * at the fastest of them */
+static void InitRefreshRates(void)
+{
+    if (!pfn_xrEnumerateDisplayRefreshRatesFB) return;
+    if (maxRefreshRate <= 0.0f) maxRefreshRate = mockRuntime ? mockConfig.refreshRate : 90.0f;
+    
+    uint32_t count = 0;
+    if (XR_FAILED(pfn_xrEnumerateDisplayRefreshRatesFB(xrSession, 0, &count, NULL)) || count == 0) return;
+    float *offered = SDL_malloc(count * sizeof(float));
+    if (!offered) return;
+    if (XR_FAILED(pfn_xrEnumerateDisplayRefreshRatesFB(xrSession, count, &count, offered))) count = 0;
+    
+    SDL_qsort(offered, count, sizeof(float), CompareRatesDescending);
+    for (uint32_t i = 0; i < count && refreshRateCount < GOVERNOR_MAX_RATES; i++) {
+        if (offered[i] <= maxRefreshRate + 0.5f) refreshRates[refreshRateCount++] = offered[i];
+    }
+    SDL_free(offered);
+    
+    float current = 0.0f;
+    pfn_xrGetDisplayRefreshRateFB(xrSession, &current);
+    if (refreshRateCount == 0) {
+        SDL_Log("No display refresh rate up to %.0f Hz offered, staying at %.0f Hz", maxRefreshRate, current);
+        return;
+    }
+    SDL_Log("Display refresh rates up to %.0f Hz: %u offered, starting at %.0f Hz (was %.0f Hz)",
+            maxRefreshRate, (unsigned)refreshRateCount, refreshRates[0], current);
+    if (refreshRates[0] != current) {
+        XrResult result = pfn_xrRequestDisplayRefreshRateFB(xrSession, refreshRates[0]);
+        if (XR_FAILED(result)) SDL_Log("xrRequestDisplayRefreshRateFB failed (result=%d)", (int)result);
+    }
+}
+
+/* Per-view layer counters sized to match each eye swapchain */
+static int CreateOverdrawTargets(void)
+{
+    for (uint32_t i = 0; i < viewCount; i++) {
+        SDL_GPUTextureCreateInfo textureInfo = {
+            .type = SDL_GPU_TEXTURETYPE_2D,
+            .format = SDL_GPU_TEXTUREFORMAT_R8_UNORM,
+            .usage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET | SDL_GPU_TEXTUREUSAGE_SAMPLER,
+            .width = (Uint32)vrSwapchains[i].size.width,
+            .height = (Uint32)vrSwapchains[i].size.height,
+            .layer_count_or_depth = 1,
+            .num_levels = 1
+        };
+        vrSwapchains[i].overdrawTexture = SDL_CreateGPUTexture(gpuDevice, &textureInfo);
+        if (!vrSwapchains[i].overdrawTexture) {
+            SDL_Log("Failed to create overdraw target %u: %s", i, SDL_GetError());
+            return 1;
+        }
+        if (runtimeProfile->debugLabels) {
+            char name[64];
+            SDL_snprintf(name, sizeof(name), "overdraw target view %u", i);
+            NameTexture(vrSwapchains[i].overdrawTexture, name);
+        }
+    }
+    
+    SDL_Log("Overdraw mode enabled%s", overdrawStats ? " with per-eye stats" : "");
+    return 0;
+}
+
+static int CreateSwapchains(void)
+{
+    XrResult result;
+    
+    /* Get view configuration */
+    result = pfn_xrEnumerateViewConfigurationViews(
+        xrInstance, xrSystemId,
+        xrViewConfigType,
+        0, &viewCount, NULL);
+    XR_ERR_LOG(result, "Failed to enumerate view config views (count)");
     
     SDL_Log("View count: %u", viewCount);
     
@@ -432,134 +1417,1102 @@ static int CreateSwapchains(void)
     
     result = pfn_xrEnumerateViewConfigurationViews(
         xrInstance, xrSystemId,
-        XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO,
+        xrViewConfigType,
         viewCount, &viewCount, viewConfigs);
     XR_ERR_LOG(result, "Failed to enumerate view config views");
     
-    /* Allocate swapchains and views */
-    vrSwapchains = SDL_calloc(viewCount, sizeof(VRSwapchain));
-    xrViews = SDL_calloc(viewCount, sizeof(XrView));
+    /* Allocate swapchains and views */
+    vrSwapchains = SDL_calloc(viewCount, sizeof(VRSwapchain));
+    xrViews = SDL_calloc(viewCount, sizeof(XrView));
+    projViews = SDL_calloc(viewCount, sizeof(XrCompositionLayerProjectionView));
+    
+    for (uint32_t i = 0; i < viewCount; i++) {
+        xrViews[i].type = XR_TYPE_VIEW;
+        xrViews[i].pose.orientation.w = 1.0f;
+        
+        SDL_Log("View %u: recommended %ux%u", i,
+                viewConfigs[i].recommendedImageRectWidth,
+                viewConfigs[i].recommendedImageRectHeight);
+        
+        /* Create swapchain using OpenXR's XrSwapchainCreateInfo */
+        XrSwapchainCreateInfo swapchainCreateInfo = { XR_TYPE_SWAPCHAIN_CREATE_INFO };
+        swapchainCreateInfo.usageFlags = XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT | XR_SWAPCHAIN_USAGE_SAMPLED_BIT;
+        if (Capture_IsEnabled()) {
+            swapchainCreateInfo.usageFlags |= XR_SWAPCHAIN_USAGE_TRANSFER_SRC_BIT; /* Eye image downloads */
+        }
+        swapchainCreateInfo.format = 0; /* Let SDL pick the format */
+        swapchainCreateInfo.sampleCount = 1;
+        swapchainCreateInfo.width = viewConfigs[i].recommendedImageRectWidth;
+        swapchainCreateInfo.height = viewConfigs[i].recommendedImageRectHeight;
+        swapchainCreateInfo.faceCount = 1;
+        swapchainCreateInfo.arraySize = 1;
+        swapchainCreateInfo.mipCount = 1;
+        
+        result = createXRSwapchain(
+            gpuDevice,
+            xrSession,
+            &swapchainCreateInfo,
+            &vrSwapchains[i].format,
+            &vrSwapchains[i].swapchain,
+            &vrSwapchains[i].images);
+        
+        if (XR_FAILED(result)) {
+            SDL_Log("Failed to create swapchain %u", i);
+            SDL_free(viewConfigs);
+            return 1;
+        }
+        
+        /* Get image count by enumerating swapchain images */
+        result = pfn_xrEnumerateSwapchainImages(vrSwapchains[i].swapchain, 0, &vrSwapchains[i].imageCount, NULL);
+        if (XR_FAILED(result)) {
+            vrSwapchains[i].imageCount = 3; /* Assume 3 if we can't query */
+        }
+        
+        vrSwapchains[i].size.width = (int32_t)swapchainCreateInfo.width;
+        vrSwapchains[i].size.height = (int32_t)swapchainCreateInfo.height;
+        
+        SDL_Log("Created swapchain %u: %dx%d, %u images",
+                i, vrSwapchains[i].size.width, vrSwapchains[i].size.height,
+                vrSwapchains[i].imageCount);
+    }
+    
+    SDL_free(viewConfigs);
+    
+    /* Create the pipeline using the swapchain format */
+    if (viewCount > 0 && pipeline == NULL) {
+        Startup_BeginPhase("CreatePipeline");
+        int failed = CreatePipeline(vrSwapchains[0].format);
+        Startup_EndPhase();
+        if (failed) {
+            return 1;
+        }
+        Startup_BeginPhase("CreateCubeBuffers");
+        failed = CreateCubeBuffers();
+        Startup_EndPhase();
+        if (failed) {
+            return 1;
+        }
+        if (activeScene) {
+            Startup_BeginPhase("CreateSceneBuffers");
+            failed = CreateSceneBuffers();
+            Startup_EndPhase();
+            if (failed) {
+                return 1;
+            }
+        }
+        Startup_BeginPhase("InitRenderPaths");
+        failed = InitRenderPaths();
+        Startup_EndPhase();
+        if (failed) {
+            return 1;
+        }
+        if (activeScene && impostorDistance > 0.0f && !overdrawMode) {
+            Startup_BeginPhase("InitImpostors");
+            InitImpostors();
+            Startup_EndPhase();
+        }
+        if (activeScene && meshletsEnabled && !overdrawMode) {
+            Startup_BeginPhase("InitMeshlets");
+            InitMeshlets();
+            Startup_EndPhase();
+        }
+        
+        if (Bench_IsEnabled()) {
+            Bench_SetInfoNumber("views", (double)viewCount);
+            Bench_SetInfoNumber("width", (double)vrSwapchains[0].size.width);
+            Bench_SetInfoNumber("height", (double)vrSwapchains[0].size.height);
+        }
+    }
+    
+    if (overdrawMode && CreateOverdrawTargets() != 0) {
+        return 1;
+    }
+    
+    return 0;
+}
+
+/* Latest notification level per domain and sub-domain, 0 being unused */
+static XrPerfSettingsNotificationLevelEXT perfNotifications[GOVERNOR_DOMAIN_COUNT][4];
+
+/* Only heat says anything about clocks: a domain the runtime warns is hot may
+ * go no higher than sustained low, and once impaired (already throttled) only
+ * power savings is left. Missed compositing or rendering deadlines are
+ * pressure on the quality knobs instead, one step for a warning and two once
+ * impaired, with the worse of the two sub-domains counting. */
+static void HandlePerfSettingsEvent(const XrEventDataPerfSettingsEXT *event)
+{
+    static const char *const subDomains[] = { "", "compositing", "rendering", "thermal" };
+    GovernorDomain domain = event->domain == XR_PERF_SETTINGS_DOMAIN_CPU_EXT ? GOVERNOR_DOMAIN_CPU : GOVERNOR_DOMAIN_GPU;
+    bool knownSubDomain = event->subDomain >= XR_PERF_SETTINGS_SUB_DOMAIN_COMPOSITING_EXT &&
+                          event->subDomain <= XR_PERF_SETTINGS_SUB_DOMAIN_THERMAL_EXT;
+    
+    SDL_Log("Runtime %s %s notification: level %d -> %d", domain == GOVERNOR_DOMAIN_CPU ? "CPU" : "GPU",
+            knownSubDomain ? subDomains[event->subDomain] : "unknown", (int)event->fromLevel, (int)event->toLevel);
+    if (!knownSubDomain) return;
+    
+    XrPerfSettingsNotificationLevelEXT *levels = perfNotifications[domain];
+    levels[event->subDomain] = event->toLevel;
+    
+    if (event->subDomain == XR_PERF_SETTINGS_SUB_DOMAIN_THERMAL_EXT) {
+        XrPerfSettingsNotificationLevelEXT thermal = levels[XR_PERF_SETTINGS_SUB_DOMAIN_THERMAL_EXT];
+        int maxLevel = (int)SDL_arraysize(perfLevels) - 1;
+        if (thermal >= XR_PERF_SETTINGS_NOTIF_LEVEL_IMPAIRED_EXT) {
+            maxLevel = 0;
+        } else if (thermal >= XR_PERF_SETTINGS_NOTIF_LEVEL_WARNING_EXT) {
+            maxLevel = 1;
+        }
+        Governor_CapPerformanceLevel(domain, maxLevel);
+    } else {
+        XrPerfSettingsNotificationLevelEXT worst = SDL_max(levels[XR_PERF_SETTINGS_SUB_DOMAIN_COMPOSITING_EXT],
+                                                           levels[XR_PERF_SETTINGS_SUB_DOMAIN_RENDERING_EXT]);
+        int pressure = 0;
+        if (worst >= XR_PERF_SETTINGS_NOTIF_LEVEL_IMPAIRED_EXT) {
+            pressure = 2;
+        } else if (worst >= XR_PERF_SETTINGS_NOTIF_LEVEL_WARNING_EXT) {
+            pressure = 1;
+        }
+        Governor_SetQualityPressure(domain, pressure);
+    }
+}
+
+static void HandleXREvents(void)
+{
+    XrEventDataBuffer eventBuffer = { XR_TYPE_EVENT_DATA_BUFFER };
+    
+    while (pfn_xrPollEvent(xrInstance, &eventBuffer) == XR_SUCCESS) {
+        switch (eventBuffer.type) {
+            case XR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED: {
+                XrEventDataSessionStateChanged *stateEvent = 
+                    (XrEventDataSessionStateChanged*)&eventBuffer;
+                
+                SDL_Log("Session state changed: %d", stateEvent->state);
+                
+                switch (stateEvent->state) {
+                    case XR_SESSION_STATE_READY: {
+                        XrSessionBeginInfo beginInfo = { XR_TYPE_SESSION_BEGIN_INFO };
+                        beginInfo.primaryViewConfigurationType = xrViewConfigType;
+                        
+                        /* Ends the phase main() opened once the rest of initialization was done */
+                        Startup_EndPhase();
+                        
+                        Startup_BeginPhase("xrBeginSession");
+                        XrResult result = pfn_xrBeginSession(xrSession, &beginInfo);
+                        Startup_EndPhase();
+                        if (XR_SUCCEEDED(result)) {
+                            SDL_Log("XR Session begun!");
+                            xrSessionRunning = true;
+                            
+                            /* Create swapchains now that session is ready */
+                            Startup_BeginPhase("CreateSwapchains");
+                            int failed = CreateSwapchains();
+                            Startup_EndPhase();
+                            if (failed) {
+                                SDL_Log("Failed to create swapchains");
+                                xrShouldQuit = true;
+                            }
+                            Startup_BeginPhase("first frame");
+                        }
+                        break;
+                    }
+                    case XR_SESSION_STATE_STOPPING:
+                        pfn_xrEndSession(xrSession);
+                        xrSessionRunning = false;
+                        break;
+                    case XR_SESSION_STATE_EXITING:
+                    case XR_SESSION_STATE_LOSS_PENDING:
+                        xrShouldQuit = true;
+                        break;
+                    default:
+                        break;
+                }
+                break;
+            }
+            case XR_TYPE_EVENT_DATA_INSTANCE_LOSS_PENDING:
+                xrShouldQuit = true;
+                break;
+            case XR_TYPE_EVENT_DATA_PERF_SETTINGS_EXT:
+                HandlePerfSettingsEvent((const XrEventDataPerfSettingsEXT *)&eventBuffer);
+                break;
+            case XR_TYPE_EVENT_DATA_DISPLAY_REFRESH_RATE_CHANGED_FB: {
+                const XrEventDataDisplayRefreshRateChangedFB *rateEvent =
+                    (const XrEventDataDisplayRefreshRateChangedFB *)&eventBuffer;
+                SDL_Log("Display refresh rate changed: %.0f -> %.0f Hz",
+                        rateEvent->fromDisplayRefreshRate, rateEvent->toDisplayRefreshRate);
+                break;
+            }
+            default:
+                break;
+        }
+        
+        eventBuffer.type = XR_TYPE_EVENT_DATA_BUFFER;
+    }
+}
+
+/* Bounding sphere radius of an unscaled cube (0.25m half-size) */
+#define CUBE_BOUND_RADIUS 0.433f
+
+/* Build every cube's model matrix once per frame; views only multiply in their view-projection */
+static void UpdateCubeModels(void)
+{
+    for (int cubeIdx = 0; cubeIdx < NUM_CUBES; cubeIdx++) {
+        float rot = animTime * cubeSpeeds[cubeIdx];
+        Vec3 pos = cubePositions[cubeIdx];
+        
+        /* Build model matrix: scale -> rotateY -> rotateX -> translate */
+        Mat4 scale = Mat4_Scale(cubeScales[cubeIdx]);
+        Mat4 rotY = Mat4_RotationY(rot);
+        Mat4 rotX = Mat4_RotationX(rot * 0.7f);
+        Mat4 trans = Mat4_Translation(pos.x, pos.y, pos.z);
+        
+        cubeModels[cubeIdx] = Mat4_Multiply(Mat4_Multiply(Mat4_Multiply(scale, rotY), rotX), trans);
+    }
+}
+
+/* Record every visible cube into an open render pass using the given vertex colors.
+ * stats, when not NULL, accumulates what was recorded. */
+static void DrawCubes(SDL_GPUCommandBuffer *cmdBuf, SDL_GPURenderPass *renderPass,
+                      SDL_GPUBuffer *cubeVertices, Mat4 viewMatrix, Mat4 projMatrix, BenchRenderStats *stats)
+{
+    SDL_GPUBufferBinding vertexBinding = {cubeVertices, 0};
+    CmdStream_BindVertexBuffers(renderPass, 0, &vertexBinding, 1);
+    
+    SDL_GPUBufferBinding indexBinding = {indexBuffer, 0};
+    CmdStream_BindIndexBuffer(renderPass, &indexBinding, SDL_GPU_INDEXELEMENTSIZE_16BIT);
+    
+    Mat4 viewProj = Mat4_Multiply(viewMatrix, projMatrix);
+    
+    PushDebugGroup(cmdBuf, "cubes");
+    
+    /* Draw each cube; narrow inset views usually reject most of them */
+    for (int cubeIdx = 0; cubeIdx < NUM_CUBES; cubeIdx++) {
+        if (!SphereInFrustum(&viewProj, cubePositions[cubeIdx], CUBE_BOUND_RADIUS * cubeScales[cubeIdx])) {
+            if (stats) stats->culledObjects++;
+            continue;
+        }
+        
+        Mat4 mvp = Mat4_Multiply(cubeModels[cubeIdx], viewProj);
+        
+        CmdStream_PushVertexUniformData(cmdBuf, 0, &mvp, sizeof(mvp));
+        CmdStream_DrawIndexedPrimitives(renderPass, 36, 1, 0, 0, 0);
+        if (stats) {
+            stats->drawCalls++;
+            stats->triangles += 12;
+        }
+    }
+    
+    PopDebugGroup(cmdBuf);
+}
+
+/* Record every visible scene object, switching pipeline and buffers only when
+ * the material or mesh changes from the previous draw. Each run of one material
+ * is a debug group. view, when not -1, is the XR view being drawn: the objects
+ * UpdateImpostors picked this frame are drawn as impostors seen from its eye,
+ * and the objects UpdateMeshlets picked draw what its cull kept. overdraw
+ * draws every object into the layer counter instead, with its overdraw copy
+ * of the mesh and the overdraw pipeline matching its culling. */
+static void DrawScene(SDL_GPUCommandBuffer *cmdBuf, SDL_GPURenderPass *renderPass,
+                      Mat4 viewMatrix, Mat4 projMatrix, int view, bool overdraw, BenchRenderStats *stats)
+{
+    Mat4 viewProj = Mat4_Multiply(viewMatrix, projMatrix);
+    Uint32 boundMaterial = UINT32_MAX;
+    Uint32 boundMesh = UINT32_MAX;
+    bool useImpostors = view >= 0 && impostors && Impostors_Count(impostors) > 0;
+    bool useMeshlets = view >= 0 && meshletCuller;
+    
+    /* Impostors stand in for the far objects and there is no depth buffer,
+     * so they go first and the nearer meshes paint over them */
+    if (useImpostors) {
+        Vec3 eye = { xrViews[view].pose.position.x, xrViews[view].pose.position.y, xrViews[view].pose.position.z };
+        PushDebugGroup(cmdBuf, "impostors (%u objects)", Impostors_Count(impostors));
+        Impostors_Draw(impostors, cmdBuf, renderPass, &viewProj, eye, stats);
+        PopDebugGroup(cmdBuf);
+    }
+    
+    for (Uint32 i = 0; i < activeScene->objectCount; i++) {
+        const SceneObject *object = &activeScene->objects[i];
+        if (useImpostors && sceneImpostors[i]) continue;
+        if (!SphereInFrustum(&viewProj, object->center, object->radius)) {
+            if (stats) stats->culledObjects++;
+            continue;
+        }
+        
+        if (object->material != boundMaterial) {
+            if (boundMaterial != UINT32_MAX) PopDebugGroup(cmdBuf);
+            boundMaterial = object->material;
+            const SceneMaterial *material = &activeScene->materials[boundMaterial];
+            PushDebugGroup(cmdBuf, "%s material %u (%s%s)", Scene_KindName(activeScene->config.kind), boundMaterial,
+                           material->blend ? "blended" : "opaque", material->doubleSided ? ", double-sided" : "");
+            if (overdraw) {
+                CmdStream_BindGraphicsPipeline(renderPass, material->doubleSided ? overdrawPipelineDoubleSided
+                                                                                 : overdrawPipeline);
+            } else {
+                CmdStream_BindGraphicsPipeline(renderPass, scenePipelines[boundMaterial]);
+                CmdStream_PushFragmentUniformData(cmdBuf, 0, material->tint, sizeof(float) * 4);
+            }
+            if (stats) stats->pipelineBinds++;
+        }
+        /* Only the vertex buffer is shared; the culled draw binds its own indices */
+        Uint32 slot = useMeshlets ? sceneClusterSlots[i] : UINT32_MAX;
+        if (slot != UINT32_MAX) {
+            SDL_GPUBufferBinding vertexBinding = {sceneVertexBuffers[object->mesh], 0};
+            CmdStream_BindVertexBuffers(renderPass, 0, &vertexBinding, 1);
+            boundMesh = UINT32_MAX;
+            
+            Mat4 mvp = Mat4_Multiply(object->model, viewProj);
+            CmdStream_PushVertexUniformData(cmdBuf, 0, &mvp, sizeof(mvp));
+            Meshlets_Draw(meshletCuller, renderPass, (Uint32)view, slot);
+            if (stats) stats->drawCalls++;
+            continue;
+        }
+        
+        if (object->mesh != boundMesh) {
+            boundMesh = object->mesh;
+            SDL_GPUBuffer *vertices = overdraw ? sceneOverdrawBuffers[boundMesh] : sceneVertexBuffers[boundMesh];
+            SDL_GPUBufferBinding vertexBinding = {vertices, 0};
+            CmdStream_BindVertexBuffers(renderPass, 0, &vertexBinding, 1);
+            SDL_GPUBufferBinding indexBinding = {sceneIndexBuffers[boundMesh], 0};
+            CmdStream_BindIndexBuffer(renderPass, &indexBinding, SDL_GPU_INDEXELEMENTSIZE_32BIT);
+        }
+        
+        Uint32 indexCount = activeScene->meshes[boundMesh].indexCount;
+        Mat4 mvp = Mat4_Multiply(object->model, viewProj);
+        
+        CmdStream_PushVertexUniformData(cmdBuf, 0, &mvp, sizeof(mvp));
+        CmdStream_DrawIndexedPrimitives(renderPass, indexCount, 1, 0, 0, 0);
+        if (stats) {
+            stats->drawCalls++;
+            stats->triangles += indexCount / 3;
+        }
+    }
+    
+    if (boundMaterial != UINT32_MAX) PopDebugGroup(cmdBuf);
+}
+
+/* Count layers into the view's R8 target, then resolve them to a heatmap in the eye image */
+static void RenderOverdrawView(SDL_GPUCommandBuffer *cmdBuf, VRSwapchain *swapchain, SDL_GPUTexture *targetTexture,
+                               Mat4 viewMatrix, Mat4 projMatrix, BenchRenderStats *stats)
+{
+    SDL_GPUViewport viewport = {0, 0, (float)swapchain->size.width, (float)swapchain->size.height, 0, 1};
+    SDL_Rect scissor = {0, 0, swapchain->size.width, swapchain->size.height};
+    
+    SDL_GPUColorTargetInfo counterTarget = {0};
+    counterTarget.texture = swapchain->overdrawTexture;
+    counterTarget.load_op = SDL_GPU_LOADOP_CLEAR;
+    counterTarget.store_op = SDL_GPU_STOREOP_STORE;
+    
+    PushDebugGroup(cmdBuf, "overdraw count pass");
+    SDL_GPURenderPass *renderPass = SDL_BeginGPURenderPass(cmdBuf, &counterTarget, 1, NULL);
+    SDL_SetGPUViewport(renderPass, &viewport);
+    SDL_SetGPUScissor(renderPass, &scissor);
+    if (activeScene) {
+        DrawScene(cmdBuf, renderPass, viewMatrix, projMatrix, -1, true, stats);
+    } else {
+        SDL_BindGPUGraphicsPipeline(renderPass, overdrawPipeline);
+        DrawCubes(cmdBuf, renderPass, overdrawVertexBuffer, viewMatrix, projMatrix, stats);
+    }
+    SDL_EndGPURenderPass(renderPass);
+    PopDebugGroup(cmdBuf);
+    
+    SDL_GPUColorTargetInfo colorTarget = {0};
+    colorTarget.texture = targetTexture;
+    colorTarget.load_op = SDL_GPU_LOADOP_DONT_CARE;
+    colorTarget.store_op = SDL_GPU_STOREOP_STORE;
+    
+    struct { float maxOverdraw; float padding[3]; } heatmapParams = { overdrawMax, {0} };
+    SDL_GPUTextureSamplerBinding counterBinding = { swapchain->overdrawTexture, overdrawSampler };
+    
+    PushDebugGroup(cmdBuf, "overdraw heatmap pass");
+    renderPass = SDL_BeginGPURenderPass(cmdBuf, &colorTarget, 1, NULL);
+    SDL_BindGPUGraphicsPipeline(renderPass, heatmapPipeline);
+    SDL_SetGPUViewport(renderPass, &viewport);
+    SDL_SetGPUScissor(renderPass, &scissor);
+    SDL_BindGPUFragmentSamplers(renderPass, 0, &counterBinding, 1);
+    SDL_PushGPUFragmentUniformData(cmdBuf, 0, &heatmapParams, sizeof(heatmapParams));
+    SDL_DrawGPUPrimitives(renderPass, 3, 1, 0, 0);
+    SDL_EndGPURenderPass(renderPass);
+    PopDebugGroup(cmdBuf);
+}
+
+/* Runs on the capture worker with the view's R8 layer counts */
+static void LogOverdrawStats(void *userdata, const ReadbackImage *image)
+{
+    (void)userdata;
+    
+    Uint64 pixelCount = (Uint64)image->width * (Uint64)image->height;
+    Uint64 totalLayers = 0, coveredPixels = 0;
+    Uint8 maxLayers = 0;
+    for (Uint32 y = 0; y < image->height; y++) {
+        const Uint8 *layers = image->pixels + (size_t)y * image->pitch;
+        for (Uint32 x = 0; x < image->width; x++) {
+            Uint8 n = layers[x];
+            totalLayers += n;
+            coveredPixels += (n != 0);
+            if (n > maxLayers) maxLayers = n;
+        }
+    }
+    
+    SDL_Log("Overdraw view %u (frame %llu): avg %.2f, avg covered %.2f (%.1f%% covered), max %u",
+            image->tag, (unsigned long long)image->frameIndex,
+            (double)totalLayers / (double)pixelCount,
+            coveredPixels ? (double)totalLayers / (double)coveredPixels : 0.0,
+            100.0 * (double)coveredPixels / (double)pixelCount, maxLayers);
+}
+
+static bool OnOverdrawReadback(void *userdata, const ReadbackImage *image)
+{
+    (void)userdata;
+    return Capture_Defer(image, LogOverdrawStats, NULL);
+}
+
+/* ========================================================================
+ * Render Path Drawing
+ * ======================================================================== */
+
+static DrawPathMesh RenderPathMesh(void)
+{
+    if (activeScene) {
+        return (DrawPathMesh){ sceneVertexBuffers[0], sceneIndexBuffers[0], SDL_GPU_INDEXELEMENTSIZE_32BIT,
+                               activeScene->meshes[0].indexCount };
+    }
+    return (DrawPathMesh){ vertexBuffer, indexBuffer, SDL_GPU_INDEXELEMENTSIZE_16BIT, 36 };
+}
+
+/* Gathers the models of the objects inside any of the given view-projections
+ * and records their upload; call outside any pass. Returns how many passed. */
+static Uint32 UploadVisibleModels(SDL_GPUCommandBuffer *cmdBuf, const Mat4 *viewProjs, Uint32 viewProjCount,
+                                  BenchRenderStats *stats)
+{
+    Uint32 objectCount = activeScene ? activeScene->objectCount : NUM_CUBES;
+    Uint32 visibleCount = 0;
+    
+    for (Uint32 i = 0; i < objectCount; i++) {
+        Vec3 center = activeScene ? activeScene->objects[i].center : cubePositions[i];
+        float radius = activeScene ? activeScene->objects[i].radius : CUBE_BOUND_RADIUS * cubeScales[i];
+        bool visible = false;
+        for (Uint32 v = 0; v < viewProjCount && !visible; v++) {
+            visible = SphereInFrustum(&viewProjs[v], center, radius);
+        }
+        if (!visible) {
+            if (stats) stats->culledObjects++;
+            continue;
+        }
+        visibleModels[visibleCount++] = activeScene ? activeScene->objects[i].model : cubeModels[i];
+    }
+    
+    DrawPathMesh mesh = RenderPathMesh();
+    PushDebugGroup(cmdBuf, "%s upload (%u objects)", RenderPathName(activeRenderPath), visibleCount);
+    DrawPaths_Upload(drawPaths, cmdBuf, RenderPathKind(activeRenderPath), &mesh, visibleModels, visibleCount);
+    PopDebugGroup(cmdBuf);
+    return visibleCount;
+}
+
+/* Records the uploaded models into an open render pass with the active path */
+static void DrawRenderPath(SDL_GPUCommandBuffer *cmdBuf, SDL_GPURenderPass *renderPass,
+                           Mat4 viewMatrix, Mat4 projMatrix, Uint32 visibleCount, BenchRenderStats *stats)
+{
+    DrawPathMesh mesh = RenderPathMesh();
+    Mat4 viewProj = Mat4_Multiply(viewMatrix, projMatrix);
+    PushDebugGroup(cmdBuf, "%s (%u objects)", RenderPathName(activeRenderPath), visibleCount);
+    DrawPaths_Draw(drawPaths, cmdBuf, renderPass, RenderPathKind(activeRenderPath), &mesh,
+                   visibleModels, visibleCount, &viewProj, stats);
+    PopDebugGroup(cmdBuf);
+}
+
+/* Picks the opaque scene objects far enough from the head to draw as impostors
+ * and records their upload. The head, not each eye, decides, so an object
+ * crossing the distance changes in both eyes in the same frame. */
+static void UpdateImpostors(SDL_GPUCommandBuffer *cmdBuf)
+{
+    Vec3 head = { 0.0f, 0.0f, 0.0f };
+    for (uint32_t i = 0; i < viewCount; i++) {
+        head.x += xrViews[i].pose.position.x / (float)viewCount;
+        head.y += xrViews[i].pose.position.y / (float)viewCount;
+        head.z += xrViews[i].pose.position.z / (float)viewCount;
+    }
+    
+    /* Blended materials stay meshes: an alpha-tested quad cannot blend in order with them */
+    Impostors_Clear(impostors);
+    for (Uint32 i = 0; i < activeScene->objectCount; i++) {
+        const SceneObject *object = &activeScene->objects[i];
+        const SceneMaterial *material = &activeScene->materials[object->material];
+        float dx = object->center.x - head.x, dy = object->center.y - head.y, dz = object->center.z - head.z;
+        sceneImpostors[i] = !material->blend &&
+                            SDL_sqrtf(dx * dx + dy * dy + dz * dz) - object->radius > impostorDistance;
+        if (sceneImpostors[i]) {
+            Impostors_Add(impostors, object->mesh, &object->model, object->center, object->radius, material->tint);
+        }
+    }
+    
+    PushDebugGroup(cmdBuf, "impostor upload (%u objects)", Impostors_Count(impostors));
+    Impostors_Upload(impostors, cmdBuf);
+    PopDebugGroup(cmdBuf);
+}
+
+/* Hands the opaque objects with meshlets that are still drawn as meshes to the
+ * culler, which gives each a draw slot. Blended objects stay whole so their
+ * triangles keep a fixed order. */
+static void UpdateMeshlets(SDL_GPUCommandBuffer *cmdBuf)
+{
+    Uint32 count = 0;
+    for (Uint32 i = 0; i < activeScene->objectCount; i++) {
+        const SceneObject *object = &activeScene->objects[i];
+        const SceneMaterial *material = &activeScene->materials[object->material];
+        sceneClusterSlots[i] = UINT32_MAX;
+        if (sceneMeshlets[object->mesh].meshletCount == 0 || material->blend) continue;
+        if (impostors && Impostors_Count(impostors) > 0 && sceneImpostors[i]) continue;
+        sceneClusterSlots[i] = count;
+        meshletObjects[count++] = (MeshletObject){ object->model, object->mesh, material->doubleSided };
+    }
+    
+    PushDebugGroup(cmdBuf, "meshlet upload (%u objects)", count);
+    Uint32 accepted = Meshlets_BeginFrame(meshletCuller, cmdBuf, meshletObjects, count);
+    PopDebugGroup(cmdBuf);
+    
+    /* Objects that did not fit are drawn whole */
+    for (Uint32 i = 0; i < activeScene->objectCount && accepted < count; i++) {
+        if (sceneClusterSlots[i] != UINT32_MAX && sceneClusterSlots[i] >= accepted) {
+            sceneClusterSlots[i] = UINT32_MAX;
+        }
+    }
+}
+
+/* Accumulates frame CPU time; about once a second puts the active path and the
+ * latest frame's counts in the desktop window titles and, with --stats or the
+ * debug profile, the log */
+static void UpdateStats(Uint64 cpuNs, const BenchRenderStats *stats)
+{
+    Uint64 now = SDL_GetTicksNS();
+    if (statsStartNs == 0) {
+        statsStartNs = now;
+        statsCpuNs = 0;
+        statsFrames = 0;
+    }
+    statsCpuNs += cpuNs;
+    statsFrames++;
+    if (now - statsStartNs < STATS_INTERVAL_NS) return;
+    
+    char line[160];
+    SDL_snprintf(line, sizeof(line), "%s | cpu %.2f ms | %u draws, %u binds, %llu tris, %u culled",
+                 RenderPathName(activeRenderPath), (double)statsCpuNs / 1e6 / statsFrames, stats->drawCalls,
+                 stats->pipelineBinds, (unsigned long long)stats->triangles, stats->culledObjects);
+    if (statsLog) {
+        Log_Write(LOG_INFO, "Stats: %s", line);
+    }
+    
+    char title[192];
+    SDL_snprintf(title, sizeof(title), "SpinningCubes Mirror - %s", line);
+    Mirror_SetTitle(title);
+    if (spectatorWindow) {
+        SDL_snprintf(title, sizeof(title), "SpinningCubes Spectator - %s", line);
+        SDL_SetWindowTitle(spectatorWindow, title);
+    }
+    
+    statsStartNs = now;
+    statsCpuNs = 0;
+    statsFrames = 0;
+}
+
+/* ========================================================================
+ * Controller Input
+ * ======================================================================== */
+
+static int CreateAction(const char *name, const char *localizedName, XrActionType type, XrAction *action)
+{
+    XrActionCreateInfo actionInfo = { XR_TYPE_ACTION_CREATE_INFO };
+    SDL_strlcpy(actionInfo.actionName, name, sizeof(actionInfo.actionName));
+    SDL_strlcpy(actionInfo.localizedActionName, localizedName, sizeof(actionInfo.localizedActionName));
+    actionInfo.actionType = type;
+    actionInfo.countSubactionPaths = HAND_COUNT;
+    actionInfo.subactionPaths = handPaths;
+    
+    XrResult result = pfn_xrCreateAction(xrActionSet, &actionInfo, action);
+    XR_ERR_LOG(result, "Failed to create action");
+    return 0;
+}
+
+/* A runtime may reject profiles it doesn't know; the others still apply.
+ * cyclePathButton is the profile's right-hand button that steps the render path. */
+static void SuggestBindings(const char *profile, const char *cyclePathButton)
+{
+    static const char *const gripPaths[HAND_COUNT] = {
+        "/user/hand/left/input/grip/pose", "/user/hand/right/input/grip/pose"
+    };
+    static const char *const aimPaths[HAND_COUNT] = {
+        "/user/hand/left/input/aim/pose", "/user/hand/right/input/aim/pose"
+    };
+    
+    XrPath profilePath;
+    if (XR_FAILED(pfn_xrStringToPath(xrInstance, profile, &profilePath))) return;
+    
+    XrActionSuggestedBinding bindings[HAND_COUNT * 2 + 1];
+    for (int hand = 0; hand < HAND_COUNT; hand++) {
+        bindings[hand * 2].action = gripPoseAction;
+        pfn_xrStringToPath(xrInstance, gripPaths[hand], &bindings[hand * 2].binding);
+        bindings[hand * 2 + 1].action = aimPoseAction;
+        pfn_xrStringToPath(xrInstance, aimPaths[hand], &bindings[hand * 2 + 1].binding);
+    }
+    bindings[HAND_COUNT * 2].action = cyclePathAction;
+    pfn_xrStringToPath(xrInstance, cyclePathButton, &bindings[HAND_COUNT * 2].binding);
+    
+    XrInteractionProfileSuggestedBinding suggested = { XR_TYPE_INTERACTION_PROFILE_SUGGESTED_BINDING };
+    suggested.interactionProfile = profilePath;
+    suggested.countSuggestedBindings = HAND_COUNT * 2 + 1;
+    suggested.suggestedBindings = bindings;
+    
+    XrResult result = pfn_xrSuggestInteractionProfileBindings(xrInstance, &suggested);
+    if (XR_FAILED(result)) {
+        SDL_Log("Controller bindings for %s rejected (result=%d)", profile, (int)result);
+    }
+}
+
+static int InitControllers(void)
+{
+    XrResult result;
+    
+    pfn_xrStringToPath(xrInstance, "/user/hand/left", &handPaths[0]);
+    pfn_xrStringToPath(xrInstance, "/user/hand/right", &handPaths[1]);
+    
+    XrActionSetCreateInfo setInfo = { XR_TYPE_ACTION_SET_CREATE_INFO };
+    SDL_strlcpy(setInfo.actionSetName, "controllers", sizeof(setInfo.actionSetName));
+    SDL_strlcpy(setInfo.localizedActionSetName, "Controllers", sizeof(setInfo.localizedActionSetName));
+    result = pfn_xrCreateActionSet(xrInstance, &setInfo, &xrActionSet);
+    XR_ERR_LOG(result, "Failed to create action set");
+    
+    if (CreateAction("grip_pose", "Grip Pose", XR_ACTION_TYPE_POSE_INPUT, &gripPoseAction) != 0 ||
+        CreateAction("aim_pose", "Aim Pose", XR_ACTION_TYPE_POSE_INPUT, &aimPoseAction) != 0 ||
+        CreateAction("cycle_render_path", "Next Render Path", XR_ACTION_TYPE_BOOLEAN_INPUT, &cyclePathAction) != 0) {
+        return 1;
+    }
+    
+    SuggestBindings("/interaction_profiles/khr/simple_controller", "/user/hand/right/input/menu/click");
+    SuggestBindings("/interaction_profiles/oculus/touch_controller", "/user/hand/right/input/a/click");
+    
+    XrSessionActionSetsAttachInfo attachInfo = { XR_TYPE_SESSION_ACTION_SETS_ATTACH_INFO };
+    attachInfo.countActionSets = 1;
+    attachInfo.actionSets = &xrActionSet;
+    result = pfn_xrAttachSessionActionSets(xrSession, &attachInfo);
+    XR_ERR_LOG(result, "Failed to attach action set");
+    
+    for (int hand = 0; hand < HAND_COUNT; hand++) {
+        XrActionSpaceCreateInfo spaceInfo = { XR_TYPE_ACTION_SPACE_CREATE_INFO };
+        spaceInfo.subactionPath = handPaths[hand];
+        spaceInfo.poseInActionSpace.orientation.w = 1.0f;
+        
+        spaceInfo.action = gripPoseAction;
+        result = pfn_xrCreateActionSpace(xrSession, &spaceInfo, &gripSpaces[hand]);
+        XR_ERR_LOG(result, "Failed to create grip space");
+        
+        spaceInfo.action = aimPoseAction;
+        result = pfn_xrCreateActionSpace(xrSession, &spaceInfo, &aimSpaces[hand]);
+        XR_ERR_LOG(result, "Failed to create aim space");
+        
+        controllerSpaceIndices[hand * 2 + 0] = Spaces_Register(gripSpaces[hand]);
+        controllerSpaceIndices[hand * 2 + 1] = Spaces_Register(aimSpaces[hand]);
+    }
+    
+    /* Model matrices live in a storage buffer so they can be rewritten after recording */
+    SDL_GPUBufferCreateInfo bufferInfo = {
+        .usage = SDL_GPU_BUFFERUSAGE_GRAPHICS_STORAGE_READ,
+        .size = sizeof(Mat4) * CONTROLLER_INSTANCES
+    };
+    controllerBuffer = SDL_CreateGPUBuffer(gpuDevice, &bufferInfo);
+    
+    SDL_GPUTransferBufferCreateInfo transferInfo = {
+        .usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
+        .size = sizeof(Mat4) * CONTROLLER_INSTANCES
+    };
+    controllerTransfer = SDL_CreateGPUTransferBuffer(gpuDevice, &transferInfo);
+    
+    if (!controllerBuffer || !controllerTransfer) {
+        SDL_Log("Failed to create controller buffers: %s", SDL_GetError());
+        return 1;
+    }
+    NameBuffer(controllerBuffer, "controller models");
+    CmdStream_RegisterBuffer(controllerBuffer, bufferInfo.usage, bufferInfo.size, NULL);
+    
+    controllersReady = true;
+    SDL_Log("Controller actions ready%s", lateLatch ? " (late-latched poses)" : "");
+    return 0;
+}
+
+static void SyncControllers(void)
+{
+    XrActiveActionSet activeSet = { xrActionSet, XR_NULL_PATH };
+    XrActionsSyncInfo syncInfo = { XR_TYPE_ACTIONS_SYNC_INFO };
+    syncInfo.countActiveActionSets = 1;
+    syncInfo.activeActionSets = &activeSet;
+    pfn_xrSyncActions(xrSession, &syncInfo);
+    
+    /* Step the render path once per press */
+    XrActionStateGetInfo getInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
+    getInfo.action = cyclePathAction;
+    XrActionStateBoolean state = { XR_TYPE_ACTION_STATE_BOOLEAN };
+    if (XR_SUCCEEDED(pfn_xrGetActionStateBoolean(xrSession, &getInfo, &state)) &&
+        state.isActive && state.changedSinceLastSync && state.currentState) {
+        CycleRenderPath();
+    }
+}
+
+/* Builds each controller part's model matrix at the display time. Inactive or
+ * untracked parts collapse to a zero matrix so the instance count never changes.
+ * Every registered space is located in the same batch as the controllers. */
+static void LocateControllers(XrTime displayTime, Mat4 models[CONTROLLER_INSTANCES])
+{
+    Spaces_LocateAll(xrLocalSpace, displayTime);
+    
+    for (int hand = 0; hand < HAND_COUNT; hand++) {
+        for (int part = 0; part < 2; part++) {
+            Mat4 *model = &models[hand * 2 + part];
+            *model = (Mat4){{0}};
+            
+            XrActionStateGetInfo getInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
+            getInfo.action = part == 0 ? gripPoseAction : aimPoseAction;
+            getInfo.subactionPath = handPaths[hand];
+            XrActionStatePose state = { XR_TYPE_ACTION_STATE_POSE };
+            if (XR_FAILED(pfn_xrGetActionStatePose(xrSession, &getInfo, &state)) || !state.isActive) continue;
+            
+            XrPosef pose;
+            if (!Spaces_GetPose(controllerSpaceIndices[hand * 2 + part], &pose)) continue;
+            
+            /* Grip: an 8x8x24cm handle. Aim: a 1cm-thick, 80cm ray starting at the aim origin. */
+            Mat4 shape = part == 0
+                ? Mat4_ScaleXYZ(0.16f, 0.16f, 0.48f)
+                : Mat4_Multiply(Mat4_ScaleXYZ(0.02f, 0.02f, 1.6f), Mat4_Translation(0.0f, 0.0f, -0.4f));
+            *model = Mat4_Multiply(shape, Mat4_FromXrPoseModel(pose));
+        }
+    }
+}
+
+static void WriteControllerModels(const Mat4 models[CONTROLLER_INSTANCES], bool cycle)
+{
+    void *mapped = SDL_MapGPUTransferBuffer(gpuDevice, controllerTransfer, cycle);
+    if (!mapped) return;
+    SDL_memcpy(mapped, models, sizeof(Mat4) * CONTROLLER_INSTANCES);
+    SDL_UnmapGPUTransferBuffer(gpuDevice, controllerTransfer);
+}
+
+/* Locates the controllers alongside xrLocateViews and records their upload
+ * at the start of the frame's command buffer */
+static void RecordControllerUpload(SDL_GPUCommandBuffer *cmdBuf, XrTime displayTime)
+{
+    Mat4 models[CONTROLLER_INSTANCES];
+    LocateControllers(displayTime, models);
+    
+    /* Cycle so the previous frame's upload can still be in flight */
+    WriteControllerModels(models, true);
+    
+    PushDebugGroup(cmdBuf, "controller upload");
+    SDL_GPUCopyPass *copyPass = SDL_BeginGPUCopyPass(cmdBuf);
+    SDL_GPUTransferBufferLocation source = { controllerTransfer, 0 };
+    SDL_GPUBufferRegion destination = { controllerBuffer, 0, sizeof(models) };
+    SDL_UploadToGPUBuffer(copyPass, &source, &destination, true);
+    SDL_EndGPUCopyPass(copyPass);
+    CmdStream_UpdateBuffer(controllerBuffer, 0, models, sizeof(models));
+    PopDebugGroup(cmdBuf);
+}
+
+/* Late latch: the upload recorded above reads the staging memory when the GPU
+ * executes it, so overwriting it right before submission swaps in the newest
+ * pose prediction without re-recording any draw */
+static void LatchControllers(XrTime displayTime)
+{
+    Mat4 models[CONTROLLER_INSTANCES];
+    LocateControllers(displayTime, models);
+    WriteControllerModels(models, false);
+}
+
+/* Both hands' grip and aim parts in one instanced draw */
+static void DrawControllers(SDL_GPUCommandBuffer *cmdBuf, SDL_GPURenderPass *renderPass,
+                            Mat4 viewMatrix, Mat4 projMatrix)
+{
+    if (!controllersReady || !controllerPipeline) return;
+    
+    Mat4 viewProj = Mat4_Multiply(viewMatrix, projMatrix);
+    
+    CmdStream_BindGraphicsPipeline(renderPass, controllerPipeline);
+    
+    SDL_GPUBufferBinding vertexBinding = {vertexBuffer, 0};
+    CmdStream_BindVertexBuffers(renderPass, 0, &vertexBinding, 1);
+    SDL_GPUBufferBinding indexBinding = {indexBuffer, 0};
+    CmdStream_BindIndexBuffer(renderPass, &indexBinding, SDL_GPU_INDEXELEMENTSIZE_16BIT);
+    CmdStream_BindVertexStorageBuffers(renderPass, 0, &controllerBuffer, 1);
+    
+    PushDebugGroup(cmdBuf, "controllers");
+    CmdStream_PushVertexUniformData(cmdBuf, 0, &viewProj, sizeof(viewProj));
+    CmdStream_DrawIndexedPrimitives(renderPass, 36, CONTROLLER_INSTANCES, 0, 0, 0);
+    PopDebugGroup(cmdBuf);
+}
+
+/* ========================================================================
+ * Spectator Camera
+ * ======================================================================== */
+
+static bool InitSpectator(void)
+{
+    /* Closing a desktop window must not end the XR session */
+    SDL_SetHint(SDL_HINT_QUIT_ON_LAST_WINDOW_CLOSE, "0");
+    
+    spectatorWindow = SDL_CreateWindow("SpinningCubes Spectator", spectatorWidth, spectatorHeight, SDL_WINDOW_RESIZABLE);
+    if (!spectatorWindow) {
+        SDL_Log("Failed to create spectator window: %s", SDL_GetError());
+        return false;
+    }
+    
+    if (!SDL_ClaimWindowForGPUDevice(gpuDevice, spectatorWindow)) {
+        SDL_Log("Failed to claim spectator window: %s", SDL_GetError());
+        SDL_DestroyWindow(spectatorWindow);
+        spectatorWindow = NULL;
+        return false;
+    }
+    
+    /* The scene renders into the sRGB eye format; never let presentation pace the XR loop */
+    SDL_GPUSwapchainComposition composition = SDL_GPU_SWAPCHAINCOMPOSITION_SDR;
+    if (SDL_WindowSupportsGPUSwapchainComposition(gpuDevice, spectatorWindow, SDL_GPU_SWAPCHAINCOMPOSITION_SDR_LINEAR)) {
+        composition = SDL_GPU_SWAPCHAINCOMPOSITION_SDR_LINEAR;
+    }
+    SDL_GPUPresentMode presentMode = SDL_GPU_PRESENTMODE_VSYNC;
+    if (SDL_WindowSupportsGPUPresentMode(gpuDevice, spectatorWindow, SDL_GPU_PRESENTMODE_MAILBOX)) {
+        presentMode = SDL_GPU_PRESENTMODE_MAILBOX;
+    } else if (SDL_WindowSupportsGPUPresentMode(gpuDevice, spectatorWindow, SDL_GPU_PRESENTMODE_IMMEDIATE)) {
+        presentMode = SDL_GPU_PRESENTMODE_IMMEDIATE;
+    }
+    SDL_SetGPUSwapchainParameters(gpuDevice, spectatorWindow, composition, presentMode);
+    
+    SDL_Log("Spectator camera %dx%d at %.0f Hz, %.0f%% resolution", spectatorWidth, spectatorHeight,
+            spectatorRate, spectatorScale * 100.0f);
+    return true;
+}
+
+static void ShutdownSpectator(void)
+{
+    if (spectatorTexture) {
+        SDL_ReleaseGPUTexture(gpuDevice, spectatorTexture);
+        spectatorTexture = NULL;
+    }
+    if (spectatorWindow) {
+        SDL_ReleaseWindowFromGPUDevice(gpuDevice, spectatorWindow);
+        SDL_DestroyWindow(spectatorWindow);
+        spectatorWindow = NULL;
+    }
+}
+
+/* Renders the scene from the spectator viewpoint in its own command buffer,
+ * with the eyes' render path. Called after xrEndFrame so the eye work is
+ * always submitted first. */
+static void RenderSpectator(Sint64 displayTimeNs)
+{
+    if (!spectatorWindow || !pipeline || viewCount == 0) return;
+    
+    /* Display times are quantized to the headset refresh, so allow 10% slack */
+    if (spectatorRateLevel == SPECTATOR_RATE_LEVELS - 1) return;
+    Sint64 intervalNs = (Sint64)(1000000000.0 / (double)spectatorRate) << spectatorRateLevel;
+    if (lastSpectatorTimeNs != 0 && displayTimeNs - lastSpectatorTimeNs < intervalNs - intervalNs / 10) {
+        return;
+    }
+    
+    SDL_GPUCommandBuffer *cmdBuf = SDL_AcquireGPUCommandBuffer(gpuDevice);
+    if (!cmdBuf) return;
     
-    for (uint32_t i = 0; i < viewCount; i++) {
-        xrViews[i].type = XR_TYPE_VIEW;
-        xrViews[i].pose.orientation.w = 1.0f;
-        
-        SDL_Log("View %u: recommended %ux%u", i,
-                viewConfigs[i].recommendedImageRectWidth,
-                viewConfigs[i].recommendedImageRectHeight);
-        
-        /* Create swapchain using OpenXR's XrSwapchainCreateInfo */
-        XrSwapchainCreateInfo swapchainCreateInfo = { XR_TYPE_SWAPCHAIN_CREATE_INFO };
-        swapchainCreateInfo.usageFlags = XR_SWAPCHAIN_USAGE_COLOR_ATTACHMENT_BIT | XR_SWAPCHAIN_USAGE_SAMPLED_BIT;
-        swapchainCreateInfo.format = 0; /* Let SDL pick the format */
-        swapchainCreateInfo.sampleCount = 1;
-        swapchainCreateInfo.width = viewConfigs[i].recommendedImageRectWidth;
-        swapchainCreateInfo.height = viewConfigs[i].recommendedImageRectHeight;
-        swapchainCreateInfo.faceCount = 1;
-        swapchainCreateInfo.arraySize = 1;
-        swapchainCreateInfo.mipCount = 1;
-        
-        result = SDL_CreateGPUXRSwapchain(
-            gpuDevice,
-            xrSession,
-            &swapchainCreateInfo,
-            &vrSwapchains[i].format,
-            &vrSwapchains[i].swapchain,
-            &vrSwapchains[i].images);
-        
-        if (XR_FAILED(result)) {
-            SDL_Log("Failed to create swapchain %u", i);
-            SDL_free(viewConfigs);
-            return 1;
-        }
+    /* Skip the whole frame, rendering included, if the window has no free image */
+    SDL_GPUTexture *swapchainTexture = NULL;
+    Uint32 windowWidth = 0, windowHeight = 0;
+    if (!SDL_AcquireGPUSwapchainTexture(cmdBuf, spectatorWindow, &swapchainTexture, &windowWidth, &windowHeight) ||
+        !swapchainTexture) {
+        SDL_SubmitGPUCommandBuffer(cmdBuf);
+        return;
+    }
+    lastSpectatorTimeNs = displayTimeNs;
+    
+    Uint32 width = SDL_max(1u, (Uint32)((float)windowWidth * spectatorScale));
+    Uint32 height = SDL_max(1u, (Uint32)((float)windowHeight * spectatorScale));
+    if (!spectatorTexture || spectatorTextureWidth != width || spectatorTextureHeight != height) {
+        if (spectatorTexture) SDL_ReleaseGPUTexture(gpuDevice, spectatorTexture);
         
-        /* Get image count by enumerating swapchain images */
-        result = pfn_xrEnumerateSwapchainImages(vrSwapchains[i].swapchain, 0, &vrSwapchains[i].imageCount, NULL);
-        if (XR_FAILED(result)) {
-            vrSwapchains[i].imageCount = 3; /* Assume 3 if we can't query */
+        SDL_GPUTextureCreateInfo textureInfo = {
+            .type = SDL_GPU_TEXTURETYPE_2D,
+            .format = vrSwapchains[0].format,
+            .usage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET | SDL_GPU_TEXTUREUSAGE_SAMPLER,
+            .width = width,
+            .height = height,
+            .layer_count_or_depth = 1,
+            .num_levels = 1
+        };
+        spectatorTexture = SDL_CreateGPUTexture(gpuDevice, &textureInfo);
+        if (!spectatorTexture) {
+            Log_Write(LOG_ERROR, "Failed to create spectator target: %s", SDL_GetError());
+            SDL_SubmitGPUCommandBuffer(cmdBuf);
+            return;
         }
-        
-        vrSwapchains[i].size.width = (int32_t)swapchainCreateInfo.width;
-        vrSwapchains[i].size.height = (int32_t)swapchainCreateInfo.height;
-        
-        SDL_Log("Created swapchain %u: %dx%d, %u images",
-                i, vrSwapchains[i].size.width, vrSwapchains[i].size.height,
-                vrSwapchains[i].imageCount);
+        NameTexture(spectatorTexture, "spectator target");
+        spectatorTextureWidth = width;
+        spectatorTextureHeight = height;
     }
     
-    SDL_free(viewConfigs);
+    /* 60 degree vertical field of view at the window's aspect ratio */
+    float halfY = 30.0f * SDL_PI_F / 180.0f;
+    float halfX = SDL_atanf(SDL_tanf(halfY) * (float)width / (float)height);
+    XrFovf fov = { -halfX, halfX, halfY, -halfY };
+    Mat4 viewMatrix = Mat4_LookAt(spectatorEye, spectatorTarget);
+    Mat4 projMatrix = Mat4_Projection(fov, 0.05f, 100.0f);
+    
+    /* Same path as the eyes, culled and uploaded again for this viewpoint;
+     * the uploads cycle, so the eye draws keep their own copy */
+    bool pathDraw = activeRenderPath != DRAWPATH_UNIFORM;
+    Uint32 visibleCount = 0;
+    if (pathDraw) {
+        Mat4 viewProj = Mat4_Multiply(viewMatrix, projMatrix);
+        visibleCount = UploadVisibleModels(cmdBuf, &viewProj, 1, NULL);
+    }
     
-    /* Create the pipeline using the swapchain format */
-    if (viewCount > 0 && pipeline == NULL) {
-        if (CreatePipeline(vrSwapchains[0].format) != 0) {
-            return 1;
-        }
-        if (CreateCubeBuffers() != 0) {
-            return 1;
-        }
+    SDL_GPUColorTargetInfo colorTarget = {0};
+    colorTarget.texture = spectatorTexture;
+    colorTarget.load_op = SDL_GPU_LOADOP_CLEAR;
+    colorTarget.store_op = SDL_GPU_STOREOP_STORE;
+    colorTarget.clear_color.r = 0.05f;
+    colorTarget.clear_color.g = 0.05f;
+    colorTarget.clear_color.b = 0.15f;
+    colorTarget.clear_color.a = 1.0f;
+    colorTarget.cycle = true;
+    
+    PushDebugGroup(cmdBuf, "spectator pass");
+    SDL_GPURenderPass *renderPass = SDL_BeginGPURenderPass(cmdBuf, &colorTarget, 1, NULL);
+    SDL_GPUViewport viewport = {0, 0, (float)width, (float)height, 0, 1};
+    SDL_SetGPUViewport(renderPass, &viewport);
+    if (pathDraw) {
+        DrawRenderPath(cmdBuf, renderPass, viewMatrix, projMatrix, visibleCount, NULL);
+    } else if (activeScene) {
+        DrawScene(cmdBuf, renderPass, viewMatrix, projMatrix, -1, false, NULL);
+    } else {
+        SDL_BindGPUGraphicsPipeline(renderPass, pipeline);
+        DrawCubes(cmdBuf, renderPass, vertexBuffer, viewMatrix, projMatrix, NULL);
     }
+    DrawControllers(cmdBuf, renderPass, viewMatrix, projMatrix);
+    SDL_EndGPURenderPass(renderPass);
+    PopDebugGroup(cmdBuf);
+    
+    SDL_GPUBlitInfo blit = {
+        .source = { .texture = spectatorTexture, .w = width, .h = height },
+        .destination = { .texture = swapchainTexture, .w = windowWidth, .h = windowHeight },
+        .load_op = SDL_GPU_LOADOP_DONT_CARE,
+        .filter = SDL_GPU_FILTER_LINEAR
+    };
+    PushDebugGroup(cmdBuf, "spectator blit");
+    SDL_BlitGPUTexture(cmdBuf, &blit);
+    PopDebugGroup(cmdBuf);
     
-    return 0;
+    SDL_SubmitGPUCommandBuffer(cmdBuf);
 }
 
-static void HandleXREvents(void)
+/* ========================================================================
+ * Frame Budget Governor Knobs
+ * ======================================================================== */
+
+static void ApplyRenderScale(void *userdata, int level)
 {
-    XrEventDataBuffer eventBuffer = { XR_TYPE_EVENT_DATA_BUFFER };
+    (void)userdata;
+    renderScale = renderScales[level];
+}
+
+static void ApplySpectatorRate(void *userdata, int level)
+{
+    (void)userdata;
+    spectatorRateLevel = level;
+}
+
+static void ApplyRefreshRate(void *userdata, int level)
+{
+    (void)userdata;
+    XrResult result = pfn_xrRequestDisplayRefreshRateFB(xrSession, refreshRates[level]);
+    if (XR_FAILED(result)) {
+        Log_Write(LOG_WARN, "xrRequestDisplayRefreshRateFB(%.0f) failed (result=%d)", refreshRates[level], (int)result);
+    }
+}
+
+static XrPerfSettingsDomainEXT PerfDomain(GovernorDomain domain)
+{
+    return domain == GOVERNOR_DOMAIN_CPU ? XR_PERF_SETTINGS_DOMAIN_CPU_EXT : XR_PERF_SETTINGS_DOMAIN_GPU_EXT;
+}
+
+static void ApplyPerformanceLevel(void *userdata, GovernorDomain domain, int level)
+{
+    (void)userdata;
+    XrResult result = pfn_xrPerfSettingsSetPerformanceLevelEXT(xrSession, PerfDomain(domain), perfLevels[level]);
+    if (XR_FAILED(result)) {
+        Log_Write(LOG_WARN, "xrPerfSettingsSetPerformanceLevelEXT failed (result=%d)", (int)result);
+    }
+}
+
+/* Registration order is the default priority: the spectator is the cheapest
+ * thing to give up, eye resolution the most visible, and a lower display
+ * rate the last resort. */
+static bool InitGovernor(void)
+{
+    if (!Governor_Init(gpuDevice, &governorConfig)) return false;
     
-    while (pfn_xrPollEvent(xrInstance, &eventBuffer) == XR_SUCCESS) {
-        switch (eventBuffer.type) {
-            case XR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED: {
-                XrEventDataSessionStateChanged *stateEvent = 
-                    (XrEventDataSessionStateChanged*)&eventBuffer;
-                
-                SDL_Log("Session state changed: %d", stateEvent->state);
-                
-                switch (stateEvent->state) {
-                    case XR_SESSION_STATE_READY: {
-                        XrSessionBeginInfo beginInfo = { XR_TYPE_SESSION_BEGIN_INFO };
-                        beginInfo.primaryViewConfigurationType = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO;
-                        
-                        XrResult result = pfn_xrBeginSession(xrSession, &beginInfo);
-                        if (XR_SUCCEEDED(result)) {
-                            SDL_Log("XR Session begun!");
-                            xrSessionRunning = true;
-                            
-                            /* Create swapchains now that session is ready */
-                            if (CreateSwapchains() != 0) {
-                                SDL_Log("Failed to create swapchains");
-                                xrShouldQuit = true;
-                            }
-                        }
-                        break;
-                    }
-                    case XR_SESSION_STATE_STOPPING:
-                        pfn_xrEndSession(xrSession);
-                        xrSessionRunning = false;
-                        break;
-                    case XR_SESSION_STATE_EXITING:
-                    case XR_SESSION_STATE_LOSS_PENDING:
-                        xrShouldQuit = true;
-                        break;
-                    default:
-                        break;
-                }
-                break;
-            }
-            case XR_TYPE_EVENT_DATA_INSTANCE_LOSS_PENDING:
-                xrShouldQuit = true;
-                break;
-            default:
-                break;
-        }
-        
-        eventBuffer.type = XR_TYPE_EVENT_DATA_BUFFER;
+    if (spectatorWindow) {
+        Governor_AddKnob("spectator", SPECTATOR_RATE_LEVELS, ApplySpectatorRate, NULL);
+    }
+    Governor_AddKnob("scale", (int)SDL_arraysize(renderScales), ApplyRenderScale, NULL);
+    if (refreshRateCount > 1) {
+        Governor_AddRefreshRateKnob("refresh", refreshRates, refreshRateCount, ApplyRefreshRate, NULL);
     }
+    
+    /* Start at sustained low and let the governor raise what the frame needs */
+    if (pfn_xrPerfSettingsSetPerformanceLevelEXT) {
+        Governor_SetPerformanceLevels((int)SDL_arraysize(perfLevels), 1, ApplyPerformanceLevel, NULL);
+    }
+    return true;
+}
+
+/* ========================================================================
+ * Benchmark
+ * ======================================================================== */
+
+static const char *ViewConfigName(XrViewConfigurationType type)
+{
+    switch (type) {
+        case XR_VIEW_CONFIGURATION_TYPE_PRIMARY_MONO: return "mono";
+        case XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO: return "stereo";
+        case XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO_WITH_FOVEATED_INSET: return "quad";
+        default: return "other";
+    }
+}
+
+/* Everything needed to tell two reports apart; the swapchain size is added once known */
+static bool InitBench(void)
+{
+    if (!Bench_Init(gpuDevice, &benchConfig)) return false;
+    
+    Bench_SetInfo("label", benchLabel ? benchLabel : "");
+    Bench_SetInfo("platform", SDL_GetPlatform());
+    Bench_SetInfo("driver", SDL_GetGPUDeviceDriver(gpuDevice));
+    Bench_SetInfo("runtime", mockRuntime ? "mock" : "openxr");
+    if (mockRuntime) {
+        Bench_SetInfoNumber("refresh_hz", mockConfig.refreshRate);
+        Bench_SetInfoNumber("paced", mockConfig.unpaced ? 0 : 1);
+    }
+    Bench_SetInfo("view_config", ViewConfigName(xrViewConfigType));
+    if (activeScene) {
+        Bench_SetInfo("scene", Scene_KindName(activeScene->config.kind));
+        Bench_SetInfoNumber("objects", activeScene->config.objectCount);
+        Bench_SetInfoNumber("materials", activeScene->materialCount);
+        Bench_SetInfoNumber("detail", activeScene->config.detail);
+    } else {
+        Bench_SetInfo("scene", "spinning-cubes");
+        Bench_SetInfoNumber("objects", NUM_CUBES);
+    }
+    Bench_SetInfoNumber("governor", governorEnabled ? 1 : 0);
+    Bench_SetInfo("profile", runtimeProfile->name);
+    Bench_SetInfoNumber("gpu_validation", runtimeProfile->gpuValidation ? 1 : 0);
+    return true;
 }
 
 static void RenderFrame(void)
 {
     if (!xrSessionRunning) return;
     
+    Readback_Poll(readbackRing);
+    
     XrFrameState frameState = { XR_TYPE_FRAME_STATE };
     XrFrameWaitInfo waitInfo = { XR_TYPE_FRAME_WAIT_INFO };
     
@@ -570,32 +2523,78 @@ static void RenderFrame(void)
     result = pfn_xrBeginFrame(xrSession, &beginInfo);
     if (XR_FAILED(result)) return;
     
-    XrCompositionLayerProjectionView *projViews = NULL;
+    Governor_BeginFrame();
+    Bench_BeginFrame();
+    
     XrCompositionLayerProjection layer = { XR_TYPE_COMPOSITION_LAYER_PROJECTION };
     uint32_t layerCount = 0;
     const XrCompositionLayerBaseHeader *layers[1] = {0};
     
     if (frameState.shouldRender && viewCount > 0 && vrSwapchains != NULL) {
-        /* Update animation time - ~90fps for Quest */
-        animTime += 0.011f;
+        /* Advance by the display period so motion keeps its speed at any refresh rate */
+        animTime += frameState.predictedDisplayPeriod > 0 ? (float)((double)frameState.predictedDisplayPeriod / 1e9) : 0.011f;
+        if (activeScene) {
+            Scene_Update(activeScene, animTime);
+        } else {
+            UpdateCubeModels();
+        }
+        
+        if (frameIndex == 0 && frameState.predictedDisplayPeriod > 0) {
+            Capture_SetFrameRate((Uint32)((1000000000.0 / (double)frameState.predictedDisplayPeriod) + 0.5));
+        }
+        
+        Mirror_BeginFrame(frameState.predictedDisplayTime);
+        
+        if (controllersReady) {
+            SyncControllers();
+        }
         
         /* Locate views */
         XrViewState viewState = { XR_TYPE_VIEW_STATE };
         XrViewLocateInfo locateInfo = { XR_TYPE_VIEW_LOCATE_INFO };
-        locateInfo.viewConfigurationType = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO;
+        locateInfo.viewConfigurationType = xrViewConfigType;
         locateInfo.displayTime = frameState.predictedDisplayTime;
         locateInfo.space = xrLocalSpace;
         
         uint32_t viewCountOutput;
         result = pfn_xrLocateViews(xrSession, &locateInfo, &viewState, viewCount, &viewCountOutput, xrViews);
         if (XR_FAILED(result)) {
-            SDL_Log("xrLocateViews failed");
+            Log_Write(LOG_WARN, "xrLocateViews failed (result=%d)", (int)result);
             goto endFrame;
         }
         
-        projViews = SDL_calloc(viewCount, sizeof(XrCompositionLayerProjectionView));
+        bool readbackOverdraw = overdrawStats && (frameIndex % OVERDRAW_STATS_INTERVAL) == 0;
         
+        /* All views share one command buffer and one submission */
+        Uint64 recordStartNs = SDL_GetTicksNS();
         SDL_GPUCommandBuffer *cmdBuf = SDL_AcquireGPUCommandBuffer(gpuDevice);
+        uint32_t renderedViews = 0;
+        BenchRenderStats frameStats = {0};
+        PushDebugGroup(cmdBuf, "frame %llu", (unsigned long long)frameIndex);
+        CmdStream_BeginFrame(frameIndex);
+        
+        /* Controllers are located at the same display time as the views */
+        if (controllersReady) {
+            RecordControllerUpload(cmdBuf, frameState.predictedDisplayTime);
+        }
+        
+        /* Far objects only become impostors on the per-object path */
+        if (impostors && activeRenderPath == DRAWPATH_UNIFORM) {
+            UpdateImpostors(cmdBuf);
+        }
+        if (meshletCuller && activeRenderPath == DRAWPATH_UNIFORM && activeScene) {
+            UpdateMeshlets(cmdBuf);
+        }
+        
+        /* Single-pass stereo culls and uploads once for every view */
+        Uint32 visibleCount = 0;
+        if (activeRenderPath == RENDER_PATH_STEREO) {
+            for (uint32_t i = 0; i < viewCount; i++) {
+                pathViewProjs[i] = Mat4_Multiply(Mat4_FromXrPose(xrViews[i].pose),
+                                                 Mat4_Projection(xrViews[i].fov, 0.05f, 100.0f));
+            }
+            visibleCount = UploadVisibleModels(cmdBuf, pathViewProjs, viewCount, &frameStats);
+        }
         
         for (uint32_t i = 0; i < viewCount; i++) {
             VRSwapchain *swapchain = &vrSwapchains[i];
@@ -617,6 +2616,14 @@ static void RenderFrame(void)
             
             /* Render the scene */
             SDL_GPUTexture *targetTexture = swapchain->images[imageIndex];
+            PushDebugGroup(cmdBuf, "view %u", i);
+            
+            /* The governor shrinks the rendered region; the heatmap always covers the full image */
+            XrExtent2Di renderSize = swapchain->size;
+            if (!overdrawMode) {
+                renderSize.width = SDL_max(1, (int32_t)((float)renderSize.width * renderScale));
+                renderSize.height = SDL_max(1, (int32_t)((float)renderSize.height * renderScale));
+            }
             
             /* Build view and projection matrices from XR pose/fov */
             Mat4 viewMatrix = Mat4_FromXrPose(xrViews[i].pose);
@@ -632,44 +2639,73 @@ static void RenderFrame(void)
             colorTarget.clear_color.b = 0.15f;
             colorTarget.clear_color.a = 1.0f;
             
-            SDL_GPURenderPass *renderPass = SDL_BeginGPURenderPass(cmdBuf, &colorTarget, 1, NULL);
-            
-            if (pipeline && vertexBuffer && indexBuffer) {
-                SDL_BindGPUGraphicsPipeline(renderPass, pipeline);
-                
-                SDL_GPUViewport viewport = {0, 0, (float)swapchain->size.width, (float)swapchain->size.height, 0, 1};
-                SDL_SetGPUViewport(renderPass, &viewport);
-                
-                SDL_Rect scissor = {0, 0, swapchain->size.width, swapchain->size.height};
-                SDL_SetGPUScissor(renderPass, &scissor);
-                
-                SDL_GPUBufferBinding vertexBinding = {vertexBuffer, 0};
-                SDL_BindGPUVertexBuffers(renderPass, 0, &vertexBinding, 1);
+            if (overdrawMode) {
+                RenderOverdrawView(cmdBuf, swapchain, targetTexture, viewMatrix, projMatrix, &frameStats);
+                if (readbackOverdraw) {
+                    Readback_Request(readbackRing, cmdBuf, swapchain->overdrawTexture, SDL_GPU_TEXTUREFORMAT_R8_UNORM,
+                                     (Uint32)swapchain->size.width, (Uint32)swapchain->size.height,
+                                     i, frameIndex, OnOverdrawReadback, NULL);
+                }
+            } else {
+                /* Other instanced paths cull and upload per view, before its pass */
+                bool pathDraw = activeRenderPath != DRAWPATH_UNIFORM;
+                if (pathDraw && activeRenderPath != RENDER_PATH_STEREO) {
+                    Mat4 viewProj = Mat4_Multiply(viewMatrix, projMatrix);
+                    visibleCount = UploadVisibleModels(cmdBuf, &viewProj, 1, &frameStats);
+                } else if (!pathDraw && meshletCuller) {
+                    Mat4 viewProj = Mat4_Multiply(viewMatrix, projMatrix);
+                    Vec3 eye = { xrViews[i].pose.position.x, xrViews[i].pose.position.y,
+                                 xrViews[i].pose.position.z };
+                    PushDebugGroup(cmdBuf, "meshlet cull");
+                    Meshlets_Cull(meshletCuller, cmdBuf, i, &viewProj, eye);
+                    PopDebugGroup(cmdBuf);
+                }
                 
-                SDL_GPUBufferBinding indexBinding = {indexBuffer, 0};
-                SDL_BindGPUIndexBuffer(renderPass, &indexBinding, SDL_GPU_INDEXELEMENTSIZE_16BIT);
+                PushDebugGroup(cmdBuf, "scene pass");
+                SDL_GPURenderPass *renderPass = CmdStream_BeginRenderPass(cmdBuf, &colorTarget,
+                                                                          (Uint32)swapchain->size.width,
+                                                                          (Uint32)swapchain->size.height,
+                                                                          swapchain->format);
                 
-                /* Draw each cube */
-                for (int cubeIdx = 0; cubeIdx < NUM_CUBES; cubeIdx++) {
-                    float rot = animTime * cubeSpeeds[cubeIdx];
-                    Vec3 pos = cubePositions[cubeIdx];
-                    
-                    /* Build model matrix: scale -> rotateY -> rotateX -> translate */
-                    Mat4 scale = Mat4_Scale(cubeScales[cubeIdx]);
-                    Mat4 rotY = Mat4_RotationY(rot);
-                    Mat4 rotX = Mat4_RotationX(rot * 0.7f);
-                    Mat4 trans = Mat4_Translation(pos.x, pos.y, pos.z);
+                if (pipeline && vertexBuffer && indexBuffer) {
+                    SDL_GPUViewport viewport = {0, 0, (float)renderSize.width, (float)renderSize.height, 0, 1};
+                    CmdStream_SetViewport(renderPass, &viewport);
                     
-                    Mat4 model = Mat4_Multiply(Mat4_Multiply(Mat4_Multiply(scale, rotY), rotX), trans);
-                    Mat4 mv = Mat4_Multiply(model, viewMatrix);
-                    Mat4 mvp = Mat4_Multiply(mv, projMatrix);
+                    SDL_Rect scissor = {0, 0, renderSize.width, renderSize.height};
+                    CmdStream_SetScissor(renderPass, &scissor);
                     
-                    SDL_PushGPUVertexUniformData(cmdBuf, 0, &mvp, sizeof(mvp));
-                    SDL_DrawGPUIndexedPrimitives(renderPass, 36, 1, 0, 0, 0);
+                    /* Scenes bind a pipeline per material themselves */
+                    if (pathDraw) {
+                        DrawRenderPath(cmdBuf, renderPass, viewMatrix, projMatrix, visibleCount, &frameStats);
+                    } else if (activeScene) {
+                        DrawScene(cmdBuf, renderPass, viewMatrix, projMatrix, (int)i, false, &frameStats);
+                    } else {
+                        CmdStream_BindGraphicsPipeline(renderPass, pipeline);
+                        frameStats.pipelineBinds++;
+                        DrawCubes(cmdBuf, renderPass, vertexBuffer, viewMatrix, projMatrix, &frameStats);
+                    }
+                    DrawControllers(cmdBuf, renderPass, viewMatrix, projMatrix);
                 }
+                
+                CmdStream_EndRenderPass(renderPass);
+                PopDebugGroup(cmdBuf);
             }
             
-            SDL_EndGPURenderPass(renderPass);
+            /* Capture copies must be recorded before the image goes back to the runtime */
+            if (Capture_WantsView(frameIndex, i)) {
+                PushDebugGroup(cmdBuf, "capture readback");
+                Readback_Request(readbackRing, cmdBuf, targetTexture, swapchain->format,
+                                 (Uint32)renderSize.width, (Uint32)renderSize.height,
+                                 i, frameIndex, Capture_OnReadback, NULL);
+                PopDebugGroup(cmdBuf);
+            }
+            if (Mirror_IsEnabled()) {
+                PushDebugGroup(cmdBuf, "mirror copy");
+                Mirror_CopyView(cmdBuf, i, targetTexture, swapchain->format,
+                                (Uint32)renderSize.width, (Uint32)renderSize.height);
+                PopDebugGroup(cmdBuf);
+            }
+            PopDebugGroup(cmdBuf);
             
             /* Release swapchain image */
             XrSwapchainImageReleaseInfo releaseInfo = { XR_TYPE_SWAPCHAIN_IMAGE_RELEASE_INFO };
@@ -682,17 +2718,34 @@ static void RenderFrame(void)
             projViews[i].subImage.swapchain = swapchain->swapchain;
             projViews[i].subImage.imageRect.offset.x = 0;
             projViews[i].subImage.imageRect.offset.y = 0;
-            projViews[i].subImage.imageRect.extent = swapchain->size;
+            projViews[i].subImage.imageRect.extent = renderSize;
             projViews[i].subImage.imageArrayIndex = 0;
+            renderedViews++;
         }
         
-        SDL_SubmitGPUCommandBuffer(cmdBuf);
+        CmdStream_EndFrame();
+        PopDebugGroup(cmdBuf);
+        if (controllersReady && lateLatch) {
+            LatchControllers(frameState.predictedDisplayTime);
+        }
+        Readback_Submit(readbackRing, cmdBuf);
+        if (runtimeProfile->instrumentation != INSTRUMENT_NONE || statsLog) {
+            UpdateStats(SDL_GetTicksNS() - recordStartNs, &frameStats);
+        }
+        Governor_EndFrame(frameState.predictedDisplayPeriod);
+        if (Bench_EndFrame(&frameStats)) {
+            pfn_xrRequestExitSession(xrSession);
+        }
+        frameIndex++;
         
-        layer.space = xrLocalSpace;
-        layer.viewCount = viewCount;
-        layer.views = projViews;
-        layers[0] = (XrCompositionLayerBaseHeader*)&layer;
-        layerCount = 1;
+        /* A projection layer must cover every view of the configuration */
+        if (renderedViews == viewCount) {
+            layer.space = xrLocalSpace;
+            layer.viewCount = viewCount;
+            layer.views = projViews;
+            layers[0] = (XrCompositionLayerBaseHeader*)&layer;
+            layerCount = 1;
+        }
     }
     
 endFrame:;
@@ -703,8 +2756,18 @@ endFrame:;
     endInfo.layers = layers;
     
     pfn_xrEndFrame(xrSession, &endInfo);
+    if (layerCount > 0) {
+        Startup_EndPhase();
+        if (runtimeProfile->instrumentation != INSTRUMENT_NONE || startupTracePath) {
+            Startup_Finish(startupTracePath);
+        }
+    }
     
-    if (projViews) SDL_free(projViews);
+    /* Outside the XR frame so a slow desktop compositor never delays xrEndFrame */
+    Mirror_Present();
+    if (frameState.shouldRender) {
+        RenderSpectator(frameState.predictedDisplayTime);
+    }
 }
 
 static void Cleanup(void)
@@ -724,82 +2787,340 @@ static void Cleanup(void)
         SDL_ReleaseGPUBuffer(gpuDevice, indexBuffer);
         indexBuffer = NULL;
     }
+    if (overdrawPipeline) {
+        SDL_ReleaseGPUGraphicsPipeline(gpuDevice, overdrawPipeline);
+        overdrawPipeline = NULL;
+    }
+    if (overdrawPipelineDoubleSided) {
+        SDL_ReleaseGPUGraphicsPipeline(gpuDevice, overdrawPipelineDoubleSided);
+        overdrawPipelineDoubleSided = NULL;
+    }
+    if (heatmapPipeline) {
+        SDL_ReleaseGPUGraphicsPipeline(gpuDevice, heatmapPipeline);
+        heatmapPipeline = NULL;
+    }
+    if (overdrawSampler) {
+        SDL_ReleaseGPUSampler(gpuDevice, overdrawSampler);
+        overdrawSampler = NULL;
+    }
+    if (overdrawVertexBuffer) {
+        SDL_ReleaseGPUBuffer(gpuDevice, overdrawVertexBuffer);
+        overdrawVertexBuffer = NULL;
+    }
+    if (controllerPipeline) {
+        SDL_ReleaseGPUGraphicsPipeline(gpuDevice, controllerPipeline);
+        controllerPipeline = NULL;
+    }
+    if (controllerBuffer) {
+        SDL_ReleaseGPUBuffer(gpuDevice, controllerBuffer);
+        controllerBuffer = NULL;
+    }
+    if (controllerTransfer) {
+        SDL_ReleaseGPUTransferBuffer(gpuDevice, controllerTransfer);
+        controllerTransfer = NULL;
+    }
+    DrawPaths_Destroy(drawPaths);
+    drawPaths = NULL;
+    Impostors_Destroy(impostors);
+    impostors = NULL;
+    SDL_free(sceneImpostors);
+    sceneImpostors = NULL;
+    Meshlets_DestroyCuller(meshletCuller);
+    meshletCuller = NULL;
+    for (Uint32 i = 0; sceneMeshlets && i < activeScene->meshCount; i++) {
+        Meshlets_Free(&sceneMeshlets[i]);
+    }
+    SDL_free(sceneMeshlets);
+    SDL_free(meshletObjects);
+    SDL_free(sceneClusterSlots);
+    sceneMeshlets = NULL;
+    meshletObjects = NULL;
+    sceneClusterSlots = NULL;
+    SDL_free(visibleModels);
+    SDL_free(pathViewProjs);
+    visibleModels = pathViewProjs = NULL;
+    if (activeScene) {
+        for (Uint32 i = 0; i < activeScene->materialCount && scenePipelines; i++) {
+            if (scenePipelines[i]) SDL_ReleaseGPUGraphicsPipeline(gpuDevice, scenePipelines[i]);
+        }
+        for (Uint32 i = 0; i < activeScene->meshCount && sceneVertexBuffers; i++) {
+            if (sceneVertexBuffers[i]) SDL_ReleaseGPUBuffer(gpuDevice, sceneVertexBuffers[i]);
+            if (sceneIndexBuffers[i]) SDL_ReleaseGPUBuffer(gpuDevice, sceneIndexBuffers[i]);
+            if (sceneOverdrawBuffers && sceneOverdrawBuffers[i]) {
+                SDL_ReleaseGPUBuffer(gpuDevice, sceneOverdrawBuffers[i]);
+            }
+        }
+        SDL_free(scenePipelines);
+        SDL_free(sceneVertexBuffers);
+        SDL_free(sceneIndexBuffers);
+        SDL_free(sceneOverdrawBuffers);
+        scenePipelines = NULL;
+        sceneVertexBuffers = sceneIndexBuffers = sceneOverdrawBuffers = NULL;
+        Scene_Destroy(activeScene);
+        activeScene = NULL;
+    }
+    
+    /* Drain capture jobs before the ring unmaps their images */
+    Capture_Shutdown();
+    Governor_Shutdown();
+    Bench_Shutdown();
+    Readback_Destroy(readbackRing);
+    readbackRing = NULL;
+    
+    Mirror_Shutdown();
+    ShutdownSpectator();
     
     if (vrSwapchains) {
         for (uint32_t i = 0; i < viewCount; i++) {
+            if (vrSwapchains[i].overdrawTexture) {
+                SDL_ReleaseGPUTexture(gpuDevice, vrSwapchains[i].overdrawTexture);
+            }
             if (vrSwapchains[i].swapchain) {
-                SDL_DestroyGPUXRSwapchain(gpuDevice, vrSwapchains[i].swapchain, vrSwapchains[i].images);
+                destroyXRSwapchain(gpuDevice, vrSwapchains[i].swapchain, vrSwapchains[i].images);
             }
         }
         SDL_free(vrSwapchains);
     }
     
     if (xrViews) SDL_free(xrViews);
+    if (projViews) SDL_free(projViews);
+    SDL_free(runtimeExtensions);
+    
+    /* Destroying the action set also destroys its actions */
+    for (int hand = 0; hand < HAND_COUNT; hand++) {
+        if (gripSpaces[hand] && pfn_xrDestroySpace) pfn_xrDestroySpace(gripSpaces[hand]);
+        if (aimSpaces[hand] && pfn_xrDestroySpace) pfn_xrDestroySpace(aimSpaces[hand]);
+    }
+    if (xrActionSet && pfn_xrDestroyActionSet) pfn_xrDestroyActionSet(xrActionSet);
+    Spaces_Shutdown();
     
     if (xrLocalSpace && pfn_xrDestroySpace) pfn_xrDestroySpace(xrLocalSpace);
     if (xrSession && pfn_xrDestroySession) pfn_xrDestroySession(xrSession);
     
+    if (mockRuntime) MockXR_Shutdown();
     if (gpuDevice) SDL_DestroyGPUDevice(gpuDevice);
     
     /* Note: xrInstance is managed by SDL */
     
+    CmdStream_Shutdown();
+    Log_Shutdown();
     SDL_Quit();
 }
 
 int main(int argc, char *argv[])
 {
-    (void)argc;
-    (void)argv;
-    
+    Startup_Init();
     SDL_Log("Quest VR Spinning Cubes Test starting...");
     
-    if (!SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS)) {
+    ParseArgs(argc, argv);
+    
+    Startup_BeginPhase("SDL_Init");
+    bool initialized = SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS);
+    Startup_EndPhase();
+    if (!initialized) {
         SDL_Log("SDL_Init failed: %s", SDL_GetError());
         return 1;
     }
     
     SDL_Log("SDL initialized");
     
+    Log_Init();
+    ApplyProfile();
+    
     /* Create GPU device with OpenXR enabled */
     SDL_Log("Creating GPU device with OpenXR enabled...");
     
     /* Create GPU device WITHOUT OpenXR to test basic Vulkan */
     SDL_PropertiesID props = SDL_CreateProperties();
     SDL_SetBooleanProperty(props, SDL_PROP_GPU_DEVICE_CREATE_SHADERS_SPIRV_BOOLEAN, true);
-    SDL_SetBooleanProperty(props, SDL_PROP_GPU_DEVICE_CREATE_DEBUGMODE_BOOLEAN, true);
-    /* Re-enable XR */
-    SDL_SetBooleanProperty(props, SDL_PROP_GPU_DEVICE_CREATE_XR_ENABLE_BOOLEAN, true);
-    SDL_SetPointerProperty(props, SDL_PROP_GPU_DEVICE_CREATE_XR_INSTANCE_POINTER, &xrInstance);
-    SDL_SetPointerProperty(props, SDL_PROP_GPU_DEVICE_CREATE_XR_SYSTEM_ID_POINTER, &xrSystemId);
-    SDL_SetStringProperty(props, SDL_PROP_GPU_DEVICE_CREATE_XR_APPLICATION_NAME_STRING, "Quest VR Test");
-    SDL_SetNumberProperty(props, SDL_PROP_GPU_DEVICE_CREATE_XR_APPLICATION_VERSION_NUMBER, 1);
+    SDL_SetBooleanProperty(props, SDL_PROP_GPU_DEVICE_CREATE_DEBUGMODE_BOOLEAN, runtimeProfile->gpuValidation);
+    
+    /* Extensions SDL does not enable on its own */
+    const char *xrExtensions[8];
+    Sint64 xrExtensionCount = 0;
+    if (requestedViewConfig == XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO_WITH_FOVEATED_INSET) {
+        xrExtensions[xrExtensionCount++] = XR_VARJO_QUAD_VIEWS_EXTENSION_NAME;
+    }
+    if (!mockRuntime) {
+        QueryRuntimeExtensions();
+    }
+    if (RuntimeHasExtension(XR_KHR_LOCATE_SPACES_EXTENSION_NAME)) {
+        xrExtensions[xrExtensionCount++] = XR_KHR_LOCATE_SPACES_EXTENSION_NAME;
+    }
+    if (governorEnabled && RuntimeHasExtension(XR_EXT_PERFORMANCE_SETTINGS_EXTENSION_NAME)) {
+        xrExtensions[xrExtensionCount++] = XR_EXT_PERFORMANCE_SETTINGS_EXTENSION_NAME;
+    }
+    if (RuntimeHasExtension(XR_FB_DISPLAY_REFRESH_RATE_EXTENSION_NAME)) {
+        xrExtensions[xrExtensionCount++] = XR_FB_DISPLAY_REFRESH_RATE_EXTENSION_NAME;
+    }
+    
+    /* The mock runtime needs a plain device; it supplies the XR side itself */
+    if (!mockRuntime) {
+        /* Re-enable XR */
+        SDL_SetBooleanProperty(props, SDL_PROP_GPU_DEVICE_CREATE_XR_ENABLE_BOOLEAN, true);
+        SDL_SetPointerProperty(props, SDL_PROP_GPU_DEVICE_CREATE_XR_INSTANCE_POINTER, &xrInstance);
+        SDL_SetPointerProperty(props, SDL_PROP_GPU_DEVICE_CREATE_XR_SYSTEM_ID_POINTER, &xrSystemId);
+        SDL_SetStringProperty(props, SDL_PROP_GPU_DEVICE_CREATE_XR_APPLICATION_NAME_STRING, "Quest VR Test");
+        SDL_SetNumberProperty(props, SDL_PROP_GPU_DEVICE_CREATE_XR_APPLICATION_VERSION_NUMBER, 1);
+        if (xrExtensionCount > 0) {
+            SDL_SetNumberProperty(props, SDL_PROP_GPU_DEVICE_CREATE_XR_EXTENSION_COUNT_NUMBER, xrExtensionCount);
+            SDL_SetPointerProperty(props, SDL_PROP_GPU_DEVICE_CREATE_XR_EXTENSION_NAMES_POINTER, (void *)xrExtensions);
+        }
+    }
     
+    Startup_BeginPhase(mockRuntime ? "CreateGPUDevice" : "CreateGPUDevice (with XR instance)");
     gpuDevice = SDL_CreateGPUDeviceWithProperties(props);
+    Startup_EndPhase();
     SDL_DestroyProperties(props);
     
     if (!gpuDevice) {
         SDL_Log("Failed to create GPU device: %s", SDL_GetError());
+        Log_Shutdown();
         SDL_Quit();
         return 1;
     }
     
+    if (mockRuntime) {
+        Startup_BeginPhase("MockXR_Init");
+        bool mockReady = MockXR_Init(gpuDevice, &mockConfig, &xrInstance, &xrSystemId);
+        Startup_EndPhase();
+        if (!mockReady) {
+            SDL_Log("Failed to initialize the mock XR runtime");
+            Cleanup();
+            return 1;
+        }
+        createXRSession = MockXR_CreateSession;
+        createXRSwapchain = MockXR_CreateSwapchain;
+        destroyXRSwapchain = MockXR_DestroySwapchain;
+    } else {
+        createXRSession = SDL_CreateGPUXRSession;
+        createXRSwapchain = SDL_CreateGPUXRSwapchain;
+        destroyXRSwapchain = SDL_DestroyGPUXRSwapchain;
+    }
+    
     SDL_Log("GPU device created, XR instance: %p, systemId: %llu", 
             (void*)(uintptr_t)xrInstance, (unsigned long long)xrSystemId);
     
     /* Load OpenXR function pointers */
-    if (LoadXRFunctions() != 0) {
+    Startup_BeginPhase("LoadXRFunctions");
+    int failed = LoadXRFunctions();
+    Startup_EndPhase();
+    if (failed) {
         SDL_Log("Failed to load XR functions");
         Cleanup();
         return 1;
     }
     
+    if (SelectViewConfiguration() != 0) {
+        Cleanup();
+        return 1;
+    }
+    
     /* Initialize XR session */
-    if (InitXRSession() != 0) {
+    Startup_BeginPhase("InitXRSession");
+    failed = InitXRSession();
+    Startup_EndPhase();
+    if (failed) {
         SDL_Log("Failed to init XR session");
         Cleanup();
         return 1;
     }
     
+    /* Without controllers the scene still renders */
+    Startup_BeginPhase("InitControllers");
+    if (controllersEnabled && InitControllers() != 0) {
+        SDL_Log("Continuing without controllers");
+    }
+    Startup_EndPhase();
+    
+    /* Scene geometry is built now; its GPU resources follow the swapchains */
+    if (sceneEnabled) {
+        if (sceneSnapshotPath) {
+            Startup_BeginPhase("Scene_Restore");
+            activeScene = Scene_Restore(&sceneConfig, sceneSnapshotPath);
+            Startup_EndPhase();
+        }
+        if (!activeScene) {
+            Startup_BeginPhase("Scene_Create");
+            activeScene = Scene_Create(&sceneConfig);
+            Startup_EndPhase();
+            if (activeScene && sceneSnapshotPath) {
+                Startup_BeginPhase("Scene_WriteSnapshot");
+                Scene_WriteSnapshot(activeScene, sceneSnapshotPath);
+                Startup_EndPhase();
+            }
+        }
+        if (!activeScene) {
+            SDL_Log("Failed to create scene %s", Scene_KindName(sceneConfig.kind));
+            Cleanup();
+            return 1;
+        }
+    }
+    
+    /* Armed before any pipeline or buffer exists so all of them get registered */
+    if (streamCapturePath) {
+        if (overdrawMode) {
+            SDL_Log("Command stream capture does not cover the overdraw view; not capturing");
+        } else {
+            Startup_BeginPhase("CmdStream_Init");
+            bool streamReady = CmdStream_Init(streamCapturePath, captureConfig.captureFrame);
+            Startup_EndPhase();
+            if (!streamReady) {
+                SDL_Log("Continuing without command stream capture");
+            }
+        }
+    }
+    
+    /* Readback ring and capture worker (also used for overdraw stats) */
+    Startup_BeginPhase("InitCapture");
+    readbackRing = Readback_Create(gpuDevice, READBACK_SLOTS);
+    bool captureReady = readbackRing && Capture_Init(&captureConfig);
+    Startup_EndPhase();
+    if (!captureReady) {
+        SDL_Log("Failed to init frame capture");
+        Cleanup();
+        return 1;
+    }
+    
+    /* A mirror failure only costs the desktop view */
+    Startup_BeginPhase("Mirror_Init");
+    bool mirrorReady = Mirror_Init(gpuDevice, mirrorMode, mirrorRate, mirrorWidth, mirrorHeight);
+    Startup_EndPhase();
+    if (!mirrorReady) {
+        SDL_Log("Continuing without mirror window");
+    }
+    if (spectatorEnabled) {
+        Startup_BeginPhase("InitSpectator");
+        bool spectatorReady = InitSpectator();
+        Startup_EndPhase();
+        if (!spectatorReady) {
+            SDL_Log("Continuing without spectator camera");
+        }
+    }
+    Startup_BeginPhase("InitRefreshRates");
+    InitRefreshRates();
+    Startup_EndPhase();
+    if (governorEnabled) {
+        Startup_BeginPhase("InitGovernor");
+        bool governorReady = InitGovernor();
+        Startup_EndPhase();
+        if (!governorReady) {
+            SDL_Log("Continuing without frame budget governor");
+        }
+    }
+    if (benchEnabled) {
+        Startup_BeginPhase("InitBench");
+        bool benchReady = InitBench();
+        Startup_EndPhase();
+        if (!benchReady) {
+            Cleanup();
+            return 1;
+        }
+    }
+    
+    /* Ended by the READY event, so it only covers the runtime's own wait */
+    Startup_BeginPhase("wait for READY");
+    
     SDL_Log("Entering main loop...");
     
     /* Main loop */
@@ -808,6 +3129,20 @@ int main(int argc, char *argv[])
         while (SDL_PollEvent(&event)) {
             if (event.type == SDL_EVENT_QUIT) {
                 xrShouldQuit = true;
+            } else if (event.type == SDL_EVENT_WINDOW_CLOSE_REQUESTED) {
+                /* Closing a desktop window only closes that window */
+                if (spectatorWindow && event.window.windowID == SDL_GetWindowID(spectatorWindow)) {
+                    ShutdownSpectator();
+                } else {
+                    Mirror_Shutdown();
+                }
+            } else if (event.type == SDL_EVENT_KEY_DOWN && !event.key.repeat) {
+                /* P steps through the render paths, 1-6 pick one */
+                if (event.key.key == SDLK_P) {
+                    CycleRenderPath();
+                } else if (event.key.key >= SDLK_1 && event.key.key < SDLK_1 + RENDER_PATH_COUNT) {
+                    SwitchRenderPath((int)(event.key.key - SDLK_1));
+                }
             }
         }
         
@@ -816,6 +3151,21 @@ int main(int argc, char *argv[])
     }
     
     Cleanup();
+    
+    /* Golden results are final only after Cleanup() drains the capture worker */
+    if (Capture_GoldenFailed()) {
+        SDL_Log("Quest VR Test finished: golden image comparison failed");
+        return 1;
+    }
+    if (Bench_Failed()) {
+        SDL_Log("Quest VR Test finished: benchmark failed or regressed against its baseline");
+        return 1;
+    }
+    if (Bench_Skipped()) {
+        SDL_Log("Quest VR Test finished: no benchmark baseline to compare against");
+        return BENCH_EXIT_SKIPPED;
+    }
+    
     SDL_Log("Quest VR Test finished");
     return 0;
 }
@@ -0,0 +1,486 @@
+/*
+ * Meshlet cluster culling - see meshlets.h
+ */
+
+#include "meshlets.h"
+
+#include "shaders.h"
+
+#define CULL_GROUP_SIZE 128         /* Threads per meshlet in MeshletCull.comp.hlsl; >= MESHLET_MAX_TRIANGLES */
+#define MAX_DISPATCH_GROUPS 65535   /* Per dispatch dimension, on every backend */
+#define CONE_MIN_SPREAD 0.1f        /* Normals closer to perpendicular than this make the cone useless */
+
+/* Per-object data of the cull; the layout MeshletCull.comp.hlsl reads */
+typedef struct {
+    Mat4 model;
+    Uint32 firstMeshlet;
+    Uint32 meshletCount;
+    Uint32 firstOutputIndex;        /* Into the view's output index buffer */
+    Uint32 cullBackfaces;
+} ClusterObject;
+
+/* MeshletCull.comp.hlsl uniforms */
+typedef struct {
+    Frustum frustum;
+    float eye[4];
+} CullUniforms;
+
+struct MeshletCuller {
+    SDL_GPUDevice *device;
+    Uint32 meshCount;
+    Uint32 viewCount;
+    Uint32 maxObjects;
+    Uint32 maxIndices;
+    Uint32 maxMeshlets;             /* Of any one mesh: the dispatch width */
+    Uint32 *meshFirst;              /* Per mesh, into meshletBuffer */
+    Uint32 *meshMeshlets;           /* Per mesh; 0 when the mesh is drawn whole */
+    Uint32 *meshIndices;
+    SDL_GPUComputePipeline *pipeline;
+    SDL_GPUBuffer *meshletBuffer;
+    SDL_GPUBuffer *indexBuffer;     /* Every clustered mesh's indices, which meshlets index into */
+    SDL_GPUBuffer *objectBuffer;
+    SDL_GPUBuffer *commandTemplate; /* Per slot, the draw with no indices yet */
+    SDL_GPUTransferBuffer *objectTransfer;
+    SDL_GPUTransferBuffer *commandTransfer;
+    SDL_GPUBuffer **viewCommands;   /* Per view, the template with the counts the cull added */
+    SDL_GPUBuffer **viewIndices;    /* Per view, the surviving triangles of every slot */
+    Uint32 objectCount;             /* This frame */
+};
+
+/* ========================================================================
+ * Building
+ * ======================================================================== */
+
+static Vec3 VertexPosition(const PositionColorVertex *vertices, Uint32 index)
+{
+    return (Vec3){ vertices[index].x, vertices[index].y, vertices[index].z };
+}
+
+static Vec3 Sub(Vec3 a, Vec3 b)
+{
+    return (Vec3){ a.x - b.x, a.y - b.y, a.z - b.z };
+}
+
+static float Dot(Vec3 a, Vec3 b)
+{
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+static Vec3 Cross(Vec3 a, Vec3 b)
+{
+    return (Vec3){ a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+}
+
+/* Outward normal of a front face, or zero for a degenerate triangle. Front
+ * faces wind so that (p1 - p0) x (p2 - p0) points into the mesh. */
+static Vec3 TriangleNormal(const PositionColorVertex *vertices, const Uint32 *triangle)
+{
+    Vec3 p0 = VertexPosition(vertices, triangle[0]);
+    Vec3 n = Cross(Sub(VertexPosition(vertices, triangle[2]), p0), Sub(VertexPosition(vertices, triangle[1]), p0));
+    float len = SDL_sqrtf(Dot(n, n));
+    if (len < 1e-12f) return (Vec3){ 0.0f, 0.0f, 0.0f };
+    return (Vec3){ n.x / len, n.y / len, n.z / len };
+}
+
+/* Bounding sphere around the center of the bounding box, then the cone that
+ * holds every triangle normal. The apex sits far enough back along the axis
+ * that an eye inside the cone sees the back of every triangle. */
+static void ComputeBounds(Meshlet *meshlet, const PositionColorVertex *vertices, const Uint32 *indices)
+{
+    const Uint32 *first = &indices[meshlet->firstIndex];
+    Uint32 indexCount = meshlet->triangleCount * 3;
+
+    Vec3 lo = VertexPosition(vertices, first[0]), hi = lo;
+    for (Uint32 i = 1; i < indexCount; i++) {
+        Vec3 p = VertexPosition(vertices, first[i]);
+        lo = (Vec3){ SDL_min(lo.x, p.x), SDL_min(lo.y, p.y), SDL_min(lo.z, p.z) };
+        hi = (Vec3){ SDL_max(hi.x, p.x), SDL_max(hi.y, p.y), SDL_max(hi.z, p.z) };
+    }
+    Vec3 center = { (lo.x + hi.x) * 0.5f, (lo.y + hi.y) * 0.5f, (lo.z + hi.z) * 0.5f };
+    float radiusSq = 0.0f;
+    for (Uint32 i = 0; i < indexCount; i++) {
+        Vec3 d = Sub(VertexPosition(vertices, first[i]), center);
+        radiusSq = SDL_max(radiusSq, Dot(d, d));
+    }
+    meshlet->center[0] = center.x;
+    meshlet->center[1] = center.y;
+    meshlet->center[2] = center.z;
+    meshlet->radius = SDL_sqrtf(radiusSq);
+    meshlet->coneCutoff = 2.0f;
+
+    Vec3 axis = { 0.0f, 0.0f, 0.0f };
+    for (Uint32 t = 0; t < meshlet->triangleCount; t++) {
+        Vec3 n = TriangleNormal(vertices, &first[t * 3]);
+        axis = (Vec3){ axis.x + n.x, axis.y + n.y, axis.z + n.z };
+    }
+    float axisLen = SDL_sqrtf(Dot(axis, axis));
+    if (axisLen < 1e-6f) return;
+    axis = (Vec3){ axis.x / axisLen, axis.y / axisLen, axis.z / axisLen };
+
+    float minDot = 1.0f;
+    for (Uint32 t = 0; t < meshlet->triangleCount; t++) {
+        Vec3 n = TriangleNormal(vertices, &first[t * 3]);
+        if (Dot(n, n) > 0.0f) minDot = SDL_min(minDot, Dot(n, axis));
+    }
+    if (minDot <= CONE_MIN_SPREAD) return;
+
+    /* Each triangle's plane crosses the axis line at center + axis * t; the
+     * apex goes behind the furthest crossing */
+    float maxT = 0.0f;
+    for (Uint32 t = 0; t < meshlet->triangleCount; t++) {
+        Vec3 n = TriangleNormal(vertices, &first[t * 3]);
+        if (Dot(n, n) == 0.0f) continue;
+        float distance = Dot(Sub(center, VertexPosition(vertices, first[t * 3])), n);
+        maxT = SDL_max(maxT, distance / Dot(axis, n));
+    }
+    meshlet->coneApex[0] = center.x - axis.x * maxT;
+    meshlet->coneApex[1] = center.y - axis.y * maxT;
+    meshlet->coneApex[2] = center.z - axis.z * maxT;
+    meshlet->coneAxis[0] = axis.x;
+    meshlet->coneAxis[1] = axis.y;
+    meshlet->coneAxis[2] = axis.z;
+    meshlet->coneCutoff = SDL_sqrtf(1.0f - minDot * minDot);
+}
+
+static bool AppendMeshlet(MeshletMesh *mesh, Uint32 *capacity, const Meshlet *meshlet)
+{
+    if (mesh->meshletCount == *capacity) {
+        Uint32 newCapacity = *capacity ? *capacity * 2 : 64;
+        Meshlet *meshlets = SDL_realloc(mesh->meshlets, newCapacity * sizeof(Meshlet));
+        if (!meshlets) return false;
+        mesh->meshlets = meshlets;
+        *capacity = newCapacity;
+    }
+    mesh->meshlets[mesh->meshletCount++] = *meshlet;
+    return true;
+}
+
+bool Meshlets_Build(const PositionColorVertex *vertices, Uint32 vertexCount, const Uint32 *indices, Uint32 indexCount,
+                    MeshletMesh *mesh)
+{
+    *mesh = (MeshletMesh){ .indices = indices, .indexCount = indexCount };
+    Uint32 triangleCount = indexCount / 3;
+    if (triangleCount < MESHLET_MIN_TRIANGLES) return true;
+
+    /* The meshlet each vertex was last counted in, so shared vertices count once */
+    Uint32 *lastMeshlet = SDL_malloc(vertexCount * sizeof(Uint32));
+    if (!lastMeshlet) return false;
+    SDL_memset(lastMeshlet, 0xff, vertexCount * sizeof(Uint32));
+
+    Uint32 capacity = 0;
+    Meshlet current = { 0 };
+    bool ok = true;
+    for (Uint32 t = 0; t < triangleCount && ok; t++) {
+        const Uint32 *triangle = &indices[t * 3];
+        Uint32 newVertices = 0;
+        for (int k = 0; k < 3; k++) {
+            if (lastMeshlet[triangle[k]] != mesh->meshletCount) newVertices++;
+        }
+        if (current.triangleCount == MESHLET_MAX_TRIANGLES ||
+            current.vertexCount + newVertices > MESHLET_MAX_VERTICES) {
+            ComputeBounds(&current, vertices, indices);
+            ok = AppendMeshlet(mesh, &capacity, &current);
+            current = (Meshlet){ .firstIndex = t * 3 };
+        }
+        for (int k = 0; k < 3; k++) {
+            if (lastMeshlet[triangle[k]] != mesh->meshletCount) {
+                lastMeshlet[triangle[k]] = mesh->meshletCount;
+                current.vertexCount++;
+            }
+        }
+        current.triangleCount++;
+    }
+    if (ok) {
+        ComputeBounds(&current, vertices, indices);
+        ok = AppendMeshlet(mesh, &capacity, &current);
+    }
+    SDL_free(lastMeshlet);
+
+    if (!ok) {
+        Meshlets_Free(mesh);
+        return false;
+    }
+    return true;
+}
+
+void Meshlets_Free(MeshletMesh *mesh)
+{
+    SDL_free(mesh->meshlets);
+    mesh->meshlets = NULL;
+    mesh->meshletCount = 0;
+}
+
+/* ========================================================================
+ * Culling
+ * ======================================================================== */
+
+static SDL_GPUComputePipeline *CreateCullPipeline(SDL_GPUDevice *device)
+{
+    SDL_GPUComputePipelineCreateInfo info = {
+        .num_readonly_storage_buffers = 3,
+        .num_readwrite_storage_buffers = 2,
+        .num_uniform_buffers = 1,
+        .threadcount_x = CULL_GROUP_SIZE,
+        .threadcount_y = 1,
+        .threadcount_z = 1
+    };
+    return Shaders_LoadCompute(device, "MeshletCull.comp", &info);
+}
+
+/* Meshlets with firstIndex made relative to the shared index buffer, then the indices */
+static bool UploadMeshlets(MeshletCuller *culler, const MeshletMesh *meshes, Uint32 meshletCount,
+                           Uint32 indexCount)
+{
+    Uint32 meshletSize = meshletCount * (Uint32)sizeof(Meshlet);
+    Uint32 indexSize = indexCount * (Uint32)sizeof(Uint32);
+    SDL_GPUTransferBufferCreateInfo transferInfo = {
+        .usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD,
+        .size = meshletSize + indexSize
+    };
+    SDL_GPUTransferBuffer *transfer = SDL_CreateGPUTransferBuffer(culler->device, &transferInfo);
+    if (!transfer) return false;
+
+    Uint8 *data = SDL_MapGPUTransferBuffer(culler->device, transfer, false);
+    if (!data) {
+        SDL_ReleaseGPUTransferBuffer(culler->device, transfer);
+        return false;
+    }
+    Meshlet *meshletData = (Meshlet *)data;
+    Uint32 *indexData = (Uint32 *)(data + meshletSize);
+    Uint32 indexBase = 0;
+    for (Uint32 i = 0; i < culler->meshCount; i++) {
+        const MeshletMesh *mesh = &meshes[i];
+        if (mesh->meshletCount == 0) continue;
+        for (Uint32 m = 0; m < mesh->meshletCount; m++) {
+            Meshlet meshlet = mesh->meshlets[m];
+            meshlet.firstIndex += indexBase;
+            meshletData[culler->meshFirst[i] + m] = meshlet;
+        }
+        SDL_memcpy(indexData + indexBase, mesh->indices, mesh->indexCount * sizeof(Uint32));
+        indexBase += mesh->indexCount;
+    }
+    SDL_UnmapGPUTransferBuffer(culler->device, transfer);
+
+    SDL_GPUCommandBuffer *cmd = SDL_AcquireGPUCommandBuffer(culler->device);
+    SDL_GPUCopyPass *copyPass = SDL_BeginGPUCopyPass(cmd);
+    SDL_GPUTransferBufferLocation srcMeshlets = { .transfer_buffer = transfer, .offset = 0 };
+    SDL_GPUBufferRegion dstMeshlets = { .buffer = culler->meshletBuffer, .offset = 0, .size = meshletSize };
+    SDL_UploadToGPUBuffer(copyPass, &srcMeshlets, &dstMeshlets, false);
+    SDL_GPUTransferBufferLocation srcIndices = { .transfer_buffer = transfer, .offset = meshletSize };
+    SDL_GPUBufferRegion dstIndices = { .buffer = culler->indexBuffer, .offset = 0, .size = indexSize };
+    SDL_UploadToGPUBuffer(copyPass, &srcIndices, &dstIndices, false);
+    SDL_EndGPUCopyPass(copyPass);
+    bool submitted = SDL_SubmitGPUCommandBuffer(cmd);
+    SDL_ReleaseGPUTransferBuffer(culler->device, transfer);
+    return submitted;
+}
+
+/* ========================================================================
+ * Public Interface
+ * ======================================================================== */
+
+MeshletCuller *Meshlets_CreateCuller(SDL_GPUDevice *device, const MeshletMesh *meshes, Uint32 meshCount,
+                                     Uint32 viewCount, Uint32 maxObjects, Uint32 maxIndices)
+{
+    MeshletCuller *culler = SDL_calloc(1, sizeof(MeshletCuller));
+    if (!culler) return NULL;
+    culler->device = device;
+    culler->meshCount = meshCount;
+    culler->viewCount = viewCount;
+    culler->maxObjects = SDL_max(1u, maxObjects);
+    culler->maxIndices = SDL_max(3u, maxIndices);
+
+    culler->meshFirst = SDL_calloc(SDL_max(1u, meshCount), sizeof(Uint32));
+    culler->meshMeshlets = SDL_calloc(SDL_max(1u, meshCount), sizeof(Uint32));
+    culler->meshIndices = SDL_calloc(SDL_max(1u, meshCount), sizeof(Uint32));
+    culler->viewCommands = SDL_calloc(SDL_max(1u, viewCount), sizeof(SDL_GPUBuffer *));
+    culler->viewIndices = SDL_calloc(SDL_max(1u, viewCount), sizeof(SDL_GPUBuffer *));
+    if (!culler->meshFirst || !culler->meshMeshlets || !culler->meshIndices || !culler->viewCommands ||
+        !culler->viewIndices) {
+        Meshlets_DestroyCuller(culler);
+        return NULL;
+    }
+
+    Uint32 meshletCount = 0, indexCount = 0;
+    for (Uint32 i = 0; i < meshCount; i++) {
+        if (meshes[i].meshletCount == 0) continue;
+        if (meshes[i].meshletCount > MAX_DISPATCH_GROUPS) {
+            SDL_Log("Meshlets: mesh %u has %u meshlets, more than one dispatch covers", i, meshes[i].meshletCount);
+            continue;
+        }
+        culler->meshFirst[i] = meshletCount;
+        culler->meshMeshlets[i] = meshes[i].meshletCount;
+        culler->meshIndices[i] = meshes[i].indexCount;
+        culler->maxMeshlets = SDL_max(culler->maxMeshlets, meshes[i].meshletCount);
+        meshletCount += meshes[i].meshletCount;
+        indexCount += meshes[i].indexCount;
+    }
+    if (meshletCount == 0) {
+        Meshlets_DestroyCuller(culler);
+        return NULL;
+    }
+
+    culler->pipeline = CreateCullPipeline(device);
+    if (!culler->pipeline) {
+        Meshlets_DestroyCuller(culler);
+        return NULL;
+    }
+
+    Uint32 objectSize = culler->maxObjects * (Uint32)sizeof(ClusterObject);
+    Uint32 commandSize = culler->maxObjects * (Uint32)sizeof(SDL_GPUIndexedIndirectDrawCommand);
+    SDL_GPUBufferCreateInfo meshletInfo = {
+        .usage = SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_READ, .size = meshletCount * (Uint32)sizeof(Meshlet)
+    };
+    SDL_GPUBufferCreateInfo indexInfo = {
+        .usage = SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_READ, .size = indexCount * (Uint32)sizeof(Uint32)
+    };
+    SDL_GPUBufferCreateInfo objectInfo = { .usage = SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_READ, .size = objectSize };
+    SDL_GPUBufferCreateInfo templateInfo = { .usage = SDL_GPU_BUFFERUSAGE_INDIRECT, .size = commandSize };
+    SDL_GPUTransferBufferCreateInfo objectTransferInfo = { .usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD, .size = objectSize };
+    SDL_GPUTransferBufferCreateInfo commandTransferInfo = { .usage = SDL_GPU_TRANSFERBUFFERUSAGE_UPLOAD, .size = commandSize };
+    culler->meshletBuffer = SDL_CreateGPUBuffer(device, &meshletInfo);
+    culler->indexBuffer = SDL_CreateGPUBuffer(device, &indexInfo);
+    culler->objectBuffer = SDL_CreateGPUBuffer(device, &objectInfo);
+    culler->commandTemplate = SDL_CreateGPUBuffer(device, &templateInfo);
+    culler->objectTransfer = SDL_CreateGPUTransferBuffer(device, &objectTransferInfo);
+    culler->commandTransfer = SDL_CreateGPUTransferBuffer(device, &commandTransferInfo);
+    bool created = culler->meshletBuffer && culler->indexBuffer && culler->objectBuffer && culler->commandTemplate &&
+                   culler->objectTransfer && culler->commandTransfer;
+
+    SDL_GPUBufferCreateInfo commandInfo = {
+        .usage = SDL_GPU_BUFFERUSAGE_INDIRECT | SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_WRITE, .size = commandSize
+    };
+    SDL_GPUBufferCreateInfo outputInfo = {
+        .usage = SDL_GPU_BUFFERUSAGE_INDEX | SDL_GPU_BUFFERUSAGE_COMPUTE_STORAGE_WRITE,
+        .size = culler->maxIndices * (Uint32)sizeof(Uint32)
+    };
+    for (Uint32 v = 0; v < viewCount && created; v++) {
+        culler->viewCommands[v] = SDL_CreateGPUBuffer(device, &commandInfo);
+        culler->viewIndices[v] = SDL_CreateGPUBuffer(device, &outputInfo);
+        created = culler->viewCommands[v] && culler->viewIndices[v];
+    }
+
+    if (!created || !UploadMeshlets(culler, meshes, meshletCount, indexCount)) {
+        SDL_Log("Meshlets: failed to create resources for %u meshlets: %s", meshletCount, SDL_GetError());
+        Meshlets_DestroyCuller(culler);
+        return NULL;
+    }
+    SDL_Log("Meshlets: %u meshlets, up to %u objects and %u indices per view", meshletCount, culler->maxObjects,
+            culler->maxIndices);
+    return culler;
+}
+
+void Meshlets_DestroyCuller(MeshletCuller *culler)
+{
+    if (!culler) return;
+
+    SDL_GPUDevice *device = culler->device;
+    if (culler->pipeline) SDL_ReleaseGPUComputePipeline(device, culler->pipeline);
+    if (culler->meshletBuffer) SDL_ReleaseGPUBuffer(device, culler->meshletBuffer);
+    if (culler->indexBuffer) SDL_ReleaseGPUBuffer(device, culler->indexBuffer);
+    if (culler->objectBuffer) SDL_ReleaseGPUBuffer(device, culler->objectBuffer);
+    if (culler->commandTemplate) SDL_ReleaseGPUBuffer(device, culler->commandTemplate);
+    if (culler->objectTransfer) SDL_ReleaseGPUTransferBuffer(device, culler->objectTransfer);
+    if (culler->commandTransfer) SDL_ReleaseGPUTransferBuffer(device, culler->commandTransfer);
+    for (Uint32 v = 0; v < culler->viewCount && culler->viewCommands; v++) {
+        if (culler->viewCommands[v]) SDL_ReleaseGPUBuffer(device, culler->viewCommands[v]);
+        if (culler->viewIndices[v]) SDL_ReleaseGPUBuffer(device, culler->viewIndices[v]);
+    }
+    SDL_free(culler->meshFirst);
+    SDL_free(culler->meshMeshlets);
+    SDL_free(culler->meshIndices);
+    SDL_free(culler->viewCommands);
+    SDL_free(culler->viewIndices);
+    SDL_free(culler);
+}
+
+Uint32 Meshlets_BeginFrame(MeshletCuller *culler, SDL_GPUCommandBuffer *cmdBuf, const MeshletObject *objects,
+                           Uint32 count)
+{
+    culler->objectCount = 0;
+    if (count == 0) return 0;
+
+    /* Cycled so the previous frame's passes can still read their copies */
+    ClusterObject *objectData = SDL_MapGPUTransferBuffer(culler->device, culler->objectTransfer, true);
+    SDL_GPUIndexedIndirectDrawCommand *commandData =
+        SDL_MapGPUTransferBuffer(culler->device, culler->commandTransfer, true);
+    if (!objectData || !commandData) {
+        if (objectData) SDL_UnmapGPUTransferBuffer(culler->device, culler->objectTransfer);
+        if (commandData) SDL_UnmapGPUTransferBuffer(culler->device, culler->commandTransfer);
+        return 0;
+    }
+
+    /* Slots are taken in order, each with its mesh's whole index count reserved in the output */
+    Uint32 accepted = 0, outputIndices = 0;
+    for (; accepted < count && accepted < culler->maxObjects; accepted++) {
+        const MeshletObject *object = &objects[accepted];
+        if (object->mesh >= culler->meshCount || culler->meshMeshlets[object->mesh] == 0) break;
+        Uint32 indexCount = culler->meshIndices[object->mesh];
+        if (indexCount > culler->maxIndices - outputIndices) break;
+
+        objectData[accepted] = (ClusterObject){
+            object->model, culler->meshFirst[object->mesh], culler->meshMeshlets[object->mesh], outputIndices,
+            object->doubleSided ? 0u : 1u
+        };
+        commandData[accepted] = (SDL_GPUIndexedIndirectDrawCommand){
+            .num_indices = 0, .num_instances = 1, .first_index = outputIndices
+        };
+        outputIndices += indexCount;
+    }
+    SDL_UnmapGPUTransferBuffer(culler->device, culler->objectTransfer);
+    SDL_UnmapGPUTransferBuffer(culler->device, culler->commandTransfer);
+    if (accepted == 0) return 0;
+
+    SDL_GPUCopyPass *copyPass = SDL_BeginGPUCopyPass(cmdBuf);
+    SDL_GPUTransferBufferLocation srcObjects = { .transfer_buffer = culler->objectTransfer };
+    SDL_GPUBufferRegion dstObjects = {
+        .buffer = culler->objectBuffer, .size = accepted * (Uint32)sizeof(ClusterObject)
+    };
+    SDL_UploadToGPUBuffer(copyPass, &srcObjects, &dstObjects, true);
+    SDL_GPUTransferBufferLocation srcCommands = { .transfer_buffer = culler->commandTransfer };
+    SDL_GPUBufferRegion dstCommands = {
+        .buffer = culler->commandTemplate, .size = accepted * (Uint32)sizeof(SDL_GPUIndexedIndirectDrawCommand)
+    };
+    SDL_UploadToGPUBuffer(copyPass, &srcCommands, &dstCommands, true);
+    SDL_EndGPUCopyPass(copyPass);
+
+    culler->objectCount = accepted;
+    return accepted;
+}
+
+void Meshlets_Cull(MeshletCuller *culler, SDL_GPUCommandBuffer *cmdBuf, Uint32 view, const Mat4 *viewProj, Vec3 eye)
+{
+    if (culler->objectCount == 0 || view >= culler->viewCount) return;
+
+    /* The cull adds to the index counts, so every view starts from the template */
+    SDL_GPUCopyPass *copyPass = SDL_BeginGPUCopyPass(cmdBuf);
+    SDL_GPUBufferLocation src = { .buffer = culler->commandTemplate };
+    SDL_GPUBufferLocation dst = { .buffer = culler->viewCommands[view] };
+    SDL_CopyGPUBufferToBuffer(copyPass, &src, &dst,
+                              culler->objectCount * (Uint32)sizeof(SDL_GPUIndexedIndirectDrawCommand), true);
+    SDL_EndGPUCopyPass(copyPass);
+
+    /* The command buffer was just cycled by the copy; the output is fully rewritten, so cycling it is safe */
+    SDL_GPUStorageBufferReadWriteBinding outputs[2] = {
+        { .buffer = culler->viewCommands[view], .cycle = false },
+        { .buffer = culler->viewIndices[view], .cycle = true }
+    };
+    SDL_GPUComputePass *computePass = SDL_BeginGPUComputePass(cmdBuf, NULL, 0, outputs, 2);
+    SDL_BindGPUComputePipeline(computePass, culler->pipeline);
+    SDL_GPUBuffer *inputs[3] = { culler->meshletBuffer, culler->indexBuffer, culler->objectBuffer };
+    SDL_BindGPUComputeStorageBuffers(computePass, 0, inputs, 3);
+    CullUniforms uniforms = { Frustum_FromViewProj(viewProj), { eye.x, eye.y, eye.z, 1.0f } };
+    SDL_PushGPUComputeUniformData(cmdBuf, 0, &uniforms, sizeof(uniforms));
+    SDL_DispatchGPUCompute(computePass, culler->maxMeshlets, culler->objectCount, 1);
+    SDL_EndGPUComputePass(computePass);
+}
+
+void Meshlets_Draw(MeshletCuller *culler, SDL_GPURenderPass *renderPass, Uint32 view, Uint32 slot)
+{
+    if (slot >= culler->objectCount || view >= culler->viewCount) return;
+
+    SDL_GPUBufferBinding indexBinding = { .buffer = culler->viewIndices[view], .offset = 0 };
+    SDL_BindGPUIndexBuffer(renderPass, &indexBinding, SDL_GPU_INDEXELEMENTSIZE_32BIT);
+    SDL_DrawGPUIndexedPrimitivesIndirect(renderPass, culler->viewCommands[view],
+                                         slot * (Uint32)sizeof(SDL_GPUIndexedIndirectDrawCommand), 1);
+}
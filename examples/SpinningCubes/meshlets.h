@@ -0,0 +1,84 @@
+/*
+ * Meshlet cluster culling
+ *
+ * Large meshes are split into meshlets of at most MESHLET_MAX_VERTICES
+ * vertices and MESHLET_MAX_TRIANGLES triangles, each with a bounding sphere
+ * and a normal cone. Before each view is drawn, a compute pass culls every
+ * meshlet of every clustered object against that view - outside the
+ * frustum, or (for single-sided materials) facing entirely away from the
+ * eye - and appends the surviving triangles to a per-view index buffer.
+ * Each object is then one indexed indirect draw whose index count the
+ * compute pass wrote, so the CPU never learns, or waits for, the result.
+ *
+ * Object-level culling keeps or rejects a whole mesh; this rejects the back
+ * half of a large sphere and whatever part of it is off screen. The draws
+ * read buffers written on the GPU, so they are not part of command stream
+ * captures, and the triangle counts in the frame stats leave them out.
+ */
+
+#ifndef MESHLETS_H
+#define MESHLETS_H
+
+#include <SDL3/SDL.h>
+
+#include "vecmath.h"
+
+#define MESHLET_MAX_VERTICES 64
+#define MESHLET_MAX_TRIANGLES 124
+#define MESHLET_MIN_TRIANGLES 4096     /* Smaller meshes are cheaper to draw whole */
+
+/* The layout MeshletCull.comp.hlsl reads */
+typedef struct Meshlet {
+    float center[3];
+    float radius;
+    float coneApex[3];
+    float coneCutoff;           /* Culled when dot(normalize(apex - eye), axis) >= cutoff; above 1 never is */
+    float coneAxis[3];
+    float padding;
+    Uint32 firstIndex;          /* Into the mesh's index list */
+    Uint32 triangleCount;
+    Uint32 vertexCount;
+    Uint32 padding2;
+} Meshlet;
+
+typedef struct MeshletMesh {
+    Meshlet *meshlets;
+    Uint32 meshletCount;
+    const Uint32 *indices;      /* The mesh's own; meshlets are runs of its triangles */
+    Uint32 indexCount;
+} MeshletMesh;
+
+/* Splits a mesh in index order. Meshes below MESHLET_MIN_TRIANGLES get no
+ * meshlets; false only when out of memory. */
+bool Meshlets_Build(const PositionColorVertex *vertices, Uint32 vertexCount, const Uint32 *indices, Uint32 indexCount,
+                    MeshletMesh *mesh);
+void Meshlets_Free(MeshletMesh *mesh);
+
+typedef struct MeshletCuller MeshletCuller;
+
+typedef struct MeshletObject {
+    Mat4 model;
+    Uint32 mesh;
+    bool doubleSided;           /* No cone culling */
+} MeshletObject;
+
+/* Uploads the meshlets of every mesh that has them. Per frame, up to
+ * maxObjects objects with up to maxIndices indices between them are culled
+ * for viewCount views. */
+MeshletCuller *Meshlets_CreateCuller(SDL_GPUDevice *device, const MeshletMesh *meshes, Uint32 meshCount,
+                                     Uint32 viewCount, Uint32 maxObjects, Uint32 maxIndices);
+void Meshlets_DestroyCuller(MeshletCuller *culler);
+
+/* Once per frame, outside any pass: the objects to cull, which become draw
+ * slots 0.. in order. Returns how many fit; the rest must be drawn whole. */
+Uint32 Meshlets_BeginFrame(MeshletCuller *culler, SDL_GPUCommandBuffer *cmdBuf, const MeshletObject *objects,
+                           Uint32 count);
+
+/* Per view, outside any pass: culls this frame's objects against the view */
+void Meshlets_Cull(MeshletCuller *culler, SDL_GPUCommandBuffer *cmdBuf, Uint32 view, const Mat4 *viewProj, Vec3 eye);
+
+/* In the view's render pass, with the object's pipeline, vertex buffer and
+ * uniforms bound: draws what survived of slot. Binds its own index buffer. */
+void Meshlets_Draw(MeshletCuller *culler, SDL_GPURenderPass *renderPass, Uint32 view, Uint32 slot);
+
+#endif /* MESHLETS_H */
@@ -0,0 +1,610 @@
+/*
+ * Microbenchmarks for the CPU-side math and renderer kernels
+ *
+ * Times the pure CPU pieces of a frame in isolation - the vecmath.h matrix
+ * helpers, the scene transform update, frustum culling, draw key sorting and
+ * instance encoding - over a batch of generated inputs, for the scalar code
+ * and every SIMD kernel table this CPU supports. Each kernel is calibrated to
+ * run for at least --min-time-ms per repetition; the median and minimum of
+ * the repetitions are reported in ns/op and millions of ops per second.
+ *
+ * With --baseline the run is compared against an earlier report, kernel by
+ * kernel, and exits with 1 when one regressed. A missing baseline exits with
+ * MICROBENCH_EXIT_SKIPPED instead, unless --record writes it from this run.
+ */
+
+#include <SDL3/SDL.h>
+
+#include "kernels.h"
+#include "scenes.h"
+#include "vecmath.h"
+
+typedef struct {
+    const char *name;
+    const char *variant;
+    void (*run)(void);
+    const KernelTable *kernels; /* The table run calls through, NULL for fixed code */
+    Uint32 opsPerCall;          /* Filled in by SetupInputs for batch kernels */
+} Microbench;
+
+#define MAX_BENCHES 48          /* Fixed kernels plus four per kernel table */
+
+#define MICROBENCH_EXIT_SKIPPED 77  /* No baseline to compare against; CTest's SKIP_RETURN_CODE */
+
+typedef struct {
+    double medianNs;            /* Per op */
+    double minNs;
+} MicrobenchResult;
+
+/* Options */
+static Uint32 batchCount = 4096;
+static Uint32 repetitions = 11;
+static double minTimeMs = 10.0;
+static const char *filter = NULL;
+static const char *outputPath = NULL;
+static const char *baselinePath = NULL;
+static bool recordBaseline = false;
+static const char *label = NULL;
+static double thresholdPercent = 15.0;
+
+/* Inputs and outputs, batchCount of each */
+static Mat4 *matrices = NULL;
+static Mat4 *results = NULL;
+static XrPosef *poses = NULL;
+static XrFovf *fovs = NULL;
+static Sphere *spheres = NULL;
+static Uint8 *visible = NULL;
+static Uint64 *unsortedKeys = NULL;
+static Uint64 *keys = NULL;
+static Uint64 *scratch = NULL;
+static InstanceData *instances = NULL;
+static Scene *scene = NULL;
+static Mat4 viewProj;
+static Frustum frustum;
+static float sceneTime = 0.0f;
+static const KernelTable *benchKernels = NULL;
+
+/* Results are folded in here so the compiler cannot drop the work */
+static volatile float sink;
+
+/* ========================================================================
+ * Kernels
+ * ======================================================================== */
+
+static void RunMultiplyScalar(void)
+{
+    for (Uint32 i = 0; i < batchCount; i++) {
+        results[i] = Mat4_Multiply(matrices[i], matrices[(i + 1) % batchCount]);
+    }
+    sink += results[batchCount - 1].m[0];
+}
+
+static void RunMultiplyTable(void)
+{
+    for (Uint32 i = 0; i < batchCount; i++) {
+        benchKernels->multiplyMat4(&matrices[i], &matrices[(i + 1) % batchCount], &results[i]);
+    }
+    sink += results[batchCount - 1].m[0];
+}
+
+static void RunFromXrPose(void)
+{
+    for (Uint32 i = 0; i < batchCount; i++) {
+        results[i] = Mat4_FromXrPose(poses[i]);
+    }
+    sink += results[batchCount - 1].m[12];
+}
+
+static void RunProjection(void)
+{
+    for (Uint32 i = 0; i < batchCount; i++) {
+        results[i] = Mat4_Projection(fovs[i], 0.05f, 100.0f);
+    }
+    sink += results[batchCount - 1].m[8];
+}
+
+static void RunTransformScalar(void)
+{
+    Kernels_TransformBatchScalar(matrices, &viewProj, results, batchCount);
+    sink += results[batchCount - 1].m[0];
+}
+
+static void RunTransformTable(void)
+{
+    benchKernels->transformBatch(matrices, &viewProj, results, batchCount);
+    sink += results[batchCount - 1].m[0];
+}
+
+static void RunSceneUpdate(void)
+{
+    sceneTime += 0.011f;
+    Scene_Update(scene, sceneTime);
+    sink += scene->objects[scene->objectCount - 1].center.x;
+}
+
+static void RunSphereInFrustum(void)
+{
+    Uint32 count = 0;
+    for (Uint32 i = 0; i < batchCount; i++) {
+        Vec3 center = { spheres[i].x, spheres[i].y, spheres[i].z };
+        count += SphereInFrustum(&viewProj, center, spheres[i].radius);
+    }
+    sink += (float)count;
+}
+
+static void RunCullScalar(void)
+{
+    sink += (float)Kernels_CullSpheresScalar(&frustum, spheres, visible, batchCount);
+}
+
+static void RunCullTable(void)
+{
+    sink += (float)benchKernels->cullSpheres(&frustum, spheres, visible, batchCount);
+}
+
+static void RunSortRadix(void)
+{
+    SDL_memcpy(keys, unsortedKeys, batchCount * sizeof(Uint64));
+    Kernels_SortKeys(keys, scratch, batchCount);
+    sink += (float)(keys[0] & 0xff);
+}
+
+static int SDLCALL CompareKeys(const void *a, const void *b)
+{
+    Uint64 x = *(const Uint64 *)a, y = *(const Uint64 *)b;
+    return (x > y) - (x < y);
+}
+
+static void RunSortQsort(void)
+{
+    SDL_memcpy(keys, unsortedKeys, batchCount * sizeof(Uint64));
+    SDL_qsort(keys, batchCount, sizeof(Uint64), CompareKeys);
+    sink += (float)(keys[0] & 0xff);
+}
+
+static void RunEncodeScalar(void)
+{
+    Kernels_EncodeInstancesScalar(matrices, instances, batchCount);
+    sink += instances[batchCount - 1].rows[0][3];
+}
+
+static void RunEncodeTable(void)
+{
+    benchKernels->encodeInstances(matrices, instances, batchCount);
+    sink += instances[batchCount - 1].rows[0][3];
+}
+
+static Microbench benches[MAX_BENCHES];
+static Uint32 benchCount = 0;
+
+/* SIMD variants are named after their table */
+static void AddBench(const char *name, const char *variant, void (*run)(void), const KernelTable *kernels)
+{
+    benches[benchCount++] = (Microbench){ name, variant, run, kernels };
+}
+
+static void AddTableBenches(const char *name, void (*run)(void), const KernelTable *const *tables, Uint32 tableCount)
+{
+    for (Uint32 t = 0; t < tableCount; t++) {
+        if (SDL_strcmp(tables[t]->name, "scalar") != 0) AddBench(name, tables[t]->name, run, tables[t]);
+    }
+}
+
+static void SetupBenches(void)
+{
+    const KernelTable *tables[8];
+    Uint32 tableCount = Kernels_SupportedTables(tables, SDL_arraysize(tables));
+
+    AddBench("mat4_multiply", "scalar", RunMultiplyScalar, NULL);
+    AddTableBenches("mat4_multiply", RunMultiplyTable, tables, tableCount);
+    AddBench("mat4_from_xr_pose", "scalar", RunFromXrPose, NULL);
+    AddBench("mat4_projection", "scalar", RunProjection, NULL);
+    AddBench("transform_batch", "scalar", RunTransformScalar, NULL);
+    AddTableBenches("transform_batch", RunTransformTable, tables, tableCount);
+    AddBench("scene_update", "scalar", RunSceneUpdate, NULL);
+    AddBench("sphere_in_frustum", "scalar", RunSphereInFrustum, NULL);
+    AddBench("cull_spheres", "scalar", RunCullScalar, NULL);
+    AddTableBenches("cull_spheres", RunCullTable, tables, tableCount);
+    AddBench("sort_keys", "radix", RunSortRadix, NULL);
+    AddBench("sort_keys", "qsort", RunSortQsort, NULL);
+    AddBench("encode_instances", "scalar", RunEncodeScalar, NULL);
+    AddTableBenches("encode_instances", RunEncodeTable, tables, tableCount);
+}
+
+/* ========================================================================
+ * Inputs
+ * ======================================================================== */
+
+static Uint32 randomState = 12345;
+
+static float RandomFloat(float lo, float hi)
+{
+    randomState = randomState * 1664525u + 1013904223u;
+    return lo + (hi - lo) * (float)(randomState >> 8) / (float)(1u << 24);
+}
+
+static bool SetupInputs(void)
+{
+    matrices = SDL_calloc(batchCount, sizeof(Mat4));
+    results = SDL_calloc(batchCount, sizeof(Mat4));
+    poses = SDL_calloc(batchCount, sizeof(XrPosef));
+    fovs = SDL_calloc(batchCount, sizeof(XrFovf));
+    spheres = SDL_calloc(batchCount, sizeof(Sphere));
+    visible = SDL_calloc(batchCount, sizeof(Uint8));
+    unsortedKeys = SDL_calloc(batchCount, sizeof(Uint64));
+    keys = SDL_calloc(batchCount, sizeof(Uint64));
+    scratch = SDL_calloc(batchCount, sizeof(Uint64));
+    instances = SDL_calloc(batchCount, sizeof(InstanceData));
+    SceneConfig sceneConfig = { SCENE_MANY_SMALL_OBJECTS, batchCount };
+    scene = Scene_Create(&sceneConfig);
+    if (!matrices || !results || !poses || !fovs || !spheres || !visible || !unsortedKeys || !keys ||
+        !scratch || !instances || !scene) {
+        return false;
+    }
+
+    for (Uint32 i = 0; i < batchCount; i++) {
+        float angle = RandomFloat(-3.14159f, 3.14159f);
+        matrices[i] = Mat4_Multiply(Mat4_Multiply(Mat4_Scale(RandomFloat(0.1f, 1.0f)), Mat4_RotationY(angle)),
+                                    Mat4_Translation(RandomFloat(-5, 5), RandomFloat(-5, 5), RandomFloat(-10, 0)));
+
+        float half = angle * 0.5f;
+        poses[i].orientation = (XrQuaternionf){ 0.0f, SDL_sinf(half), 0.0f, SDL_cosf(half) };
+        poses[i].position = (XrVector3f){ RandomFloat(-1, 1), RandomFloat(1, 2), RandomFloat(-1, 1) };
+
+        fovs[i] = (XrFovf){ RandomFloat(-0.9f, -0.6f), RandomFloat(0.6f, 0.9f),
+                            RandomFloat(0.6f, 0.9f), RandomFloat(-0.9f, -0.6f) };
+
+        /* About half of the spheres end up outside the view */
+        spheres[i] = (Sphere){ RandomFloat(-8, 8), RandomFloat(-8, 8), RandomFloat(-12, 2), RandomFloat(0.05f, 0.5f) };
+
+        /* Sort keys as a renderer builds them: pass, material, depth, then the object index */
+        Uint64 material = (Uint64)(RandomFloat(0, 64));
+        Uint64 depth = (Uint64)(RandomFloat(0, 65535));
+        unsortedKeys[i] = ((Uint64)(i & 1) << 56) | (material << 48) | (depth << 32) | i;
+    }
+
+    XrPosef head = { { 0.0f, 0.0f, 0.0f, 1.0f }, { 0.0f, 1.6f, 0.0f } };
+    XrFovf fov = { -0.8f, 0.8f, 0.8f, -0.8f };
+    viewProj = Mat4_Multiply(Mat4_FromXrPose(head), Mat4_Projection(fov, 0.05f, 100.0f));
+    frustum = Frustum_FromViewProj(&viewProj);
+
+    for (Uint32 i = 0; i < benchCount; i++) {
+        benches[i].opsPerCall = batchCount;
+    }
+    return true;
+}
+
+static void FreeInputs(void)
+{
+    SDL_free(matrices);
+    SDL_free(results);
+    SDL_free(poses);
+    SDL_free(fovs);
+    SDL_free(spheres);
+    SDL_free(visible);
+    SDL_free(unsortedKeys);
+    SDL_free(keys);
+    SDL_free(scratch);
+    SDL_free(instances);
+    Scene_Destroy(scene);
+}
+
+static bool MatricesAgree(const Mat4 *expected, const Mat4 *actual, Uint32 count)
+{
+    for (Uint32 i = 0; i < count; i++) {
+        for (int j = 0; j < 16; j++) {
+            float tolerance = 1e-5f * SDL_max(1.0f, SDL_fabsf(expected[i].m[j]));
+            if (SDL_fabsf(expected[i].m[j] - actual[i].m[j]) > tolerance) return false;
+        }
+    }
+    return true;
+}
+
+/* The SIMD variants are only worth timing if they agree with the scalar code */
+static bool VerifyVariants(void)
+{
+    Mat4 *expected = SDL_calloc(batchCount, sizeof(Mat4));
+    Mat4 *expectedProducts = SDL_calloc(batchCount, sizeof(Mat4));
+    InstanceData *expectedInstances = SDL_calloc(batchCount, sizeof(InstanceData));
+    Uint8 *expectedVisible = SDL_calloc(batchCount, sizeof(Uint8));
+    bool ok = expected && expectedProducts && expectedInstances && expectedVisible;
+    Uint32 expectedCount = 0;
+
+    if (ok) {
+        Kernels_TransformBatchScalar(matrices, &viewProj, expected, batchCount);
+        for (Uint32 i = 0; i < batchCount; i++) {
+            expectedProducts[i] = Mat4_Multiply(matrices[i], matrices[(i + 1) % batchCount]);
+        }
+        expectedCount = Kernels_CullSpheresScalar(&frustum, spheres, expectedVisible, batchCount);
+        Kernels_EncodeInstancesScalar(matrices, expectedInstances, batchCount);
+    }
+
+    const KernelTable *tables[8];
+    Uint32 tableCount = ok ? Kernels_SupportedTables(tables, SDL_arraysize(tables)) : 0;
+    for (Uint32 t = 0; t < tableCount && ok; t++) {
+        const KernelTable *kernels = tables[t];
+        if (SDL_strcmp(kernels->name, "scalar") == 0) continue;
+
+        for (Uint32 i = 0; i < batchCount; i++) {
+            kernels->multiplyMat4(&matrices[i], &matrices[(i + 1) % batchCount], &results[i]);
+        }
+        ok = MatricesAgree(expectedProducts, results, batchCount);
+        if (!ok) {
+            SDL_Log("Microbench: %s mat4_multiply disagrees with scalar", kernels->name);
+            break;
+        }
+
+        kernels->transformBatch(matrices, &viewProj, results, batchCount);
+        ok = MatricesAgree(expected, results, batchCount);
+        if (!ok) {
+            SDL_Log("Microbench: %s transform_batch disagrees with scalar", kernels->name);
+            break;
+        }
+
+        ok = kernels->cullSpheres(&frustum, spheres, visible, batchCount) == expectedCount &&
+             SDL_memcmp(expectedVisible, visible, batchCount) == 0;
+        if (!ok) {
+            SDL_Log("Microbench: %s cull_spheres disagrees with scalar", kernels->name);
+            break;
+        }
+
+        kernels->encodeInstances(matrices, instances, batchCount);
+        ok = SDL_memcmp(expectedInstances, instances, batchCount * sizeof(InstanceData)) == 0;
+        if (!ok) {
+            SDL_Log("Microbench: %s encode_instances disagrees with scalar", kernels->name);
+        }
+    }
+    if (ok) {
+        SDL_memcpy(keys, unsortedKeys, batchCount * sizeof(Uint64));
+        Kernels_SortKeys(keys, scratch, batchCount);
+        for (Uint32 i = 1; i < batchCount && ok; i++) {
+            ok = keys[i - 1] <= keys[i];
+        }
+        if (!ok) SDL_Log("Microbench: radix sort_keys output is not sorted");
+    }
+
+    SDL_free(expected);
+    SDL_free(expectedProducts);
+    SDL_free(expectedInstances);
+    SDL_free(expectedVisible);
+    return ok;
+}
+
+/* ========================================================================
+ * Timing
+ * ======================================================================== */
+
+static int SDLCALL CompareDoubles(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static MicrobenchResult Measure(const Microbench *bench)
+{
+    benchKernels = bench->kernels;
+
+    /* Double the calls per repetition until one repetition takes minTimeMs */
+    Uint64 calls = 1;
+    for (;;) {
+        Uint64 start = SDL_GetTicksNS();
+        for (Uint64 c = 0; c < calls; c++) bench->run();
+        Uint64 elapsed = SDL_GetTicksNS() - start;
+        if ((double)elapsed >= minTimeMs * 1e6 || calls >= (1u << 30)) break;
+        calls *= 2;
+    }
+
+    double perOp[64];
+    Uint32 reps = SDL_clamp(repetitions, 1u, (Uint32)SDL_arraysize(perOp));
+    for (Uint32 r = 0; r < reps; r++) {
+        Uint64 start = SDL_GetTicksNS();
+        for (Uint64 c = 0; c < calls; c++) bench->run();
+        Uint64 elapsed = SDL_GetTicksNS() - start;
+        perOp[r] = (double)elapsed / ((double)calls * bench->opsPerCall);
+    }
+    SDL_qsort(perOp, reps, sizeof(double), CompareDoubles);
+
+    MicrobenchResult result = { perOp[reps / 2], perOp[0] };
+    return result;
+}
+
+/* ========================================================================
+ * Report and Baseline
+ * ======================================================================== */
+
+static void WriteRun(SDL_IOStream *io)
+{
+    SDL_IOprintf(io, "  \"run\": {\n    \"label\": \"%s\",\n    \"platform\": \"%s\",\n    \"simd\": \"%s\",\n"
+                 "    \"batch\": %u\n  },\n", label ? label : "", SDL_GetPlatform(), Kernels_SIMDName(), batchCount);
+}
+
+static bool WriteReport(const char *path, const MicrobenchResult *measured, const bool *ran)
+{
+    SDL_IOStream *io = SDL_IOFromFile(path, "w");
+    if (!io) {
+        SDL_Log("Microbench: failed to open %s: %s", path, SDL_GetError());
+        return false;
+    }
+
+    SDL_IOprintf(io, "{\n  \"format\": \"spinningcubes-microbench\",\n  \"version\": 1,\n");
+    WriteRun(io);
+    SDL_IOprintf(io, "  \"results\": {");
+    bool first = true;
+    for (Uint32 i = 0; i < benchCount; i++) {
+        if (!ran[i]) continue;
+        SDL_IOprintf(io, "%s\n    \"%s.%s\": { \"ns_per_op\": %.4f, \"min_ns_per_op\": %.4f, \"mops\": %.3f }",
+                     first ? "" : ",", benches[i].name, benches[i].variant, measured[i].medianNs,
+                     measured[i].minNs, 1000.0 / measured[i].medianNs);
+        first = false;
+    }
+    SDL_IOprintf(io, "\n  }\n}\n");
+
+    if (!SDL_CloseIO(io)) {
+        SDL_Log("Microbench: failed to write %s: %s", path, SDL_GetError());
+        return false;
+    }
+    return true;
+}
+
+/* Finds "key": inside the object that follows "object": */
+static const char *FindValue(const char *json, const char *object, const char *key)
+{
+    char pattern[96];
+    SDL_snprintf(pattern, sizeof(pattern), "\"%s\":", object);
+    json = SDL_strstr(json, pattern);
+    if (!json || !(json = SDL_strchr(json, '{'))) return NULL;
+    const char *end = SDL_strchr(json, '}');
+
+    SDL_snprintf(pattern, sizeof(pattern), "\"%s\":", key);
+    const char *value = SDL_strstr(json, pattern);
+    if (!value || value > end) return NULL;
+    value += SDL_strlen(pattern);
+    while (*value == ' ') value++;
+    return value;
+}
+
+static bool SameRunString(const char *json, const char *key, const char *expected)
+{
+    const char *value = FindValue(json, "run", key);
+    size_t length = SDL_strlen(expected);
+    return value && value[0] == '"' && SDL_strncmp(value + 1, expected, length) == 0 && value[length + 1] == '"';
+}
+
+/*
+ * A kernel regresses when both its median and its fastest repetition are
+ * more than the threshold slower than the baseline's, so scheduling noise in
+ * some of the repetitions does not fail the run.
+ */
+static bool CompareBaseline(const MicrobenchResult *measured, const bool *ran, bool *skipped)
+{
+    if (recordBaseline) {
+        SDL_Log("Microbench: recording baseline %s", baselinePath);
+        return WriteReport(baselinePath, measured, ran);
+    }
+
+    char *json = SDL_LoadFile(baselinePath, NULL);
+    if (!json) {
+        SDL_Log("Microbench: baseline %s not found, comparison skipped (record one with --record)", baselinePath);
+        *skipped = true;
+        return true;
+    }
+
+    const char *batch = FindValue(json, "run", "batch");
+    if (!SameRunString(json, "platform", SDL_GetPlatform()) || !SameRunString(json, "simd", Kernels_SIMDName()) ||
+        !batch || SDL_strtoul(batch, NULL, 10) != batchCount) {
+        SDL_Log("Microbench: baseline %s was recorded on a different platform, SIMD level or batch size", baselinePath);
+        SDL_free(json);
+        return false;
+    }
+
+    bool passed = true;
+    for (Uint32 i = 0; i < benchCount; i++) {
+        if (!ran[i]) continue;
+
+        char key[64];
+        SDL_snprintf(key, sizeof(key), "%s.%s", benches[i].name, benches[i].variant);
+        const char *median = FindValue(json, key, "ns_per_op");
+        const char *fastest = FindValue(json, key, "min_ns_per_op");
+        if (!median || !fastest) continue;
+
+        double base = SDL_strtod(median, NULL);
+        double baseMin = SDL_strtod(fastest, NULL);
+        double change = (measured[i].medianNs - base) / SDL_max(base, 1e-9);
+        double minChange = (measured[i].minNs - baseMin) / SDL_max(baseMin, 1e-9);
+        double limit = thresholdPercent / 100.0;
+        bool regressed = change > limit && minChange > limit;
+        SDL_Log("Microbench: %-28s %9.3f -> %9.3f ns/op (%+6.1f%%)%s", key, base, measured[i].medianNs,
+                change * 100.0, regressed ? "  REGRESSION" : "");
+        passed &= !regressed;
+    }
+    SDL_free(json);
+
+    SDL_Log("Microbench: baseline compare %s against %s", passed ? "passed" : "FAILED", baselinePath);
+    return passed;
+}
+
+/* ========================================================================
+ * Main
+ * ======================================================================== */
+
+/* Separate from SDL_max, which would evaluate argv[++i] twice */
+static int ParseInt(const char *text, int min)
+{
+    int value = SDL_atoi(text);
+    return SDL_max(min, value);
+}
+
+static double ParseDouble(const char *text, double min)
+{
+    double value = SDL_atof(text);
+    return SDL_max(min, value);
+}
+
+static void ParseArgs(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; i++) {
+        if (SDL_strcmp(argv[i], "--batch") == 0 && i + 1 < argc) {
+            batchCount = (Uint32)ParseInt(argv[++i], 4);
+        } else if (SDL_strcmp(argv[i], "--reps") == 0 && i + 1 < argc) {
+            repetitions = (Uint32)ParseInt(argv[++i], 1);
+        } else if (SDL_strcmp(argv[i], "--min-time-ms") == 0 && i + 1 < argc) {
+            minTimeMs = ParseDouble(argv[++i], 0.1);
+        } else if (SDL_strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else if (SDL_strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            outputPath = argv[++i];
+        } else if (SDL_strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+            baselinePath = argv[++i];
+        } else if (SDL_strcmp(argv[i], "--record") == 0) {
+            recordBaseline = true;
+        } else if (SDL_strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) {
+            thresholdPercent = ParseDouble(argv[++i], 0.0);
+        } else if (SDL_strcmp(argv[i], "--label") == 0 && i + 1 < argc) {
+            label = argv[++i];
+        } else {
+            SDL_Log("Ignoring unknown option: %s", argv[i]);
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    ParseArgs(argc, argv);
+
+    SetupBenches();
+    if (!SetupInputs()) {
+        SDL_Log("Microbench: out of memory for a batch of %u", batchCount);
+        FreeInputs();
+        return 1;
+    }
+    if (!VerifyVariants()) {
+        FreeInputs();
+        return 1;
+    }
+
+    SDL_Log("Microbench: batch %u, %u repetitions of at least %.1f ms, SIMD: %s",
+            batchCount, repetitions, minTimeMs, Kernels_SIMDName());
+
+    MicrobenchResult measured[SDL_arraysize(benches)];
+    bool ran[SDL_arraysize(benches)];
+    for (Uint32 i = 0; i < benchCount; i++) {
+        ran[i] = !filter || SDL_strstr(benches[i].name, filter);
+        if (!ran[i]) continue;
+
+        measured[i] = Measure(&benches[i]);
+        SDL_Log("Microbench: %-18s %-7s %9.3f ns/op (min %9.3f) %10.2f Mops/s", benches[i].name,
+                benches[i].variant, measured[i].medianNs, measured[i].minNs, 1000.0 / measured[i].medianNs);
+    }
+
+    bool passed = true, skipped = false;
+    if (outputPath) {
+        passed &= WriteReport(outputPath, measured, ran);
+    }
+    if (baselinePath) {
+        passed &= CompareBaseline(measured, ran, &skipped);
+    }
+
+    FreeInputs();
+    if (!passed) return 1;
+    return skipped ? MICROBENCH_EXIT_SKIPPED : 0;
+}
@@ -0,0 +1,233 @@
+/*
+ * Desktop mirror window - see mirror.h
+ */
+
+#include "mirror.h"
+
+#include "log.h"
+
+static SDL_GPUDevice *mirrorDevice = NULL;
+static SDL_Window *mirrorWindow = NULL;
+static MirrorMode mirrorMode = MIRROR_OFF;
+static Sint64 mirrorIntervalNs = 0;
+static Sint64 lastMirrorTimeNs = 0;
+
+/* Downscaled eyes, side by side in MIRROR_BOTH */
+static SDL_GPUTexture *stagingTexture = NULL;
+static SDL_GPUTextureFormat stagingFormat = SDL_GPU_TEXTUREFORMAT_INVALID;
+static Uint32 stagingEyeWidth = 0, stagingEyeHeight = 0;
+
+static bool mirrorThisFrame = false;
+static bool stagedThisFrame = false;
+
+MirrorMode Mirror_ParseMode(const char *name)
+{
+    if (SDL_strcmp(name, "left") == 0) return MIRROR_LEFT;
+    if (SDL_strcmp(name, "right") == 0) return MIRROR_RIGHT;
+    if (SDL_strcmp(name, "both") == 0) return MIRROR_BOTH;
+    SDL_Log("Unknown mirror mode '%s' (expected left, right or both)", name);
+    return MIRROR_OFF;
+}
+
+bool Mirror_Init(SDL_GPUDevice *device, MirrorMode mode, float rateHz, int width, int height)
+{
+    if (mode == MIRROR_OFF) return true;
+
+#ifdef SDL_PLATFORM_ANDROID
+    (void)device; (void)rateHz; (void)width; (void)height;
+    SDL_Log("Mirror window is not available on Android");
+    return true;
+#else
+    /* The mirror is the only window; closing it must not end the XR session */
+    SDL_SetHint(SDL_HINT_QUIT_ON_LAST_WINDOW_CLOSE, "0");
+    mirrorWindow = SDL_CreateWindow("SpinningCubes Mirror", width, height, SDL_WINDOW_RESIZABLE);
+    if (!mirrorWindow) {
+        SDL_Log("Failed to create mirror window: %s", SDL_GetError());
+        return false;
+    }
+
+    if (!SDL_ClaimWindowForGPUDevice(device, mirrorWindow)) {
+        SDL_Log("Failed to claim mirror window: %s", SDL_GetError());
+        SDL_DestroyWindow(mirrorWindow);
+        mirrorWindow = NULL;
+        return false;
+    }
+
+    /* Eye images are sRGB; a linear-composition swapchain keeps the blit from darkening them.
+     * Mailbox/immediate keep the present from ever pacing the XR frame loop. */
+    SDL_GPUSwapchainComposition composition = SDL_GPU_SWAPCHAINCOMPOSITION_SDR;
+    if (SDL_WindowSupportsGPUSwapchainComposition(device, mirrorWindow, SDL_GPU_SWAPCHAINCOMPOSITION_SDR_LINEAR)) {
+        composition = SDL_GPU_SWAPCHAINCOMPOSITION_SDR_LINEAR;
+    }
+    SDL_GPUPresentMode presentMode = SDL_GPU_PRESENTMODE_VSYNC;
+    if (SDL_WindowSupportsGPUPresentMode(device, mirrorWindow, SDL_GPU_PRESENTMODE_MAILBOX)) {
+        presentMode = SDL_GPU_PRESENTMODE_MAILBOX;
+    } else if (SDL_WindowSupportsGPUPresentMode(device, mirrorWindow, SDL_GPU_PRESENTMODE_IMMEDIATE)) {
+        presentMode = SDL_GPU_PRESENTMODE_IMMEDIATE;
+    }
+    SDL_SetGPUSwapchainParameters(device, mirrorWindow, composition, presentMode);
+
+    mirrorDevice = device;
+    mirrorMode = mode;
+    mirrorIntervalNs = rateHz > 0.0f ? (Sint64)(1000000000.0 / (double)rateHz) : 0;
+
+    SDL_Log("Mirror window %dx%d, %s eye%s at %.0f Hz", width, height,
+            mode == MIRROR_BOTH ? "both" : (mode == MIRROR_LEFT ? "left" : "right"),
+            mode == MIRROR_BOTH ? "s" : "", rateHz);
+    return true;
+#endif
+}
+
+void Mirror_Shutdown(void)
+{
+    if (stagingTexture) {
+        SDL_ReleaseGPUTexture(mirrorDevice, stagingTexture);
+        stagingTexture = NULL;
+    }
+    if (mirrorWindow) {
+        SDL_ReleaseWindowFromGPUDevice(mirrorDevice, mirrorWindow);
+        SDL_DestroyWindow(mirrorWindow);
+        mirrorWindow = NULL;
+    }
+    mirrorMode = MIRROR_OFF;
+    mirrorDevice = NULL;
+}
+
+bool Mirror_IsEnabled(void)
+{
+    return mirrorWindow != NULL;
+}
+
+void Mirror_SetTitle(const char *title)
+{
+    if (mirrorWindow) {
+        SDL_SetWindowTitle(mirrorWindow, title);
+    }
+}
+
+bool Mirror_BeginFrame(Sint64 displayTimeNs)
+{
+    mirrorThisFrame = false;
+    stagedThisFrame = false;
+    if (!mirrorWindow) return false;
+
+    /* Display times are quantized to the headset refresh, so allow 10% slack */
+    if (lastMirrorTimeNs != 0 && displayTimeNs - lastMirrorTimeNs < mirrorIntervalNs - mirrorIntervalNs / 10) {
+        return false;
+    }
+
+    lastMirrorTimeNs = displayTimeNs;
+    mirrorThisFrame = true;
+    return true;
+}
+
+static bool EnsureStaging(SDL_GPUTextureFormat format, Uint32 eyeWidth, Uint32 eyeHeight)
+{
+    int windowWidth = 0, windowHeight = 0;
+    SDL_GetWindowSizeInPixels(mirrorWindow, &windowWidth, &windowHeight);
+
+    /* Never stage more pixels than the window can show */
+    float scale = windowHeight > 0 ? SDL_min(1.0f, (float)windowHeight / (float)eyeHeight) : 1.0f;
+    Uint32 stagedWidth = SDL_max(1u, (Uint32)((float)eyeWidth * scale));
+    Uint32 stagedHeight = SDL_max(1u, (Uint32)((float)eyeHeight * scale));
+
+    if (stagingTexture && stagingFormat == format &&
+        stagingEyeWidth == stagedWidth && stagingEyeHeight == stagedHeight) {
+        return true;
+    }
+
+    if (stagingTexture) {
+        SDL_ReleaseGPUTexture(mirrorDevice, stagingTexture);
+    }
+
+    SDL_GPUTextureCreateInfo textureInfo = {
+        .type = SDL_GPU_TEXTURETYPE_2D,
+        .format = format,
+        .usage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET | SDL_GPU_TEXTUREUSAGE_SAMPLER,
+        .width = stagedWidth * (mirrorMode == MIRROR_BOTH ? 2 : 1),
+        .height = stagedHeight,
+        .layer_count_or_depth = 1,
+        .num_levels = 1
+    };
+    stagingTexture = SDL_CreateGPUTexture(mirrorDevice, &textureInfo);
+    if (!stagingTexture) {
+        Log_Write(LOG_ERROR, "Failed to create mirror staging texture: %s", SDL_GetError());
+        return false;
+    }
+
+    stagingFormat = format;
+    stagingEyeWidth = stagedWidth;
+    stagingEyeHeight = stagedHeight;
+    return true;
+}
+
+void Mirror_CopyView(SDL_GPUCommandBuffer *cmdBuf, Uint32 view, SDL_GPUTexture *eyeTexture,
+                     SDL_GPUTextureFormat format, Uint32 width, Uint32 height)
+{
+    if (!mirrorThisFrame) return;
+
+    Uint32 slot;
+    if (mirrorMode == MIRROR_BOTH && view < 2) {
+        slot = view;
+    } else if ((mirrorMode == MIRROR_LEFT && view == 0) || (mirrorMode == MIRROR_RIGHT && view == 1)) {
+        slot = 0;
+    } else {
+        return;
+    }
+
+    if (!EnsureStaging(format, width, height)) return;
+
+    /* Cycle on the first write of a frame so the previous present is never waited on */
+    SDL_GPUBlitInfo blit = {
+        .source = { .texture = eyeTexture, .w = width, .h = height },
+        .destination = {
+            .texture = stagingTexture,
+            .x = slot * stagingEyeWidth,
+            .w = stagingEyeWidth,
+            .h = stagingEyeHeight
+        },
+        .load_op = SDL_GPU_LOADOP_LOAD,
+        .filter = SDL_GPU_FILTER_LINEAR,
+        .cycle = !stagedThisFrame
+    };
+    SDL_BlitGPUTexture(cmdBuf, &blit);
+    stagedThisFrame = true;
+}
+
+void Mirror_Present(void)
+{
+    if (!stagedThisFrame) return;
+    stagedThisFrame = false;
+    mirrorThisFrame = false;
+
+    SDL_GPUCommandBuffer *cmdBuf = SDL_AcquireGPUCommandBuffer(mirrorDevice);
+    if (!cmdBuf) return;
+
+    SDL_GPUTexture *swapchainTexture = NULL;
+    Uint32 windowWidth = 0, windowHeight = 0;
+    if (SDL_AcquireGPUSwapchainTexture(cmdBuf, mirrorWindow, &swapchainTexture, &windowWidth, &windowHeight) &&
+        swapchainTexture) {
+        /* Letterbox the staged eyes into the window */
+        Uint32 stagedWidth = stagingEyeWidth * (mirrorMode == MIRROR_BOTH ? 2 : 1);
+        float scale = SDL_min((float)windowWidth / (float)stagedWidth, (float)windowHeight / (float)stagingEyeHeight);
+        Uint32 w = (Uint32)((float)stagedWidth * scale);
+        Uint32 h = (Uint32)((float)stagingEyeHeight * scale);
+
+        SDL_GPUBlitInfo blit = {
+            .source = { .texture = stagingTexture, .w = stagedWidth, .h = stagingEyeHeight },
+            .destination = {
+                .texture = swapchainTexture,
+                .x = (windowWidth - w) / 2,
+                .y = (windowHeight - h) / 2,
+                .w = w,
+                .h = h
+            },
+            .load_op = SDL_GPU_LOADOP_CLEAR,
+            .clear_color = { 0.0f, 0.0f, 0.0f, 1.0f },
+            .filter = SDL_GPU_FILTER_LINEAR
+        };
+        SDL_BlitGPUTexture(cmdBuf, &blit);
+    }
+
+    SDL_SubmitGPUCommandBuffer(cmdBuf);
+}
@@ -0,0 +1,46 @@
+/*
+ * Desktop mirror window
+ *
+ * Shows one eye, or both side by side, in a desktop window without ever
+ * re-rendering the scene. On mirror frames the already-rendered eye images
+ * are blitted (downscaled) into a staging texture from inside the eye
+ * command buffer; after xrEndFrame a separate command buffer blits the
+ * staging texture to the window swapchain. The window swapchain is never
+ * waited on: if no image is available the mirror frame is skipped.
+ */
+
+#ifndef MIRROR_H
+#define MIRROR_H
+
+#include <SDL3/SDL.h>
+
+typedef enum {
+    MIRROR_OFF,
+    MIRROR_LEFT,
+    MIRROR_RIGHT,
+    MIRROR_BOTH
+} MirrorMode;
+
+bool Mirror_Init(SDL_GPUDevice *device, MirrorMode mode, float rateHz, int width, int height);
+void Mirror_Shutdown(void);
+
+bool Mirror_IsEnabled(void);
+
+/* Decides whether this XR frame is mirrored, based on its display time */
+bool Mirror_BeginFrame(Sint64 displayTimeNs);
+
+/* Records a blit of an eye image into the staging texture; call before the
+ * image is released back to the runtime */
+void Mirror_CopyView(SDL_GPUCommandBuffer *cmdBuf, Uint32 view, SDL_GPUTexture *eyeTexture,
+                     SDL_GPUTextureFormat format, Uint32 width, Uint32 height);
+
+/* Presents the staged eyes in their own command buffer, if this frame was mirrored */
+void Mirror_Present(void);
+
+/* Replaces the window title, e.g. with a stats line; ignored without a window */
+void Mirror_SetTitle(const char *title);
+
+/* Parses "left", "right" or "both" */
+MirrorMode Mirror_ParseMode(const char *name);
+
+#endif /* MIRROR_H */
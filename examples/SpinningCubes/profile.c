@@ -0,0 +1,38 @@
+/*
+ * Runtime profiles - see profile.h
+ */
+
+#include "profile.h"
+
+static const RuntimeProfile profiles[PROFILE_COUNT] = {
+    { PROFILE_DEBUG, "debug", true, true, INSTRUMENT_FULL, LOG_DEBUG },
+    { PROFILE_PROFILE, "profile", false, true, INSTRUMENT_TIMING, LOG_INFO },
+    { PROFILE_RELEASE, "release", false, false, INSTRUMENT_NONE, LOG_WARN }
+};
+
+const RuntimeProfile *Profile_Get(ProfileKind kind)
+{
+    return &profiles[kind];
+}
+
+ProfileKind Profile_Default(void)
+{
+#if defined(SPINNING_CUBES_BENCH)
+    return PROFILE_PROFILE;
+#elif defined(NDEBUG)
+    return PROFILE_RELEASE;
+#else
+    return PROFILE_DEBUG;
+#endif
+}
+
+bool Profile_ParseKind(const char *name, ProfileKind *kind)
+{
+    for (int i = 0; i < PROFILE_COUNT; i++) {
+        if (SDL_strcmp(name, profiles[i].name) == 0) {
+            *kind = (ProfileKind)i;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,50 @@
+/*
+ * Runtime profiles
+ *
+ * One switch for everything that trades speed for diagnosability:
+ *
+ *   debug    GPU validation, debug labels, full instrumentation, debug logging
+ *   profile  no validation; debug labels and timing kept for captures
+ *   release  no validation, no labels, no instrumentation, warnings only
+ *
+ * Validation and labels are fixed when the GPU device is created, so the
+ * profile is chosen at launch (--profile) rather than switched at runtime.
+ */
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <SDL3/SDL.h>
+#include "log.h"
+
+typedef enum ProfileKind {
+    PROFILE_DEBUG,
+    PROFILE_PROFILE,
+    PROFILE_RELEASE,
+    PROFILE_COUNT
+} ProfileKind;
+
+typedef enum InstrumentLevel {
+    INSTRUMENT_NONE,        /* Only what was asked for explicitly (--stats, --startup-trace) */
+    INSTRUMENT_TIMING,      /* Startup timeline, frame stats in the window titles */
+    INSTRUMENT_FULL         /* Timing, plus the frame stats logged every second */
+} InstrumentLevel;
+
+typedef struct RuntimeProfile {
+    ProfileKind kind;
+    const char *name;
+    bool gpuValidation;     /* SDL_PROP_GPU_DEVICE_CREATE_DEBUGMODE_BOOLEAN */
+    bool debugLabels;       /* Resource names and command buffer debug groups */
+    InstrumentLevel instrumentation;
+    LogLevel logLevel;
+} RuntimeProfile;
+
+const RuntimeProfile *Profile_Get(ProfileKind kind);
+
+/* The profile a build starts in: profile for the benchmark build, release
+ * when built with NDEBUG, debug otherwise */
+ProfileKind Profile_Default(void);
+
+bool Profile_ParseKind(const char *name, ProfileKind *kind);
+
+#endif /* PROFILE_H */
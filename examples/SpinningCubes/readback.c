@@ -0,0 +1,246 @@
+/*
+ * Asynchronous GPU readback ring - see readback.h
+ */
+
+#include "readback.h"
+
+#include "log.h"
+
+typedef enum {
+    SLOT_FREE,
+    SLOT_RECORDED,  /* Download recorded, command buffer not yet submitted */
+    SLOT_IN_FLIGHT, /* Submitted, waiting on the fence */
+    SLOT_RETAINED   /* Mapped and handed to a consumer */
+} ReadbackSlotState;
+
+typedef struct {
+    SDL_GPUTransferBuffer *buffer;
+    Uint32 capacity;
+    ReadbackSlotState state;
+    SDL_GPUCommandBuffer *cmdBuf;
+    SDL_GPUFence *fence;        /* Shared by every slot of the same submission */
+    ReadbackImage image;
+    ReadbackCallback callback;
+    void *userdata;
+    SDL_AtomicInt released;
+} ReadbackSlot;
+
+struct ReadbackRing {
+    SDL_GPUDevice *device;
+    ReadbackSlot *slots;
+    Uint32 slotCount;
+    Uint32 nextSlot;
+    Uint64 dropped;
+};
+
+ReadbackRing *Readback_Create(SDL_GPUDevice *device, Uint32 slotCount)
+{
+    ReadbackRing *ring = SDL_calloc(1, sizeof(ReadbackRing));
+    if (!ring) return NULL;
+
+    ring->slots = SDL_calloc(slotCount, sizeof(ReadbackSlot));
+    if (!ring->slots) {
+        SDL_free(ring);
+        return NULL;
+    }
+    ring->device = device;
+    ring->slotCount = slotCount;
+
+    for (Uint32 i = 0; i < slotCount; i++) {
+        ring->slots[i].image.internal = &ring->slots[i];
+    }
+    return ring;
+}
+
+static void RecycleSlot(ReadbackRing *ring, ReadbackSlot *slot)
+{
+    if (slot->state == SLOT_RETAINED) {
+        SDL_UnmapGPUTransferBuffer(ring->device, slot->buffer);
+    }
+    slot->state = SLOT_FREE;
+    slot->cmdBuf = NULL;
+    slot->fence = NULL;
+    slot->callback = NULL;
+    slot->userdata = NULL;
+    SDL_SetAtomicInt(&slot->released, 0);
+}
+
+void Readback_Destroy(ReadbackRing *ring)
+{
+    if (!ring) return;
+
+    for (Uint32 i = 0; i < ring->slotCount; i++) {
+        ReadbackSlot *slot = &ring->slots[i];
+
+        /* In-flight downloads are discarded; their fence is released once */
+        if (slot->state == SLOT_IN_FLIGHT && slot->fence) {
+            SDL_GPUFence *fence = slot->fence;
+            SDL_WaitForGPUFences(ring->device, true, &fence, 1);
+            for (Uint32 j = i; j < ring->slotCount; j++) {
+                if (ring->slots[j].fence == fence) ring->slots[j].fence = NULL;
+            }
+            SDL_ReleaseGPUFence(ring->device, fence);
+        }
+        RecycleSlot(ring, slot);
+
+        if (slot->buffer) {
+            SDL_ReleaseGPUTransferBuffer(ring->device, slot->buffer);
+        }
+    }
+
+    if (ring->dropped > 0) {
+        SDL_Log("Readback ring dropped %llu requests (all slots busy)", (unsigned long long)ring->dropped);
+    }
+
+    SDL_free(ring->slots);
+    SDL_free(ring);
+}
+
+bool Readback_Request(ReadbackRing *ring, SDL_GPUCommandBuffer *cmdBuf,
+                      SDL_GPUTexture *texture, SDL_GPUTextureFormat format,
+                      Uint32 width, Uint32 height, Uint32 tag, Uint64 frameIndex,
+                      ReadbackCallback callback, void *userdata)
+{
+    ReadbackSlot *slot = NULL;
+    for (Uint32 n = 0; n < ring->slotCount; n++) {
+        ReadbackSlot *candidate = &ring->slots[(ring->nextSlot + n) % ring->slotCount];
+        if (candidate->state == SLOT_FREE) {
+            slot = candidate;
+            ring->nextSlot = (ring->nextSlot + n + 1) % ring->slotCount;
+            break;
+        }
+    }
+    if (!slot) {
+        ring->dropped++;
+        return false;
+    }
+
+    Uint32 pitch = width * SDL_GPUTextureFormatTexelBlockSize(format);
+    Uint32 size = pitch * height;
+
+    /* Slots grow to the largest image they have carried; steady state allocates nothing */
+    if (slot->capacity < size) {
+        if (slot->buffer) {
+            SDL_ReleaseGPUTransferBuffer(ring->device, slot->buffer);
+        }
+        SDL_GPUTransferBufferCreateInfo transferInfo = {
+            .usage = SDL_GPU_TRANSFERBUFFERUSAGE_DOWNLOAD,
+            .size = size
+        };
+        slot->buffer = SDL_CreateGPUTransferBuffer(ring->device, &transferInfo);
+        slot->capacity = slot->buffer ? size : 0;
+        if (!slot->buffer) {
+            SDL_Log("Failed to create readback buffer (%u bytes): %s", size, SDL_GetError());
+            ring->dropped++;
+            return false;
+        }
+    }
+
+    SDL_GPUCopyPass *copyPass = SDL_BeginGPUCopyPass(cmdBuf);
+    SDL_GPUTextureRegion src = {
+        .texture = texture,
+        .w = width,
+        .h = height,
+        .d = 1
+    };
+    SDL_GPUTextureTransferInfo dst = { .transfer_buffer = slot->buffer };
+    SDL_DownloadFromGPUTexture(copyPass, &src, &dst);
+    SDL_EndGPUCopyPass(copyPass);
+
+    slot->state = SLOT_RECORDED;
+    slot->cmdBuf = cmdBuf;
+    slot->callback = callback;
+    slot->userdata = userdata;
+    slot->image.pixels = NULL;
+    slot->image.width = width;
+    slot->image.height = height;
+    slot->image.pitch = pitch;
+    slot->image.format = format;
+    slot->image.tag = tag;
+    slot->image.frameIndex = frameIndex;
+    return true;
+}
+
+bool Readback_Submit(ReadbackRing *ring, SDL_GPUCommandBuffer *cmdBuf)
+{
+    bool recorded = false;
+    for (Uint32 i = 0; i < ring->slotCount; i++) {
+        if (ring->slots[i].state == SLOT_RECORDED && ring->slots[i].cmdBuf == cmdBuf) {
+            recorded = true;
+            break;
+        }
+    }
+
+    if (!recorded) {
+        return SDL_SubmitGPUCommandBuffer(cmdBuf);
+    }
+
+    SDL_GPUFence *fence = SDL_SubmitGPUCommandBufferAndAcquireFence(cmdBuf);
+    for (Uint32 i = 0; i < ring->slotCount; i++) {
+        ReadbackSlot *slot = &ring->slots[i];
+        if (slot->state != SLOT_RECORDED || slot->cmdBuf != cmdBuf) continue;
+
+        slot->cmdBuf = NULL;
+        if (fence) {
+            slot->state = SLOT_IN_FLIGHT;
+            slot->fence = fence;
+        } else {
+            RecycleSlot(ring, slot);
+        }
+    }
+
+    if (!fence) {
+        Log_Write(LOG_ERROR, "Failed to submit readback command buffer: %s", SDL_GetError());
+        return false;
+    }
+    return true;
+}
+
+static void DeliverSlot(ReadbackRing *ring, ReadbackSlot *slot)
+{
+    slot->fence = NULL;
+    slot->image.pixels = SDL_MapGPUTransferBuffer(ring->device, slot->buffer, false);
+    if (!slot->image.pixels) {
+        Log_Write(LOG_ERROR, "Failed to map readback buffer: %s", SDL_GetError());
+        RecycleSlot(ring, slot);
+        return;
+    }
+
+    slot->state = SLOT_RETAINED;
+    if (!slot->callback(slot->userdata, &slot->image)) {
+        RecycleSlot(ring, slot);
+    }
+}
+
+void Readback_Poll(ReadbackRing *ring)
+{
+    if (!ring) return;
+
+    for (Uint32 i = 0; i < ring->slotCount; i++) {
+        ReadbackSlot *slot = &ring->slots[i];
+
+        if (slot->state == SLOT_RETAINED && SDL_GetAtomicInt(&slot->released)) {
+            RecycleSlot(ring, slot);
+        } else if (slot->state == SLOT_IN_FLIGHT && SDL_QueryGPUFence(ring->device, slot->fence)) {
+            /* Deliver every slot filled by the same submission, then drop the fence */
+            SDL_GPUFence *fence = slot->fence;
+            for (Uint32 j = 0; j < ring->slotCount; j++) {
+                if (ring->slots[j].state == SLOT_IN_FLIGHT && ring->slots[j].fence == fence) {
+                    DeliverSlot(ring, &ring->slots[j]);
+                }
+            }
+            SDL_ReleaseGPUFence(ring->device, fence);
+        }
+    }
+}
+
+void Readback_Release(const ReadbackImage *image)
+{
+    ReadbackSlot *slot = (ReadbackSlot *)image->internal;
+    SDL_SetAtomicInt(&slot->released, 1);
+}
+
+Uint64 Readback_GetDroppedCount(const ReadbackRing *ring)
+{
+    return ring ? ring->dropped : 0;
+}
@@ -0,0 +1,56 @@
+/*
+ * Asynchronous GPU readback ring
+ *
+ * Texture downloads are recorded into the frame's own command buffer and
+ * land in a small set of rotating download transfer buffers. The CPU only
+ * touches a buffer after the fence of the submission that filled it has
+ * signaled, so requesting or consuming a readback never waits on the GPU.
+ * When every slot is busy a request is dropped instead of stalling.
+ */
+
+#ifndef READBACK_H
+#define READBACK_H
+
+#include <SDL3/SDL.h>
+
+typedef struct ReadbackRing ReadbackRing;
+
+/* A completed download; pixels stay mapped until the image is released */
+typedef struct ReadbackImage {
+    const Uint8 *pixels;
+    Uint32 width;
+    Uint32 height;
+    Uint32 pitch;
+    SDL_GPUTextureFormat format;
+    Uint32 tag;         /* Caller-defined, e.g. the view index */
+    Uint64 frameIndex;
+    void *internal;
+} ReadbackImage;
+
+/* Runs on the polling thread. Return true to keep the pixels mapped until
+ * Readback_Release() is called (from any thread), false to recycle the slot
+ * as soon as the callback returns. */
+typedef bool (*ReadbackCallback)(void *userdata, const ReadbackImage *image);
+
+ReadbackRing *Readback_Create(SDL_GPUDevice *device, Uint32 slotCount);
+void Readback_Destroy(ReadbackRing *ring);
+
+/* Records a download of the whole texture into cmdBuf (outside any pass).
+ * Returns false and counts a drop if no slot is free. */
+bool Readback_Request(ReadbackRing *ring, SDL_GPUCommandBuffer *cmdBuf,
+                      SDL_GPUTexture *texture, SDL_GPUTextureFormat format,
+                      Uint32 width, Uint32 height, Uint32 tag, Uint64 frameIndex,
+                      ReadbackCallback callback, void *userdata);
+
+/* Submits cmdBuf, acquiring a fence only if readbacks were recorded into it */
+bool Readback_Submit(ReadbackRing *ring, SDL_GPUCommandBuffer *cmdBuf);
+
+/* Delivers finished readbacks and recycles released slots; never waits */
+void Readback_Poll(ReadbackRing *ring);
+
+/* Hands a retained image back to the ring; safe to call from any thread */
+void Readback_Release(const ReadbackImage *image);
+
+Uint64 Readback_GetDroppedCount(const ReadbackRing *ring);
+
+#endif /* READBACK_H */
@@ -0,0 +1,191 @@
+/*
+ * Command stream replay
+ *
+ * Re-executes a frame captured with --stream-capture (cmdstream.h) into
+ * offscreen targets, headless and unpaced, and reports its CPU recording
+ * time and GPU time per frame. The capture's pipelines are rebuilt from
+ * this build's shaders (or SPINNING_CUBES_SHADER_DIR's), so shader changes
+ * can be measured against the exact frame that was captured.
+ */
+
+#include <SDL3/SDL.h>
+
+#include "cmdstream.h"
+#include "gputimer.h"
+
+#define MAX_FRAMES 4096
+#define FRAMES_IN_FLIGHT 2
+
+/* Options */
+static const char *capturePath = NULL;
+static Uint32 warmupFrames = 20;
+static Uint32 measureFrames = 200;
+static bool validation = false;
+static const char *outputPath = NULL;
+static const char *label = NULL;
+
+static SDL_GPUDevice *device = NULL;
+static CmdStreamReplay *replay = NULL;
+static GpuTimer *gpuTimer = NULL;
+
+static Uint64 cpuSamples[MAX_FRAMES];
+static Uint64 gpuSamples[MAX_FRAMES + FRAMES_IN_FLIGHT];
+static Uint32 cpuCount = 0, gpuCount = 0;
+static Uint32 drawsPerFrame = 0;
+
+/* ========================================================================
+ * Measurement
+ * ======================================================================== */
+
+static int SDLCALL CompareSamples(const void *a, const void *b)
+{
+    Uint64 x = *(const Uint64 *)a, y = *(const Uint64 *)b;
+    return (x > y) - (x < y);
+}
+
+/* samples must be sorted */
+static double PercentileMs(const Uint64 *samples, Uint32 count, double percentile)
+{
+    if (count == 0) return 0.0;
+    Uint32 index = SDL_min(count - 1, (Uint32)(percentile * (double)count));
+    return (double)samples[index] / 1e6;
+}
+
+static void ReadGpuTimes(Uint32 *gpuSeen)
+{
+    Uint64 samples[FRAMES_IN_FLIGHT];
+    Uint32 read;
+    while ((read = GpuTimer_Read(gpuTimer, samples, FRAMES_IN_FLIGHT)) > 0) {
+        for (Uint32 i = 0; i < read; i++, (*gpuSeen)++) {
+            if (*gpuSeen >= warmupFrames && gpuCount < SDL_arraysize(gpuSamples)) gpuSamples[gpuCount++] = samples[i];
+        }
+    }
+}
+
+static void Measure(void)
+{
+    Uint32 frames = SDL_min(measureFrames, (Uint32)MAX_FRAMES);
+    Uint32 gpuSeen = 0;
+
+    for (Uint32 frame = 0; frame < warmupFrames + frames; frame++) {
+        Uint64 start = SDL_GetTicksNS();
+        SDL_GPUCommandBuffer *cmdBuf = SDL_AcquireGPUCommandBuffer(device);
+        drawsPerFrame = CmdStream_Execute(replay, cmdBuf);
+        SDL_SubmitGPUCommandBuffer(cmdBuf);
+        if (frame >= warmupFrames) cpuSamples[cpuCount++] = SDL_GetTicksNS() - start;
+
+        GpuTimer_Wait(gpuTimer, FRAMES_IN_FLIGHT - 1);
+        GpuTimer_Mark(gpuTimer);
+        ReadGpuTimes(&gpuSeen);
+    }
+
+    GpuTimer_Wait(gpuTimer, 0);
+    ReadGpuTimes(&gpuSeen);
+
+    SDL_qsort(cpuSamples, cpuCount, sizeof(Uint64), CompareSamples);
+    SDL_qsort(gpuSamples, gpuCount, sizeof(Uint64), CompareSamples);
+}
+
+/* ========================================================================
+ * Report
+ * ======================================================================== */
+
+static bool WriteReport(void)
+{
+    SDL_IOStream *io = SDL_IOFromFile(outputPath, "w");
+    if (!io) {
+        SDL_Log("Replay: failed to open %s: %s", outputPath, SDL_GetError());
+        return false;
+    }
+
+    SDL_IOprintf(io, "{\n  \"format\": \"spinningcubes-replay\",\n  \"version\": 1,\n");
+    SDL_IOprintf(io, "  \"run\": {\n    \"label\": \"%s\",\n    \"platform\": \"%s\",\n    \"driver\": \"%s\",\n"
+                 "    \"capture\": \"%s\",\n    \"gpu_validation\": %d\n  },\n", label ? label : "", SDL_GetPlatform(),
+                 SDL_GetGPUDeviceDriver(device), capturePath, validation ? 1 : 0);
+    SDL_IOprintf(io, "  \"frame\": { \"passes\": %u, \"pipelines\": %u, \"draws\": %u, \"buffer_bytes\": %llu },\n",
+                 CmdStream_PassCount(replay), CmdStream_PipelineCount(replay), drawsPerFrame,
+                 (unsigned long long)CmdStream_BufferBytes(replay));
+    SDL_IOprintf(io, "  \"cpu\": { \"frames\": %u, \"p50_ms\": %.4f, \"p95_ms\": %.4f },\n", cpuCount,
+                 PercentileMs(cpuSamples, cpuCount, 0.5), PercentileMs(cpuSamples, cpuCount, 0.95));
+    SDL_IOprintf(io, "  \"gpu\": { \"frames\": %u, \"p50_ms\": %.4f, \"p95_ms\": %.4f }\n}\n", gpuCount,
+                 PercentileMs(gpuSamples, gpuCount, 0.5), PercentileMs(gpuSamples, gpuCount, 0.95));
+
+    if (!SDL_CloseIO(io)) {
+        SDL_Log("Replay: failed to write %s: %s", outputPath, SDL_GetError());
+        return false;
+    }
+    SDL_Log("Replay: report written to %s", outputPath);
+    return true;
+}
+
+/* ========================================================================
+ * Main
+ * ======================================================================== */
+
+static int ParseInt(const char *text, int min)
+{
+    int value = SDL_atoi(text);
+    return SDL_max(min, value);
+}
+
+static void ParseArgs(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; i++) {
+        if (SDL_strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            measureFrames = (Uint32)ParseInt(argv[++i], 1);
+        } else if (SDL_strcmp(argv[i], "--warmup") == 0 && i + 1 < argc) {
+            warmupFrames = (Uint32)ParseInt(argv[++i], 0);
+        } else if (SDL_strcmp(argv[i], "--validation") == 0) {
+            validation = true;
+        } else if (SDL_strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            outputPath = argv[++i];
+        } else if (SDL_strcmp(argv[i], "--label") == 0 && i + 1 < argc) {
+            label = argv[++i];
+        } else if (argv[i][0] != '-' && !capturePath) {
+            capturePath = argv[i];
+        } else {
+            SDL_Log("Ignoring unknown option: %s", argv[i]);
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    ParseArgs(argc, argv);
+    if (!capturePath) {
+        SDL_Log("Usage: %s CAPTURE [--frames N] [--warmup N] [--validation] [--out FILE.json] [--label TEXT]", argv[0]);
+        return 1;
+    }
+
+    if (!SDL_Init(SDL_INIT_VIDEO)) {
+        SDL_Log("Replay: SDL_Init failed: %s", SDL_GetError());
+        return 1;
+    }
+    device = SDL_CreateGPUDevice(SDL_GPU_SHADERFORMAT_SPIRV, validation, NULL);
+    if (!device) {
+        SDL_Log("Replay: failed to create GPU device: %s", SDL_GetError());
+        SDL_Quit();
+        return 1;
+    }
+    replay = CmdStream_Load(device, capturePath);
+    gpuTimer = GpuTimer_Create(device, FRAMES_IN_FLIGHT);
+
+    bool ok = replay && gpuTimer;
+    if (ok) {
+        SDL_Log("Replay: %s, %u warmup + %u frames%s", SDL_GetGPUDeviceDriver(device), warmupFrames,
+                SDL_min(measureFrames, (Uint32)MAX_FRAMES), validation ? " with GPU validation" : "");
+        Measure();
+        SDL_Log("Replay: %u passes, %u draws per frame", CmdStream_PassCount(replay), drawsPerFrame);
+        SDL_Log("Replay: cpu p50 %.3f ms, p95 %.3f ms", PercentileMs(cpuSamples, cpuCount, 0.5),
+                PercentileMs(cpuSamples, cpuCount, 0.95));
+        SDL_Log("Replay: gpu p50 %.3f ms, p95 %.3f ms", PercentileMs(gpuSamples, gpuCount, 0.5),
+                PercentileMs(gpuSamples, gpuCount, 0.95));
+        ok = !outputPath || WriteReport();
+    }
+
+    if (gpuTimer) GpuTimer_Destroy(gpuTimer);
+    CmdStream_Free(replay);
+    SDL_DestroyGPUDevice(device);
+    SDL_Quit();
+    return ok ? 0 : 1;
+}
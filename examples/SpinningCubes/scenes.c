@@ -0,0 +1,521 @@
+/*
+ * Benchmark scene library - see scenes.h
+ */
+
+#include "scenes.h"
+
+#include "snapshot.h"
+
+#define CUBE_HALF_SIZE 0.25f
+#define SPHERE_RADIUS 0.5f
+
+#define SNAPSHOT_MAGIC 0x50414E53u     /* "SNAP" */
+#define SNAPSHOT_VERSION 1              /* Bump whenever Scene_Create builds something different */
+#define SNAPSHOT_ALIGN 16
+
+struct SceneNode {
+    Vec3 position;      /* World position for roots, offset from the parent otherwise */
+    float scale;
+    float speed;
+    float phase;
+    Sint32 parent;      /* Index of an earlier node, or -1 */
+    Mat4 world;         /* Unscaled, so children don't inherit the parent's size */
+};
+
+static const char *const sceneNames[SCENE_KIND_COUNT] = {
+    "many-small-objects",
+    "few-large-overdraw",
+    "vertex-heavy",
+    "many-materials",
+    "deep-hierarchy"
+};
+
+/* Deterministic, so every run of a scene places its objects identically */
+static float RandomFloat(Uint32 *state, float lo, float hi)
+{
+    *state = *state * 1664525u + 1013904223u;
+    return lo + (hi - lo) * (float)(*state >> 8) / (float)(1u << 24);
+}
+
+/* ========================================================================
+ * Meshes
+ * ======================================================================== */
+
+static bool AllocMesh(SceneMesh *mesh, Uint32 vertexCount, Uint32 indexCount)
+{
+    mesh->vertices = SDL_malloc(vertexCount * sizeof(PositionColorVertex));
+    mesh->indices = SDL_malloc(indexCount * sizeof(Uint32));
+    mesh->vertexCount = vertexCount;
+    mesh->indexCount = indexCount;
+    return mesh->vertices && mesh->indices;
+}
+
+/* Same cube as the default scene: each face a different color */
+static bool BuildCube(SceneMesh *mesh)
+{
+    static const float corners[6][4][3] = {
+        { {-1,-1,-1}, { 1,-1,-1}, { 1, 1,-1}, {-1, 1,-1} },    /* Front */
+        { { 1,-1, 1}, {-1,-1, 1}, {-1, 1, 1}, { 1, 1, 1} },    /* Back */
+        { {-1,-1, 1}, {-1,-1,-1}, {-1, 1,-1}, {-1, 1, 1} },    /* Left */
+        { { 1,-1,-1}, { 1,-1, 1}, { 1, 1, 1}, { 1, 1,-1} },    /* Right */
+        { {-1, 1,-1}, { 1, 1,-1}, { 1, 1, 1}, {-1, 1, 1} },    /* Top */
+        { {-1,-1, 1}, { 1,-1, 1}, { 1,-1,-1}, {-1,-1,-1} }     /* Bottom */
+    };
+    static const Uint8 colors[6][3] = {
+        {255,0,0}, {0,255,0}, {0,0,255}, {255,255,0}, {255,0,255}, {0,255,255}
+    };
+
+    if (!AllocMesh(mesh, 24, 36)) return false;
+
+    for (Uint32 face = 0; face < 6; face++) {
+        for (Uint32 corner = 0; corner < 4; corner++) {
+            mesh->vertices[face * 4 + corner] = (PositionColorVertex){
+                corners[face][corner][0] * CUBE_HALF_SIZE,
+                corners[face][corner][1] * CUBE_HALF_SIZE,
+                corners[face][corner][2] * CUBE_HALF_SIZE,
+                colors[face][0], colors[face][1], colors[face][2], 255
+            };
+        }
+        Uint32 *index = &mesh->indices[face * 6];
+        Uint32 base = face * 4;
+        index[0] = base; index[1] = base + 1; index[2] = base + 2;
+        index[3] = base; index[4] = base + 2; index[5] = base + 3;
+    }
+    mesh->boundRadius = CUBE_HALF_SIZE * 1.7320508f;
+    return true;
+}
+
+/* UV sphere with rings x 2*rings quads, colored by its normal */
+static bool BuildSphere(SceneMesh *mesh, Uint32 rings)
+{
+    Uint32 segments = rings * 2;
+    Uint32 columns = segments + 1;
+    if (!AllocMesh(mesh, (rings + 1) * columns, rings * segments * 6)) return false;
+
+    for (Uint32 ring = 0; ring <= rings; ring++) {
+        float theta = SDL_PI_F * (float)ring / (float)rings;
+        for (Uint32 segment = 0; segment <= segments; segment++) {
+            float phi = 2.0f * SDL_PI_F * (float)segment / (float)segments;
+            float nx = SDL_sinf(theta) * SDL_cosf(phi);
+            float ny = SDL_cosf(theta);
+            float nz = SDL_sinf(theta) * SDL_sinf(phi);
+            mesh->vertices[ring * columns + segment] = (PositionColorVertex){
+                nx * SPHERE_RADIUS, ny * SPHERE_RADIUS, nz * SPHERE_RADIUS,
+                (Uint8)((nx * 0.5f + 0.5f) * 255.0f),
+                (Uint8)((ny * 0.5f + 0.5f) * 255.0f),
+                (Uint8)((nz * 0.5f + 0.5f) * 255.0f),
+                255
+            };
+        }
+    }
+
+    /* Same winding as the cube faces */
+    Uint32 *index = mesh->indices;
+    for (Uint32 ring = 0; ring < rings; ring++) {
+        for (Uint32 segment = 0; segment < segments; segment++) {
+            Uint32 a = ring * columns + segment;
+            Uint32 b = a + columns;
+            *index++ = a; *index++ = b; *index++ = b + 1;
+            *index++ = a; *index++ = b + 1; *index++ = a + 1;
+        }
+    }
+    mesh->boundRadius = SPHERE_RADIUS;
+    return true;
+}
+
+/* ========================================================================
+ * Scene Layouts
+ * ======================================================================== */
+
+static void SetMaterial(SceneMaterial *material, float r, float g, float b, float a, bool blend, bool doubleSided)
+{
+    *material = (SceneMaterial){ { r, g, b, a }, blend, doubleSided };
+}
+
+/* Spinning objects scattered through the volume in front of the viewer */
+static void ScatterObjects(Scene *scene, float minScale, float maxScale)
+{
+    Uint32 seed = 12345;
+    for (Uint32 i = 0; i < scene->objectCount; i++) {
+        SceneNode *node = &scene->nodes[i];
+        node->position.x = RandomFloat(&seed, -3.0f, 3.0f);
+        node->position.y = RandomFloat(&seed, -1.5f, 1.5f);
+        node->position.z = RandomFloat(&seed, -8.0f, -1.5f);
+        node->scale = RandomFloat(&seed, minScale, maxScale);
+        node->speed = RandomFloat(&seed, -2.0f, 2.0f);
+        node->phase = RandomFloat(&seed, 0.0f, 6.2831853f);
+        node->parent = -1;
+        scene->objects[i].material = i % scene->materialCount;
+    }
+}
+
+/* Nested, nearly view-filling cubes; every one adds a full-screen blended layer */
+static void LayoutOverdraw(Scene *scene)
+{
+    for (Uint32 i = 0; i < scene->objectCount; i++) {
+        SceneNode *node = &scene->nodes[i];
+        node->position = (Vec3){ 0.0f, 0.0f, -2.0f - 0.25f * (float)i };
+        node->scale = 6.0f;
+        node->speed = (i % 2) ? 0.3f : -0.3f;
+        node->phase = (float)i;
+        node->parent = -1;
+    }
+}
+
+/* Spheres on a grid facing the viewer */
+static void LayoutGrid(Scene *scene)
+{
+    Uint32 columns = (Uint32)SDL_ceilf(SDL_sqrtf((float)scene->objectCount));
+    Uint32 rows = (scene->objectCount + columns - 1) / columns;
+    for (Uint32 i = 0; i < scene->objectCount; i++) {
+        SceneNode *node = &scene->nodes[i];
+        float column = (float)(i % columns) - (float)(columns - 1) * 0.5f;
+        float row = (float)(i / columns) - (float)(rows - 1) * 0.5f;
+        node->position = (Vec3){ column * 1.2f, row * 1.2f, -2.5f - 0.5f * (float)columns };
+        node->scale = 1.0f;
+        node->speed = 0.5f;
+        node->phase = (float)i;
+        node->parent = -1;
+    }
+}
+
+/* Chains rising from a row of roots; each link sways relative to the one below */
+static void LayoutChains(Scene *scene)
+{
+    Uint32 depth = scene->config.detail;
+    Uint32 chains = (scene->objectCount + depth - 1) / depth;
+    for (Uint32 i = 0; i < scene->objectCount; i++) {
+        SceneNode *node = &scene->nodes[i];
+        Uint32 chain = i / depth;
+        Uint32 link = i % depth;
+        if (link == 0) {
+            float x = ((float)chain - (float)(chains - 1) * 0.5f) * 0.3f;
+            node->position = (Vec3){ x, -1.2f, -3.0f - 0.5f * (float)(chain % 3) };
+            node->parent = -1;
+        } else {
+            node->position = (Vec3){ 0.0f, 2.0f / (float)depth, 0.0f };
+            node->parent = (Sint32)(i - 1);
+        }
+        node->scale = 0.12f;
+        node->speed = 0.5f + 0.1f * (float)(chain % 7);
+        node->phase = 0.3f * (float)link + (float)chain;
+    }
+}
+
+/* ========================================================================
+ * Snapshots
+ * ======================================================================== */
+
+typedef struct {
+    Uint32 magic;
+    Uint32 version;
+    Uint64 key;             /* SnapshotKey of the config it was built for */
+    Uint64 size;            /* Whole file, so truncated ones are rejected */
+    SceneConfig config;
+    Uint32 meshCount;
+    Uint32 materialCount;
+    Uint32 objectCount;
+} SnapshotHeader;
+
+typedef struct {
+    Uint64 verticesOffset;
+    Uint64 indicesOffset;
+    Uint32 vertexCount;
+    Uint32 indexCount;
+    float boundRadius;
+} SnapshotMesh;
+
+/* Section offsets; mesh data follows the nodes */
+typedef struct {
+    size_t meshes;
+    size_t materials;
+    size_t objects;
+    size_t nodes;
+    size_t meshData;
+} SnapshotLayout;
+
+static size_t AlignSnapshot(size_t offset)
+{
+    return (offset + SNAPSHOT_ALIGN - 1) & ~(size_t)(SNAPSHOT_ALIGN - 1);
+}
+
+static SnapshotLayout LayoutSnapshot(Uint32 meshCount, Uint32 materialCount, Uint32 objectCount)
+{
+    SnapshotLayout layout;
+    layout.meshes = AlignSnapshot(sizeof(SnapshotHeader));
+    layout.materials = AlignSnapshot(layout.meshes + meshCount * sizeof(SnapshotMesh));
+    layout.objects = AlignSnapshot(layout.materials + materialCount * sizeof(SceneMaterial));
+    layout.nodes = AlignSnapshot(layout.objects + objectCount * sizeof(SceneObject));
+    layout.meshData = AlignSnapshot(layout.nodes + objectCount * sizeof(SceneNode));
+    return layout;
+}
+
+/* The resolved config plus the size of every stored struct, so a snapshot
+ * from a build with a different layout is never misread */
+static Uint64 SnapshotKey(const SceneConfig *config)
+{
+    const Uint32 values[] = {
+        SNAPSHOT_VERSION, (Uint32)config->kind, config->objectCount, config->materialCount, config->detail,
+        (Uint32)sizeof(SnapshotHeader), (Uint32)sizeof(SnapshotMesh), (Uint32)sizeof(SceneMaterial),
+        (Uint32)sizeof(SceneObject), (Uint32)sizeof(SceneNode), (Uint32)sizeof(PositionColorVertex)
+    };
+    return Snapshot_Hash(SNAPSHOT_HASH_SEED, values, sizeof(values));
+}
+
+/* Fills in the defaults Scene_Create uses */
+static SceneConfig ResolveConfig(const SceneConfig *config)
+{
+    static const Uint32 defaultObjects[SCENE_KIND_COUNT] = { 2000, 8, 4, 1000, 1000 };
+
+    SceneConfig resolved = *config;
+    if (resolved.objectCount == 0) resolved.objectCount = defaultObjects[config->kind];
+    if (resolved.materialCount == 0) resolved.materialCount = 64;
+    if (resolved.detail == 0) resolved.detail = config->kind == SCENE_VERTEX_HEAVY ? 256 : 50;
+    return resolved;
+}
+
+static bool SectionFits(Uint64 offset, Uint64 count, size_t elementSize, size_t fileSize)
+{
+    return offset % SNAPSHOT_ALIGN == 0 && offset <= fileSize && count <= (fileSize - offset) / elementSize;
+}
+
+/* ========================================================================
+ * Public Interface
+ * ======================================================================== */
+
+Scene *Scene_Create(const SceneConfig *config)
+{
+    Scene *scene = SDL_calloc(1, sizeof(Scene));
+    if (!scene) return NULL;
+
+    scene->config = ResolveConfig(config);
+
+    scene->objectCount = scene->config.objectCount;
+    scene->materialCount = config->kind == SCENE_MANY_MATERIALS ? scene->config.materialCount : 1;
+    scene->meshCount = 1;
+
+    scene->meshes = SDL_calloc(scene->meshCount, sizeof(SceneMesh));
+    scene->materials = SDL_calloc(scene->materialCount, sizeof(SceneMaterial));
+    scene->objects = SDL_calloc(scene->objectCount, sizeof(SceneObject));
+    scene->nodes = SDL_calloc(scene->objectCount, sizeof(SceneNode));
+    if (!scene->meshes || !scene->materials || !scene->objects || !scene->nodes) {
+        Scene_Destroy(scene);
+        return NULL;
+    }
+
+    bool built = config->kind == SCENE_VERTEX_HEAVY
+        ? BuildSphere(&scene->meshes[0], scene->config.detail)
+        : BuildCube(&scene->meshes[0]);
+    if (!built) {
+        SDL_Log("Scene: out of memory building %s meshes", Scene_KindName(config->kind));
+        Scene_Destroy(scene);
+        return NULL;
+    }
+
+    SetMaterial(&scene->materials[0], 1.0f, 1.0f, 1.0f, 1.0f, false, false);
+
+    switch (config->kind) {
+        case SCENE_MANY_SMALL_OBJECTS:
+            ScatterObjects(scene, 0.1f, 0.25f);
+            break;
+        case SCENE_FEW_LARGE_OVERDRAW:
+            SetMaterial(&scene->materials[0], 1.0f, 1.0f, 1.0f, 0.2f, true, false);
+            LayoutOverdraw(scene);
+            break;
+        case SCENE_VERTEX_HEAVY:
+            LayoutGrid(scene);
+            break;
+        case SCENE_MANY_MATERIALS:
+            /* Every material differs in tint and most in pipeline state, and objects
+             * cycle through them so consecutive draws never share one */
+            for (Uint32 i = 0; i < scene->materialCount; i++) {
+                float hue = 6.0f * (float)i / (float)scene->materialCount;
+                float r = SDL_clamp(SDL_fabsf(hue - 3.0f) - 1.0f, 0.2f, 1.0f);
+                float g = SDL_clamp(2.0f - SDL_fabsf(hue - 2.0f), 0.2f, 1.0f);
+                float b = SDL_clamp(2.0f - SDL_fabsf(hue - 4.0f), 0.2f, 1.0f);
+                bool blend = (i % 4) == 3;
+                SetMaterial(&scene->materials[i], r, g, b, blend ? 0.6f : 1.0f, blend, (i % 3) == 2);
+            }
+            ScatterObjects(scene, 0.3f, 0.5f);
+            break;
+        case SCENE_DEEP_HIERARCHY:
+            LayoutChains(scene);
+            break;
+        default:
+            break;
+    }
+
+    for (Uint32 i = 0; i < scene->objectCount; i++) {
+        scene->objects[i].mesh = 0;
+        scene->objects[i].radius = scene->meshes[0].boundRadius * scene->nodes[i].scale;
+    }
+
+    Scene_Update(scene, 0.0f);
+    SDL_Log("Scene: %s, %u objects, %u materials, %u triangles per object",
+            Scene_KindName(config->kind), scene->objectCount, scene->materialCount,
+            scene->meshes[0].indexCount / 3);
+    return scene;
+}
+
+void Scene_Destroy(Scene *scene)
+{
+    if (!scene) return;
+
+    if (scene->meshes && !scene->snapshot) {
+        for (Uint32 i = 0; i < scene->meshCount; i++) {
+            SDL_free(scene->meshes[i].vertices);
+            SDL_free(scene->meshes[i].indices);
+        }
+    }
+    SDL_free(scene->meshes);
+    SDL_free(scene->materials);
+    SDL_free(scene->objects);
+    SDL_free(scene->nodes);
+    Snapshot_Unmap(scene->snapshot);
+    SDL_free(scene);
+}
+
+Scene *Scene_Restore(const SceneConfig *config, const char *path)
+{
+    SnapshotFile *snapshot = Snapshot_Map(path);
+    if (!snapshot) return NULL;
+
+    SceneConfig resolved = ResolveConfig(config);
+    const Uint8 *base = Snapshot_Data(snapshot);
+    size_t size = Snapshot_Size(snapshot);
+    const SnapshotHeader *header = (const SnapshotHeader *)base;
+    bool valid = size >= sizeof(SnapshotHeader) && header->magic == SNAPSHOT_MAGIC &&
+                 header->version == SNAPSHOT_VERSION && header->size == size && header->key == SnapshotKey(&resolved);
+
+    SnapshotLayout layout = { 0 };
+    if (valid) {
+        layout = LayoutSnapshot(header->meshCount, header->materialCount, header->objectCount);
+        valid = header->meshCount > 0 && header->objectCount == resolved.objectCount && layout.meshData <= size;
+    }
+    const SnapshotMesh *meshes = (const SnapshotMesh *)(base + layout.meshes);
+    for (Uint32 i = 0; valid && i < header->meshCount; i++) {
+        valid = SectionFits(meshes[i].verticesOffset, meshes[i].vertexCount, sizeof(PositionColorVertex), size) &&
+                SectionFits(meshes[i].indicesOffset, meshes[i].indexCount, sizeof(Uint32), size);
+    }
+    if (!valid) {
+        SDL_Log("Scene: snapshot %s is from another build or config; rebuilding", path);
+        Snapshot_Unmap(snapshot);
+        return NULL;
+    }
+
+    Scene *scene = SDL_calloc(1, sizeof(Scene));
+    if (!scene) {
+        Snapshot_Unmap(snapshot);
+        return NULL;
+    }
+    scene->snapshot = snapshot;
+    scene->config = resolved;
+    scene->meshCount = header->meshCount;
+    scene->materialCount = header->materialCount;
+    scene->objectCount = header->objectCount;
+
+    /* Meshes are used in place; everything Scene_Update writes is copied out */
+    scene->meshes = SDL_calloc(scene->meshCount, sizeof(SceneMesh));
+    scene->materials = SDL_malloc(scene->materialCount * sizeof(SceneMaterial));
+    scene->objects = SDL_malloc(scene->objectCount * sizeof(SceneObject));
+    scene->nodes = SDL_malloc(scene->objectCount * sizeof(SceneNode));
+    if (!scene->meshes || !scene->materials || !scene->objects || !scene->nodes) {
+        Scene_Destroy(scene);
+        return NULL;
+    }
+    for (Uint32 i = 0; i < scene->meshCount; i++) {
+        scene->meshes[i] = (SceneMesh){
+            (PositionColorVertex *)(base + meshes[i].verticesOffset), meshes[i].vertexCount,
+            (Uint32 *)(base + meshes[i].indicesOffset), meshes[i].indexCount, meshes[i].boundRadius
+        };
+    }
+    SDL_memcpy(scene->materials, base + layout.materials, scene->materialCount * sizeof(SceneMaterial));
+    SDL_memcpy(scene->objects, base + layout.objects, scene->objectCount * sizeof(SceneObject));
+    SDL_memcpy(scene->nodes, base + layout.nodes, scene->objectCount * sizeof(SceneNode));
+
+    Scene_Update(scene, 0.0f);
+    SDL_Log("Scene: %s restored from %s, %u objects, %u materials", Scene_KindName(resolved.kind), path,
+            scene->objectCount, scene->materialCount);
+    return scene;
+}
+
+bool Scene_WriteSnapshot(const Scene *scene, const char *path)
+{
+    SnapshotLayout layout = LayoutSnapshot(scene->meshCount, scene->materialCount, scene->objectCount);
+    size_t size = layout.meshData;
+    for (Uint32 i = 0; i < scene->meshCount; i++) {
+        size = AlignSnapshot(size + scene->meshes[i].vertexCount * sizeof(PositionColorVertex));
+        size = AlignSnapshot(size + scene->meshes[i].indexCount * sizeof(Uint32));
+    }
+
+    /* Zeroed, so padding is deterministic */
+    Uint8 *data = SDL_calloc(1, size);
+    if (!data) return false;
+
+    SnapshotHeader *header = (SnapshotHeader *)data;
+    *header = (SnapshotHeader){
+        SNAPSHOT_MAGIC, SNAPSHOT_VERSION, SnapshotKey(&scene->config), size, scene->config,
+        scene->meshCount, scene->materialCount, scene->objectCount
+    };
+
+    SnapshotMesh *meshes = (SnapshotMesh *)(data + layout.meshes);
+    size_t offset = layout.meshData;
+    for (Uint32 i = 0; i < scene->meshCount; i++) {
+        const SceneMesh *mesh = &scene->meshes[i];
+        meshes[i] = (SnapshotMesh){ offset, 0, mesh->vertexCount, mesh->indexCount, mesh->boundRadius };
+        SDL_memcpy(data + offset, mesh->vertices, mesh->vertexCount * sizeof(PositionColorVertex));
+        offset = AlignSnapshot(offset + mesh->vertexCount * sizeof(PositionColorVertex));
+        meshes[i].indicesOffset = offset;
+        SDL_memcpy(data + offset, mesh->indices, mesh->indexCount * sizeof(Uint32));
+        offset = AlignSnapshot(offset + mesh->indexCount * sizeof(Uint32));
+    }
+    SDL_memcpy(data + layout.materials, scene->materials, scene->materialCount * sizeof(SceneMaterial));
+    SDL_memcpy(data + layout.objects, scene->objects, scene->objectCount * sizeof(SceneObject));
+    SDL_memcpy(data + layout.nodes, scene->nodes, scene->objectCount * sizeof(SceneNode));
+
+    bool written = Snapshot_Write(path, data, size);
+    SDL_free(data);
+    if (written) SDL_Log("Scene: snapshot written to %s (%llu bytes)", path, (unsigned long long)size);
+    return written;
+}
+
+void Scene_Update(Scene *scene, float time)
+{
+    /* Whole-view and chained objects only sway, so their coverage stays put */
+    bool sway = scene->config.kind == SCENE_FEW_LARGE_OVERDRAW || scene->config.kind == SCENE_DEEP_HIERARCHY;
+
+    for (Uint32 i = 0; i < scene->objectCount; i++) {
+        SceneNode *node = &scene->nodes[i];
+        SceneObject *object = &scene->objects[i];
+        float angle = time * node->speed + node->phase;
+        Vec3 pos = node->position;
+
+        Mat4 rotation = sway
+            ? Mat4_Multiply(Mat4_RotationX(0.15f * SDL_sinf(angle)), Mat4_RotationY(0.2f * SDL_cosf(angle)))
+            : Mat4_Multiply(Mat4_RotationY(angle), Mat4_RotationX(angle * 0.7f));
+        node->world = Mat4_Multiply(rotation, Mat4_Translation(pos.x, pos.y, pos.z));
+        if (node->parent >= 0) {
+            /* Children hang off the end of their parent */
+            node->world = Mat4_Multiply(node->world, scene->nodes[node->parent].world);
+        }
+
+        object->model = Mat4_Multiply(Mat4_Scale(node->scale), node->world);
+        object->center = (Vec3){ node->world.m[12], node->world.m[13], node->world.m[14] };
+    }
+}
+
+const char *Scene_KindName(SceneKind kind)
+{
+    return kind < SCENE_KIND_COUNT ? sceneNames[kind] : "unknown";
+}
+
+bool Scene_ParseKind(const char *name, SceneKind *kind)
+{
+    for (int i = 0; i < SCENE_KIND_COUNT; i++) {
+        if (SDL_strcmp(name, sceneNames[i]) == 0) {
+            *kind = (SceneKind)i;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,99 @@
+/*
+ * Benchmark scene library
+ *
+ * Parameterized scenes that each stress one part of the frame: object count,
+ * fill rate, vertex throughput, state changes and CPU transform work. A scene
+ * is plain CPU data - meshes, materials and a flat object list whose model
+ * matrices and world bounds Scene_Update refreshes every frame. The renderer
+ * uploads the meshes, builds a pipeline per material and draws the objects.
+ *
+ *   many-small-objects   objectCount small spinning cubes filling the view
+ *   few-large-overdraw   objectCount blended cubes that each cover the whole view
+ *   vertex-heavy         objectCount spheres of detail x 2*detail quads each
+ *   many-materials       objectCount cubes cycling through materialCount materials
+ *   deep-hierarchy       objectCount cubes in chains detail nodes deep, each
+ *                        node animated relative to its parent
+ *
+ * A created scene can be written to a snapshot and restored from it on a
+ * later run: the snapshot is memory mapped and the meshes are used in place,
+ * so a warm start skips generating them. A snapshot is keyed to the resolved
+ * config and the layout of everything it stores, and is ignored (and
+ * rewritten by the caller) when either differs.
+ */
+
+#ifndef SCENES_H
+#define SCENES_H
+
+#include <SDL3/SDL.h>
+
+#include "vecmath.h"
+
+typedef enum SceneKind {
+    SCENE_MANY_SMALL_OBJECTS,
+    SCENE_FEW_LARGE_OVERDRAW,
+    SCENE_VERTEX_HEAVY,
+    SCENE_MANY_MATERIALS,
+    SCENE_DEEP_HIERARCHY,
+    SCENE_KIND_COUNT
+} SceneKind;
+
+typedef struct SceneConfig {
+    SceneKind kind;
+    Uint32 objectCount;     /* 0 picks the scene's default */
+    Uint32 materialCount;   /* many-materials only; 0 picks the default */
+    Uint32 detail;          /* Sphere rings (vertex-heavy) or chain depth (deep-hierarchy); 0 picks the default */
+} SceneConfig;
+
+typedef struct SceneMesh {
+    PositionColorVertex *vertices;
+    Uint32 vertexCount;
+    Uint32 *indices;
+    Uint32 indexCount;
+    float boundRadius;      /* Around the mesh origin, before the object's scale */
+} SceneMesh;
+
+typedef struct SceneMaterial {
+    float tint[4];          /* Multiplies the vertex color */
+    bool blend;             /* Alpha blended instead of opaque */
+    bool doubleSided;       /* No back-face culling */
+} SceneMaterial;
+
+typedef struct SceneObject {
+    Mat4 model;
+    Vec3 center;            /* World-space bounding sphere */
+    float radius;
+    Uint32 mesh;
+    Uint32 material;
+} SceneObject;
+
+typedef struct SceneNode SceneNode;
+
+typedef struct Scene {
+    SceneConfig config;     /* With defaults filled in */
+    SceneMesh *meshes;
+    Uint32 meshCount;
+    SceneMaterial *materials;
+    Uint32 materialCount;
+    SceneObject *objects;
+    Uint32 objectCount;
+    SceneNode *nodes;       /* Animation state, parallel to objects */
+    struct SnapshotFile *snapshot;  /* Set when restored; the meshes point into it, read-only */
+} Scene;
+
+Scene *Scene_Create(const SceneConfig *config);
+void Scene_Destroy(Scene *scene);
+
+/* The scene Scene_Create would build for config, from a snapshot written by
+ * Scene_WriteSnapshot. Returns NULL if the file is missing or does not match
+ * this build and config. */
+Scene *Scene_Restore(const SceneConfig *config, const char *path);
+
+bool Scene_WriteSnapshot(const Scene *scene, const char *path);
+
+/* Recomputes every object's model matrix and bounds for the given time in seconds */
+void Scene_Update(Scene *scene, float time);
+
+const char *Scene_KindName(SceneKind kind);
+bool Scene_ParseKind(const char *name, SceneKind *kind);
+
+#endif /* SCENES_H */
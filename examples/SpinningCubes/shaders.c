@@ -0,0 +1,98 @@
+/*
+ * Shader loading - see shaders.h
+ */
+
+#include "shaders.h"
+
+/* Generated at build time */
+extern const ShaderBinary embeddedShaders[];
+extern const Uint32 embeddedShaderCount;
+
+static const ShaderBinary *FindEmbedded(const char *name)
+{
+    for (Uint32 i = 0; i < embeddedShaderCount; i++) {
+        if (SDL_strcmp(embeddedShaders[i].name, name) == 0) return &embeddedShaders[i];
+    }
+    return NULL;
+}
+
+/* The embedded binary, or the override file (returned in loaded, to be freed by the caller) */
+static bool FindCode(const char *name, const Uint8 **code, size_t *codeSize, void **loaded)
+{
+    const char *overrideDir = SDL_getenv("SPINNING_CUBES_SHADER_DIR");
+    *loaded = NULL;
+
+    if (overrideDir) {
+        char path[512];
+        SDL_snprintf(path, sizeof(path), "%s/%s.spv", overrideDir, name);
+        *loaded = SDL_LoadFile(path, codeSize);
+        if (!*loaded) {
+            SDL_Log("Failed to load shader %s: %s", path, SDL_GetError());
+            return false;
+        }
+        *code = *loaded;
+    } else {
+        const ShaderBinary *binary = FindEmbedded(name);
+        if (!binary) {
+            SDL_Log("Shader %s is not embedded in this build (it has no checked-in SPIR-V and shadercross was not found)", name);
+            return false;
+        }
+        *code = binary->code;
+        *codeSize = binary->size;
+    }
+    return true;
+}
+
+static void LogLoaded(const char *name, bool loaded)
+{
+    if (!loaded) {
+        SDL_Log("Failed to create shader %s: %s", name, SDL_GetError());
+    } else {
+        SDL_Log("Loaded shader: %s%s", name, SDL_getenv("SPINNING_CUBES_SHADER_DIR") ? " (from SPINNING_CUBES_SHADER_DIR)" : "");
+    }
+}
+
+SDL_GPUShader *Shaders_Load(SDL_GPUDevice *device, const char *name, SDL_GPUShaderStage stage,
+                            Uint32 samplerCount, Uint32 uniformBufferCount, Uint32 storageBufferCount)
+{
+    const Uint8 *code;
+    size_t codeSize;
+    void *loaded;
+    if (!FindCode(name, &code, &codeSize, &loaded)) return NULL;
+
+    SDL_GPUShaderCreateInfo shaderInfo = {
+        .code = code,
+        .code_size = codeSize,
+        .entrypoint = "main",
+        .format = SDL_GPU_SHADERFORMAT_SPIRV,
+        .stage = stage,
+        .num_samplers = samplerCount,
+        .num_uniform_buffers = uniformBufferCount,
+        .num_storage_buffers = storageBufferCount
+    };
+
+    SDL_GPUShader *shader = SDL_CreateGPUShader(device, &shaderInfo);
+    SDL_free(loaded);
+    LogLoaded(name, shader != NULL);
+    return shader;
+}
+
+SDL_GPUComputePipeline *Shaders_LoadCompute(SDL_GPUDevice *device, const char *name,
+                                            const SDL_GPUComputePipelineCreateInfo *info)
+{
+    const Uint8 *code;
+    size_t codeSize;
+    void *loaded;
+    if (!FindCode(name, &code, &codeSize, &loaded)) return NULL;
+
+    SDL_GPUComputePipelineCreateInfo pipelineInfo = *info;
+    pipelineInfo.code = code;
+    pipelineInfo.code_size = codeSize;
+    pipelineInfo.entrypoint = "main";
+    pipelineInfo.format = SDL_GPU_SHADERFORMAT_SPIRV;
+
+    SDL_GPUComputePipeline *pipeline = SDL_CreateGPUComputePipeline(device, &pipelineInfo);
+    SDL_free(loaded);
+    LogLoaded(name, pipeline != NULL);
+    return pipeline;
+}
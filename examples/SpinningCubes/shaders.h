@@ -0,0 +1,31 @@
+/*
+ * Shader loading
+ *
+ * Compiled SPIR-V is embedded in the executable at build time (see
+ * cmake/EmbedShaders.cmake), so loading a shader reads no files. For shader
+ * development SPINNING_CUBES_SHADER_DIR can name a folder of <name>.spv
+ * files that are loaded instead, without rebuilding the examples.
+ */
+
+#ifndef SHADERS_H
+#define SHADERS_H
+
+#include <SDL3/SDL.h>
+
+/* An entry of the generated embeddedShaders table */
+typedef struct {
+    const char *name;
+    const Uint8 *code;
+    size_t size;
+} ShaderBinary;
+
+/* name is the source file without .hlsl, e.g. "SolidColor.frag"; NULL if missing or invalid */
+SDL_GPUShader *Shaders_Load(SDL_GPUDevice *device, const char *name, SDL_GPUShaderStage stage,
+                            Uint32 samplerCount, Uint32 uniformBufferCount, Uint32 storageBufferCount);
+
+/* Compute shaders are whole pipelines in SDL GPU: info gives the resource
+ * counts and thread counts, the code is filled in here. NULL if missing or invalid. */
+SDL_GPUComputePipeline *Shaders_LoadCompute(SDL_GPUDevice *device, const char *name,
+                                            const SDL_GPUComputePipelineCreateInfo *info);
+
+#endif /* SHADERS_H */
@@ -0,0 +1,163 @@
+/*
+ * Snapshot files - see snapshot.h
+ */
+
+#include "snapshot.h"
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#define SNAPSHOT_MMAP_WINDOWS
+#elif defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SNAPSHOT_MMAP_POSIX
+#endif
+
+struct SnapshotFile {
+    void *data;
+    size_t size;
+#if defined(SNAPSHOT_MMAP_WINDOWS)
+    HANDLE file;
+    HANDLE mapping;
+#endif
+};
+
+/* ========================================================================
+ * Mapping
+ * ======================================================================== */
+
+#if defined(SNAPSHOT_MMAP_POSIX)
+
+static bool MapFile(SnapshotFile *snapshot, const char *path)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    bool mapped = false;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        void *data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) {
+            snapshot->data = data;
+            snapshot->size = (size_t)info.st_size;
+            mapped = true;
+        }
+    }
+    /* The mapping keeps the file referenced */
+    close(fd);
+    return mapped;
+}
+
+static void UnmapFile(SnapshotFile *snapshot)
+{
+    munmap(snapshot->data, snapshot->size);
+}
+
+#elif defined(SNAPSHOT_MMAP_WINDOWS)
+
+static bool MapFile(SnapshotFile *snapshot, const char *path)
+{
+    snapshot->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING,
+                                 FILE_ATTRIBUTE_NORMAL, NULL);
+    if (snapshot->file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size;
+    if (GetFileSizeEx(snapshot->file, &size) && size.QuadPart > 0) {
+        snapshot->mapping = CreateFileMappingA(snapshot->file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (snapshot->mapping) {
+            snapshot->data = MapViewOfFile(snapshot->mapping, FILE_MAP_READ, 0, 0, 0);
+            if (snapshot->data) {
+                snapshot->size = (size_t)size.QuadPart;
+                return true;
+            }
+            CloseHandle(snapshot->mapping);
+        }
+    }
+    CloseHandle(snapshot->file);
+    return false;
+}
+
+static void UnmapFile(SnapshotFile *snapshot)
+{
+    UnmapViewOfFile(snapshot->data);
+    CloseHandle(snapshot->mapping);
+    CloseHandle(snapshot->file);
+}
+
+#else
+
+static bool MapFile(SnapshotFile *snapshot, const char *path)
+{
+    snapshot->data = SDL_LoadFile(path, &snapshot->size);
+    return snapshot->data != NULL;
+}
+
+static void UnmapFile(SnapshotFile *snapshot)
+{
+    SDL_free(snapshot->data);
+}
+
+#endif
+
+/* ========================================================================
+ * Public Interface
+ * ======================================================================== */
+
+SnapshotFile *Snapshot_Map(const char *path)
+{
+    SnapshotFile *snapshot = SDL_calloc(1, sizeof(SnapshotFile));
+    if (!snapshot) return NULL;
+
+    if (!MapFile(snapshot, path)) {
+        SDL_free(snapshot);
+        return NULL;
+    }
+    return snapshot;
+}
+
+void Snapshot_Unmap(SnapshotFile *snapshot)
+{
+    if (!snapshot) return;
+    UnmapFile(snapshot);
+    SDL_free(snapshot);
+}
+
+const void *Snapshot_Data(const SnapshotFile *snapshot)
+{
+    return snapshot->data;
+}
+
+size_t Snapshot_Size(const SnapshotFile *snapshot)
+{
+    return snapshot->size;
+}
+
+bool Snapshot_Write(const char *path, const void *data, size_t size)
+{
+    char *tempPath = NULL;
+    if (SDL_asprintf(&tempPath, "%s.tmp", path) < 0) return false;
+
+    SDL_IOStream *io = SDL_IOFromFile(tempPath, "wb");
+    bool written = io && SDL_WriteIO(io, data, size) == size;
+    if (io && !SDL_CloseIO(io)) written = false;
+
+    if (written && !SDL_RenamePath(tempPath, path)) written = false;
+    if (!written) {
+        SDL_Log("Snapshot: failed to write %s: %s", path, SDL_GetError());
+        SDL_RemovePath(tempPath);
+    }
+    SDL_free(tempPath);
+    return written;
+}
+
+Uint64 Snapshot_Hash(Uint64 hash, const void *data, size_t size)
+{
+    const Uint8 *bytes = data;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ bytes[i]) * 0x100000001b3ull;
+    }
+    return hash;
+}
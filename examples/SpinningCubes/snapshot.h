@@ -0,0 +1,34 @@
+/*
+ * Snapshot files
+ *
+ * Read-only memory mapping of a file, so a warm start can use data written
+ * by an earlier run in place: pages are only read from storage when first
+ * touched, and stay shared with the page cache. Writes go to a temporary
+ * file that is renamed over the target, so a process killed mid-write never
+ * leaves a torn snapshot behind.
+ *
+ * Mapping uses mmap on POSIX systems and file mappings on Windows; elsewhere
+ * the file is read into memory instead.
+ */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <SDL3/SDL.h>
+
+typedef struct SnapshotFile SnapshotFile;
+
+/* NULL, without logging, if the file does not exist */
+SnapshotFile *Snapshot_Map(const char *path);
+void Snapshot_Unmap(SnapshotFile *snapshot);
+
+const void *Snapshot_Data(const SnapshotFile *snapshot);
+size_t Snapshot_Size(const SnapshotFile *snapshot);
+
+bool Snapshot_Write(const char *path, const void *data, size_t size);
+
+/* FNV-1a, for keying a snapshot to the inputs it was derived from */
+Uint64 Snapshot_Hash(Uint64 hash, const void *data, size_t size);
+#define SNAPSHOT_HASH_SEED 0xcbf29ce484222325ull
+
+#endif /* SNAPSHOT_H */
@@ -0,0 +1,112 @@
+/*
+ * Spatial tracking - see spaces.h
+ */
+
+#include "spaces.h"
+
+static XrSession spacesSession = XR_NULL_HANDLE;
+static PFN_xrLocateSpace pfn_locateSpace = NULL;
+static PFN_xrLocateSpacesKHR pfn_locateSpaces = NULL;
+
+static XrSpace spaces[SPACES_MAX];
+static Uint32 spaceCount = 0;
+
+/* Pose table columns */
+static XrQuaternionf orientations[SPACES_MAX];
+static XrVector3f positions[SPACES_MAX];
+static XrSpaceLocationFlags flags[SPACES_MAX];
+static SpacePoses poses = { 0, orientations, positions, flags };
+
+/* xrLocateSpacesKHR writes array-of-structs; scattered into the columns afterwards */
+static XrSpaceLocationDataKHR batch[SPACES_MAX];
+
+bool Spaces_Init(XrSession session, PFN_xrLocateSpace locateSpace, PFN_xrLocateSpacesKHR locateSpaces)
+{
+    if (!locateSpace && !locateSpaces) {
+        SDL_Log("Spaces: no locate function");
+        return false;
+    }
+    spacesSession = session;
+    pfn_locateSpace = locateSpace;
+    pfn_locateSpaces = locateSpaces;
+    spaceCount = 0;
+    poses.count = 0;
+    SDL_Log("Spaces: locating with %s", locateSpaces ? "xrLocateSpacesKHR" : "xrLocateSpace per space");
+    return true;
+}
+
+void Spaces_Shutdown(void)
+{
+    spacesSession = XR_NULL_HANDLE;
+    pfn_locateSpace = NULL;
+    pfn_locateSpaces = NULL;
+    spaceCount = 0;
+    poses.count = 0;
+}
+
+int Spaces_Register(XrSpace space)
+{
+    if (spaceCount >= SPACES_MAX) {
+        SDL_Log("Spaces: table full (%d spaces)", SPACES_MAX);
+        return -1;
+    }
+    spaces[spaceCount] = space;
+    flags[spaceCount] = 0;
+    poses.count = spaceCount + 1;
+    return (int)spaceCount++;
+}
+
+bool Spaces_LocateAll(XrSpace baseSpace, XrTime time)
+{
+    if (spaceCount == 0) return true;
+
+    if (pfn_locateSpaces) {
+        XrSpacesLocateInfoKHR locateInfo = { XR_TYPE_SPACES_LOCATE_INFO_KHR };
+        locateInfo.baseSpace = baseSpace;
+        locateInfo.time = time;
+        locateInfo.spaceCount = spaceCount;
+        locateInfo.spaces = spaces;
+        XrSpaceLocationsKHR locations = { XR_TYPE_SPACE_LOCATIONS_KHR };
+        locations.locationCount = spaceCount;
+        locations.locations = batch;
+
+        if (XR_FAILED(pfn_locateSpaces(spacesSession, &locateInfo, &locations))) {
+            SDL_memset(flags, 0, spaceCount * sizeof(flags[0]));
+            return false;
+        }
+        for (Uint32 i = 0; i < spaceCount; i++) {
+            orientations[i] = batch[i].pose.orientation;
+            positions[i] = batch[i].pose.position;
+            flags[i] = batch[i].locationFlags;
+        }
+        return true;
+    }
+
+    for (Uint32 i = 0; i < spaceCount; i++) {
+        XrSpaceLocation location = { XR_TYPE_SPACE_LOCATION };
+        if (XR_FAILED(pfn_locateSpace(spaces[i], baseSpace, time, &location))) {
+            flags[i] = 0;
+            continue;
+        }
+        orientations[i] = location.pose.orientation;
+        positions[i] = location.pose.position;
+        flags[i] = location.locationFlags;
+    }
+    return true;
+}
+
+const SpacePoses *Spaces_GetPoses(void)
+{
+    return &poses;
+}
+
+bool Spaces_GetPose(int index, XrPosef *pose)
+{
+    const XrSpaceLocationFlags validFlags = XR_SPACE_LOCATION_ORIENTATION_VALID_BIT | XR_SPACE_LOCATION_POSITION_VALID_BIT;
+
+    if (index < 0 || (Uint32)index >= spaceCount) return false;
+    if ((flags[index] & validFlags) != validFlags) return false;
+    pose->orientation = orientations[index];
+    pose->position = positions[index];
+    return true;
+}
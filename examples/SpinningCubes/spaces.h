@@ -0,0 +1,46 @@
+/*
+ * Spatial tracking
+ *
+ * Spaces whose poses are needed every frame (controllers, anchors, extra
+ * reference spaces) are registered once and then located together against
+ * one base space: a single xrLocateSpacesKHR call when XR_KHR_locate_spaces
+ * is available, one xrLocateSpace per space otherwise. Results land in a
+ * structure-of-arrays pose table indexed by registration order, so callers
+ * walking many poses only touch the columns they read.
+ */
+
+#ifndef SPACES_H
+#define SPACES_H
+
+#include <openxr/openxr.h>
+#include <SDL3/SDL.h>
+
+#define SPACES_MAX 64
+
+typedef struct SpacePoses {
+    Uint32 count;
+    const XrQuaternionf *orientations;
+    const XrVector3f *positions;
+    const XrSpaceLocationFlags *flags;      /* 0 for spaces that could not be located */
+} SpacePoses;
+
+/* locateSpaces may be NULL, in which case every space is located with locateSpace */
+bool Spaces_Init(XrSession session, PFN_xrLocateSpace locateSpace, PFN_xrLocateSpacesKHR locateSpaces);
+void Spaces_Shutdown(void);
+
+/* Returns the space's index in the pose table, or -1 when the table is full.
+ * The caller keeps ownership of the space and must not destroy it before
+ * Spaces_Shutdown. */
+int Spaces_Register(XrSpace space);
+
+/* Locates every registered space at time relative to baseSpace. Returns false
+ * if the batched call failed, in which case every flag is cleared. */
+bool Spaces_LocateAll(XrSpace baseSpace, XrTime time);
+
+/* The table filled by the last Spaces_LocateAll */
+const SpacePoses *Spaces_GetPoses(void);
+
+/* True when both orientation and position of a space are valid */
+bool Spaces_GetPose(int index, XrPosef *pose);
+
+#endif /* SPACES_H */
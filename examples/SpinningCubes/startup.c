@@ -0,0 +1,151 @@
+/*
+ * Startup phase profiler - see startup.h
+ */
+
+#include "startup.h"
+
+#if defined(SDL_PLATFORM_LINUX) || defined(SDL_PLATFORM_ANDROID)
+#include <unistd.h>
+#endif
+
+#define STARTUP_MAX_PHASES 32
+#define STARTUP_MAX_DEPTH 8
+
+typedef struct {
+    const char *name;
+    Uint64 beginNs;         /* Since launch */
+    Uint64 endNs;           /* 0 while open */
+    int depth;
+} StartupPhase;
+
+static StartupPhase phases[STARTUP_MAX_PHASES];
+static int phaseCount = 0;
+static int openPhases[STARTUP_MAX_DEPTH];
+static int openCount = 0;
+static Uint64 initTicksNs = 0;
+static Uint64 launchOffsetNs = 0;   /* Process age when Startup_Init ran; 0 if unknown */
+static bool finished = false;
+
+static Uint64 Now(void)
+{
+    return SDL_GetTicksNS() - initTicksNs + launchOffsetNs;
+}
+
+static double Ms(Uint64 ns)
+{
+    return (double)ns / 1e6;
+}
+
+/* Time since boot minus the process start time, both from /proc */
+static Uint64 ProcessAgeNs(void)
+{
+#if defined(SDL_PLATFORM_LINUX) || defined(SDL_PLATFORM_ANDROID)
+    char *uptime = SDL_LoadFile("/proc/uptime", NULL);
+    char *stat = SDL_LoadFile("/proc/self/stat", NULL);
+    Uint64 ageNs = 0;
+
+    /* The command name may contain spaces, so count fields from its closing
+     * parenthesis: the state is field 3 and the start time field 22 */
+    const char *field = stat ? SDL_strrchr(stat, ')') : NULL;
+    long ticksPerSecond = sysconf(_SC_CLK_TCK);
+    if (uptime && field && ticksPerSecond > 0) {
+        field++;
+        for (int i = 3; i < 22 && *field; i++) {
+            while (*field == ' ') field++;
+            while (*field && *field != ' ') field++;
+        }
+        double startSeconds = (double)SDL_strtoull(field, NULL, 10) / (double)ticksPerSecond;
+        double ageSeconds = SDL_strtod(uptime, NULL) - startSeconds;
+        if (ageSeconds > 0.0) {
+            ageNs = (Uint64)(ageSeconds * 1e9);
+        }
+    }
+    SDL_free(uptime);
+    SDL_free(stat);
+    return ageNs;
+#else
+    return 0;
+#endif
+}
+
+void Startup_Init(void)
+{
+    initTicksNs = SDL_GetTicksNS();
+    launchOffsetNs = ProcessAgeNs();
+}
+
+void Startup_BeginPhase(const char *name)
+{
+    if (finished || phaseCount == STARTUP_MAX_PHASES || openCount == STARTUP_MAX_DEPTH) return;
+    phases[phaseCount] = (StartupPhase){ name, Now(), 0, openCount };
+    openPhases[openCount++] = phaseCount++;
+}
+
+void Startup_EndPhase(void)
+{
+    if (finished || openCount == 0) return;
+    phases[openPhases[--openCount]].endNs = Now();
+}
+
+/* ========================================================================
+ * Report
+ * ======================================================================== */
+
+static void LogTimeline(Uint64 firstFrameNs)
+{
+    SDL_Log("Startup: timeline in ms since %s", launchOffsetNs ? "process launch" : "main()");
+    SDL_Log("Startup: %9s %9s %9s  %s", "start", "end", "duration", "phase");
+    if (launchOffsetNs) {
+        SDL_Log("Startup: %9.1f %9.1f %9.1f  %s", 0.0, Ms(launchOffsetNs), Ms(launchOffsetNs), "launch to main()");
+    }
+    for (int i = 0; i < phaseCount; i++) {
+        const StartupPhase *phase = &phases[i];
+        Uint64 endNs = phase->endNs ? phase->endNs : firstFrameNs;
+        SDL_Log("Startup: %9.1f %9.1f %9.1f  %*s%s%s", Ms(phase->beginNs), Ms(endNs), Ms(endNs - phase->beginNs),
+                phase->depth * 2, "", phase->name, phase->endNs ? "" : " (not ended)");
+    }
+    SDL_Log("Startup: first frame submitted at %.1f ms", Ms(firstFrameNs));
+}
+
+/* Chrome trace events: one complete event per phase, microseconds since launch */
+static bool WriteTrace(const char *path, Uint64 firstFrameNs)
+{
+    SDL_IOStream *io = SDL_IOFromFile(path, "w");
+    if (!io) {
+        SDL_Log("Startup: failed to open %s: %s", path, SDL_GetError());
+        return false;
+    }
+
+    SDL_IOprintf(io, "{\n  \"displayTimeUnit\": \"ms\",\n  \"traceEvents\": [\n");
+    if (launchOffsetNs) {
+        SDL_IOprintf(io, "    { \"name\": \"launch to main()\", \"ph\": \"X\", \"pid\": 1, \"tid\": 1, "
+                     "\"ts\": 0, \"dur\": %.1f },\n", (double)launchOffsetNs / 1e3);
+    }
+    for (int i = 0; i < phaseCount; i++) {
+        const StartupPhase *phase = &phases[i];
+        Uint64 endNs = phase->endNs ? phase->endNs : firstFrameNs;
+        SDL_IOprintf(io, "    { \"name\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": 1, \"ts\": %.1f, \"dur\": %.1f },\n",
+                     phase->name, (double)phase->beginNs / 1e3, (double)(endNs - phase->beginNs) / 1e3);
+    }
+    SDL_IOprintf(io, "    { \"name\": \"first frame submitted\", \"ph\": \"i\", \"s\": \"g\", \"pid\": 1, \"tid\": 1, "
+                 "\"ts\": %.1f }\n  ]\n}\n", (double)firstFrameNs / 1e3);
+
+    if (!SDL_CloseIO(io)) {
+        SDL_Log("Startup: failed to write %s: %s", path, SDL_GetError());
+        return false;
+    }
+    SDL_Log("Startup: trace written to %s", path);
+    return true;
+}
+
+void Startup_Finish(const char *tracePath)
+{
+    if (finished) return;
+    finished = true;
+
+    Uint64 firstFrameNs = Now();
+    LogTimeline(firstFrameNs);
+    if (tracePath) {
+        WriteTrace(tracePath, firstFrameNs);
+    }
+}
@@ -0,0 +1,30 @@
+/*
+ * Startup phase profiler
+ *
+ * Times the phases between process launch and the first frame submitted
+ * with layers, so cold-start work can be attacked where it is largest.
+ * Phases nest (e.g. CreatePipeline inside CreateSwapchains) and are logged
+ * as an indented timeline once the first frame is out; the same timeline
+ * can be written as a Chrome trace (chrome://tracing, Perfetto).
+ *
+ * Times are relative to process launch where the platform reports it
+ * (Linux and Android, to the 10 ms resolution of /proc), else to main().
+ */
+
+#ifndef STARTUP_H
+#define STARTUP_H
+
+#include <SDL3/SDL.h>
+
+/* Call first thing in main */
+void Startup_Init(void);
+
+/* Phases must end in the reverse order they began; both do nothing after Startup_Finish */
+void Startup_BeginPhase(const char *name);
+void Startup_EndPhase(void);
+
+/* Call once the first frame with layers has been ended. Logs the timeline and,
+ * if tracePath is not NULL, writes it as a trace; only the first call counts. */
+void Startup_Finish(const char *tracePath);
+
+#endif /* STARTUP_H */
@@ -0,0 +1,173 @@
+/*
+ * Math types and functions for 3D rendering
+ *
+ * Row-vector convention: a point transforms as v * M, so matrices compose
+ * left to right (model * view * projection). Shared by the renderer, the
+ * scene library and the benchmarks.
+ */
+
+#ifndef VECMATH_H
+#define VECMATH_H
+
+#include <openxr/openxr.h>
+#include <SDL3/SDL.h>
+
+typedef struct { float x, y, z; } Vec3;
+typedef struct { float m[16]; } Mat4;
+
+/* Vertex layout of every mesh the renderer draws */
+typedef struct {
+    float x, y, z;
+    Uint8 r, g, b, a;
+} PositionColorVertex;
+
+static inline Mat4 Mat4_Identity(void) {
+    return (Mat4){{ 1,0,0,0, 0,1,0,0, 0,0,1,0, 0,0,0,1 }};
+}
+
+static inline Mat4 Mat4_Multiply(Mat4 a, Mat4 b) {
+    Mat4 result = {{0}};
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+            for (int k = 0; k < 4; k++) {
+                result.m[i * 4 + j] += a.m[i * 4 + k] * b.m[k * 4 + j];
+            }
+        }
+    }
+    return result;
+}
+
+static inline Mat4 Mat4_Translation(float x, float y, float z) {
+    return (Mat4){{ 1,0,0,0, 0,1,0,0, 0,0,1,0, x,y,z,1 }};
+}
+
+static inline Mat4 Mat4_Scale(float s) {
+    return (Mat4){{ s,0,0,0, 0,s,0,0, 0,0,s,0, 0,0,0,1 }};
+}
+
+static inline Mat4 Mat4_RotationY(float rad) {
+    float c = SDL_cosf(rad), s = SDL_sinf(rad);
+    return (Mat4){{ c,0,-s,0, 0,1,0,0, s,0,c,0, 0,0,0,1 }};
+}
+
+static inline Mat4 Mat4_RotationX(float rad) {
+    float c = SDL_cosf(rad), s = SDL_sinf(rad);
+    return (Mat4){{ 1,0,0,0, 0,c,s,0, 0,-s,c,0, 0,0,0,1 }};
+}
+
+/* Convert XrPosef to view matrix (inverted transform) */
+static inline Mat4 Mat4_FromXrPose(XrPosef pose) {
+    float x = pose.orientation.x, y = pose.orientation.y;
+    float z = pose.orientation.z, w = pose.orientation.w;
+    
+    /* Quaternion to rotation matrix columns */
+    Vec3 right = { 1-2*(y*y+z*z), 2*(x*y+w*z), 2*(x*z-w*y) };
+    Vec3 up = { 2*(x*y-w*z), 1-2*(x*x+z*z), 2*(y*z+w*x) };
+    Vec3 fwd = { 2*(x*z+w*y), 2*(y*z-w*x), 1-2*(x*x+y*y) };
+    Vec3 pos = { pose.position.x, pose.position.y, pose.position.z };
+    
+    /* Inverted transform for view matrix */
+    float dr = -(right.x*pos.x + right.y*pos.y + right.z*pos.z);
+    float du = -(up.x*pos.x + up.y*pos.y + up.z*pos.z);
+    float df = -(fwd.x*pos.x + fwd.y*pos.y + fwd.z*pos.z);
+    
+    return (Mat4){{ right.x,up.x,fwd.x,0, right.y,up.y,fwd.y,0, right.z,up.z,fwd.z,0, dr,du,df,1 }};
+}
+
+static inline Mat4 Mat4_ScaleXYZ(float x, float y, float z) {
+    return (Mat4){{ x,0,0,0, 0,y,0,0, 0,0,z,0, 0,0,0,1 }};
+}
+
+/* Convert XrPosef to a model matrix (object to reference space) */
+static inline Mat4 Mat4_FromXrPoseModel(XrPosef pose) {
+    float x = pose.orientation.x, y = pose.orientation.y;
+    float z = pose.orientation.z, w = pose.orientation.w;
+    
+    return (Mat4){{
+        1-2*(y*y+z*z), 2*(x*y+w*z), 2*(x*z-w*y), 0,
+        2*(x*y-w*z), 1-2*(x*x+z*z), 2*(y*z+w*x), 0,
+        2*(x*z+w*y), 2*(y*z-w*x), 1-2*(x*x+y*y), 0,
+        pose.position.x, pose.position.y, pose.position.z, 1
+    }};
+}
+
+/* View matrix for a camera at eye looking at target, +Y up */
+static inline Mat4 Mat4_LookAt(Vec3 eye, Vec3 target) {
+    /* The camera looks down -Z, so its +Z axis points from the target back to the eye */
+    Vec3 fwd = { eye.x - target.x, eye.y - target.y, eye.z - target.z };
+    float len = SDL_sqrtf(fwd.x*fwd.x + fwd.y*fwd.y + fwd.z*fwd.z);
+    fwd.x /= len; fwd.y /= len; fwd.z /= len;
+    
+    /* right = worldUp x fwd, up = fwd x right */
+    Vec3 right = { fwd.z, 0.0f, -fwd.x };
+    len = SDL_sqrtf(right.x*right.x + right.z*right.z);
+    right.x /= len; right.z /= len;
+    Vec3 up = { fwd.y*right.z, fwd.z*right.x - fwd.x*right.z, -fwd.y*right.x };
+    
+    float dr = -(right.x*eye.x + right.y*eye.y + right.z*eye.z);
+    float du = -(up.x*eye.x + up.y*eye.y + up.z*eye.z);
+    float df = -(fwd.x*eye.x + fwd.y*eye.y + fwd.z*eye.z);
+    
+    return (Mat4){{ right.x,up.x,fwd.x,0, right.y,up.y,fwd.y,0, right.z,up.z,fwd.z,0, dr,du,df,1 }};
+}
+
+/* Create asymmetric projection matrix from XR FOV */
+static inline Mat4 Mat4_Projection(XrFovf fov, float nearZ, float farZ) {
+    float tL = SDL_tanf(fov.angleLeft), tR = SDL_tanf(fov.angleRight);
+    float tU = SDL_tanf(fov.angleUp), tD = SDL_tanf(fov.angleDown);
+    float w = tR - tL, h = tU - tD;
+    
+    return (Mat4){{
+        2/w, 0, 0, 0,
+        0, 2/h, 0, 0,
+        (tR+tL)/w, (tU+tD)/h, -farZ/(farZ-nearZ), -1,
+        0, 0, -(farZ*nearZ)/(farZ-nearZ), 0
+    }};
+}
+
+/* Sphere against the six clip planes of a row-vector view-projection matrix */
+static inline bool SphereInFrustum(const Mat4 *viewProj, Vec3 center, float radius) {
+    const float *m = viewProj->m;
+    for (int plane = 0; plane < 6; plane++) {
+        /* Planes are sums/differences of the w column with the x, y and z columns;
+         * depth runs 0..1 so near is the z column on its own */
+        int axis = plane / 2;
+        float sign = (plane % 2) ? -1.0f : 1.0f;
+        float w = (axis == 2 && sign > 0.0f) ? 0.0f : 1.0f;
+        float a = w * m[3] + sign * m[axis];
+        float b = w * m[7] + sign * m[4 + axis];
+        float c = w * m[11] + sign * m[8 + axis];
+        float d = w * m[15] + sign * m[12 + axis];
+        
+        float distance = a * center.x + b * center.y + c * center.z + d;
+        if (distance < -radius * SDL_sqrtf(a * a + b * b + c * c)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* The same six planes, normalized once so many spheres can be tested against them */
+typedef struct { float planes[6][4]; } Frustum;
+
+static inline Frustum Frustum_FromViewProj(const Mat4 *viewProj) {
+    const float *m = viewProj->m;
+    Frustum f;
+    for (int plane = 0; plane < 6; plane++) {
+        int axis = plane / 2;
+        float sign = (plane % 2) ? -1.0f : 1.0f;
+        float w = (axis == 2 && sign > 0.0f) ? 0.0f : 1.0f;
+        float a = w * m[3] + sign * m[axis];
+        float b = w * m[7] + sign * m[4 + axis];
+        float c = w * m[11] + sign * m[8 + axis];
+        float d = w * m[15] + sign * m[12 + axis];
+        float inv = 1.0f / SDL_sqrtf(a * a + b * b + c * c);
+        f.planes[plane][0] = a * inv;
+        f.planes[plane][1] = b * inv;
+        f.planes[plane][2] = c * inv;
+        f.planes[plane][3] = d * inv;
+    }
+    return f;
+}
+
+#endif /* VECMATH_H */
@@ -0,0 +1,825 @@
+/*
+ * In-process mock OpenXR runtime - see xrmock.h
+ */
+
+#include "xrmock.h"
+
+#define MOCK_MAX_VIEWS 4
+#define MOCK_SWAPCHAIN_IMAGES 3
+#define MOCK_EVENT_QUEUE_SIZE 8
+#define MOCK_IPD 0.064f
+#define MOCK_MAX_ACTIONS 16
+#define MOCK_MAX_ACTION_SPACES 16
+
+/* Paths the mock knows about; any other string gets a fresh id */
+#define MOCK_PATH_LEFT_HAND 1
+#define MOCK_PATH_RIGHT_HAND 2
+
+/* Handles are addresses of mock objects; the round trip through uintptr_t
+ * works whether the platform defines them as pointers or 64-bit integers. */
+#define MOCK_HANDLE(type, object) ((type)(uintptr_t)(object))
+#define MOCK_OBJECT(type, handle) ((type *)(uintptr_t)(handle))
+
+typedef struct {
+    SDL_GPUTexture **images;
+    Uint32 nextImage;
+} MockSwapchain;
+
+typedef struct {
+    bool aim;               /* Aim poses sit ahead of and above the grip */
+} MockAction;
+
+typedef struct {
+    bool inUse;
+    const MockAction *action;
+    XrPath hand;
+} MockActionSpace;
+
+typedef union {
+    XrEventDataBaseHeader header;
+    XrEventDataSessionStateChanged sessionStateChanged;
+    XrEventDataPerfSettingsEXT perfSettings;
+    XrEventDataDisplayRefreshRateChangedFB refreshRateChanged;
+} MockEvent;
+
+/* Emulated heat of one performance domain, 0 (cold) to 1 */
+typedef struct {
+    XrPerfSettingsLevelEXT level;
+    float heat;
+    XrPerfSettingsNotificationLevelEXT notification;
+} MockThermalDomain;
+
+static SDL_GPUDevice *mockDevice = NULL;
+static MockXRConfig mockConfig;
+static int mockInstance, mockSession, mockSpace; /* Only their addresses are used */
+
+static XrSessionState sessionState = XR_SESSION_STATE_UNKNOWN;
+static bool sessionRunning = false;
+static bool stopQueued = false;
+static XrViewConfigurationType activeViewConfiguration = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO;
+static MockEvent eventQueue[MOCK_EVENT_QUEUE_SIZE];
+static Uint32 eventHead = 0, eventCount = 0;
+
+static Uint64 frameCount = 0;
+static Uint64 nextWakeNs = 0;
+static bool frameBegun = false;
+static bool loggedInvalidLayer = false;
+
+static int mockActionSet;
+static MockAction actions[MOCK_MAX_ACTIONS];
+static Uint32 actionCount = 0;
+static MockActionSpace actionSpaces[MOCK_MAX_ACTION_SPACES];
+static bool actionSetAttached = false;
+static XrPath nextPath = MOCK_PATH_RIGHT_HAND + 1;
+
+static MockThermalDomain thermalDomains[2];    /* Indexed by XrPerfSettingsDomainEXT - 1 */
+
+/* Rates offered through XR_FB_display_refresh_rate, ascending, plus the configured one */
+static const float standardRefreshRates[] = { 60.0f, 72.0f, 80.0f, 90.0f, 120.0f };
+static float refreshRates[SDL_arraysize(standardRefreshRates) + 1];
+static uint32_t refreshRateCount = 0;
+static float defaultRefreshRate = 90.0f;
+
+static const XrViewConfigurationType offeredConfigurations[] = {
+    XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO,
+    XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO_WITH_FOVEATED_INSET,
+    XR_VIEW_CONFIGURATION_TYPE_PRIMARY_MONO
+};
+
+static Uint32 ViewCountFor(XrViewConfigurationType type)
+{
+    switch (type) {
+        case XR_VIEW_CONFIGURATION_TYPE_PRIMARY_MONO: return 1;
+        case XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO: return 2;
+        case XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO_WITH_FOVEATED_INSET: return 4;
+        default: return 0;
+    }
+}
+
+static void QueueEvent(const MockEvent *event)
+{
+    if (eventCount == MOCK_EVENT_QUEUE_SIZE) return;
+    eventQueue[(eventHead + eventCount) % MOCK_EVENT_QUEUE_SIZE] = *event;
+    eventCount++;
+}
+
+static void QueueState(XrSessionState state)
+{
+    MockEvent event;
+    SDL_zero(event);
+    event.sessionStateChanged.type = XR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED;
+    event.sessionStateChanged.session = MOCK_HANDLE(XrSession, &mockSession);
+    event.sessionStateChanged.state = state;
+    QueueEvent(&event);
+}
+
+/* The frame limit and the app can both end the session; only the first counts */
+static void QueueStop(void)
+{
+    if (stopQueued) return;
+    stopQueued = true;
+    QueueState(XR_SESSION_STATE_STOPPING);
+}
+
+/* ========================================================================
+ * Instance and System
+ * ======================================================================== */
+
+static XrResult XRAPI_CALL Mock_xrEnumerateViewConfigurations(XrInstance instance, XrSystemId systemId,
+                                                              uint32_t capIn, uint32_t *countOut,
+                                                              XrViewConfigurationType *types)
+{
+    (void)instance; (void)systemId;
+    uint32_t count = (uint32_t)SDL_arraysize(offeredConfigurations);
+    *countOut = count;
+    if (capIn == 0) return XR_SUCCESS;
+    if (capIn < count) return XR_ERROR_SIZE_INSUFFICIENT;
+    SDL_memcpy(types, offeredConfigurations, sizeof(offeredConfigurations));
+    return XR_SUCCESS;
+}
+
+static XrResult XRAPI_CALL Mock_xrEnumerateViewConfigurationViews(XrInstance instance, XrSystemId systemId,
+                                                                  XrViewConfigurationType type,
+                                                                  uint32_t viewCapacityInput, uint32_t *viewCountOutput,
+                                                                  XrViewConfigurationView *views)
+{
+    (void)instance; (void)systemId;
+    uint32_t count = ViewCountFor(type);
+    if (count == 0) return XR_ERROR_VIEW_CONFIGURATION_TYPE_UNSUPPORTED;
+
+    *viewCountOutput = count;
+    if (viewCapacityInput == 0) return XR_SUCCESS;
+    if (viewCapacityInput < count) return XR_ERROR_SIZE_INSUFFICIENT;
+
+    for (uint32_t i = 0; i < count; i++) {
+        views[i].recommendedImageRectWidth = mockConfig.width;
+        views[i].recommendedImageRectHeight = mockConfig.height;
+        views[i].maxImageRectWidth = mockConfig.width * 2;
+        views[i].maxImageRectHeight = mockConfig.height * 2;
+        views[i].recommendedSwapchainSampleCount = 1;
+        views[i].maxSwapchainSampleCount = 4;
+    }
+    return XR_SUCCESS;
+}
+
+static XrResult XRAPI_CALL Mock_xrPollEvent(XrInstance instance, XrEventDataBuffer *eventData)
+{
+    (void)instance;
+    if (eventCount == 0) return XR_EVENT_UNAVAILABLE;
+
+    MockEvent *event = &eventQueue[eventHead];
+    if (event->header.type == XR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED) {
+        event->sessionStateChanged.time = (XrTime)SDL_GetTicksNS();
+        sessionState = event->sessionStateChanged.state;
+    }
+    SDL_memcpy(eventData, event, sizeof(*event));
+
+    eventHead = (eventHead + 1) % MOCK_EVENT_QUEUE_SIZE;
+    eventCount--;
+    return XR_SUCCESS;
+}
+
+/* ========================================================================
+ * Session and Spaces
+ * ======================================================================== */
+
+static XrResult XRAPI_CALL Mock_xrBeginSession(XrSession session, const XrSessionBeginInfo *beginInfo)
+{
+    (void)session;
+    if (sessionState != XR_SESSION_STATE_READY) return XR_ERROR_SESSION_NOT_READY;
+    if (ViewCountFor(beginInfo->primaryViewConfigurationType) == 0) return XR_ERROR_VIEW_CONFIGURATION_TYPE_UNSUPPORTED;
+
+    activeViewConfiguration = beginInfo->primaryViewConfigurationType;
+    sessionRunning = true;
+    QueueState(XR_SESSION_STATE_SYNCHRONIZED);
+    QueueState(XR_SESSION_STATE_VISIBLE);
+    QueueState(XR_SESSION_STATE_FOCUSED);
+    return XR_SUCCESS;
+}
+
+static XrResult XRAPI_CALL Mock_xrEndSession(XrSession session)
+{
+    (void)session;
+    if (sessionState != XR_SESSION_STATE_STOPPING) return XR_ERROR_SESSION_NOT_STOPPING;
+
+    sessionRunning = false;
+    QueueState(XR_SESSION_STATE_IDLE);
+    QueueState(XR_SESSION_STATE_EXITING);
+    return XR_SUCCESS;
+}
+
+static XrResult XRAPI_CALL Mock_xrRequestExitSession(XrSession session)
+{
+    (void)session;
+    if (!sessionRunning) return XR_ERROR_SESSION_NOT_RUNNING;
+
+    QueueStop();
+    return XR_SUCCESS;
+}
+
+static XrResult XRAPI_CALL Mock_xrDestroySession(XrSession session)
+{
+    (void)session;
+    sessionState = XR_SESSION_STATE_UNKNOWN;
+    eventCount = 0;
+    return XR_SUCCESS;
+}
+
+static XrResult XRAPI_CALL Mock_xrCreateReferenceSpace(XrSession session, const XrReferenceSpaceCreateInfo *createInfo,
+                                                       XrSpace *space)
+{
+    (void)session; (void)createInfo;
+    *space = MOCK_HANDLE(XrSpace, &mockSpace);
+    return XR_SUCCESS;
+}
+
+static XrResult XRAPI_CALL Mock_xrDestroySpace(XrSpace space)
+{
+    /* Reference spaces are all the same static object; action spaces are pooled */
+    MockActionSpace *actionSpace = MOCK_OBJECT(MockActionSpace, space);
+    if (actionSpace >= actionSpaces && actionSpace < actionSpaces + MOCK_MAX_ACTION_SPACES) {
+        actionSpace->inUse = false;
+    }
+    return XR_SUCCESS;
+}
+
+/* ========================================================================
+ * Controller Input
+ * ======================================================================== */
+
+static XrResult XRAPI_CALL Mock_xrStringToPath(XrInstance instance, const char *pathString, XrPath *path)
+{
+    (void)instance;
+    if (!pathString || pathString[0] != '/') return XR_ERROR_PATH_FORMAT_INVALID;
+
+    if (SDL_strcmp(pathString, "/user/hand/left") == 0) {
+        *path = MOCK_PATH_LEFT_HAND;
+    } else if (SDL_strcmp(pathString, "/user/hand/right") == 0) {
+        *path = MOCK_PATH_RIGHT_HAND;
+    } else {
+        *path = nextPath++;
+    }
+    return XR_SUCCESS;
+}
+
+static XrResult XRAPI_CALL Mock_xrCreateActionSet(XrInstance instance, const XrActionSetCreateInfo *createInfo,
+                                                  XrActionSet *actionSet)
+{
+    (void)instance; (void)createInfo;
+    actionCount = 0;
+    *actionSet = MOCK_HANDLE(XrActionSet, &mockActionSet);
+    return XR_SUCCESS;
+}
+
+static XrResult XRAPI_CALL Mock_xrDestroyActionSet(XrActionSet actionSet)
+{
+    (void)actionSet;
+    actionCount = 0;
+    actionSetAttached = false;
+    return XR_SUCCESS;
+}
+
+static XrResult XRAPI_CALL Mock_xrCreateAction(XrActionSet actionSet, const XrActionCreateInfo *createInfo,
+                                               XrAction *action)
+{
+    (void)actionSet;
+    if (actionSetAttached) return XR_ERROR_ACTIONSETS_ALREADY_ATTACHED;
+    if (actionCount == MOCK_MAX_ACTIONS) return XR_ERROR_LIMIT_REACHED;
+
+    MockAction *mock = &actions[actionCount++];
+    mock->aim = SDL_strstr(createInfo->actionName, "aim") != NULL;
+    *action = MOCK_HANDLE(XrAction, mock);
+    return XR_SUCCESS;
+}
+
+/* Every profile is accepted; the mock has no physical bindings to check against */
+static XrResult XRAPI_CALL Mock_xrSuggestInteractionProfileBindings(XrInstance instance,
+                                                                    const XrInteractionProfileSuggestedBinding *suggestedBindings)
+{
+    (void)instance; (void)suggestedBindings;
+    return XR_SUCCESS;
+}
+
+static XrResult XRAPI_CALL Mock_xrAttachSessionActionSets(XrSession session, const XrSessionActionSetsAttachInfo *attachInfo)
+{
+    (void)session; (void)attachInfo;
+    if (actionSetAttached) return XR_ERROR_ACTIONSETS_ALREADY_ATTACHED;
+    actionSetAttached = true;
+    return XR_SUCCESS;
+}
+
+static XrResult XRAPI_CALL Mock_xrSyncActions(XrSession session, const XrActionsSyncInfo *syncInfo)
+{
+    (void)session; (void)syncInfo;
+    if (!actionSetAttached) return XR_ERROR_ACTIONSET_NOT_ATTACHED;
+    return sessionState == XR_SESSION_STATE_FOCUSED ? XR_SUCCESS : XR_SESSION_NOT_FOCUSED;
+}
+
+static XrResult XRAPI_CALL Mock_xrCreateActionSpace(XrSession session, const XrActionSpaceCreateInfo *createInfo,
+                                                    XrSpace *space)
+{
+    (void)session;
+    for (Uint32 i = 0; i < MOCK_MAX_ACTION_SPACES; i++) {
+        if (!actionSpaces[i].inUse) {
+            actionSpaces[i] = (MockActionSpace){ true, MOCK_OBJECT(MockAction, createInfo->action), createInfo->subactionPath };
+            *space = MOCK_HANDLE(XrSpace, &actionSpaces[i]);
+            return XR_SUCCESS;
+        }
+    }
+    return XR_ERROR_LIMIT_REACHED;
+}
+
+static XrResult XRAPI_CALL Mock_xrGetActionStatePose(XrSession session, const XrActionStateGetInfo *getInfo,
+                                                     XrActionStatePose *state)
+{
+    (void)session; (void)getInfo;
+    if (!actionSetAttached) return XR_ERROR_ACTIONSET_NOT_ATTACHED;
+    state->isActive = sessionState == XR_SESSION_STATE_FOCUSED;
+    return XR_SUCCESS;
+}
+
+/* No buttons are ever pressed */
+static XrResult XRAPI_CALL Mock_xrGetActionStateBoolean(XrSession session, const XrActionStateGetInfo *getInfo,
+                                                        XrActionStateBoolean *state)
+{
+    (void)session; (void)getInfo;
+    if (!actionSetAttached) return XR_ERROR_ACTIONSET_NOT_ATTACHED;
+    state->isActive = sessionState == XR_SESSION_STATE_FOCUSED;
+    state->currentState = XR_FALSE;
+    state->changedSinceLastSync = XR_FALSE;
+    state->lastChangeTime = 0;
+    return XR_SUCCESS;
+}
+
+/* Hands held in front of the body, bobbing and swaying slowly so latency and
+ * late latching have something to show. Locations are relative to the fixed
+ * head, so the base space is ignored. */
+static XrResult XRAPI_CALL Mock_xrLocateSpace(XrSpace space, XrSpace baseSpace, XrTime time, XrSpaceLocation *location)
+{
+    (void)baseSpace;
+    location->locationFlags = XR_SPACE_LOCATION_ORIENTATION_VALID_BIT | XR_SPACE_LOCATION_POSITION_VALID_BIT |
+                              XR_SPACE_LOCATION_ORIENTATION_TRACKED_BIT | XR_SPACE_LOCATION_POSITION_TRACKED_BIT;
+    location->pose.orientation = (XrQuaternionf){ 0.0f, 0.0f, 0.0f, 1.0f };
+    location->pose.position = (XrVector3f){ 0.0f, 0.0f, 0.0f };
+
+    MockActionSpace *actionSpace = MOCK_OBJECT(MockActionSpace, space);
+    if (actionSpace < actionSpaces || actionSpace >= actionSpaces + MOCK_MAX_ACTION_SPACES) {
+        return XR_SUCCESS;
+    }
+
+    float side = actionSpace->hand == MOCK_PATH_RIGHT_HAND ? 1.0f : -1.0f;
+    float seconds = (float)((double)time / 1e9);
+    float yaw = 0.2f * SDL_sinf(seconds * 0.8f) * side;
+
+    location->pose.orientation = (XrQuaternionf){ 0.0f, SDL_sinf(yaw * 0.5f), 0.0f, SDL_cosf(yaw * 0.5f) };
+    location->pose.position = (XrVector3f){
+        0.2f * side,
+        -0.3f + 0.03f * SDL_sinf(seconds * 1.3f + side),
+        -0.4f + 0.05f * SDL_sinf(seconds * 0.9f)
+    };
+    if (actionSpace->action && actionSpace->action->aim) {
+        location->pose.position.y += 0.02f;
+        location->pose.position.z -= 0.05f;
+    }
+    return XR_SUCCESS;
+}
+
+/* XR_KHR_locate_spaces, always offered so the batched path gets exercised */
+static XrResult XRAPI_CALL Mock_xrLocateSpacesKHR(XrSession session, const XrSpacesLocateInfoKHR *locateInfo,
+                                                  XrSpaceLocationsKHR *spaceLocations)
+{
+    (void)session;
+    if (spaceLocations->locationCount != locateInfo->spaceCount) return XR_ERROR_VALIDATION_FAILURE;
+    for (uint32_t i = 0; i < locateInfo->spaceCount; i++) {
+        XrSpaceLocation location = { XR_TYPE_SPACE_LOCATION };
+        Mock_xrLocateSpace(locateInfo->spaces[i], locateInfo->baseSpace, locateInfo->time, &location);
+        spaceLocations->locations[i].locationFlags = location.locationFlags;
+        spaceLocations->locations[i].pose = location.pose;
+    }
+    return XR_SUCCESS;
+}
+
+/* ========================================================================
+ * Performance Settings
+ * ======================================================================== */
+
+/* XR_EXT_performance_settings. Levels do not change how fast anything runs
+ * here; with thermalSeconds set they heat an emulated device instead, which
+ * reports WARNING and IMPAIRED notifications like a standalone headset. */
+static XrResult XRAPI_CALL Mock_xrPerfSettingsSetPerformanceLevelEXT(XrSession session, XrPerfSettingsDomainEXT domain,
+                                                                     XrPerfSettingsLevelEXT level)
+{
+    (void)session;
+    if (domain != XR_PERF_SETTINGS_DOMAIN_CPU_EXT && domain != XR_PERF_SETTINGS_DOMAIN_GPU_EXT) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    MockThermalDomain *thermal = &thermalDomains[domain - 1];
+    if (thermal->level != level) {
+        SDL_Log("MockXR: %s performance level %d", domain == XR_PERF_SETTINGS_DOMAIN_CPU_EXT ? "CPU" : "GPU", (int)level);
+    }
+    thermal->level = level;
+    return XR_SUCCESS;
+}
+
+/* Heat each level settles at: sustained high runs warm, boost overheats */
+static float ThermalTarget(XrPerfSettingsLevelEXT level)
+{
+    switch (level) {
+        case XR_PERF_SETTINGS_LEVEL_POWER_SAVINGS_EXT: return 0.3f;
+        case XR_PERF_SETTINGS_LEVEL_SUSTAINED_LOW_EXT: return 0.55f;
+        case XR_PERF_SETTINGS_LEVEL_SUSTAINED_HIGH_EXT: return 0.8f;
+        default: return 1.0f;
+    }
+}
+
+/* WARNING is entered above 0.75 and IMPAIRED above 0.95; leaving either takes 0.05 less */
+static XrPerfSettingsNotificationLevelEXT ThermalNotification(float heat, XrPerfSettingsNotificationLevelEXT current)
+{
+    const float margin = 0.05f;
+    if (heat > 0.95f || (current == XR_PERF_SETTINGS_NOTIF_LEVEL_IMPAIRED_EXT && heat > 0.95f - margin)) {
+        return XR_PERF_SETTINGS_NOTIF_LEVEL_IMPAIRED_EXT;
+    }
+    if (heat > 0.75f || (current != XR_PERF_SETTINGS_NOTIF_LEVEL_NORMAL_EXT && heat > 0.75f - margin)) {
+        return XR_PERF_SETTINGS_NOTIF_LEVEL_WARNING_EXT;
+    }
+    return XR_PERF_SETTINGS_NOTIF_LEVEL_NORMAL_EXT;
+}
+
+/* Moves each domain's heat toward its level's target and queues a thermal
+ * notification whenever the device state changes */
+static void UpdateThermals(void)
+{
+    if (mockConfig.thermalSeconds <= 0.0f) return;
+
+    float step = SDL_min(1.0f, 1.0f / (mockConfig.refreshRate * mockConfig.thermalSeconds));
+    for (int i = 0; i < (int)SDL_arraysize(thermalDomains); i++) {
+        MockThermalDomain *thermal = &thermalDomains[i];
+        thermal->heat += (ThermalTarget(thermal->level) - thermal->heat) * step;
+
+        XrPerfSettingsNotificationLevelEXT notification = ThermalNotification(thermal->heat, thermal->notification);
+        if (notification == thermal->notification) continue;
+
+        MockEvent event;
+        SDL_zero(event);
+        event.perfSettings.type = XR_TYPE_EVENT_DATA_PERF_SETTINGS_EXT;
+        event.perfSettings.domain = (XrPerfSettingsDomainEXT)(i + 1);
+        event.perfSettings.subDomain = XR_PERF_SETTINGS_SUB_DOMAIN_THERMAL_EXT;
+        event.perfSettings.fromLevel = thermal->notification;
+        event.perfSettings.toLevel = notification;
+        QueueEvent(&event);
+        thermal->notification = notification;
+    }
+}
+
+/* ========================================================================
+ * Display Refresh Rate
+ * ======================================================================== */
+
+/* The configured rate is merged into the standard ones so --mock-hz stays selectable */
+static void InitRefreshRates(void)
+{
+    defaultRefreshRate = mockConfig.refreshRate;
+    refreshRateCount = 0;
+    bool inserted = false;
+    for (size_t i = 0; i < SDL_arraysize(standardRefreshRates); i++) {
+        if (!inserted && defaultRefreshRate <= standardRefreshRates[i]) {
+            if (defaultRefreshRate < standardRefreshRates[i]) refreshRates[refreshRateCount++] = defaultRefreshRate;
+            inserted = true;
+        }
+        refreshRates[refreshRateCount++] = standardRefreshRates[i];
+    }
+    if (!inserted) refreshRates[refreshRateCount++] = defaultRefreshRate;
+}
+
+static XrResult XRAPI_CALL Mock_xrEnumerateDisplayRefreshRatesFB(XrSession session, uint32_t displayRefreshRateCapacityInput,
+                                                                 uint32_t *displayRefreshRateCountOutput,
+                                                                 float *displayRefreshRates)
+{
+    (void)session;
+    *displayRefreshRateCountOutput = refreshRateCount;
+    if (displayRefreshRateCapacityInput == 0) return XR_SUCCESS;
+    if (displayRefreshRateCapacityInput < refreshRateCount) return XR_ERROR_SIZE_INSUFFICIENT;
+    SDL_memcpy(displayRefreshRates, refreshRates, refreshRateCount * sizeof(float));
+    return XR_SUCCESS;
+}
+
+static XrResult XRAPI_CALL Mock_xrGetDisplayRefreshRateFB(XrSession session, float *displayRefreshRate)
+{
+    (void)session;
+    *displayRefreshRate = mockConfig.refreshRate;
+    return XR_SUCCESS;
+}
+
+/* Takes effect from the next xrWaitFrame; 0 returns to the configured rate */
+static XrResult XRAPI_CALL Mock_xrRequestDisplayRefreshRateFB(XrSession session, float displayRefreshRate)
+{
+    (void)session;
+    float rate = displayRefreshRate == 0.0f ? defaultRefreshRate : displayRefreshRate;
+    bool offered = false;
+    for (uint32_t i = 0; i < refreshRateCount; i++) {
+        if (refreshRates[i] == rate) offered = true;
+    }
+    if (!offered) return XR_ERROR_DISPLAY_REFRESH_RATE_UNSUPPORTED_FB;
+    if (rate == mockConfig.refreshRate) return XR_SUCCESS;
+
+    MockEvent event;
+    SDL_zero(event);
+    event.refreshRateChanged.type = XR_TYPE_EVENT_DATA_DISPLAY_REFRESH_RATE_CHANGED_FB;
+    event.refreshRateChanged.fromDisplayRefreshRate = mockConfig.refreshRate;
+    event.refreshRateChanged.toDisplayRefreshRate = rate;
+    QueueEvent(&event);
+    mockConfig.refreshRate = rate;
+    return XR_SUCCESS;
+}
+
+/* ========================================================================
+ * Frame Loop
+ * ======================================================================== */
+
+static XrResult XRAPI_CALL Mock_xrWaitFrame(XrSession session, const XrFrameWaitInfo *frameWaitInfo, XrFrameState *frameState)
+{
+    (void)session; (void)frameWaitInfo;
+    Uint64 periodNs = (Uint64)(1000000000.0 / (double)mockConfig.refreshRate);
+    Uint64 nowNs = SDL_GetTicksNS();
+
+    if (!mockConfig.unpaced && nowNs < nextWakeNs) {
+        SDL_DelayPrecise(nextWakeNs - nowNs);
+        nowNs = nextWakeNs;
+    }
+    /* A late frame skips to the next vsync instead of trying to catch up */
+    nextWakeNs = SDL_max(nextWakeNs, nowNs) + periodNs;
+
+    frameState->predictedDisplayTime = (XrTime)(nowNs + periodNs);
+    frameState->predictedDisplayPeriod = (XrDuration)periodNs;
+    frameState->shouldRender = sessionState == XR_SESSION_STATE_VISIBLE || sessionState == XR_SESSION_STATE_FOCUSED;
+    return XR_SUCCESS;
+}
+
+static XrResult XRAPI_CALL Mock_xrBeginFrame(XrSession session, const XrFrameBeginInfo *frameBeginInfo)
+{
+    (void)session; (void)frameBeginInfo;
+    XrResult result = frameBegun ? XR_FRAME_DISCARDED : XR_SUCCESS;
+    frameBegun = true;
+    return result;
+}
+
+static bool ValidateLayer(const XrCompositionLayerBaseHeader *header)
+{
+    if (header->type != XR_TYPE_COMPOSITION_LAYER_PROJECTION) return true;
+
+    const XrCompositionLayerProjection *layer = (const XrCompositionLayerProjection *)header;
+    if (layer->viewCount != ViewCountFor(activeViewConfiguration)) return false;
+    for (uint32_t i = 0; i < layer->viewCount; i++) {
+        const XrSwapchainSubImage *subImage = &layer->views[i].subImage;
+        if (subImage->swapchain == XR_NULL_HANDLE) return false;
+        if (subImage->imageRect.offset.x < 0 || subImage->imageRect.offset.y < 0) return false;
+        if (subImage->imageRect.extent.width <= 0 || subImage->imageRect.extent.height <= 0) return false;
+    }
+    return true;
+}
+
+static XrResult XRAPI_CALL Mock_xrEndFrame(XrSession session, const XrFrameEndInfo *frameEndInfo)
+{
+    (void)session;
+    if (!frameBegun) return XR_ERROR_CALL_ORDER_INVALID;
+    frameBegun = false;
+
+    for (uint32_t i = 0; i < frameEndInfo->layerCount; i++) {
+        if (!ValidateLayer(frameEndInfo->layers[i])) {
+            if (!loggedInvalidLayer) {
+                SDL_Log("MockXR: layer %u does not match the %u-view configuration", i,
+                        ViewCountFor(activeViewConfiguration));
+                loggedInvalidLayer = true;
+            }
+            return XR_ERROR_LAYER_INVALID;
+        }
+    }
+
+    frameCount++;
+    UpdateThermals();
+    if (mockConfig.frameLimit > 0 && frameCount == mockConfig.frameLimit) {
+        QueueStop();
+    }
+    return XR_SUCCESS;
+}
+
+/* Head fixed at the origin looking down -Z; inset views share their eye's pose */
+static XrResult XRAPI_CALL Mock_xrLocateViews(XrSession session, const XrViewLocateInfo *viewLocateInfo,
+                                              XrViewState *viewState, uint32_t viewCapacityInput,
+                                              uint32_t *viewCountOutput, XrView *views)
+{
+    (void)session;
+    uint32_t count = ViewCountFor(viewLocateInfo->viewConfigurationType);
+    if (count == 0) return XR_ERROR_VIEW_CONFIGURATION_TYPE_UNSUPPORTED;
+
+    *viewCountOutput = count;
+    if (viewCapacityInput == 0) return XR_SUCCESS;
+    if (viewCapacityInput < count) return XR_ERROR_SIZE_INSUFFICIENT;
+
+    viewState->viewStateFlags = XR_VIEW_STATE_ORIENTATION_VALID_BIT | XR_VIEW_STATE_POSITION_VALID_BIT;
+
+    /* Canted, asymmetric eye frusta similar to a standalone headset */
+    static const XrFovf eyeFov[2] = {
+        { -0.942f, 0.698f, 0.733f, -0.820f },
+        { -0.698f, 0.942f, 0.733f, -0.820f }
+    };
+    static const XrFovf insetFov = { -0.35f, 0.35f, 0.35f, -0.35f };
+    static const XrFovf monoFov = { -0.8f, 0.8f, 0.8f, -0.8f };
+
+    for (uint32_t i = 0; i < count; i++) {
+        views[i].pose.orientation = (XrQuaternionf){ 0.0f, 0.0f, 0.0f, 1.0f };
+        if (count == 1) {
+            views[i].pose.position = (XrVector3f){ 0.0f, 0.0f, 0.0f };
+            views[i].fov = monoFov;
+        } else {
+            uint32_t eye = i % 2;
+            views[i].pose.position = (XrVector3f){ eye == 0 ? -MOCK_IPD / 2 : MOCK_IPD / 2, 0.0f, 0.0f };
+            views[i].fov = i < 2 ? eyeFov[eye] : insetFov;
+        }
+    }
+    return XR_SUCCESS;
+}
+
+/* ========================================================================
+ * Swapchains
+ * ======================================================================== */
+
+static XrResult XRAPI_CALL Mock_xrEnumerateSwapchainImages(XrSwapchain swapchain, uint32_t imageCapacityInput,
+                                                           uint32_t *imageCountOutput, void *images)
+{
+    (void)swapchain; (void)images;
+    *imageCountOutput = MOCK_SWAPCHAIN_IMAGES;
+    /* There are no graphics-API image structs to hand out; use the SDL textures */
+    return imageCapacityInput == 0 ? XR_SUCCESS : XR_ERROR_FUNCTION_UNSUPPORTED;
+}
+
+static XrResult XRAPI_CALL Mock_xrAcquireSwapchainImage(XrSwapchain swapchain, const XrSwapchainImageAcquireInfo *acquireInfo,
+                                                        uint32_t *index)
+{
+    (void)acquireInfo;
+    MockSwapchain *mock = MOCK_OBJECT(MockSwapchain, swapchain);
+    *index = mock->nextImage;
+    mock->nextImage = (mock->nextImage + 1) % MOCK_SWAPCHAIN_IMAGES;
+    return XR_SUCCESS;
+}
+
+static XrResult XRAPI_CALL Mock_xrWaitSwapchainImage(XrSwapchain swapchain, const XrSwapchainImageWaitInfo *waitInfo)
+{
+    (void)swapchain; (void)waitInfo;
+    return XR_SUCCESS;
+}
+
+static XrResult XRAPI_CALL Mock_xrReleaseSwapchainImage(XrSwapchain swapchain, const XrSwapchainImageReleaseInfo *releaseInfo)
+{
+    (void)swapchain; (void)releaseInfo;
+    return XR_SUCCESS;
+}
+
+XrResult SDLCALL MockXR_CreateSwapchain(SDL_GPUDevice *device, XrSession session, const XrSwapchainCreateInfo *createinfo,
+                                        SDL_GPUTextureFormat *textureFormat, XrSwapchain *swapchain,
+                                        SDL_GPUTexture ***textures)
+{
+    (void)session;
+    MockSwapchain *mock = SDL_calloc(1, sizeof(MockSwapchain));
+    SDL_GPUTexture **images = SDL_calloc(MOCK_SWAPCHAIN_IMAGES, sizeof(SDL_GPUTexture *));
+    if (!mock || !images) {
+        SDL_free(mock);
+        SDL_free(images);
+        return XR_ERROR_OUT_OF_MEMORY;
+    }
+
+    SDL_GPUTextureCreateInfo textureInfo = {
+        .type = SDL_GPU_TEXTURETYPE_2D,
+        .format = SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM_SRGB,
+        .usage = SDL_GPU_TEXTUREUSAGE_COLOR_TARGET | SDL_GPU_TEXTUREUSAGE_SAMPLER,
+        .width = createinfo->width,
+        .height = createinfo->height,
+        .layer_count_or_depth = 1,
+        .num_levels = 1
+    };
+    for (Uint32 i = 0; i < MOCK_SWAPCHAIN_IMAGES; i++) {
+        images[i] = SDL_CreateGPUTexture(device, &textureInfo);
+        if (!images[i]) {
+            SDL_Log("MockXR: failed to create swapchain image: %s", SDL_GetError());
+            mock->images = images;
+            MockXR_DestroySwapchain(device, MOCK_HANDLE(XrSwapchain, mock), images);
+            return XR_ERROR_RUNTIME_FAILURE;
+        }
+    }
+
+    mock->images = images;
+    *textureFormat = textureInfo.format;
+    *swapchain = MOCK_HANDLE(XrSwapchain, mock);
+    *textures = images;
+    return XR_SUCCESS;
+}
+
+XrResult SDLCALL MockXR_DestroySwapchain(SDL_GPUDevice *device, XrSwapchain swapchain, SDL_GPUTexture **swapchainImages)
+{
+    for (Uint32 i = 0; i < MOCK_SWAPCHAIN_IMAGES; i++) {
+        if (swapchainImages[i]) SDL_ReleaseGPUTexture(device, swapchainImages[i]);
+    }
+    SDL_free(swapchainImages);
+    SDL_free(MOCK_OBJECT(MockSwapchain, swapchain));
+    return XR_SUCCESS;
+}
+
+/* ========================================================================
+ * Public Interface
+ * ======================================================================== */
+
+bool MockXR_Init(SDL_GPUDevice *device, const MockXRConfig *config, XrInstance *instance, XrSystemId *systemId)
+{
+    mockDevice = device;
+    mockConfig = *config;
+    if (mockConfig.refreshRate <= 0.0f) mockConfig.refreshRate = 90.0f;
+    InitRefreshRates();
+
+    frameCount = 0;
+    nextWakeNs = 0;
+    for (int i = 0; i < (int)SDL_arraysize(thermalDomains); i++) {
+        thermalDomains[i] = (MockThermalDomain){ XR_PERF_SETTINGS_LEVEL_SUSTAINED_HIGH_EXT, 0.5f, XR_PERF_SETTINGS_NOTIF_LEVEL_NORMAL_EXT };
+    }
+    *instance = MOCK_HANDLE(XrInstance, &mockInstance);
+    *systemId = 1;
+
+    SDL_Log("MockXR: %ux%u per view at %.0f Hz%s", mockConfig.width, mockConfig.height,
+            mockConfig.refreshRate, mockConfig.unpaced ? " (unpaced)" : "");
+    return true;
+}
+
+void MockXR_Shutdown(void)
+{
+    if (mockDevice) {
+        SDL_Log("MockXR: %llu frames submitted", (unsigned long long)frameCount);
+    }
+    mockDevice = NULL;
+}
+
+XrResult SDLCALL MockXR_CreateSession(SDL_GPUDevice *device, const XrSessionCreateInfo *createinfo, XrSession *session)
+{
+    (void)device; (void)createinfo;
+    sessionState = XR_SESSION_STATE_IDLE;
+    sessionRunning = false;
+    stopQueued = false;
+    QueueState(XR_SESSION_STATE_READY);
+    *session = MOCK_HANDLE(XrSession, &mockSession);
+    return XR_SUCCESS;
+}
+
+Uint64 MockXR_GetFrameCount(void)
+{
+    return frameCount;
+}
+
+XrResult XRAPI_CALL MockXR_GetInstanceProcAddr(XrInstance instance, const char *name, PFN_xrVoidFunction *function)
+{
+    (void)instance;
+
+#define MOCK_ENTRY(fn) { #fn, (PFN_xrVoidFunction)Mock_##fn }
+    static const struct { const char *name; PFN_xrVoidFunction function; } entries[] = {
+        MOCK_ENTRY(xrEnumerateViewConfigurations),
+        MOCK_ENTRY(xrEnumerateViewConfigurationViews),
+        MOCK_ENTRY(xrEnumerateSwapchainImages),
+        MOCK_ENTRY(xrCreateReferenceSpace),
+        MOCK_ENTRY(xrDestroySpace),
+        MOCK_ENTRY(xrDestroySession),
+        MOCK_ENTRY(xrPollEvent),
+        MOCK_ENTRY(xrBeginSession),
+        MOCK_ENTRY(xrEndSession),
+        MOCK_ENTRY(xrRequestExitSession),
+        MOCK_ENTRY(xrWaitFrame),
+        MOCK_ENTRY(xrBeginFrame),
+        MOCK_ENTRY(xrEndFrame),
+        MOCK_ENTRY(xrLocateViews),
+        MOCK_ENTRY(xrAcquireSwapchainImage),
+        MOCK_ENTRY(xrWaitSwapchainImage),
+        MOCK_ENTRY(xrReleaseSwapchainImage),
+        MOCK_ENTRY(xrStringToPath),
+        MOCK_ENTRY(xrCreateActionSet),
+        MOCK_ENTRY(xrDestroyActionSet),
+        MOCK_ENTRY(xrCreateAction),
+        MOCK_ENTRY(xrSuggestInteractionProfileBindings),
+        MOCK_ENTRY(xrAttachSessionActionSets),
+        MOCK_ENTRY(xrSyncActions),
+        MOCK_ENTRY(xrCreateActionSpace),
+        MOCK_ENTRY(xrGetActionStatePose),
+        MOCK_ENTRY(xrGetActionStateBoolean),
+        MOCK_ENTRY(xrLocateSpace),
+        MOCK_ENTRY(xrLocateSpacesKHR),
+        MOCK_ENTRY(xrPerfSettingsSetPerformanceLevelEXT),
+        MOCK_ENTRY(xrEnumerateDisplayRefreshRatesFB),
+        MOCK_ENTRY(xrGetDisplayRefreshRateFB),
+        MOCK_ENTRY(xrRequestDisplayRefreshRateFB),
+    };
+#undef MOCK_ENTRY
+
+    for (size_t i = 0; i < SDL_arraysize(entries); i++) {
+        if (SDL_strcmp(entries[i].name, name) == 0) {
+            *function = entries[i].function;
+            return XR_SUCCESS;
+        }
+    }
+    *function = NULL;
+    return XR_ERROR_FUNCTION_UNSUPPORTED;
+}
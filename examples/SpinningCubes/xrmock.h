@@ -0,0 +1,52 @@
+/*
+ * In-process mock OpenXR runtime
+ *
+ * Stands in for the loader and a headset so the renderer can run, and be
+ * benchmarked, on a desktop GPU without XR hardware. It resolves the OpenXR
+ * entry points this example uses, drives the session through READY to
+ * FOCUSED, paces xrWaitFrame to a configurable refresh rate and backs each
+ * swapchain with plain SDL GPU textures. Mono, stereo and quad
+ * (stereo with foveated inset) view configurations are offered; the two
+ * inset views of the quad configuration have a narrower field of view at
+ * the same resolution as the outer views. Pose actions on either hand report
+ * synthetic, slowly moving controllers. Performance levels requested through
+ * XR_EXT_performance_settings can drive an emulated thermal model, and
+ * XR_FB_display_refresh_rate offers 60, 72, 80, 90 and 120 Hz besides the
+ * configured rate, switching the pacing on request.
+ *
+ * The GPU device must be created without OpenXR; the SDL session and
+ * swapchain helpers are replaced by the MockXR_ equivalents below.
+ */
+
+#ifndef XRMOCK_H
+#define XRMOCK_H
+
+#include <openxr/openxr.h>
+#include <SDL3/SDL.h>
+
+typedef struct MockXRConfig {
+    Uint32 width;           /* Recommended size of every view */
+    Uint32 height;
+    float refreshRate;      /* Initial rate; XR_FB_display_refresh_rate can change it */
+    Uint64 frameLimit;      /* Ask the app to exit after this many frames; 0 runs until quit */
+    bool unpaced;           /* xrWaitFrame returns immediately instead of pacing to refreshRate */
+    float thermalSeconds;   /* Time constant of the emulated device heat; 0 never reports thermal events */
+} MockXRConfig;
+
+/* Returns the instance and system handles the app would get from SDL */
+bool MockXR_Init(SDL_GPUDevice *device, const MockXRConfig *config, XrInstance *instance, XrSystemId *systemId);
+void MockXR_Shutdown(void);
+
+XrResult XRAPI_CALL MockXR_GetInstanceProcAddr(XrInstance instance, const char *name, PFN_xrVoidFunction *function);
+
+/* Drop-in replacements for SDL_CreateGPUXRSession / SDL_CreateGPUXRSwapchain / SDL_DestroyGPUXRSwapchain */
+XrResult SDLCALL MockXR_CreateSession(SDL_GPUDevice *device, const XrSessionCreateInfo *createinfo, XrSession *session);
+XrResult SDLCALL MockXR_CreateSwapchain(SDL_GPUDevice *device, XrSession session, const XrSwapchainCreateInfo *createinfo,
+                                        SDL_GPUTextureFormat *textureFormat, XrSwapchain *swapchain,
+                                        SDL_GPUTexture ***textures);
+XrResult SDLCALL MockXR_DestroySwapchain(SDL_GPUDevice *device, XrSwapchain swapchain, SDL_GPUTexture **swapchainImages);
+
+/* Frames completed through xrEndFrame */
+Uint64 MockXR_GetFrameCount(void);
+
+#endif /* XRMOCK_H */